@@ -84,12 +84,15 @@
 //! \brief      Implements core graphic rendering capabilities.
 //---------------------------------------------------------------------------
 #include "graphics/CColor.h"
+#include "graphics/CCompressedImage.h"
 #include "graphics/CDisplayList.h"
 #include "graphics/CDraw3D.h"
 #include "graphics/CFog.h"
 #include "graphics/CFont.h"
 #include "graphics/CImage.h"
 #include "graphics/CMultiImage.h"
+#include "graphics/CModifiedRanges.h"
+#include "graphics/CMultiImageView.h"
 #include "graphics/CVideo.h"
 #include "graphics/CPrimitives.h"
 #include "graphics/CRenderOptions.h"
@@ -244,14 +247,18 @@
 //! \defgroup   files  Files
 //! \brief      Implements support for files.
 //---------------------------------------------------------------------------
+#include "files/CAssetLoader.h"
 #include "files/CFileAudioWAV.h"
 #include "files/CFileImageBMP.h"
+#include "files/CFileImageDDS.h"
 #include "files/CFileImageGIF.h"
 #include "files/CFileImageJPG.h"
+#include "files/CFileImageKTX.h"
 #include "files/CFileImagePNG.h"
 #include "files/CFileImagePPM.h"
 #include "files/CFileImageRAW.h"
 #include "files/CFileModel3DS.h"
+#include "files/CFileModelCMM.h"
 #include "files/CFileModelOBJ.h"
 #include "files/CFileModelSTL.h"
 #include "files/CFileXML.h"
@@ -261,11 +268,13 @@
 //! \defgroup   system  System
 //! \brief      Implements general capabilities that are OS dependent.
 //---------------------------------------------------------------------------
+#include "system/CFileMap.h"
 #include "system/CGenericType.h"
 #include "system/CGlobals.h"
 #include "system/CMutex.h"
 #include "system/CString.h"
 #include "system/CThread.h"
+#include "system/CThreadPool.h"
 
 
 //---------------------------------------------------------------------------
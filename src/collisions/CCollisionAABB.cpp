@@ -78,6 +78,10 @@ cCollisionAABB::cCollisionAABB()
     m_rootIndex = -1;
     m_maxDepth = 0;
     m_radius = 0.0;
+
+    // rebuild tree once a quarter of the elements have been refitted
+    m_rebuildThreshold = 0.25;
+    m_numUpdatedElements = 0;
 }
 
 
@@ -127,6 +131,7 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
 
     // clear previous tree
     m_nodes.clear();
+    m_numUpdatedElements = 0;
 
     // get number of elements
     m_numElements = m_elements->getNumElements();
@@ -234,6 +239,226 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
     {
         m_rootIndex = 0;
     }
+
+    // leaves are reordered while building the tree, record where each element ended up
+    m_elementToLeaf.resize(m_numElements);
+    for (int i=0; i<m_numElements; i++)
+    {
+        m_elementToLeaf[m_nodes[i].m_leftSubTree] = i;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method refits the collision tree after the elements passed as argument
+    have been modified. The topology of the tree is preserved; only the 
+    boundary boxes of the affected leaves are recomputed, followed by a single
+    pass over the internal nodes. This is much faster than rebuilding the tree
+    when small local regions of a large model are modified, but the quality of
+    the tree may degrade if elements move far from their original location. 
+    Elements that have been removed from the array are given an empty boundary
+    box so that they no longer enlarge the internal nodes.\n
+
+    If new elements have been added to the array since the tree was built, or
+    if the number of elements refitted since the last build exceeds the
+    fraction set by \ref setRebuildThreshold(), the tree is fully rebuilt.
+
+    \param  a_elementIndices  List of elements that have been modified.
+*/
+//==============================================================================
+void cCollisionAABB::updateElements(const std::vector<unsigned int>& a_elementIndices)
+{
+    // sanity check
+    if (m_elements == nullptr) { return; }
+
+    // if the number of elements has changed, the tree needs to be rebuilt
+    if ((m_rootIndex == -1) || 
+        ((int)(m_elements->getNumElements()) != m_numElements) ||
+        ((int)(m_elementToLeaf.size()) != m_numElements))
+    {
+        initialize(m_elements, m_radius);
+        return;
+    }
+
+    // nothing to update
+    if (a_elementIndices.size() == 0) { return; }
+
+    // rebuild the tree once too many elements have been refitted, as freed
+    // and reused slots no longer match the spatial layout of the tree
+    unsigned int numIndices = (unsigned int)(a_elementIndices.size());
+    m_numUpdatedElements += numIndices;
+    if ((double)(m_numUpdatedElements) > m_rebuildThreshold * (double)(m_numElements))
+    {
+        initialize(m_elements, m_radius);
+        return;
+    }
+
+    // refit leaves of modified elements
+    int numVerticesPerElement = m_elements->getNumVerticesPerElement();
+    for (unsigned int i=0; i<numIndices; i++)
+    {
+        unsigned int element = a_elementIndices[i];
+        if ((int)element >= m_numElements) { continue; }
+
+        cCollisionAABBNode& leaf = m_nodes[m_elementToLeaf[element]];
+
+        // removed elements do not contribute to the tree
+        if (!m_elements->getAllocated(element))
+        {
+            leaf.m_bbox.setEmpty();
+            continue;
+        }
+
+        switch (numVerticesPerElement)
+        {
+        case 1:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                leaf.fitBBox(m_radius, vertex0);
+                break;
+            }
+
+        case 2:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                cVector3d vertex1 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+                leaf.fitBBox(m_radius, vertex0, vertex1);
+                break;
+            }
+
+        case 3:
+            {
+                cVector3d vertex0 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+                cVector3d vertex1 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+                cVector3d vertex2 = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(element, 2));
+                leaf.fitBBox(m_radius, vertex0, vertex1, vertex2);
+                break;
+            }
+        }
+    }
+
+    // refit internal nodes. Since internal nodes are always inserted after 
+    // their children, a single forward pass is sufficient.
+    int numNodes = (int)(m_nodes.size());
+    for (int i=m_numElements; i<numNodes; i++)
+    {
+        cCollisionAABBNode& node = m_nodes[i];
+        node.m_bbox.setEmpty();
+        node.m_bbox.enclose(m_nodes[node.m_leftSubTree].m_bbox);
+        node.m_bbox.enclose(m_nodes[node.m_rightSubTree].m_bbox);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method restores a collision tree that was previously built for the 
+    same list of elements, typically after reading it back from a binary model 
+    cache. The node list must follow the layout produced by 
+    \ref initialize(): one leaf node per element stored first, followed by the 
+    internal nodes. The tree is validated before it is accepted: node indices
+    must be in range, each element must have exactly one leaf, and every node
+    must be reached exactly once from the root. If the node list does not 
+    match the elements, the method returns __false__ and the current tree is
+    left unchanged.
+
+    \param  a_elements   Pointer to element array.
+    \param  a_nodes      List of nodes that compose the tree.
+    \param  a_rootIndex  Index number of the root node.
+    \param  a_radius     Bounding radius that was used to build the tree.
+
+    \return __true__ if the tree was restored, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionAABB::restore(const cGenericArrayPtr a_elements,
+                             const std::vector<cCollisionAABBNode>& a_nodes,
+                             const int a_rootIndex,
+                             const double a_radius)
+{
+    // sanity check
+    if (a_elements == nullptr) { return (false); }
+
+    // check number of nodes
+    int numElements = a_elements->getNumElements();
+    int numNodes = (int)(a_nodes.size());
+    if (numElements == 0)
+    {
+        if (numNodes != 0) { return (false); }
+    }
+    else if (numNodes != (2 * numElements - 1))
+    {
+        return (false);
+    }
+
+    // check root
+    if ((numElements > 0) && ((a_rootIndex < 0) || (a_rootIndex >= numNodes)))
+    {
+        return (false);
+    }
+
+    // check leaves and build element lookup table
+    std::vector<int> elementToLeaf(numElements, -1);
+    int maxDepth = 0;
+    for (int i=0; i<numNodes; i++)
+    {
+        const cCollisionAABBNode& node = a_nodes[i];
+        if (i < numElements)
+        {
+            if (node.m_nodeType != C_AABB_NODE_LEAF) { return (false); }
+            if ((node.m_leftSubTree < 0) || (node.m_leftSubTree >= numElements)) { return (false); }
+            if (elementToLeaf[node.m_leftSubTree] != -1) { return (false); }
+            elementToLeaf[node.m_leftSubTree] = i;
+        }
+        else
+        {
+            if (node.m_nodeType != C_AABB_NODE_INTERNAL) { return (false); }
+            if ((node.m_leftSubTree < 0) || (node.m_leftSubTree >= numNodes) ||
+                (node.m_rightSubTree < 0) || (node.m_rightSubTree >= numNodes))
+            {
+                return (false);
+            }
+        }
+        maxDepth = cMax(maxDepth, node.m_depth);
+    }
+
+    // check that every node is reached exactly once from the root, so that 
+    // the node list contains no cycle and no shared subtree
+    if (numElements > 0)
+    {
+        std::vector<char> visited(numNodes, 0);
+        std::vector<int> stack;
+        stack.push_back(a_rootIndex);
+        int numVisited = 0;
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+            if (visited[index]) { return (false); }
+            visited[index] = 1;
+            numVisited++;
+
+            const cCollisionAABBNode& node = a_nodes[index];
+            if (node.m_nodeType == C_AABB_NODE_INTERNAL)
+            {
+                stack.push_back(node.m_leftSubTree);
+                stack.push_back(node.m_rightSubTree);
+            }
+        }
+        if (numVisited != numNodes) { return (false); }
+    }
+
+    // store tree
+    m_elements = a_elements;
+    m_radius = a_radius;
+    m_numElements = numElements;
+    m_nodes = a_nodes;
+    m_rootIndex = (numElements > 0) ? a_rootIndex : -1;
+    m_maxDepth = maxDepth;
+    m_elementToLeaf.swap(elementToLeaf);
+    m_numUpdatedElements = 0;
+
+    return (true);
 }
 
 
@@ -133,6 +133,30 @@ public:
     void initialize(const cGenericArrayPtr a_elements,
                     const double a_radius = 0.0);
 
+    //! This method refits the collision tree after a subset of elements has been modified.
+    void updateElements(const std::vector<unsigned int>& a_elementIndices);
+
+    //! This method restores a collision tree that was previously built for the same elements.
+    bool restore(const cGenericArrayPtr a_elements,
+                 const std::vector<cCollisionAABBNode>& a_nodes,
+                 const int a_rootIndex,
+                 const double a_radius = 0.0);
+
+    //! This method returns the list of nodes that compose the collision tree.
+    const std::vector<cCollisionAABBNode>& getNodes() const { return (m_nodes); }
+
+    //! This method returns the index number of the root node.
+    int getRootIndex() const { return (m_rootIndex); }
+
+    //! This method returns the collision shell radius around elements.
+    double getRadius() const { return (m_radius); }
+
+    //! This method sets the fraction of refitted elements above which \ref updateElements() rebuilds the tree.
+    void setRebuildThreshold(const double a_threshold) { m_rebuildThreshold = cMax(a_threshold, 0.0); }
+
+    //! This method returns the fraction of refitted elements above which \ref updateElements() rebuilds the tree.
+    double getRebuildThreshold() const { return (m_rebuildThreshold); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -167,6 +191,15 @@ protected:
 
     //! Maximum depth of tree.
     int m_maxDepth;
+
+    //! Index of the leaf node associated with each element.
+    std::vector<int> m_elementToLeaf;
+
+    //! Fraction of refitted elements above which the tree is rebuilt.
+    double m_rebuildThreshold;
+
+    //! Number of elements refitted since the tree was last built.
+    unsigned int m_numUpdatedElements;
 };
 
 //------------------------------------------------------------------------------
@@ -63,6 +63,8 @@ using namespace std;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+unsigned int cCamera::s_numFrustumCullingViews = 0;
+
 //==============================================================================
 /*!
     Constructor of cCamera.
@@ -117,6 +119,16 @@ cCamera::cCamera(cWorld* a_parentWorld)
     // reset display status
     m_markForUpdate = false;
 
+    // largest screen-space error of mesh levels of detail
+    m_lodPixelError = 1.0;
+
+    // frustum culling disabled by default
+    m_useFrustumCulling = false;
+    m_frustumCullingActive = false;
+    m_frustumCullingViewID = 0;
+    m_numObjectsTested = 0;
+    m_numObjectsCulled = 0;
+
     // create front and back layers
     m_frontLayer = new cWorld();
     m_backLayer = new cWorld();
@@ -477,6 +489,144 @@ void cCamera::setFieldViewAngleDeg(double a_fieldViewAngleDeg)
 }
 
 
+//==============================================================================
+/*!
+    This method computes the size in pixels of a distance __a_error__ located 
+    at position __a_globalPos__, based on the field of view (or orthographic 
+    width) and the size of the display during the last rendering pass. It is 
+    used by meshes to select the coarsest level of detail whose geometric error 
+    remains below \ref getLodPixelError() pixels.
+
+    \param  a_globalPos  Position in world coordinates.
+    \param  a_error      Distance in world units.
+
+    \return Size in pixels.
+*/
+//==============================================================================
+double cCamera::computeScreenSpaceError(const cVector3d& a_globalPos, const double a_error)
+{
+    // orthographic view: size is independent of distance
+    if (!m_perspectiveMode)
+    {
+        if (m_orthographicWidth <= 0.0) { return (0.0); }
+        return (a_error * (double)m_lastDisplayWidth / m_orthographicWidth);
+    }
+
+    // perspective view: size decreases with the distance along the view axis
+    double distance = -cDot(cSub(a_globalPos, m_globalPos), m_globalRot.getCol0());
+    if (distance <= m_distanceNear) { return (C_LARGE); }
+
+    double tanHalfAngle = tan(0.5 * cDegToRad(m_fieldViewAngleDeg));
+    if (tanHalfAngle <= 0.0) { return (C_LARGE); }
+
+    return (a_error * (double)m_lastDisplayHeight / (2.0 * distance * tanHalfAngle));
+}
+
+
+//==============================================================================
+/*!
+    This method tests a boundary box against the view frustum of the camera.
+    The box is expressed in a reference frame whose position and orientation
+    are given in world coordinates, usually the global position and rotation
+    of the object being rendered. The clipping planes of the frustum, which
+    are extracted once per view by \ref renderView(), are transformed to this
+    frame and the box is reported outside when it lies entirely beyond one
+    of them. No OpenGL state is queried. \n
+
+    Tests are only performed while the world is rendered by \ref renderView()
+    and frustum culling is enabled; otherwise this method returns __false__.
+
+    \param  a_boxMin  Minimum corner of the boundary box.
+    \param  a_boxMax  Maximum corner of the boundary box.
+    \param  a_pos     Position of the frame of the box in world coordinates.
+    \param  a_rot     Orientation of the frame of the box in world coordinates.
+
+    \return __true__ if the box is entirely outside of the view frustum, __false__ otherwise.
+*/
+//==============================================================================
+bool cCamera::isBoxOutsideFrustum(const cVector3d& a_boxMin,
+                                  const cVector3d& a_boxMax,
+                                  const cVector3d& a_pos,
+                                  const cMatrix3d& a_rot)
+{
+    if (!m_frustumCullingActive)
+    {
+        return (false);
+    }
+
+    m_numObjectsTested++;
+
+    for (int i=0; i<6; i++)
+    {
+        // express plane in the frame of the box
+        cVector3d normal(cDot(a_rot.getCol0(), m_frustumPlaneNormals[i]),
+                         cDot(a_rot.getCol1(), m_frustumPlaneNormals[i]),
+                         cDot(a_rot.getCol2(), m_frustumPlaneNormals[i]));
+        double offset = m_frustumPlaneOffsets[i] + cDot(m_frustumPlaneNormals[i], a_pos);
+
+        // corner of the box that lies furthest inside the plane
+        double x = (normal(0) > 0.0) ? a_boxMax(0) : a_boxMin(0);
+        double y = (normal(1) > 0.0) ? a_boxMax(1) : a_boxMin(1);
+        double z = (normal(2) > 0.0) ? a_boxMax(2) : a_boxMin(2);
+
+        if (normal(0) * x + normal(1) * y + normal(2) * z + offset < 0.0)
+        {
+            m_numObjectsCulled++;
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+
+//==============================================================================
+/*!
+    This method extracts the six clipping planes of the view frustum from
+    the projection and modelview matrices of the camera, and starts a new
+    view for frustum culling. Objects test themselves at most once per view
+    and reuse the result in all rendering passes of the view.
+*/
+//==============================================================================
+void cCamera::updateFrustumPlanes()
+{
+    // transformation from world to clip coordinates (column-major)
+    const double* projection = m_projectionMatrix.getData();
+    const double* modelView = m_modelViewMatrix.getData();
+
+    double m[16];
+    for (int c=0; c<4; c++)
+    {
+        for (int r=0; r<4; r++)
+        {
+            m[4*c+r] = projection[r]    * modelView[4*c]   +
+                       projection[4+r]  * modelView[4*c+1] +
+                       projection[8+r]  * modelView[4*c+2] +
+                       projection[12+r] * modelView[4*c+3];
+        }
+    }
+
+    // planes are the sum and difference of the last row with the other rows
+    for (int i=0; i<6; i++)
+    {
+        int row = i / 2;
+        double sign = (i % 2 == 0) ? 1.0 : -1.0;
+        m_frustumPlaneNormals[i].set(m[3]  + sign * m[row],
+                                     m[7]  + sign * m[4+row],
+                                     m[11] + sign * m[8+row]);
+        m_frustumPlaneOffsets[i] = m[15] + sign * m[12+row];
+    }
+
+    // start a new view (identifier 0 is never used)
+    s_numFrustumCullingViews++;
+    if (s_numFrustumCullingViews == 0)
+    {
+        s_numFrustumCullingViews++;
+    }
+    m_frustumCullingViewID = s_numFrustumCullingViews;
+}
+
+
 //==============================================================================
 /*!
     This method returns the aspect ratio of output image.
@@ -989,6 +1139,11 @@ void cCamera::renderView(const int a_windowWidth,
     // enable multi-sampling if available
     glEnable(GL_MULTISAMPLE);
 
+    // reset frustum culling statistics
+    m_numObjectsTested = 0;
+    m_numObjectsCulled = 0;
+
+
 
     //-----------------------------------------------------------------------
     // (1) SHADOW CASTING
@@ -1395,6 +1550,13 @@ void cCamera::renderView(const int a_windowWidth,
         // (4.5) RENDER THE 3D WORLD
         //-------------------------------------------------------------------
 
+        // enable frustum culling tests while the world is rendered
+        m_frustumCullingActive = m_useFrustumCulling;
+        if (m_frustumCullingActive)
+        {
+            updateFrustumPlanes();
+        }
+
         // Set up reasonable default OpenGL state
         glEnable(GL_LIGHTING);
         glDisable(GL_BLEND);
@@ -1678,6 +1840,9 @@ void cCamera::renderView(const int a_windowWidth,
         // (4.6) RENDER FRONT PLANE
         //-------------------------------------------------------------------
 
+        // disable frustum culling tests
+        m_frustumCullingActive = false;
+
         // clear depth buffer
         glClear(GL_DEPTH_BUFFER_BIT);
 
@@ -362,6 +362,50 @@ public:
     void updateGPU();
 
 
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - FRUSTUM CULLING:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables the culling of objects whose boundary box lies outside of the view frustum.
+    void setUseFrustumCulling(const bool a_useFrustumCulling) { m_useFrustumCulling = a_useFrustumCulling; }
+
+    //! This method returns __true__ if frustum culling is enabled, __false__ otherwise.
+    bool getUseFrustumCulling() const { return (m_useFrustumCulling); }
+
+    //! This method returns the number of objects tested against the view frustum during the last call to \ref renderView(), once per object and eye.
+    unsigned int getNumObjectsTested() const { return (m_numObjectsTested); }
+
+    //! This method returns the number of objects culled during the last call to \ref renderView().
+    unsigned int getNumObjectsCulled() const { return (m_numObjectsCulled); }
+
+    //! This method returns __true__ while the world is rendered by \ref renderView() with frustum culling enabled.
+    bool getFrustumCullingActive() const { return (m_frustumCullingActive); }
+
+    //! This method returns an identifier of the view currently rendered, unique among all cameras.
+    unsigned int getFrustumCullingViewID() const { return (m_frustumCullingViewID); }
+
+    //! This method returns __true__ if a boundary box expressed in a frame located in world coordinates lies outside of the view frustum.
+    bool isBoxOutsideFrustum(const cVector3d& a_boxMin, const cVector3d& a_boxMax, const cVector3d& a_pos, const cMatrix3d& a_rot);
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - LEVEL OF DETAIL:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method sets the largest screen-space error (in pixels) allowed when selecting the level of detail of meshes.
+    void setLodPixelError(const double a_lodPixelError) { m_lodPixelError = cMax(0.0, a_lodPixelError); }
+
+    //! This method returns the largest screen-space error (in pixels) allowed when selecting the level of detail of meshes.
+    double getLodPixelError() const { return (m_lodPixelError); }
+
+    //! This method computes the size in pixels of a distance located at a given position in world coordinates.
+    double computeScreenSpaceError(const cVector3d& a_globalPos, const double a_error);
+
+
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - STEREO:
     //-----------------------------------------------------------------------
@@ -489,6 +533,33 @@ protected:
     //! Scale factor used for vertical mirroring. (-1.0 or 1.0)
     double m_scaleV;
 
+    //! Largest screen-space error (in pixels) allowed when selecting the level of detail of meshes.
+    double m_lodPixelError;
+
+    //! If __true__, objects whose boundary box lies outside of the view frustum are not rendered.
+    bool m_useFrustumCulling;
+
+    //! If __true__, the world is being rendered and frustum culling tests are performed.
+    bool m_frustumCullingActive;
+
+    //! Identifier of the view currently rendered.
+    unsigned int m_frustumCullingViewID;
+
+    //! Number of views rendered with frustum culling by all cameras, used to generate unique view identifiers.
+    static unsigned int s_numFrustumCullingViews;
+
+    //! Normals of the six clipping planes of the view frustum, in world coordinates and pointing inwards.
+    cVector3d m_frustumPlaneNormals[6];
+
+    //! Offsets of the six clipping planes of the view frustum.
+    double m_frustumPlaneOffsets[6];
+
+    //! Number of objects tested against the view frustum during the last rendering.
+    unsigned int m_numObjectsTested;
+
+    //! Number of objects culled during the last rendering.
+    unsigned int m_numObjectsCulled;
+
     //! Camera polar position in radians (spherical coordinates).
     double m_posPolarRad;
 
@@ -519,6 +590,9 @@ protected:
 
     //! Renders a 2D layer within this camera's view.
     void renderLayer(cGenericObject* a_graph, int a_width, int a_height);
+
+    //! Extract the clipping planes of the view frustum from the current projection and modelview matrices.
+    void updateFrustumPlanes();
 };
 
 //------------------------------------------------------------------------------
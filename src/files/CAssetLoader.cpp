@@ -0,0 +1,453 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "files/CAssetLoader.h"
+//------------------------------------------------------------------------------
+#include "graphics/CRenderOptions.h"
+#include "timers/CPrecisionClock.h"
+//------------------------------------------------------------------------------
+#include <set>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cAssetLoader.
+
+    \param  a_numThreads  Number of worker threads reading files.
+*/
+//==============================================================================
+cAssetLoader::cAssetLoader(const unsigned int a_numThreads)
+{
+    m_threadPool = new cThreadPool(cMax(a_numThreads, 1u));
+    m_numPendingRequests = 0;
+    m_cancelled = false;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cAssetLoader. Files that are being read are completed,
+    requests that have not been started are cancelled, and all pending 
+    requests are completed with a null result.
+*/
+//==============================================================================
+cAssetLoader::~cAssetLoader()
+{
+    // cancel requests that have not been started and wait for worker threads
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_cancelled = true;
+    }
+    delete m_threadPool;
+
+    // complete all pending requests
+    while (!m_loadedRequests.empty())
+    {
+        m_uploadRequests.push_back(m_loadedRequests.front());
+        m_loadedRequests.pop_front();
+    }
+    while (!m_uploadRequests.empty())
+    {
+        m_uploadRequests.front()->m_complete(false);
+        m_uploadRequests.pop_front();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method loads a 3D model file in the background (see 
+    \ref cMultiMesh::loadFromFile()). Textures of the model are transferred to 
+    the GPU by \ref update(), as well as the vertex buffers of meshes that are 
+    rendered with a shader program. \n
+
+    Once completed, the future holds the new model, or __NULL__ if the file 
+    could not be loaded. The model is not added to any world; this is left to
+    the caller, for instance from the callback.
+
+    \param  a_filename                 Filename of 3D model.
+    \param  a_callback                 Function called by \ref update() once the request is completed.
+    \param  a_createCollisionDetector  If __true__, AABB collision detectors are built by the worker thread.
+    \param  a_collisionRadius          Radius of the collision detectors.
+
+    \return Future holding the loaded model.
+*/
+//==============================================================================
+shared_future<cMultiMesh*> cAssetLoader::loadMultiMesh(const string& a_filename,
+                                                       const function<void(cMultiMesh*)>& a_callback,
+                                                       const bool a_createCollisionDetector,
+                                                       const double a_collisionRadius)
+{
+    shared_ptr< promise<cMultiMesh*> > result = make_shared< promise<cMultiMesh*> >();
+    shared_future<cMultiMesh*> future = result->get_future().share();
+    cMultiMesh* object = new cMultiMesh();
+
+    cAssetRequestPtr request = make_shared<cAssetRequest>();
+    request->m_load = [=](cAssetRequest& a_request) -> bool
+    {
+        if (!object->loadFromFile(a_filename))
+        {
+            return (false);
+        }
+
+        if (a_createCollisionDetector)
+        {
+            object->createAABBCollisionDetector(a_collisionRadius);
+        }
+
+        addMultiMeshUploads(a_request, object);
+        return (true);
+    };
+    request->m_complete = [=](bool a_result)
+    {
+        cMultiMesh* value = object;
+        if (!a_result)
+        {
+            delete object;
+            value = NULL;
+        }
+
+        result->set_value(value);
+        if (a_callback)
+        {
+            a_callback(value);
+        }
+    };
+
+    submit(request);
+    return (future);
+}
+
+
+//==============================================================================
+/*!
+    This method loads an image file in the background (see 
+    \ref cImage::loadFromFile()). \n
+
+    Once completed, the future holds the new image, or __nullptr__ if the file
+    could not be loaded.
+
+    \param  a_filename  Filename of image.
+    \param  a_callback  Function called by \ref update() once the request is completed.
+
+    \return Future holding the loaded image.
+*/
+//==============================================================================
+shared_future<cImagePtr> cAssetLoader::loadImage(const string& a_filename,
+                                                 const function<void(cImagePtr)>& a_callback)
+{
+    shared_ptr< promise<cImagePtr> > result = make_shared< promise<cImagePtr> >();
+    shared_future<cImagePtr> future = result->get_future().share();
+    cImagePtr image = cImage::create();
+
+    cAssetRequestPtr request = make_shared<cAssetRequest>();
+    request->m_load = [=](cAssetRequest& a_request) -> bool
+    {
+        return (image->loadFromFile(a_filename));
+    };
+    request->m_complete = [=](bool a_result)
+    {
+        cImagePtr value = a_result ? image : nullptr;
+        result->set_value(value);
+        if (a_callback)
+        {
+            a_callback(value);
+        }
+    };
+
+    submit(request);
+    return (future);
+}
+
+
+//==============================================================================
+/*!
+    This method loads a 2D texture from an image file in the background (see 
+    \ref cTexture2d::loadFromFile()). The texture is transferred to the GPU by 
+    \ref update() before the request is completed. \n
+
+    Once completed, the future holds the new texture, or __nullptr__ if the 
+    file could not be loaded.
+
+    \param  a_filename  Filename of image.
+    \param  a_callback  Function called by \ref update() once the request is completed.
+
+    \return Future holding the loaded texture.
+*/
+//==============================================================================
+shared_future<cTexture2dPtr> cAssetLoader::loadTexture2d(const string& a_filename,
+                                                         const function<void(cTexture2dPtr)>& a_callback)
+{
+    shared_ptr< promise<cTexture2dPtr> > result = make_shared< promise<cTexture2dPtr> >();
+    shared_future<cTexture2dPtr> future = result->get_future().share();
+    cTexture2dPtr texture = cTexture2d::create();
+
+    cAssetRequestPtr request = make_shared<cAssetRequest>();
+    request->m_load = [=](cAssetRequest& a_request) -> bool
+    {
+        if (!texture->loadFromFile(a_filename))
+        {
+            return (false);
+        }
+
+        addTextureUpload(a_request, texture);
+        return (true);
+    };
+    request->m_complete = [=](bool a_result)
+    {
+        cTexture2dPtr value = a_result ? texture : nullptr;
+        result->set_value(value);
+        if (a_callback)
+        {
+            a_callback(value);
+        }
+    };
+
+    submit(request);
+    return (future);
+}
+
+
+//==============================================================================
+/*!
+    This method transfers the textures and buffers of loaded requests to the 
+    GPU, and completes the requests whose transfers are finished by making 
+    their future ready and invoking their callback. Transfers are performed 
+    in request order until __a_timeBudget__ is exhausted; at least one 
+    transfer is performed per call so that large requests always progress. \n
+
+    This method must be called from the graphics thread, with the OpenGL 
+    context current, typically once per frame before rendering.
+
+    \param  a_timeBudget  Time allocated to GPU transfers in seconds.
+
+    \return Number of requests completed during this call.
+*/
+//==============================================================================
+unsigned int cAssetLoader::update(const double a_timeBudget)
+{
+    cPrecisionClock clock;
+    clock.start(true);
+
+    // collect requests read by the worker threads
+    {
+        lock_guard<mutex> lock(m_mutex);
+        while (!m_loadedRequests.empty())
+        {
+            m_uploadRequests.push_back(m_loadedRequests.front());
+            m_loadedRequests.pop_front();
+        }
+    }
+
+    // perform transfers and complete requests
+    unsigned int numCompleted = 0;
+    bool transferred = false;
+    while (!m_uploadRequests.empty())
+    {
+        cAssetRequestPtr request = m_uploadRequests.front();
+        while (!request->m_uploads.empty())
+        {
+            if (transferred && (clock.getCurrentTimeSeconds() >= a_timeBudget))
+            {
+                return (numCompleted);
+            }
+
+            function<void()> upload = request->m_uploads.front();
+            request->m_uploads.pop_front();
+            upload();
+            transferred = true;
+        }
+
+        m_uploadRequests.pop_front();
+        request->m_complete(request->m_result);
+        numCompleted++;
+
+        lock_guard<mutex> lock(m_mutex);
+        m_numPendingRequests--;
+    }
+
+    return (numCompleted);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of requests that have been submitted and 
+    not yet completed by \ref update().
+
+    \return Number of pending requests.
+*/
+//==============================================================================
+unsigned int cAssetLoader::getNumPendingRequests()
+{
+    lock_guard<mutex> lock(m_mutex);
+    return (m_numPendingRequests);
+}
+
+
+//==============================================================================
+/*!
+    This method submits a request to the worker threads. Once the file has 
+    been read, the request is queued for \ref update().
+
+    \param  a_request  Request to be executed.
+*/
+//==============================================================================
+void cAssetLoader::submit(cAssetRequestPtr a_request)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_numPendingRequests++;
+    }
+
+    m_threadPool->addTask([this, a_request]()
+    {
+        bool cancelled;
+        {
+            lock_guard<mutex> lock(m_mutex);
+            cancelled = m_cancelled;
+        }
+
+        // read file
+        a_request->m_result = (!cancelled) && a_request->m_load(*a_request);
+        if (!a_request->m_result)
+        {
+            a_request->m_uploads.clear();
+        }
+
+        // queue request for update()
+        lock_guard<mutex> lock(m_mutex);
+        m_loadedRequests.push_back(a_request);
+    });
+}
+
+
+//==============================================================================
+/*!
+    This method adds the transfer of a texture to the GPU to a request.
+
+    \param  a_request  Request.
+    \param  a_texture  Texture to be transferred.
+*/
+//==============================================================================
+void cAssetLoader::addTextureUpload(cAssetRequest& a_request, cTexture1dPtr a_texture)
+{
+    a_request.m_uploads.push_back([a_texture]()
+    {
+#ifdef C_USE_OPENGL
+        // the texture is transferred when it is first enabled
+        cRenderOptions options;
+        options.m_camera                                = NULL;
+        options.m_single_pass_only                      = true;
+        options.m_render_opaque_objects_only            = false;
+        options.m_render_transparent_front_faces_only   = false;
+        options.m_render_transparent_back_faces_only    = false;
+        options.m_enable_lighting                       = true;
+        options.m_render_materials                      = true;
+        options.m_render_textures                       = true;
+        options.m_creating_shadow_map                   = false;
+        options.m_rendering_shadow                      = false;
+        options.m_shadow_light_level                    = 1.0;
+        options.m_storeObjectPositions                  = false;
+        options.m_markForUpdate                         = false;
+
+        a_texture->renderInitialize(options);
+        a_texture->renderFinalize(options);
+#endif
+    });
+}
+
+
+//==============================================================================
+/*!
+    This method adds the transfers of the textures of a model to the GPU to a 
+    request, followed by the vertex and element buffers of its meshes that 
+    are rendered with a shader program. Other meshes are rendered directly 
+    from memory and do not require any transfer.
+
+    \param  a_request  Request.
+    \param  a_object   Model to be transferred.
+*/
+//==============================================================================
+void cAssetLoader::addMultiMeshUploads(cAssetRequest& a_request, cMultiMesh* a_object)
+{
+    // textures are often shared between meshes
+    set<cGenericTexture*> textures;
+
+    int numMeshes = a_object->getNumMeshes();
+    for (int i=0; i<numMeshes; i++)
+    {
+        cMesh* mesh = a_object->getMesh(i);
+
+        if ((mesh->m_texture != nullptr) && textures.insert(mesh->m_texture.get()).second)
+        {
+            addTextureUpload(a_request, mesh->m_texture);
+        }
+
+        if ((mesh->m_normalMap != nullptr) && textures.insert(mesh->m_normalMap.get()).second)
+        {
+            addTextureUpload(a_request, mesh->m_normalMap);
+        }
+
+        if (mesh->getShaderProgram() != nullptr)
+        {
+            cTriangleArrayPtr triangles = mesh->m_triangles;
+            a_request.m_uploads.push_back([triangles]()
+            {
+                triangles->updateBuffers();
+            });
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
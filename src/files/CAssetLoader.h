@@ -0,0 +1,218 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CAssetLoaderH
+#define CAssetLoaderH
+//------------------------------------------------------------------------------
+#include "graphics/CImage.h"
+#include "materials/CTexture2d.h"
+#include "system/CThreadPool.h"
+#include "world/CMultiMesh.h"
+//------------------------------------------------------------------------------
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CAssetLoader.h
+    \ingroup    files
+
+    \brief
+    Implements asynchronous loading of models, images and textures.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cAssetLoader
+    \ingroup    files
+
+    \brief
+    This class loads models, images and textures in the background.
+
+    \details
+    cAssetLoader reads files on its own worker threads so that the graphics 
+    and haptics loops keep running while new content is being loaded. Each 
+    request returns a future and accepts an optional callback. \n
+
+    Once a file has been read, the transfer of its textures and vertex buffers
+    to the GPU is performed by method \ref update(), which must be called 
+    regularly from the graphics thread (with the OpenGL context current), 
+    typically once per frame before rendering the scene. Each call performs 
+    GPU transfers until the time budget passed as argument is exhausted, and 
+    completes the requests whose transfers are finished: their future becomes 
+    ready and their callback is invoked from within \ref update(). Callbacks 
+    are therefore the natural place to insert new objects into a live world. \n
+
+    A future should not be waited on from the graphics thread, since the 
+    request it belongs to can only be completed by \ref update(). Requests
+    that are still pending when the loader is deleted are completed with a 
+    null result.
+*/
+//==============================================================================
+class cAssetLoader
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cAssetLoader.
+    cAssetLoader(const unsigned int a_numThreads = 1);
+
+    //! Destructor of cAssetLoader.
+    virtual ~cAssetLoader();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method loads a 3D model file in the background.
+    std::shared_future<cMultiMesh*> loadMultiMesh(const std::string& a_filename,
+                                                  const std::function<void(cMultiMesh*)>& a_callback = nullptr,
+                                                  const bool a_createCollisionDetector = false,
+                                                  const double a_collisionRadius = 0.0);
+
+    //! This method loads an image file in the background.
+    std::shared_future<cImagePtr> loadImage(const std::string& a_filename,
+                                            const std::function<void(cImagePtr)>& a_callback = nullptr);
+
+    //! This method loads a 2D texture from an image file in the background.
+    std::shared_future<cTexture2dPtr> loadTexture2d(const std::string& a_filename,
+                                                    const std::function<void(cTexture2dPtr)>& a_callback = nullptr);
+
+    //! This method performs GPU transfers and completes loaded requests. It must be called from the graphics thread.
+    unsigned int update(const double a_timeBudget = 0.002);
+
+    //! This method returns the number of requests that have not been completed yet.
+    unsigned int getNumPendingRequests();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Asynchronous request.
+    struct cAssetRequest
+    {
+        //! Reads the file. Executed by a worker thread.
+        std::function<bool(cAssetRequest&)> m_load;
+
+        //! Completes the request. Executed by the graphics thread.
+        std::function<void(bool)> m_complete;
+
+        //! GPU transfers. Executed by the graphics thread.
+        std::deque< std::function<void()> > m_uploads;
+
+        //! Result of the file read.
+        bool m_result;
+    };
+
+    //! Shared pointer to an asynchronous request.
+    typedef std::shared_ptr<cAssetRequest> cAssetRequestPtr;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method submits a request to the worker threads.
+    void submit(cAssetRequestPtr a_request);
+
+    //! This method adds the GPU transfers of a texture to a request.
+    static void addTextureUpload(cAssetRequest& a_request, cTexture1dPtr a_texture);
+
+    //! This method adds the GPU transfers of the meshes of a model to a request.
+    static void addMultiMeshUploads(cAssetRequest& a_request, cMultiMesh* a_object);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Worker threads reading files.
+    cThreadPool* m_threadPool;
+
+    //! Mutex protecting the list of loaded requests and the request counter.
+    std::mutex m_mutex;
+
+    //! Requests read by a worker thread and waiting for \ref update().
+    std::deque<cAssetRequestPtr> m_loadedRequests;
+
+    //! Requests whose GPU transfers are in progress. Accessed by the graphics thread only.
+    std::deque<cAssetRequestPtr> m_uploadRequests;
+
+    //! Number of requests submitted and not yet completed.
+    unsigned int m_numPendingRequests;
+
+    //! If __true__, requests that have not been started are cancelled.
+    bool m_cancelled;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -43,6 +43,8 @@
 
 //------------------------------------------------------------------------------
 #include "files/CFileImageBMP.h"
+#include "math/CMaths.h"
+#include "system/CFileMap.h"
 //------------------------------------------------------------------------------
 #include <cstring>
 #include <fstream>
@@ -137,29 +139,57 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
     BITMAPINFOHEADER  bmih;
     BITMAPFILEHEADER  bmfh;
     int               i, j;
-    unsigned char     r, g, b, a;
-    unsigned char    *buffer;
+    unsigned char     r;
 
     // sanity check
     if (a_image == NULL)
         return false;
 
-    // open file
-    std::ifstream imgfile(a_filename.c_str(), ios::binary);
-    if (!imgfile)
+    // map file into memory
+    cFileMap file;
+    if (!file.open(a_filename))
         return false;
 
+    const unsigned char* fileData = (const unsigned char*)file.getData();
+    size_t fileSize = file.getSize();
+
     // read header
-    imgfile.read((char *) &bmfh.bfType,      sizeof(WORD));
-    imgfile.read((char *) &bmfh.bfSize,      sizeof(DWORD));
-    imgfile.read((char *) &bmfh.bfReserved1, sizeof(WORD));
-    imgfile.read((char *) &bmfh.bfReserved2, sizeof(WORD));
-    imgfile.read((char *) &bmfh.bfOffBits,   sizeof(DWORD));
-    imgfile.read((char *) &bmih,             sizeof(BITMAPINFOHEADER));
+    if (fileSize < sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER))
+        return false;
+    memcpy(&bmfh, fileData, sizeof(BITMAPFILEHEADER));
+    memcpy(&bmih, fileData + sizeof(BITMAPFILEHEADER), sizeof(BITMAPINFOHEADER));
 
     // update width of the height of image
     int width  = bmih.biWidth;
     int height = bmih.biHeight;
+    if ((width <= 0) || (height <= 0))
+        return false;
+
+    // lines are aligned on 32 bits
+    size_t bytesLine = (((size_t)bmih.biBitCount * width + 31) / 32) * 4;
+
+    // verify that the pixel data is contained in the file. 8-bit images saved
+    // by earlier versions of cSaveFileBMP() have lines without padding.
+    if ((size_t)bmfh.bfOffBits + bytesLine * height > fileSize)
+    {
+        if ((bmih.biBitCount == 8) && ((size_t)bmfh.bfOffBits + (size_t)width * height <= fileSize))
+            bytesLine = width;
+        else
+            return false;
+    }
+
+    // the palette (if any) follows the info header. it is copied to a table
+    // of 256 entries so that any 8-bit index can be looked up safely.
+    unsigned char palette[1024];
+    memset(palette, 0, sizeof(palette));
+    if (bmih.biBitCount == 8)
+    {
+        size_t paletteOffset = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER);
+        size_t paletteSize = (bmih.biClrUsed == BI_RGB) ? 1024 : cMin((size_t)1024, 4 * (size_t)bmih.biClrUsed);
+        if (paletteOffset + paletteSize > fileSize)
+            return false;
+        memcpy(palette, fileData + paletteOffset, paletteSize);
+    }
 
     // pixels are stored consecutively as RGB|RGB|RGB|RGB...
     if (bmih.biClrUsed == BI_RGB)
@@ -176,26 +206,10 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
                 // retrieve pointer to image data
                 unsigned char* data = a_image->getData();
 
-                // allocate color palette
-                LPBYTE palette = new BYTE[1024];
-
-                // read-in palette
-                imgfile.read((char *) palette, 1024);
-
-                // allocate line buffer
-                if (NULL == (buffer = (unsigned char *)malloc(width)))
-                {
-                    imgfile.close();
-                    delete [] palette;
-                    return false;
-                }
-
-                // read data
-                imgfile.seekg(bmfh.bfOffBits, ios::beg);
+                // decode data
                 for (j=0; j<height; j++)
                 {
-                    unsigned char *p = buffer;
-                    imgfile.read((char *) buffer, width);
+                    const unsigned char *p = fileData + bmfh.bfOffBits + j * bytesLine;
                     for (i=0; i<width; i++)
                     {
                         r = *p++;
@@ -204,10 +218,6 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
                         *data++ = (unsigned char) palette[4 * r];
                     }
                 }
-
-                // cleanup
-                free(buffer);
-                delete [] palette;
             }
             break;
 
@@ -221,36 +231,19 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
                 // retrieve pointer to image data
                 unsigned char* data = a_image->getData();
 
-                // a bit tricky: align within 32 bits
-                int          align     = (4 - (width%4)) & 3;
-                unsigned int bytesLine = (width + align) * 3;
-
-                // allocate line buffer
-                if (NULL == (buffer = (unsigned char *)malloc(bytesLine)))
-                {
-                    imgfile.close();
-                    return false;
-                }
-
-                // read data
-                imgfile.seekg(bmfh.bfOffBits, ios::beg);
+                // decode data
                 for (j=0; j<height; j++)
                 {
-                    unsigned char *p = buffer;
-                    imgfile.read((char *) buffer, bytesLine);
-                    for (i=0; i <width; i++)
+                    const unsigned char *p = fileData + bmfh.bfOffBits + j * bytesLine;
+                    for (i=0; i<width; i++)
                     {
-                        b = *p++;
-                        g = *p++;
-                        r = *p++;
-                        *data++ = (unsigned char) r;
-                        *data++ = (unsigned char) g;
-                        *data++ = (unsigned char) b;
+                        data[0] = p[2];
+                        data[1] = p[1];
+                        data[2] = p[0];
+                        data += 3;
+                        p += 3;
                     }
                 }
-
-                // cleanup
-                free(buffer);
             }
             break;
 
@@ -264,44 +257,26 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
                 // retrieve pointer to image data
                 unsigned char* data = a_image->getData();
 
-                // line stride
-                unsigned int bytesLine = width * 4;
-
-                // allocate line buffer
-                if (NULL == (buffer = (unsigned char *)malloc(bytesLine)))
-                {
-                    imgfile.close();
-                    return false;
-                }
-
-                // read data
-                imgfile.seekg(bmfh.bfOffBits, ios::beg);
+                // decode data
                 for (j=0; j<height; j++)
                 {
-                    unsigned char *p = buffer;
-                    imgfile.read((char *) buffer, bytesLine);
+                    const unsigned char *p = fileData + bmfh.bfOffBits + j * bytesLine;
                     for (i=0; i<width; i++)
                     {
-                        b = *p++;
-                        g = *p++;
-                        r = *p++;
-                        a = *p++;
-                        *data++ = (unsigned char) r;
-                        *data++ = (unsigned char) g;
-                        *data++ = (unsigned char) b;
-                        *data++ = (unsigned char) a;
+                        data[0] = p[2];
+                        data[1] = p[1];
+                        data[2] = p[0];
+                        data[3] = p[3];
+                        data += 4;
+                        p += 4;
                     }
                 }
-
-                // cleanup
-                free(buffer);
             }
             break;
 
             // monochrome and 4bits (8 colors) unsupported yet
             default:
             {
-                imgfile.close();
                 return false;
             }
         }
@@ -310,6 +285,10 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
     // indexed color
     else
     {
+        // only 8-bit indices are supported
+        if (bmih.biBitCount != 8)
+            return false;
+
         // allocate memory for GL_RGB image
         if (!a_image->allocate(width, height, GL_RGB))
             return false;
@@ -317,26 +296,10 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
         // retrieve pointer to image data
         unsigned char* data = a_image->getData();
 
-        // allocate palette
-        LPBYTE palette = new BYTE[4 * bmih.biClrUsed];
-
-        // read-in palette
-        imgfile.read((char *) palette, 4 * bmih.biClrUsed);
-
-        // allocate line buffer
-        if (NULL == (buffer = (unsigned char *)malloc(width)))
-        {
-            imgfile.close();
-            delete [] palette;
-            return false;
-        }
-
-        // read data
-        imgfile.seekg(bmfh.bfOffBits, ios::beg);
+        // decode data
         for (j=0; j<height; j++)
         {
-            unsigned char *p = buffer;
-            imgfile.read((char *) buffer, width);
+            const unsigned char *p = fileData + bmfh.bfOffBits + j * bytesLine;
             for (i=0; i<width; i++)
             {
                 r = *p++;
@@ -345,14 +308,8 @@ bool cLoadFileBMP(cImage* a_image, const std::string& a_filename)
                 *data++ = (unsigned char) palette[4 * r];
             }
         }
-
-        // cleanup
-        free(buffer);
-        delete [] palette;
     }
 
-    imgfile.close();
-
     // return success
     return (C_SUCCESS);
 }
@@ -453,8 +410,10 @@ bool cSaveFileBMP(cImage* a_image, const std::string& a_filename)
         // gray scale (palette)
         case 8:
         {
-            // allocate line buffer
-            if (NULL == (buffer = (unsigned char *)malloc(width)))
+            // allocate line buffer (lines are aligned on 32 bits)
+            int          align     = (4 - (width % 4)) & 3;
+            unsigned int bytesLine = width + align;
+            if (NULL == (buffer = (unsigned char *)calloc(bytesLine, 1)))
                 return false;
 
             // allocate color palette
@@ -482,7 +441,7 @@ bool cSaveFileBMP(cImage* a_image, const std::string& a_filename)
                 {
                     *p++ = palette[4*(*data++)];
                 }
-                imgfile.write((char*)buffer, sizeof(unsigned char) * width);
+                imgfile.write((char*)buffer, sizeof(unsigned char) * bytesLine);
             }
 
             // cleanup
@@ -0,0 +1,336 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "files/CFileImageDDS.h"
+#include "math/CMaths.h"
+#include "system/CFileMap.h"
+//------------------------------------------------------------------------------
+#include <cstring>
+#include <fstream>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// DDS header layout (all values little endian, offsets from the header start)
+static const unsigned int C_DDS_HEADER_SIZE             = 124;
+static const unsigned int C_DDS_HEADER_DX10_SIZE        = 20;
+static const unsigned int C_DDS_OFFSET_FLAGS            = 4;
+static const unsigned int C_DDS_OFFSET_HEIGHT           = 8;
+static const unsigned int C_DDS_OFFSET_WIDTH            = 12;
+static const unsigned int C_DDS_OFFSET_LINEAR_SIZE      = 16;
+static const unsigned int C_DDS_OFFSET_MIPMAP_COUNT     = 24;
+static const unsigned int C_DDS_OFFSET_PF_SIZE          = 72;
+static const unsigned int C_DDS_OFFSET_PF_FLAGS         = 76;
+static const unsigned int C_DDS_OFFSET_PF_FOURCC        = 80;
+static const unsigned int C_DDS_OFFSET_CAPS             = 104;
+static const unsigned int C_DDS_OFFSET_CAPS2            = 108;
+
+static const unsigned int C_DDSD_CAPS                   = 0x00000001;
+static const unsigned int C_DDSD_HEIGHT                 = 0x00000002;
+static const unsigned int C_DDSD_WIDTH                  = 0x00000004;
+static const unsigned int C_DDSD_PIXELFORMAT            = 0x00001000;
+static const unsigned int C_DDSD_MIPMAPCOUNT            = 0x00020000;
+static const unsigned int C_DDSD_LINEARSIZE             = 0x00080000;
+static const unsigned int C_DDPF_ALPHAPIXELS            = 0x00000001;
+static const unsigned int C_DDPF_FOURCC                 = 0x00000004;
+static const unsigned int C_DDSCAPS_COMPLEX             = 0x00000008;
+static const unsigned int C_DDSCAPS_TEXTURE             = 0x00001000;
+static const unsigned int C_DDSCAPS_MIPMAP              = 0x00400000;
+static const unsigned int C_DDSCAPS2_CUBEMAP            = 0x00000200;
+static const unsigned int C_DDSCAPS2_VOLUME             = 0x00200000;
+
+static const unsigned int C_DXGI_FORMAT_BC1_UNORM       = 71;
+static const unsigned int C_DXGI_FORMAT_BC2_UNORM       = 74;
+static const unsigned int C_DXGI_FORMAT_BC3_UNORM       = 77;
+
+static inline unsigned int _fourCC(const char* a_code)
+{
+    return ((unsigned int)(unsigned char)a_code[0]         |
+            ((unsigned int)(unsigned char)a_code[1] << 8)  |
+            ((unsigned int)(unsigned char)a_code[2] << 16) |
+            ((unsigned int)(unsigned char)a_code[3] << 24));
+}
+
+static inline unsigned int _readUInt32(const unsigned char* a_data)
+{
+    return ((unsigned int)a_data[0] | ((unsigned int)a_data[1] << 8) |
+            ((unsigned int)a_data[2] << 16) | ((unsigned int)a_data[3] << 24));
+}
+
+static inline void _writeUInt32(unsigned char* a_data, const unsigned int a_value)
+{
+    a_data[0] = (unsigned char)(a_value & 0xff);
+    a_data[1] = (unsigned char)((a_value >> 8) & 0xff);
+    a_data[2] = (unsigned char)((a_value >> 16) & 0xff);
+    a_data[3] = (unsigned char)((a_value >> 24) & 0xff);
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function loads a DDS image from a file into a cCompressedImage
+    structure. DXT1, DXT3 and DXT5 files, with or without a DX10 extended
+    header, are supported, including their mipmap levels. Cube maps and
+    volume textures are rejected. Since DDS files store rows top-down, the
+    image is flipped after loading.
+
+    \param  a_image  Compressed image structure.
+    \param  a_filename  Filename.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cLoadFileDDS(cCompressedImage* a_image, const std::string& a_filename)
+{
+    // map file in memory
+    cFileMap file;
+    if (!file.open(a_filename))
+    {
+        return (false);
+    }
+
+    const unsigned char* data = (const unsigned char*)file.getData();
+    size_t size = file.getSize();
+
+    // check magic number and header
+    if ((size < 4 + C_DDS_HEADER_SIZE) || (memcmp(data, "DDS ", 4) != 0))
+    {
+        return (false);
+    }
+
+    const unsigned char* header = data + 4;
+    if ((_readUInt32(header) != C_DDS_HEADER_SIZE) ||
+        (_readUInt32(header + C_DDS_OFFSET_PF_SIZE) != 32))
+    {
+        return (false);
+    }
+
+    unsigned int flags = _readUInt32(header + C_DDS_OFFSET_FLAGS);
+    unsigned int height = _readUInt32(header + C_DDS_OFFSET_HEIGHT);
+    unsigned int width = _readUInt32(header + C_DDS_OFFSET_WIDTH);
+    unsigned int pfFlags = _readUInt32(header + C_DDS_OFFSET_PF_FLAGS);
+    unsigned int fourCC = _readUInt32(header + C_DDS_OFFSET_PF_FOURCC);
+    unsigned int caps2 = _readUInt32(header + C_DDS_OFFSET_CAPS2);
+    size_t offset = 4 + C_DDS_HEADER_SIZE;
+
+    // only plain 2D textures are supported
+    if (((pfFlags & C_DDPF_FOURCC) == 0) ||
+        ((caps2 & (C_DDSCAPS2_CUBEMAP | C_DDSCAPS2_VOLUME)) != 0))
+    {
+        return (false);
+    }
+
+    // determine compressed format
+    GLenum format;
+    if (fourCC == _fourCC("DXT1"))
+    {
+        format = (pfFlags & C_DDPF_ALPHAPIXELS) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+    else if (fourCC == _fourCC("DXT3"))
+    {
+        format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    }
+    else if (fourCC == _fourCC("DXT5"))
+    {
+        format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+    else if (fourCC == _fourCC("DX10"))
+    {
+        if (size < offset + C_DDS_HEADER_DX10_SIZE)
+        {
+            return (false);
+        }
+
+        // DXGI format, resource dimension (3 = 2D texture) and array size
+        unsigned int dxgiFormat = _readUInt32(data + offset);
+        unsigned int dimension = _readUInt32(data + offset + 4);
+        unsigned int arraySize = _readUInt32(data + offset + 12);
+        offset += C_DDS_HEADER_DX10_SIZE;
+
+        if ((dimension != 3) || (arraySize > 1))
+        {
+            return (false);
+        }
+
+        if (dxgiFormat == C_DXGI_FORMAT_BC1_UNORM)
+        {
+            format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        }
+        else if (dxgiFormat == C_DXGI_FORMAT_BC2_UNORM)
+        {
+            format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+        }
+        else if (dxgiFormat == C_DXGI_FORMAT_BC3_UNORM)
+        {
+            format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+        else
+        {
+            return (false);
+        }
+    }
+    else
+    {
+        return (false);
+    }
+
+    // number of mipmap levels
+    unsigned int numLevels = 1;
+    if (flags & C_DDSD_MIPMAPCOUNT)
+    {
+        numLevels = cClamp(_readUInt32(header + C_DDS_OFFSET_MIPMAP_COUNT), 1u,
+                           cCompressedImage::queryNumLevels(width, height));
+    }
+
+    // check that the file contains all levels before allocating memory
+    size_t dataSize = cCompressedImage::querySize(format, width, height, numLevels);
+    if ((dataSize == 0) || (dataSize > size - offset))
+    {
+        return (false);
+    }
+
+    // allocate image
+    if (!a_image->allocate(width, height, format, numLevels))
+    {
+        return (false);
+    }
+
+    // copy level data
+    memcpy(a_image->getLevelData(0), data + offset, a_image->getSizeInBytes());
+
+    // DDS rows are stored top-down
+    a_image->flipHorizontal();
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This function saves a cCompressedImage structure to a DDS file, including
+    all of its mipmap levels.
+
+    \param  a_image  Compressed image structure.
+    \param  a_filename  Filename.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cSaveFileDDS(cCompressedImage* a_image, const std::string& a_filename)
+{
+    // sanity check
+    if ((a_image == nullptr) || (!a_image->isInitialized()))
+    {
+        return (false);
+    }
+
+    // determine four character code
+    const char* fourCC;
+    switch (a_image->getFormat())
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:  fourCC = "DXT1"; break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:  fourCC = "DXT3"; break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:  fourCC = "DXT5"; break;
+        default: return (false);
+    }
+
+    // build header
+    unsigned int numLevels = a_image->getNumLevels();
+    unsigned char header[4 + C_DDS_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, "DDS ", 4);
+
+    unsigned char* h = header + 4;
+    unsigned int flags = C_DDSD_CAPS | C_DDSD_HEIGHT | C_DDSD_WIDTH | C_DDSD_PIXELFORMAT | C_DDSD_LINEARSIZE;
+    unsigned int caps = C_DDSCAPS_TEXTURE;
+    if (numLevels > 1)
+    {
+        flags |= C_DDSD_MIPMAPCOUNT;
+        caps |= C_DDSCAPS_COMPLEX | C_DDSCAPS_MIPMAP;
+    }
+
+    _writeUInt32(h, C_DDS_HEADER_SIZE);
+    _writeUInt32(h + C_DDS_OFFSET_FLAGS, flags);
+    _writeUInt32(h + C_DDS_OFFSET_HEIGHT, a_image->getHeight());
+    _writeUInt32(h + C_DDS_OFFSET_WIDTH, a_image->getWidth());
+    _writeUInt32(h + C_DDS_OFFSET_LINEAR_SIZE, a_image->getLevelSize(0));
+    _writeUInt32(h + C_DDS_OFFSET_MIPMAP_COUNT, numLevels);
+    _writeUInt32(h + C_DDS_OFFSET_PF_SIZE, 32);
+    _writeUInt32(h + C_DDS_OFFSET_PF_FLAGS, C_DDPF_FOURCC | ((a_image->getFormat() == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) ? C_DDPF_ALPHAPIXELS : 0));
+    _writeUInt32(h + C_DDS_OFFSET_PF_FOURCC, _fourCC(fourCC));
+    _writeUInt32(h + C_DDS_OFFSET_CAPS, caps);
+
+    // DDS rows are stored top-down
+    cCompressedImagePtr image = a_image->copy();
+    image->flipHorizontal();
+
+    // write file
+    ofstream file(a_filename.c_str(), ios::binary);
+    if (!file)
+    {
+        return (false);
+    }
+
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)image->getLevelData(0), image->getSizeInBytes());
+
+    return (file.good());
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -43,12 +43,12 @@
 
 //------------------------------------------------------------------------------
 #include "files/CFileImageJPG.h"
+#include "system/CFileMap.h"
 //------------------------------------------------------------------------------
 #ifdef C_USE_FILE_JPG
 //------------------------------------------------------------------------------
 #include <sstream>
 #include <fstream>
-#include <streambuf>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -68,15 +68,6 @@ namespace chai3d {
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
 
-// wrap any buffer into a stream
-struct swrapper : public std::streambuf
-{
-    swrapper(char* s, std::size_t n)
-    {
-        setg(s, s, s + n);
-    }
-};
-
 // Most of the following helper functions have been adapted from
 // http://ai.stanford.edu/~acoates/jpegAndIOS.txt
 
@@ -90,13 +81,6 @@ struct my_error_mgr
 
 typedef struct my_error_mgr *my_error_ptr;
 
-struct my_source_mgr
-{
-    struct jpeg_source_mgr pub;
-    std::istream* is;
-    JOCTET*       buffer;
-};
-
 METHODDEF (void) my_error_warn (j_common_ptr cinfo) 
 {
     char buffer[JMSG_LENGTH_MAX];
@@ -106,89 +90,29 @@ METHODDEF (void) my_error_warn (j_common_ptr cinfo)
     longjmp (myerr->setjmp_buffer, 1);
 }
 
-static void my_init_source(j_decompress_ptr cinfo) {}
-
-static boolean my_fill_input_buffer(j_decompress_ptr cinfo)
-{
-    my_source_mgr* src = (my_source_mgr*)cinfo->src;
-    src->is->read((char*)src->buffer, JPEG_BUF_SIZE);
-    size_t bytes = (size_t)(src->is->gcount());
-    if (bytes == 0)
-    {
-        src->buffer[0] = (JOCTET) 0xFF;
-        src->buffer[1] = (JOCTET) JPEG_EOI;
-        bytes = 2;
-    }
-    src->pub.next_input_byte = src->buffer;
-    src->pub.bytes_in_buffer = bytes;
-    return TRUE;
-}
-
-static void my_skip_input_data(j_decompress_ptr cinfo, long num_bytes)
-{
-    my_source_mgr* src = (my_source_mgr*)cinfo->src;
-    if (num_bytes > 0)
-    {
-        while (num_bytes > (long)src->pub.bytes_in_buffer)
-        {
-            num_bytes -= (long)src->pub.bytes_in_buffer;
-            my_fill_input_buffer(cinfo);
-        }
-        src->pub.next_input_byte += num_bytes;
-        src->pub.bytes_in_buffer -= num_bytes;
-    }
-}
-
-static void my_term_source(j_decompress_ptr cinfo)
-{
-    my_source_mgr* src = (my_source_mgr*)cinfo->src;
-    src->is->clear();
-    src->is->seekg( src->is->tellg() - (std::streampos)src->pub.bytes_in_buffer );
-}
-
-static void my_set_source_mgr(j_decompress_ptr cinfo, std::istream& is)
-{
-    my_source_mgr* src = NULL;
-    if (cinfo->src == 0)
-    {
-        cinfo->src = (struct jpeg_source_mgr *)(*cinfo->mem->alloc_small)((j_common_ptr) cinfo, JPOOL_PERMANENT, sizeof(my_source_mgr));
-        src = (my_source_mgr*) cinfo->src;
-        src->buffer = (JOCTET *)(*cinfo->mem->alloc_small)((j_common_ptr) cinfo, JPOOL_PERMANENT, JPEG_BUF_SIZE*sizeof(JOCTET));
-    }
-    src->is = &is;
-    src->pub.init_source = my_init_source;
-    src->pub.fill_input_buffer = my_fill_input_buffer;
-    src->pub.skip_input_data = my_skip_input_data;
-    src->pub.resync_to_restart = jpeg_resync_to_restart;
-    src->pub.term_source = my_term_source;
-    src->pub.bytes_in_buffer = 0;
-    src->pub.next_input_byte = 0;
-}
-
 
 //==============================================================================
 /*!
     JPG decompressor, used by
     \ref bool cLoadJPG(cImage* a_image, void *a_buffer, int a_len) and
     \ref bool cLoadFileJPG(cImage* a_image, string a_filename).
+    Scan lines are decoded directly into the image buffer.
 
-    \param a_image  The source image to receive the decompressed JPG data.
-    \param a_is     The input stream that contains the raw JPG data.
+    \param a_image   The source image to receive the decompressed JPG data.
+    \param a_buffer  The memory buffer that contains the raw JPG data.
+    \param a_len     Size of the memory buffer in bytes.
 
     \return __true__ in case of success, __false__ otherwise.
 */
 //==============================================================================
-static bool _loadJPG(cImage* a_image, std::istream &a_is)
+static bool _loadJPG(cImage* a_image, const unsigned char* a_buffer, size_t a_len)
 {
     struct jpeg_decompress_struct cinfo;
     struct my_error_mgr           jerr;
 
-    JSAMPARRAY  buffer;
-    int         row_stride;
-
     // sanity check
-    if (a_image == NULL)
-        return false;
+    if ((a_image == NULL) || (a_buffer == NULL) || (a_len == 0))
+        return (C_ERROR);
 
     // setup error routines
     cinfo.err = jpeg_std_error(&jerr.pub);
@@ -202,8 +126,8 @@ static bool _loadJPG(cImage* a_image, std::istream &a_is)
     // allocate jpeg decompressor
     jpeg_create_decompress(&cinfo);
 
-    // specify data source (the stream)
-    my_set_source_mgr(&cinfo, a_is);
+    // specify data source (the memory buffer is only read from)
+    jpeg_mem_src(&cinfo, (unsigned char*)a_buffer, (unsigned long)a_len);
 
     // read file parameters with jpeg_read_header()
     jpeg_read_header(&cinfo, TRUE);
@@ -213,37 +137,24 @@ static bool _loadJPG(cImage* a_image, std::istream &a_is)
     int width  = (int)(cinfo.output_width);
     int height = (int)(cinfo.output_height);
 
-    // we allocate memory for image
-    if ((cinfo.out_color_components == 1 && !a_image->allocate(width, height, GL_LUMINANCE)) ||
-        (cinfo.out_color_components == 3 && !a_image->allocate(width, height, GL_RGB)))
+    // we allocate memory for image (or reuse the current image buffer)
+    if (!((cinfo.out_color_components == 1 && a_image->allocate(width, height, GL_LUMINANCE)) ||
+          (cinfo.out_color_components == 3 && a_image->allocate(width, height, GL_RGB))))
     {
+        jpeg_destroy_decompress(&cinfo);
         return (C_ERROR);
     }
 
     // retrieve pointer to image data
     unsigned char* data = a_image->getData();
+    size_t row_stride = cinfo.output_width * cinfo.output_components;
 
-    // allocate temporary buffer
-    row_stride = cinfo.output_width * cinfo.output_components;
-    buffer =(*cinfo.mem->alloc_sarray)((j_common_ptr) & cinfo, JPOOL_IMAGE, row_stride, 1);
-
-    // while (scan lines remain to be read)
-    int line = 0;
+    // decode scan lines directly into the image. rows are stored bottom-up
+    // in the image, therefore the first scan line maps to the last line.
     while (cinfo.output_scanline < cinfo.output_height)
     {
-        jpeg_read_scanlines(&cinfo, buffer, 1);
-        int index = 3*width*(height-1-line++);
-        unsigned char *ptr = buffer[0];
-        if (cinfo.out_color_components == 3)
-        {
-            for (int count=0; count<width; count++)
-            {
-                for (int channel=0; channel<cinfo.out_color_components; channel++)
-                {
-                    data[index++] = *ptr++;
-                }
-            }
-        }
+        JSAMPROW row = data + row_stride * (height - 1 - cinfo.output_scanline);
+        jpeg_read_scanlines(&cinfo, &row, 1);
     }
 
     // finish decompression
@@ -429,14 +340,14 @@ static bool _saveJPG(cImage* a_image, std::ostream &a_os)
 //==============================================================================
 bool cLoadFileJPG(cImage* a_image, const std::string& a_filename)
 {
-    ifstream in;
-    in.open(a_filename.c_str(), ios::in | ios::binary);
-    if (!in.is_open())
+    // map file into memory
+    cFileMap file;
+    if (!file.open(a_filename))
     {
         return (C_ERROR);
     }
 
-    return (_loadJPG(a_image, in));
+    return (_loadJPG(a_image, (const unsigned char*)file.getData(), file.getSize()));
 }
 
 
@@ -457,10 +368,7 @@ bool cLoadFileJPG(cImage* a_image, const std::string& a_filename)
 //==============================================================================
 bool cLoadJPG(cImage* a_image, const unsigned char *a_buffer, unsigned int a_len)
 {
-    swrapper buf((char*)a_buffer, a_len);
-    istream in(&buf);
-
-    return (_loadJPG (a_image, in));
+    return (_loadJPG(a_image, a_buffer, a_len));
 }
 
 
@@ -0,0 +1,316 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "files/CFileImageKTX.h"
+#include "math/CMaths.h"
+#include "system/CFileMap.h"
+//------------------------------------------------------------------------------
+#include <cstring>
+#include <fstream>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// KTX 1.1 file identifier
+static const unsigned char C_KTX_IDENTIFIER[12] =
+{
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+// KTX header fields, stored as 32-bit words after the identifier
+enum cKTXHeaderField
+{
+    C_KTX_ENDIANNESS = 0,
+    C_KTX_GL_TYPE,
+    C_KTX_GL_TYPE_SIZE,
+    C_KTX_GL_FORMAT,
+    C_KTX_GL_INTERNAL_FORMAT,
+    C_KTX_GL_BASE_INTERNAL_FORMAT,
+    C_KTX_PIXEL_WIDTH,
+    C_KTX_PIXEL_HEIGHT,
+    C_KTX_PIXEL_DEPTH,
+    C_KTX_NUMBER_OF_ARRAY_ELEMENTS,
+    C_KTX_NUMBER_OF_FACES,
+    C_KTX_NUMBER_OF_MIPMAP_LEVELS,
+    C_KTX_BYTES_OF_KEY_VALUE_DATA,
+    C_KTX_NUM_HEADER_FIELDS
+};
+
+static const unsigned int C_KTX_HEADER_SIZE = 12 + 4 * C_KTX_NUM_HEADER_FIELDS;
+static const unsigned int C_KTX_ENDIANNESS_REFERENCE = 0x04030201;
+
+// orientation written by the saver: rows are stored bottom-up, as in OpenGL
+static const char C_KTX_ORIENTATION_KEY[] = "KTXorientation";
+static const char C_KTX_ORIENTATION_VALUE[] = "S=r,T=u";
+
+static inline unsigned int _readUInt32(const unsigned char* a_data)
+{
+    unsigned int value;
+    memcpy(&value, a_data, 4);
+    return (value);
+}
+
+static inline unsigned int _pad4(const unsigned int a_size)
+{
+    return ((a_size + 3) & ~3u);
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function loads a KTX image from a file into a cCompressedImage
+    structure. Only 2D textures stored in one of the S3TC compressed formats
+    are supported, including their mipmap levels. Images whose
+    __KTXorientation__ value indicates top-down rows are flipped after
+    loading.
+
+    \param  a_image  Compressed image structure.
+    \param  a_filename  Filename.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cLoadFileKTX(cCompressedImage* a_image, const std::string& a_filename)
+{
+    // map file in memory
+    cFileMap file;
+    if (!file.open(a_filename))
+    {
+        return (false);
+    }
+
+    const unsigned char* data = (const unsigned char*)file.getData();
+    size_t size = file.getSize();
+
+    // check identifier and byte order of the file
+    if ((size < C_KTX_HEADER_SIZE) || (memcmp(data, C_KTX_IDENTIFIER, 12) != 0))
+    {
+        return (false);
+    }
+
+    unsigned int header[C_KTX_NUM_HEADER_FIELDS];
+    for (int i=0; i<C_KTX_NUM_HEADER_FIELDS; i++)
+    {
+        header[i] = _readUInt32(data + 12 + 4 * i);
+    }
+
+    if (header[C_KTX_ENDIANNESS] != C_KTX_ENDIANNESS_REFERENCE)
+    {
+        return (false);
+    }
+
+    // only compressed 2D textures are supported
+    GLenum format = header[C_KTX_GL_INTERNAL_FORMAT];
+    if ((header[C_KTX_GL_TYPE] != 0) ||
+        (header[C_KTX_GL_FORMAT] != 0) ||
+        (header[C_KTX_PIXEL_DEPTH] > 1) ||
+        (header[C_KTX_NUMBER_OF_ARRAY_ELEMENTS] > 1) ||
+        (header[C_KTX_NUMBER_OF_FACES] != 1) ||
+        (cCompressedImage::queryBytesPerBlock(format) == 0))
+    {
+        return (false);
+    }
+
+    // parse key/value data for the orientation of the image
+    bool topDown = false;
+    size_t offset = C_KTX_HEADER_SIZE;
+    size_t end = offset + header[C_KTX_BYTES_OF_KEY_VALUE_DATA];
+    if (end > size)
+    {
+        return (false);
+    }
+
+    while (offset + 4 <= end)
+    {
+        unsigned int length = _readUInt32(data + offset);
+        const char* keyValue = (const char*)(data + offset + 4);
+        offset += 4;
+        if (offset + length > end)
+        {
+            return (false);
+        }
+
+        // key and value are null terminated strings
+        size_t keyLength = strnlen(keyValue, length);
+        if ((keyLength < length) && (strcmp(keyValue, C_KTX_ORIENTATION_KEY) == 0))
+        {
+            string value(keyValue + keyLength + 1, strnlen(keyValue + keyLength + 1, length - keyLength - 1));
+            topDown = (value.find("T=d") != string::npos);
+        }
+
+        offset += _pad4(length);
+    }
+    offset = end;
+
+    // allocate image (a level count of zero requests runtime mipmap generation)
+    unsigned int width = header[C_KTX_PIXEL_WIDTH];
+    unsigned int height = cMax(1u, header[C_KTX_PIXEL_HEIGHT]);
+    unsigned int numLevels = cMax(1u, header[C_KTX_NUMBER_OF_MIPMAP_LEVELS]);
+
+    // check that the file can contain all levels before allocating memory
+    size_t dataSize = cCompressedImage::querySize(format, width, height, numLevels);
+    if ((dataSize == 0) || (dataSize > size - offset))
+    {
+        return (false);
+    }
+
+    if (!a_image->allocate(width, height, format, numLevels))
+    {
+        return (false);
+    }
+
+    // copy level data
+    for (unsigned int i=0; i<numLevels; i++)
+    {
+        if (offset + 4 > size)
+        {
+            a_image->erase();
+            return (false);
+        }
+
+        unsigned int levelSize = a_image->getLevelSize(i);
+        unsigned int imageSize = _readUInt32(data + offset);
+        offset += 4;
+        if ((imageSize != levelSize) || (offset + imageSize > size))
+        {
+            a_image->erase();
+            return (false);
+        }
+
+        memcpy(a_image->getLevelData(i), data + offset, levelSize);
+        offset += _pad4(imageSize);
+    }
+
+    if (topDown)
+    {
+        a_image->flipHorizontal();
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This function saves a cCompressedImage structure to a KTX file, including
+    all of its mipmap levels. Rows are written bottom-up and the file is
+    tagged with the matching __KTXorientation__ value.
+
+    \param  a_image  Compressed image structure.
+    \param  a_filename  Filename.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cSaveFileKTX(cCompressedImage* a_image, const std::string& a_filename)
+{
+    // sanity check
+    if ((a_image == nullptr) || (!a_image->isInitialized()))
+    {
+        return (false);
+    }
+
+    GLenum format = a_image->getFormat();
+    if (cCompressedImage::queryBytesPerBlock(format) == 0)
+    {
+        return (false);
+    }
+
+    // key/value data
+    unsigned int keyValueLength = sizeof(C_KTX_ORIENTATION_KEY) + sizeof(C_KTX_ORIENTATION_VALUE);
+    vector<unsigned char> keyValue(4 + _pad4(keyValueLength), 0);
+    memcpy(&keyValue[0], &keyValueLength, 4);
+    memcpy(&keyValue[4], C_KTX_ORIENTATION_KEY, sizeof(C_KTX_ORIENTATION_KEY));
+    memcpy(&keyValue[4 + sizeof(C_KTX_ORIENTATION_KEY)], C_KTX_ORIENTATION_VALUE, sizeof(C_KTX_ORIENTATION_VALUE));
+
+    // header
+    unsigned int header[C_KTX_NUM_HEADER_FIELDS];
+    memset(header, 0, sizeof(header));
+    header[C_KTX_ENDIANNESS] = C_KTX_ENDIANNESS_REFERENCE;
+    header[C_KTX_GL_TYPE_SIZE] = 1;
+    header[C_KTX_GL_INTERNAL_FORMAT] = format;
+    header[C_KTX_GL_BASE_INTERNAL_FORMAT] = (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? GL_RGB : GL_RGBA;
+    header[C_KTX_PIXEL_WIDTH] = a_image->getWidth();
+    header[C_KTX_PIXEL_HEIGHT] = a_image->getHeight();
+    header[C_KTX_NUMBER_OF_FACES] = 1;
+    header[C_KTX_NUMBER_OF_MIPMAP_LEVELS] = a_image->getNumLevels();
+    header[C_KTX_BYTES_OF_KEY_VALUE_DATA] = (unsigned int)keyValue.size();
+
+    // write file
+    ofstream file(a_filename.c_str(), ios::binary);
+    if (!file)
+    {
+        return (false);
+    }
+
+    file.write((const char*)C_KTX_IDENTIFIER, sizeof(C_KTX_IDENTIFIER));
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)&keyValue[0], keyValue.size());
+
+    // compressed block sizes are multiples of four, so levels need no padding
+    for (unsigned int i=0; i<a_image->getNumLevels(); i++)
+    {
+        unsigned int imageSize = a_image->getLevelSize(i);
+        file.write((const char*)&imageSize, 4);
+        file.write((const char*)a_image->getLevelData(i), imageSize);
+    }
+
+    return (file.good());
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
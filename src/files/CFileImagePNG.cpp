@@ -113,18 +113,8 @@ static bool _decompressPNG(png_structp a_png_ptr, png_infop a_info_ptr, cImage*
     if (color_type & PNG_COLOR_MASK_ALPHA || png_get_valid(a_png_ptr, a_info_ptr, PNG_INFO_tRNS))
         bpp += 1;
 
-    // allocate row buffers
-    size_t    rowsize = bpp*width;
-    png_bytep *row_pointers = new png_bytep[height];
-    for (j=0; j<height; j++)
-    {
-        row_pointers[j] = (png_bytep)png_malloc(a_png_ptr, rowsize);
-    }
-
-    // read the entire image in one go
-    png_read_image(a_png_ptr, row_pointers);
-
-    // we allocate memory for image. By default we shall use OpenGL's RGB mode.
+    // allocate memory for image (or reuse the current image buffer if it
+    // already has the right size). By default we shall use OpenGL's RGB mode.
     if (bpp == 1 && !a_image->allocate(width, height, GL_LUMINANCE))
         return (C_ERROR);
     if (bpp == 2 && !a_image->allocate(width, height, GL_LUMINANCE_ALPHA))
@@ -137,17 +127,19 @@ static bool _decompressPNG(png_structp a_png_ptr, png_infop a_info_ptr, cImage*
     // retrieve pointer to image data
     unsigned char* data = a_image->getData();
 
-    // put rows neatly in the destination buffer
+    // point each PNG row to its line in the image buffer. rows are stored
+    // bottom-up in the image, therefore the first PNG row maps to the last line.
+    size_t rowsize = bpp*width;
+    png_bytep *row_pointers = new png_bytep[height];
     for (j=0; j<height; j++)
     {
-        memcpy(data+bpp*j*width, row_pointers[height-1-j], rowsize);
+        row_pointers[j] = (png_bytep)(data + rowsize*(height-1-j));
     }
 
-    // clean up after the read and free any memory allocated
-    for (j=0; j<height; j++)
-    {
-        png_free(a_png_ptr, row_pointers[j]);
-    }
+    // decode the entire image in one go, directly into the image buffer
+    png_read_image(a_png_ptr, row_pointers);
+
+    // clean up after the read
     delete [] row_pointers;
     png_read_end(a_png_ptr, NULL);
 
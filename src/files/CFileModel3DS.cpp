@@ -47,6 +47,8 @@
 //------------------------------------------------------------------------------
 #ifdef C_USE_FILE_3DS
 //------------------------------------------------------------------------------
+#include "system/CFileMap.h"
+#include "system/CThreadPool.h"
 #include "lib3ds.h"
 #include <map>
 //------------------------------------------------------------------------------
@@ -71,6 +73,124 @@ struct c3dsMaterial
     bool m_useTexture;
 };
 
+// triangles of a 3DS mesh that use the same 3DS material, three vertices per
+// triangle. vertex data is kept in single precision, as in the file.
+struct c3dsTriangleGroup
+{
+    int m_material;
+    vector<float> m_positions;
+    vector<float> m_normals;
+    vector<float> m_texCoords;
+};
+
+//------------------------------------------------------------------------------
+
+static string _contentKey(const string& a_filename)
+{
+    // map file in memory
+    cFileMap file;
+    if (!file.open(a_filename))
+    {
+        return ("");
+    }
+
+    // 64-bit FNV-1a hash of the file content
+    const unsigned char* data = (const unsigned char*)file.getData();
+    size_t size = file.getSize();
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i=0; i<size; i++)
+    {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+
+    // key is made of the file size and hash
+    string key;
+    key.append((const char*)&size, sizeof(size));
+    key.append((const char*)&hash, sizeof(hash));
+    return (key);
+}
+
+static void _buildTriangleGroups(Lib3dsMesh* a_mesh,
+                                 const vector<int>& a_materialIndices,
+                                 vector<c3dsTriangleGroup>& a_groups)
+{
+    int numFaces = a_mesh->nfaces;
+    if (numFaces == 0) { return; }
+
+    // compute vertex normals
+    float (*normals)[3] = (float(*)[3])malloc(3*3*sizeof(float)*numFaces);
+    if (normals != NULL)
+    {
+        lib3ds_mesh_calculate_vertex_normals(a_mesh, normals);
+    }
+
+    // groups by 3DS material, in order of first use
+    map<int, int> groupIndices;
+
+    for (int j=0; j<numFaces; j++)
+    {
+        Lib3dsFace* face = &(a_mesh->faces[j]);
+
+        // get 3DS material and its record (shared by materials with identical properties)
+        int fileMaterial = -1;
+        int material = -1;
+        if ((face->material >= 0) && (face->material < (int)a_materialIndices.size()))
+        {
+            fileMaterial = face->material;
+            material = a_materialIndices[face->material];
+        }
+
+        // get triangle group. groups follow the 3DS materials rather than the
+        // shared records, so that merging materials does not merge meshes.
+        map<int, int>::iterator it = groupIndices.find(fileMaterial);
+        if (it == groupIndices.end())
+        {
+            it = groupIndices.insert(make_pair(fileMaterial, (int)a_groups.size())).first;
+            a_groups.push_back(c3dsTriangleGroup());
+            a_groups.back().m_material = material;
+        }
+        c3dsTriangleGroup& group = a_groups[it->second];
+
+        for (int k=0; k<3; k++)
+        {
+            int vertex = face->index[k];
+
+            // vertex position
+            if (a_mesh->vertices != NULL)
+            {
+                group.m_positions.insert(group.m_positions.end(), a_mesh->vertices[vertex], a_mesh->vertices[vertex] + 3);
+            }
+            else
+            {
+                group.m_positions.resize(group.m_positions.size() + 3, 0.0f);
+            }
+
+            // vertex normal
+            if (normals != NULL)
+            {
+                group.m_normals.insert(group.m_normals.end(), normals[3*j+k], normals[3*j+k] + 3);
+            }
+            else
+            {
+                group.m_normals.resize(group.m_normals.size() + 3, 0.0f);
+            }
+
+            // vertex texture coordinate
+            if (a_mesh->texcos != NULL)
+            {
+                group.m_texCoords.insert(group.m_texCoords.end(), a_mesh->texcos[vertex], a_mesh->texcos[vertex] + 2);
+            }
+            else
+            {
+                group.m_texCoords.resize(group.m_texCoords.size() + 2, 0.0f);
+            }
+        }
+    }
+
+    // free normal table
+    free(normals);
+}
+
 //------------------------------------------------------------------------------
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -81,7 +201,16 @@ struct c3dsMaterial
     This function loads a 3DS 3D model from a file into a cMultiMesh structure.
     If the operation succeeds, then the functions returns __true__ and the
     3D model is loaded into cMultiMesh.
-    If the operation fails, then the function returns __false__.
+    If the operation fails, then the function returns __false__. \n
+
+    Texture files are identified by their content, so that a bitmap used by
+    several materials is decoded only once and shared, even if it is referenced
+    under different file names. Materials with identical properties share the
+    same cMaterial and texture objects. As before, one mesh is created for each
+    3DS material used by each 3DS mesh, so the number of meshes is not affected
+    by this sharing. The triangles of each 3DS mesh are converted in parallel
+    before the resulting meshes are added to the multimesh on the calling
+    thread.
 
     \param  a_object    Multimesh object.
     \param  a_filename  Filename.
@@ -107,21 +236,122 @@ bool cLoadFile3DS(cMultiMesh* a_object, const std::string& a_filename)
         // verify if file was loaded
         if (file == NULL) { return (C_ERROR); }
 
+        // thread pool used to load textures and build meshes
+        cThreadPool* threadPool = cThreadPool::getSharedThreadPool();
+
         // vector where all material properties are stored
         vector<c3dsMaterial> matRecords;
 
+        // material record used by each 3DS material
+        vector<int> matIndices;
+
 
         /////////////////////////////////////////////////////////////////////////
-        // MATERIALS & TEXTURE
+        // TEXTURES
         /////////////////////////////////////////////////////////////////////////
 
         // load all material properties
         int f_nmaterials = file->nmaterials;
         Lib3dsMaterial** f_materials = file->materials;
 
+        // list texture files used by materials
+        string directory = cGetDirectory(a_filename);
+        vector<string> textureFiles;
+        vector<int> matTextureFiles(f_nmaterials, -1);
+        map<string, int> textureFileIndices;
+        for (int i=0; i<f_nmaterials; i++)
+        {
+            // get texture filename
+            string name = f_materials[i]->texture1_map.name;
+            if (name == "") { continue; }
+
+            string filename = directory + name;
+            map<string, int>::iterator it = textureFileIndices.find(filename);
+            if (it == textureFileIndices.end())
+            {
+                it = textureFileIndices.insert(make_pair(filename, (int)textureFiles.size())).first;
+                textureFiles.push_back(filename);
+            }
+            matTextureFiles[i] = it->second;
+        }
+
+        // identify texture files by content
+        int numTextureFiles = (int)textureFiles.size();
+        vector<string> textureKeys(numTextureFiles);
+        threadPool->parallelFor(numTextureFiles, [&](unsigned int a_index)
+        {
+            textureKeys[a_index] = _contentKey(textureFiles[a_index]);
+        });
+
+        // files with identical content share the same texture
+        vector<int> fileTextures(numTextureFiles, -1);
+        vector<int> textureSources;
+        map<string, int> textureIndices;
+        for (int i=0; i<numTextureFiles; i++)
+        {
+            if (textureKeys[i] == "") { continue; }
+
+            map<string, int>::iterator it = textureIndices.find(textureKeys[i]);
+            if (it == textureIndices.end())
+            {
+                it = textureIndices.insert(make_pair(textureKeys[i], (int)textureSources.size())).first;
+                textureSources.push_back(i);
+            }
+            fileTextures[i] = it->second;
+        }
+
+        // load each texture once
+        vector<cTexture2dPtr> textures(textureSources.size());
+        threadPool->parallelFor((unsigned int)textureSources.size(), [&](unsigned int a_index)
+        {
+            cTexture2dPtr texture = cTexture2d::create();
+            if (texture->loadFromFile(textureFiles[textureSources[a_index]]))
+            {
+                textures[a_index] = texture;
+            }
+        });
+
+
+        /////////////////////////////////////////////////////////////////////////
+        // MATERIALS
+        /////////////////////////////////////////////////////////////////////////
+
+        // material records, indexed by material properties
+        map<string, int> matRecordIndices;
+
         // parse all materials
         for (int i=0; i<f_nmaterials; i++)
         {
+            // get next material
+            Lib3dsMaterial* f_material = f_materials[i];
+
+            // get texture
+            cTexture2dPtr texture;
+            if ((matTextureFiles[i] >= 0) && (fileTextures[matTextureFiles[i]] >= 0))
+            {
+                texture = textures[fileTextures[matTextureFiles[i]]];
+            }
+
+            // materials with identical properties share the same record
+            string key;
+            key.append((const char*)f_material->ambient, sizeof(f_material->ambient));
+            key.append((const char*)f_material->diffuse, sizeof(f_material->diffuse));
+            key.append((const char*)f_material->specular, sizeof(f_material->specular));
+            key.append((const char*)&f_material->shin_strength, sizeof(f_material->shin_strength));
+            key.append((const char*)&f_material->transparency, sizeof(f_material->transparency));
+            key.append((const char*)&f_material->two_sided, sizeof(f_material->two_sided));
+            cTexture2d* texturePointer = texture.get();
+            key.append((const char*)&texturePointer, sizeof(texturePointer));
+
+            map<string, int>::iterator it = matRecordIndices.find(key);
+            if (it != matRecordIndices.end())
+            {
+                matIndices.push_back(it->second);
+                continue;
+            }
+            matRecordIndices.insert(make_pair(key, (int)matRecords.size()));
+            matIndices.push_back((int)matRecords.size());
+
             // initialize variable
             c3dsMaterial matRecord;
             matRecord.m_material = cMaterialPtr();
@@ -130,10 +360,6 @@ bool cLoadFile3DS(cMultiMesh* a_object, const std::string& a_filename)
             matRecord.m_useCulling = false;
             matRecord.m_useTransparency = false;
 
-            // get next material
-            Lib3dsMaterial* f_material = *f_materials;
-            f_materials++;
-
             // create new material
             matRecord.m_material = cMaterial::create();
             cMaterialPtr material = matRecord.m_material;
@@ -181,32 +407,11 @@ bool cLoadFile3DS(cMultiMesh* a_object, const std::string& a_filename)
                 matRecord.m_useCulling = false;
             }
 
-            // get texture filename
-            string name = f_material->texture1_map.name;
-
-            // create texture if defined
-            if (name != "")
+            // assign texture if loaded
+            if (texture != nullptr)
             {
-                // create texture object
-                cTexture2dPtr texture = cTexture2d::create();
-
-                // load texture image
-                string directory = cGetDirectory(a_filename);
-                string filename = directory + name;
-                bool success = texture->loadFromFile(filename);
-
-                // store reference to texture if loaded
-                if (success)
-                {
-                    matRecord.m_texture = texture;
-                    matRecord.m_useTexture = true;
-                }
-                else
-                {
-                    //delete texture;
-                    matRecord.m_texture = cTexture2dPtr();
-                    matRecord.m_useTexture = false;
-                }
+                matRecord.m_texture = texture;
+                matRecord.m_useTexture = true;
             }
 
             // store material record
@@ -222,167 +427,69 @@ bool cLoadFile3DS(cMultiMesh* a_object, const std::string& a_filename)
         int f_nmeshes = file->nmeshes;
         Lib3dsMesh** f_meshes = file->meshes;
 
-        // build each mesh object
-        for (int i=0; i<f_nmeshes; i++)
+        // build triangle data of each mesh object in parallel
+        vector< vector<c3dsTriangleGroup> > groups(f_nmeshes);
+        threadPool->parallelFor(f_nmeshes, [&](unsigned int a_index)
         {
-            // pointer to mesh composed of triangle with no material property
-            cMesh* meshNoMaterial = NULL;
-
-            // get next mesh
-            Lib3dsMesh* f_mesh = *f_meshes;
-            f_meshes++;
-
-
-            /////////////////////////////////////////////////////////////////////////
-            // COMPUTE NORMALS
-            /////////////////////////////////////////////////////////////////////////
-        
-            // allocate table for normals
-            float (*f_normals)[3] = (float(*)[3])malloc(3*3*sizeof(float)*f_mesh->nfaces);
+            _buildTriangleGroups(f_meshes[a_index], matIndices, groups[a_index]);
+        });
 
-            // compute vertex normals
-            lib3ds_mesh_calculate_vertex_normals(f_mesh, f_normals);
-
-
-            /////////////////////////////////////////////////////////////////////////
-            // TRIANGLE DATA
-            /////////////////////////////////////////////////////////////////////////
-            std::map<int, cMesh*> map;
-
-            int f_ntriangles = f_mesh->nfaces;
-        
-            for (int j=0; j<f_ntriangles; j++)
+        // create one mesh per 3DS material of each mesh object
+        for (int i=0; i<f_nmeshes; i++)
+        {
+            for (unsigned int j=0; j<groups[i].size(); j++)
             {
-                int index0, index1, index2;
-                Lib3dsFace* f_face = &(f_mesh->faces[j]);
+                c3dsTriangleGroup& group = groups[i][j];
+                cMesh* mesh = multiMesh->newMesh();
 
-                // get material 
-                int f_material = f_face->material;
-
-                // get vertex indices
-                int f_vertex0 = f_face->index[0];
-                int f_vertex1 = f_face->index[1];
-                int f_vertex2 = f_face->index[2];
-
-                // get vertex position data
-                cVector3d v0, v1, v2, n0, n1, n2, t0, t1, t2;
-
-                if (f_mesh->vertices != NULL)
+                if (group.m_material >= 0)
                 {
-                    v0.set((double)(f_mesh->vertices[f_vertex0][0]),
-                           (double)(f_mesh->vertices[f_vertex0][1]),
-                           (double)(f_mesh->vertices[f_vertex0][2]));
-
-                    v1.set((double)(f_mesh->vertices[f_vertex1][0]),
-                           (double)(f_mesh->vertices[f_vertex1][1]),
-                           (double)(f_mesh->vertices[f_vertex1][2]));
+                    const c3dsMaterial& matRecord = matRecords[group.m_material];
 
-                    v2.set((double)(f_mesh->vertices[f_vertex2][0]),
-                           (double)(f_mesh->vertices[f_vertex2][1]),
-                           (double)(f_mesh->vertices[f_vertex2][2]));
-                }
-                else
-                {
-                    v0.zero();
-                    v1.zero();
-                    v2.zero();
-                }
-
-                // get vertex normal data
-                if (f_normals != NULL)
-                {
-                    index0 = 3*j;
-                    n0.set((double)(f_normals[index0][0]),
-                           (double)(f_normals[index0][1]),
-                           (double)(f_normals[index0][2]));
-
-                    index1 = 3*j+1;
-                    n1.set((double)(f_normals[index1][0]),
-                           (double)(f_normals[index1][1]),
-                           (double)(f_normals[index1][2]));
-
-                    index2 = 3*j+2;
-                    n2.set((double)(f_normals[index2][0]),
-                           (double)(f_normals[index2][1]),
-                           (double)(f_normals[index2][2]));
-                }
-                else
-                {
-                    n0.zero();
-                    n1.zero();
-                    n2.zero();
-                }
+                    // assign material
+                    mesh->setMaterial(matRecord.m_material);
 
-                // get vertex texture coordinate data
-                if (f_mesh->texcos != NULL)
-                {
-                    t0.set((double)(f_mesh->texcos[f_vertex0][0]),
-                           (double)(f_mesh->texcos[f_vertex0][1]),
-                           0.0);
+                    // assign texture
+                    if (matRecord.m_useTexture)
+                    {
+                        mesh->setTexture(dynamic_pointer_cast<cTexture1d>(matRecord.m_texture));
+                        mesh->setUseTexture(true);
+                    }
 
-                    t1.set((double)(f_mesh->texcos[f_vertex1][0]),
-                           (double)(f_mesh->texcos[f_vertex1][1]),
-                           0.0);
+                    // set transparency
+                    mesh->setUseTransparency(matRecord.m_useTransparency);
 
-                    t2.set((double)(f_mesh->texcos[f_vertex2][0]),
-                           (double)(f_mesh->texcos[f_vertex2][1]),
-                           0.0);
+                    // set culling
+                    mesh->setUseCulling(matRecord.m_useCulling);
                 }
-                else
+
+                // create vertices
+                unsigned int numVertices = (unsigned int)(group.m_positions.size() / 3);
+                unsigned int firstVertex = mesh->m_vertices->newVertices(numVertices);
+                for (unsigned int k=0; k<numVertices; k++)
                 {
-                    t0.zero();
-                    t1.zero();
-                    t2.zero();
+                    const float* pos = &group.m_positions[3*k];
+                    const float* normal = &group.m_normals[3*k];
+                    const float* texCoord = &group.m_texCoords[2*k];
+                    mesh->m_vertices->setLocalPos(firstVertex + k, pos[0], pos[1], pos[2]);
+                    mesh->m_vertices->setNormal(firstVertex + k, normal[0], normal[1], normal[2]);
+                    mesh->m_vertices->setTexCoord(firstVertex + k, texCoord[0], texCoord[1], 0.0);
                 }
 
-                // search for mesh
-                cMesh* mesh; 
-                if (f_material >= 0)
+                // create triangles
+                vector<unsigned int> indices(numVertices);
+                for (unsigned int k=0; k<numVertices; k++)
                 {
-                    if (map.find(f_material) == map.end())
-                    {
-                        // mesh not found. create new mesh for handling the designed material 
-                        mesh = multiMesh->newMesh();
-                        map[f_material] = mesh;
-
-                        // assign material
-                        mesh->setMaterial(matRecords[f_material].m_material);
-
-                        // assign texture
-                        if (matRecords[f_material].m_useTexture)
-                        {
-                            mesh->setTexture(dynamic_pointer_cast<cTexture1d>(matRecords[f_material].m_texture));
-                            mesh->setUseTexture(true);
-                        }
-
-                        // set transparency
-                        mesh->setUseTransparency(matRecords[f_material].m_useTransparency);
-
-                        // set culling
-                        mesh->setUseCulling(matRecords[f_material].m_useCulling);
-                    }
-                    else
-                    {
-                        mesh = map[f_material];
-                    }
+                    indices[k] = firstVertex + k;
                 }
-                else
-                {
-                    if (meshNoMaterial == NULL)
-                    {
-                        meshNoMaterial =  multiMesh->newMesh();
-                    }
+                mesh->m_triangles->newTriangles(&indices[0], numVertices / 3);
 
-                    // mesh not found. create new mesh for handling the designed material 
-                    mesh = meshNoMaterial;
-                }
+                // mark mesh for update
+                mesh->markForUpdate(false);
 
-                // create triangle
-                mesh->newTriangle(v0, v1, v2, n0, n1, n2, t0, t1, t2);
+                // release triangle data
+                group = c3dsTriangleGroup();
             }
-
-            // free normal table
-            free (f_normals);
         }
 
         // load file
@@ -0,0 +1,697 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "files/CFileModelCMM.h"
+//------------------------------------------------------------------------------
+#include "collisions/CCollisionAABB.h"
+#include "system/CFileMap.h"
+#include "system/CString.h"
+//------------------------------------------------------------------------------
+#include "stdint.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+using namespace chai3d;
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// file identifier and format version
+static const char C_CMM_MAGIC[8] = { 'C', 'H', 'A', 'I', '3', 'D', 'M', 'M' };
+static const uint32_t C_CMM_VERSION = 2;
+
+// written in the byte order of the machine that created the file
+static const uint32_t C_CMM_BYTE_ORDER = 0x01020304;
+
+// mesh flags
+static const uint32_t C_CMM_NORMALS             = 0x0001;
+static const uint32_t C_CMM_TEXCOORDS           = 0x0002;
+static const uint32_t C_CMM_COLORS              = 0x0004;
+static const uint32_t C_CMM_TANGENTS            = 0x0008;
+static const uint32_t C_CMM_BITANGENTS          = 0x0010;
+static const uint32_t C_CMM_USE_TEXTURE         = 0x0020;
+static const uint32_t C_CMM_USE_VERTEX_COLORS   = 0x0040;
+static const uint32_t C_CMM_USE_MATERIAL        = 0x0080;
+static const uint32_t C_CMM_USE_TRANSPARENCY    = 0x0100;
+static const uint32_t C_CMM_COLLISION_TREE      = 0x0200;
+
+// file header
+struct cHeaderCMM
+{
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_numMeshes;
+    uint32_t m_flags;
+    uint32_t m_byteOrder;
+};
+
+// mesh header, followed by the mesh name, texture path and data arrays
+struct cMeshHeaderCMM
+{
+    double m_localPos[3];
+    double m_localRot[9];
+    double m_collisionRadius;
+    float m_ambient[4];
+    float m_diffuse[4];
+    float m_specular[4];
+    float m_emission[4];
+    uint32_t m_shininess;
+    uint32_t m_flags;
+    uint32_t m_numVertices;
+    uint32_t m_numTriangles;
+    uint32_t m_numNodes;
+    int32_t m_rootIndex;
+    uint32_t m_nameLength;
+    uint32_t m_textureLength;
+};
+
+// collision tree node
+struct cNodeCMM
+{
+    double m_min[3];
+    double m_max[3];
+    int32_t m_depth;
+    int32_t m_nodeType;
+    int32_t m_leftSubTree;
+    int32_t m_rightSubTree;
+};
+
+// sequential reader over a memory-mapped file
+struct cReaderCMM
+{
+    const char* m_data;
+    size_t m_size;
+    size_t m_offset;
+
+    // returns the next block of a_size bytes and moves to the next 8-byte boundary
+    const char* read(size_t a_size)
+    {
+        if ((m_offset > m_size) || (a_size > m_size - m_offset)) { return (NULL); }
+        const char* block = m_data + m_offset;
+        m_offset = m_offset + ((a_size + 7) & ~((size_t)7));
+        return (block);
+    }
+};
+
+//------------------------------------------------------------------------------
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function writes a block of data followed by the padding needed to 
+    align the next block on an 8-byte boundary.
+
+    \param  a_file  File handle.
+    \param  a_data  Data to be written.
+    \param  a_size  Size of data in bytes.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+static inline bool _writeBlock(FILE* a_file, const void* a_data, size_t a_size)
+{
+    static const char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    if ((a_size > 0) && (fwrite(a_data, 1, a_size, a_file) != a_size))
+    {
+        return (false);
+    }
+
+    size_t paddingSize = (8 - (a_size & 7)) & 7;
+    if ((paddingSize > 0) && (fwrite(padding, 1, paddingSize, a_file) != paddingSize))
+    {
+        return (false);
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This function copies a block of cVector3d data from a memory-mapped file 
+    into a vertex attribute array.
+
+    \param  a_reader   File reader.
+    \param  a_array    Destination array, already sized to the number of vertices.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+static inline bool _readVectors(cReaderCMM& a_reader, vector<cVector3d>& a_array)
+{
+    size_t size = a_array.size() * sizeof(cVector3d);
+    const char* data = a_reader.read(size);
+    if (data == NULL) { return (false); }
+    if (size > 0) { memcpy(&a_array[0], data, size); }
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This function copies four color components into a cColorf.
+
+    \param  a_color  Destination color.
+    \param  a_data   Red, green, blue and alpha components.
+*/
+//==============================================================================
+static inline void _setColor(cColorf& a_color, const float a_data[4])
+{
+    a_color.set(a_data[0], a_data[1], a_data[2], a_data[3]);
+}
+
+
+//==============================================================================
+/*!
+    This function copies the components of a cColorf into an array.
+
+    \param  a_data   Destination array.
+    \param  a_color  Source color.
+*/
+//==============================================================================
+static inline void _getColor(float a_data[4], const cColorf& a_color)
+{
+    memcpy(a_data, a_color.m_color, 4 * sizeof(float));
+}
+
+
+//==============================================================================
+/*!
+    This function reads a mesh from a memory-mapped CMM file and adds it to a
+    cMultiMesh structure.
+
+    \param  a_reader     File reader, positioned at the mesh header.
+    \param  a_object     Multimesh object.
+    \param  a_textures   Textures already loaded, indexed by path.
+    \param  a_directory  Directory of the cache file.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+static bool _readMeshCMM(cReaderCMM& a_reader,
+                         cMultiMesh* a_object,
+                         map<string, cTexture2dPtr>& a_textures,
+                         const string& a_directory)
+{
+    // read mesh header
+    const cMeshHeaderCMM* meshHeader = (const cMeshHeaderCMM*)(a_reader.read(sizeof(cMeshHeaderCMM)));
+    if (meshHeader == NULL)
+        return (C_ERROR);
+
+    unsigned int flags = meshHeader->m_flags;
+    unsigned int numVertices = meshHeader->m_numVertices;
+    unsigned int numTriangles = meshHeader->m_numTriangles;
+
+    // read mesh name and texture path
+    const char* name = a_reader.read(meshHeader->m_nameLength);
+    const char* texturePath = a_reader.read(meshHeader->m_textureLength);
+    if ((name == NULL) || (texturePath == NULL))
+        return (C_ERROR);
+
+    // create mesh
+    cMesh* mesh = a_object->newMesh();
+    mesh->m_name = string(name, meshHeader->m_nameLength);
+
+    // set position and orientation
+    const double* r = meshHeader->m_localRot;
+    cMatrix3d rot;
+    rot.set(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7], r[8]);
+    mesh->setLocalPos(cVector3d(meshHeader->m_localPos[0], meshHeader->m_localPos[1], meshHeader->m_localPos[2]));
+    mesh->setLocalRot(rot);
+
+    // allocate and copy vertex data
+    cVertexArrayPtr vertices = mesh->m_vertices;
+    if (numVertices > 0)
+    {
+        vertices->allocateData(numVertices,
+                               (flags & C_CMM_NORMALS) != 0,
+                               (flags & C_CMM_TEXCOORDS) != 0,
+                               (flags & C_CMM_COLORS) != 0,
+                               (flags & C_CMM_TANGENTS) != 0,
+                               (flags & C_CMM_BITANGENTS) != 0,
+                               false);
+    }
+
+    if (!_readVectors(a_reader, vertices->m_localPos))
+        return (C_ERROR);
+
+    if ((flags & C_CMM_NORMALS) && !_readVectors(a_reader, vertices->m_normal))
+        return (C_ERROR);
+
+    if ((flags & C_CMM_TEXCOORDS) && !_readVectors(a_reader, vertices->m_texCoord))
+        return (C_ERROR);
+
+    if ((flags & C_CMM_TANGENTS) && !_readVectors(a_reader, vertices->m_tangent))
+        return (C_ERROR);
+
+    if ((flags & C_CMM_BITANGENTS) && !_readVectors(a_reader, vertices->m_bitangent))
+        return (C_ERROR);
+
+    if (flags & C_CMM_COLORS)
+    {
+        const float* colors = (const float*)(a_reader.read((size_t)numVertices * 4 * sizeof(float)));
+        if (colors == NULL)
+            return (C_ERROR);
+
+        for (unsigned int j=0; j<numVertices; j++)
+        {
+            memcpy(vertices->m_color[j].m_color, colors + 4 * j, 4 * sizeof(float));
+        }
+    }
+
+    // copy triangle data
+    const unsigned int* indices = (const unsigned int*)(a_reader.read((size_t)numTriangles * 3 * sizeof(unsigned int)));
+    if (indices == NULL)
+        return (C_ERROR);
+
+    for (unsigned int j=0; j<3*numTriangles; j++)
+    {
+        if (indices[j] >= numVertices)
+            return (C_ERROR);
+    }
+
+    cTriangleArrayPtr triangles = mesh->m_triangles;
+    triangles->newTriangles(indices, numTriangles);
+
+    // restore collision tree
+    if (flags & C_CMM_COLLISION_TREE)
+    {
+        const cNodeCMM* data = (const cNodeCMM*)(a_reader.read((size_t)meshHeader->m_numNodes * sizeof(cNodeCMM)));
+        if (data == NULL)
+            return (C_ERROR);
+
+        vector<cCollisionAABBNode> nodes(meshHeader->m_numNodes);
+        for (unsigned int j=0; j<meshHeader->m_numNodes; j++)
+        {
+            cCollisionAABBNode& node = nodes[j];
+            node.m_bbox.setValue(cVector3d(data[j].m_min[0], data[j].m_min[1], data[j].m_min[2]),
+                                 cVector3d(data[j].m_max[0], data[j].m_max[1], data[j].m_max[2]));
+            node.m_depth = data[j].m_depth;
+            node.m_nodeType = (cAABBNodeType)(data[j].m_nodeType);
+            node.m_leftSubTree = data[j].m_leftSubTree;
+            node.m_rightSubTree = data[j].m_rightSubTree;
+        }
+
+        // a tree that does not match the triangles is rebuilt
+        cCollisionAABB* collisionDetector = new cCollisionAABB();
+        if (!collisionDetector->restore(triangles, nodes, meshHeader->m_rootIndex, meshHeader->m_collisionRadius))
+        {
+            collisionDetector->initialize(triangles, meshHeader->m_collisionRadius);
+        }
+        mesh->setCollisionDetector(collisionDetector);
+    }
+
+    // set material
+    _setColor(mesh->m_material->m_ambient, meshHeader->m_ambient);
+    _setColor(mesh->m_material->m_diffuse, meshHeader->m_diffuse);
+    _setColor(mesh->m_material->m_specular, meshHeader->m_specular);
+    _setColor(mesh->m_material->m_emission, meshHeader->m_emission);
+    mesh->m_material->setShininess(meshHeader->m_shininess);
+
+    // load texture
+    if (meshHeader->m_textureLength > 0)
+    {
+        string path(texturePath, meshHeader->m_textureLength);
+
+        map<string, cTexture2dPtr>::iterator it = a_textures.find(path);
+        if (it != a_textures.end())
+        {
+            mesh->setTexture(it->second);
+        }
+        else
+        {
+            // texture paths are first searched relative to the cache file
+            cTexture2dPtr texture = cTexture2d::create();
+            bool result = texture->loadFromFile(a_directory + path);
+            if (!result)
+            {
+                result = texture->loadFromFile(path);
+            }
+
+            if (result)
+            {
+                a_textures[path] = texture;
+                mesh->setTexture(texture);
+            }
+        }
+    }
+
+    // set rendering options
+    mesh->setUseTexture((flags & C_CMM_USE_TEXTURE) && (mesh->m_texture != nullptr));
+    mesh->setUseVertexColors((flags & C_CMM_USE_VERTEX_COLORS) != 0);
+    mesh->setUseMaterial((flags & C_CMM_USE_MATERIAL) != 0);
+    mesh->setUseTransparency((flags & C_CMM_USE_TRANSPARENCY) != 0);
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This function loads a CHAI3D binary model cache file into a cMultiMesh
+    structure. The file is memory-mapped and vertex, triangle and collision
+    tree data are copied in bulk into the mesh arrays; no parsing, normal
+    computation or collision tree construction takes place. Textures are 
+    loaded from the image files referenced by the cache. 
+    If the operation succeeds, then the functions returns __true__ and the
+    meshes are added to the cMultiMesh object.
+    If the operation fails, then the function returns __false__ and the 
+    meshes already read from the file are deleted.
+
+    \param  a_object    Multimesh object.
+    \param  a_filename  Filename.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cLoadFileCMM(cMultiMesh* a_object, const std::string& a_filename)
+{
+    // the layout of the arrays in memory must match the file layout
+    static_assert(sizeof(cVector3d) == 3 * sizeof(double), "unexpected cVector3d layout");
+
+    // sanity check
+    if (a_object == NULL)
+        return (C_ERROR);
+
+    // map file into memory
+    cFileMap fileMap;
+    if (!fileMap.open(a_filename))
+        return (C_ERROR);
+
+    cReaderCMM reader;
+    reader.m_data = fileMap.getData();
+    reader.m_size = fileMap.getSize();
+    reader.m_offset = 0;
+
+    // read header
+    const cHeaderCMM* header = (const cHeaderCMM*)(reader.read(sizeof(cHeaderCMM)));
+    if ((header == NULL) ||
+        (memcmp(header->m_magic, C_CMM_MAGIC, sizeof(C_CMM_MAGIC)) != 0) ||
+        (header->m_version != C_CMM_VERSION) ||
+        (header->m_byteOrder != C_CMM_BYTE_ORDER))
+    {
+        return (C_ERROR);
+    }
+
+    // textures shared between meshes are loaded once
+    map<string, cTexture2dPtr> textures;
+    string directory = cGetDirectory(a_filename);
+
+    // read meshes
+    int numMeshes = a_object->getNumMeshes();
+    bool result = C_SUCCESS;
+    for (unsigned int i=0; (i<header->m_numMeshes) && result; i++)
+    {
+        result = _readMeshCMM(reader, a_object, textures, directory);
+    }
+
+    // on error, delete the meshes created from this file
+    if (!result)
+    {
+        while (a_object->getNumMeshes() > numMeshes)
+        {
+            cMesh* mesh = a_object->getMesh(a_object->getNumMeshes() - 1);
+            a_object->removeMesh(mesh);
+            delete (mesh);
+        }
+    }
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This function saves the meshes of a cMultiMesh object to a CHAI3D binary 
+    model cache file. Textures are stored as references to their image files;
+    images that were not loaded from a file are saved in PNG format next to 
+    the cache file. If requested, the AABB collision tree of each mesh is 
+    stored so that it does not need to be rebuilt when the file is loaded.
+
+    \param  a_object                Multimesh object.
+    \param  a_filename              Filename.
+    \param  a_includeCollisionTree  If __true__, AABB collision trees are saved.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cSaveFileCMM(cMultiMesh* a_object, const std::string& a_filename, const bool a_includeCollisionTree)
+{
+    // sanity check
+    if (a_object == NULL) 
+        return (C_ERROR);
+
+    // open file
+    FILE* file = fopen(a_filename.c_str(), "wb");
+    if (file == NULL)
+        return (C_ERROR);
+
+    // write header
+    int numMeshes = a_object->getNumMeshes();
+
+    cHeaderCMM header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, C_CMM_MAGIC, sizeof(C_CMM_MAGIC));
+    header.m_version = C_CMM_VERSION;
+    header.m_numMeshes = numMeshes;
+    header.m_byteOrder = C_CMM_BYTE_ORDER;
+
+    bool result = _writeBlock(file, &header, sizeof(header));
+
+    // images without a file are written once, next to the cache file
+    map<cImage*, string> savedImages;
+    string directory = cGetDirectory(a_filename);
+    string basename = cGetFilename(a_filename, false);
+
+    for (int i=0; (i<numMeshes) && result; i++)
+    {
+        cMesh* mesh = a_object->getMesh(i);
+        cVertexArrayPtr vertices = mesh->m_vertices;
+        cTriangleArrayPtr triangles = mesh->m_triangles;
+        unsigned int numVertices = vertices->getNumElements();
+
+        // gather allocated triangles
+        vector<unsigned int> indices;
+        const unsigned int* indexData = NULL;
+        unsigned int numTriangles = triangles->getNumElements();
+        unsigned int numAllocated = 0;
+        for (unsigned int j=0; j<numTriangles; j++)
+        {
+            if (triangles->m_allocated[j]) { numAllocated++; }
+        }
+
+        if (numAllocated == numTriangles)
+        {
+            if (numTriangles > 0) { indexData = &(triangles->m_indices[0]); }
+        }
+        else
+        {
+            indices.reserve(3 * numAllocated);
+            for (unsigned int j=0; j<numTriangles; j++)
+            {
+                if (triangles->m_allocated[j])
+                {
+                    indices.push_back(triangles->m_indices[3*j+0]);
+                    indices.push_back(triangles->m_indices[3*j+1]);
+                    indices.push_back(triangles->m_indices[3*j+2]);
+                }
+            }
+            if (numAllocated > 0) { indexData = &(indices[0]); }
+        }
+
+        // the collision tree refers to triangle indices, it is only saved if triangles were not compacted
+        cCollisionAABB* collisionDetector = dynamic_cast<cCollisionAABB*>(mesh->getCollisionDetector());
+        bool saveTree = a_includeCollisionTree && 
+                        (collisionDetector != NULL) && 
+                        (numAllocated == numTriangles) &&
+                        (collisionDetector->getNodes().size() == ((numTriangles > 0) ? (2 * numTriangles - 1) : 0));
+
+        // find texture path
+        string texturePath;
+        if ((mesh->m_texture != nullptr) && (mesh->m_texture->m_image != nullptr))
+        {
+            cImage* image = mesh->m_texture->m_image.get();
+            texturePath = image->getFilename();
+            if (texturePath.empty())
+            {
+                map<cImage*, string>::iterator it = savedImages.find(image);
+                if (it != savedImages.end())
+                {
+                    texturePath = it->second;
+                }
+                else
+                {
+                    texturePath = basename + "-texture" + cStr((int)(savedImages.size())) + ".png";
+                    if (!image->saveToFile(directory + texturePath))
+                    {
+                        texturePath.clear();
+                    }
+                    savedImages[image] = texturePath;
+                }
+            }
+        }
+
+        // setup mesh header
+        cMeshHeaderCMM meshHeader;
+        memset(&meshHeader, 0, sizeof(meshHeader));
+
+        cVector3d pos = mesh->getLocalPos();
+        cMatrix3d rot = mesh->getLocalRot();
+        for (int j=0; j<3; j++)
+        {
+            meshHeader.m_localPos[j] = pos(j);
+            for (int k=0; k<3; k++)
+            {
+                meshHeader.m_localRot[3*j+k] = rot(j,k);
+            }
+        }
+
+        _getColor(meshHeader.m_ambient, mesh->m_material->m_ambient);
+        _getColor(meshHeader.m_diffuse, mesh->m_material->m_diffuse);
+        _getColor(meshHeader.m_specular, mesh->m_material->m_specular);
+        _getColor(meshHeader.m_emission, mesh->m_material->m_emission);
+        meshHeader.m_shininess = mesh->m_material->getShininess();
+
+        bool useNormals = vertices->getUseNormalData() && (vertices->m_normal.size() == numVertices);
+        bool useTexCoords = vertices->getUseTexCoordData() && (vertices->m_texCoord.size() == numVertices);
+        bool useColors = vertices->getUseColorData() && (vertices->m_color.size() == numVertices);
+        bool useTangents = vertices->getUseTangentData() && (vertices->m_tangent.size() == numVertices);
+        bool useBitangents = vertices->getUseBitangentData() && (vertices->m_bitangent.size() == numVertices);
+
+        unsigned int flags = 0;
+        if (useNormals)                     { flags |= C_CMM_NORMALS; }
+        if (useTexCoords)                   { flags |= C_CMM_TEXCOORDS; }
+        if (useColors)                      { flags |= C_CMM_COLORS; }
+        if (useTangents)                    { flags |= C_CMM_TANGENTS; }
+        if (useBitangents)                  { flags |= C_CMM_BITANGENTS; }
+        if (mesh->getUseTexture())          { flags |= C_CMM_USE_TEXTURE; }
+        if (mesh->getUseVertexColors())     { flags |= C_CMM_USE_VERTEX_COLORS; }
+        if (mesh->getUseMaterial())         { flags |= C_CMM_USE_MATERIAL; }
+        if (mesh->getUseTransparency())     { flags |= C_CMM_USE_TRANSPARENCY; }
+        if (saveTree)                       { flags |= C_CMM_COLLISION_TREE; }
+
+        meshHeader.m_flags = flags;
+        meshHeader.m_numVertices = numVertices;
+        meshHeader.m_numTriangles = numAllocated;
+        meshHeader.m_nameLength = (uint32_t)(mesh->m_name.length());
+        meshHeader.m_textureLength = (uint32_t)(texturePath.length());
+        if (saveTree)
+        {
+            meshHeader.m_numNodes = (uint32_t)(collisionDetector->getNodes().size());
+            meshHeader.m_rootIndex = collisionDetector->getRootIndex();
+            meshHeader.m_collisionRadius = collisionDetector->getRadius();
+        }
+
+        // write mesh header, name and texture path
+        result = result && _writeBlock(file, &meshHeader, sizeof(meshHeader));
+        result = result && _writeBlock(file, mesh->m_name.c_str(), mesh->m_name.length());
+        result = result && _writeBlock(file, texturePath.c_str(), texturePath.length());
+
+        // write vertex data
+        size_t vectorSize = (size_t)numVertices * sizeof(cVector3d);
+        if (numVertices > 0)
+        {
+            result = result && _writeBlock(file, &(vertices->m_localPos[0]), vectorSize);
+            if (useNormals)     { result = result && _writeBlock(file, &(vertices->m_normal[0]), vectorSize); }
+            if (useTexCoords)   { result = result && _writeBlock(file, &(vertices->m_texCoord[0]), vectorSize); }
+            if (useTangents)    { result = result && _writeBlock(file, &(vertices->m_tangent[0]), vectorSize); }
+            if (useBitangents)  { result = result && _writeBlock(file, &(vertices->m_bitangent[0]), vectorSize); }
+            if (useColors)
+            {
+                vector<float> colors(4 * numVertices);
+                for (unsigned int j=0; j<numVertices; j++)
+                {
+                    _getColor(&colors[4*j], vertices->m_color[j]);
+                }
+                result = result && _writeBlock(file, &colors[0], colors.size() * sizeof(float));
+            }
+        }
+
+        // write triangle data
+        result = result && _writeBlock(file, indexData, (size_t)numAllocated * 3 * sizeof(unsigned int));
+
+        // write collision tree
+        if (saveTree && (meshHeader.m_numNodes > 0))
+        {
+            const vector<cCollisionAABBNode>& nodes = collisionDetector->getNodes();
+            vector<cNodeCMM> data(nodes.size());
+            for (unsigned int j=0; j<nodes.size(); j++)
+            {
+                for (int k=0; k<3; k++)
+                {
+                    data[j].m_min[k] = nodes[j].m_bbox.m_min(k);
+                    data[j].m_max[k] = nodes[j].m_bbox.m_max(k);
+                }
+                data[j].m_depth = nodes[j].m_depth;
+                data[j].m_nodeType = nodes[j].m_nodeType;
+                data[j].m_leftSubTree = nodes[j].m_leftSubTree;
+                data[j].m_rightSubTree = nodes[j].m_rightSubTree;
+            }
+            result = result && _writeBlock(file, &data[0], data.size() * sizeof(cNodeCMM));
+        }
+    }
+
+    // close file
+    if (fclose(file) != 0)
+        result = false;
+
+    // return result
+    return (result);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
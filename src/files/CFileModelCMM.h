@@ -0,0 +1,93 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CFileModelCMMH
+#define CFileModelCMMH
+//------------------------------------------------------------------------------
+#include "world/CMultiMesh.h"
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CFileModelCMM.h
+    \ingroup    files
+
+    \brief
+    Implements CHAI3D binary model cache (CMM) file support.
+
+    \details
+    CMM files store meshes exactly as they are held in memory once a model
+    has been loaded and optimized: vertex arrays, triangle indices, materials,
+    texture references and, optionally, the AABB collision tree of each mesh.
+    Arrays are aligned on 8-byte boundaries and stored in the native layout of
+    \ref cVertexArray and \ref cTriangleArray so that they can be copied in bulk 
+    from a memory-mapped file. Files are therefore written in the byte order
+    of the machine that created them; the header records it, and files 
+    written with a different byte order are rejected.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*!
+    \addtogroup files
+*/
+//------------------------------------------------------------------------------
+
+//@{
+
+//! This function loads a CHAI3D binary model cache file.
+bool cLoadFileCMM(cMultiMesh* a_object, const std::string& a_filename);
+
+//! This function saves a CHAI3D binary model cache file.
+bool cSaveFileCMM(cMultiMesh* a_object, const std::string& a_filename, const bool a_includeCollisionTree = true);
+
+//@}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
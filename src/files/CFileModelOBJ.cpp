@@ -45,6 +45,9 @@
 //------------------------------------------------------------------------------
 #include "files/CFileModelOBJ.h"
 //------------------------------------------------------------------------------
+#include "system/CFileMap.h"
+#include "system/CThreadPool.h"
+//------------------------------------------------------------------------------
 #include <iostream>
 #include <iomanip>
 #include <ostream>
@@ -52,6 +55,7 @@
 #include <algorithm>
 #include <string>
 #include <cstring>
+#include <cmath>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -91,7 +95,7 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
         a_object->deleteAllMeshes();
 
         // get information about file
-        int numMaterials = fileObj.m_OBJInfo.m_materialCount;
+        int numMaterials = (int)(fileObj.m_materials.size());
 
         // extract materials
         vector<cMaterial> materials;
@@ -121,7 +125,7 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
                 newMesh->setUseMaterial(true);
 
                 // get next material
-                cMaterialInfo material = fileObj.m_pMaterials[i];
+                cMaterialInfo& material = fileObj.m_materials[i];
 
                 int textureId = material.m_textureID;
                 if (textureId >= 1)
@@ -193,25 +197,21 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
             a_object->setUseTransparency(found_transparent_material, false);
         }
 
-        // Keep track of vertex mapping in each mesh; maps "old" vertices
-        // to new vertices
+        // Keep track of vertex mapping in each mesh; maps face vertices
+        // to mesh vertices
         int nMeshes = a_object->getNumMeshes();
-        vertexIndexSet_uint_map* vertexMaps = new vertexIndexSet_uint_map[nMeshes];
-        vertexIndexSet_uint_map::iterator vertexMapIter;
+        vector<cOBJVertexTable> vertexTables(nMeshes);
 
         // build object
         {
-            int i = 0;
-
-            // get triangles
-            int numTriangles = fileObj.m_OBJInfo.m_faceCount;
-            int j = 0;
-            if (numTriangles > 0)
+            // get faces
+            unsigned int numFaces = (unsigned int)(fileObj.m_faces.size());
+            if (numFaces > 0)
             {
-                while (j < numTriangles)
+                for (unsigned int j=0; j<numFaces; j++)
                 {
                     // get next face
-                    cFace face = fileObj.m_pFaces[j];
+                    const cOBJFace& face = fileObj.m_faces[j];
 
                     // get material index attributed to the face
                     int objIndex = face.m_materialIndex;
@@ -221,120 +221,114 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
 
                     // create a name for this mesh if necessary (over-writing a previous
                     // name if one has been written)
-                    if ( (face.m_groupIndex >= 0) && (fileObj.m_groupNames.size() > 0) )
+                    if (face.m_groupIndex >= 0)
                     {
                         curMesh->m_name = fileObj.m_groupNames[face.m_groupIndex];
                     }
 
-                    // get the vertex map for this mesh
-                    vertexIndexSet_uint_map* curVertexMap = &(vertexMaps[objIndex]);
+                    // faces with less than three vertices are ignored
+                    int vertCount = face.m_numCorners;
+                    if (vertCount < 3) { continue; }
+
+                    // get the vertex table for this mesh
+                    cOBJVertexTable* curVertexTable = &(vertexTables[objIndex]);
+
+                    // get face vertices. normals and texture coordinates are only
+                    // used if they are defined for every vertex of the face.
+                    const cOBJCorner* corners = &(fileObj.m_corners[face.m_firstCorner]);
+                    bool useNormals = true;
+                    bool useTexCoords = true;
+                    for (int k=0; k<vertCount; k++)
+                    {
+                        if (corners[k].m_normalIndex < 0) { useNormals = false; }
+                        if (corners[k].m_texCoordIndex < 0) { useTexCoords = false; }
+                    }
+
+                    cOBJCorner vis = corners[0];
+                    if (!useNormals) { vis.m_normalIndex = -1; }
+                    if (!useTexCoords) { vis.m_texCoordIndex = -1; }
 
-                    // number of vertices on face
-                    int vertCount = face.m_numVertices;
+                    int indexV1 = vis.m_vertexIndex;
+                    if (g_objLoaderShouldGenerateExtraVertices==false) 
+                    {
+                        indexV1 = curVertexTable->getVertexIndex(curMesh, &fileObj, vis);
+                    }                
 
-                    if (vertCount >= 3) 
+                    for (int triangleVert = 2; triangleVert < vertCount; triangleVert++)
                     {
-                        int indexV1 = face.m_pVertexIndices[0];
+                        const cOBJCorner& corner2 = corners[triangleVert-1];
+                        const cOBJCorner& corner3 = corners[triangleVert];
+
+                        int indexV2 = corner2.m_vertexIndex;
+                        int indexV3 = corner3.m_vertexIndex;
+                        if (g_objLoaderShouldGenerateExtraVertices==false) 
+                        {
+                            vis = corner2;
+                            if (!useNormals) { vis.m_normalIndex = -1; }
+                            if (!useTexCoords) { vis.m_texCoordIndex = -1; }
+                            indexV2 = curVertexTable->getVertexIndex(curMesh, &fileObj, vis);
+
+                            vis = corner3;
+                            if (!useNormals) { vis.m_normalIndex = -1; }
+                            if (!useTexCoords) { vis.m_texCoordIndex = -1; }
+                            indexV3 = curVertexTable->getVertexIndex(curMesh, &fileObj, vis);
+                        }
 
+                        unsigned int indexTriangle;
+
+                        // create triangle:
                         if (g_objLoaderShouldGenerateExtraVertices==false) 
                         {
-                            vertexIndexSet vis(indexV1);
-                            if (face.m_pNormals != NULL) vis.nIndex = face.m_pNormalIndices[0];
-                            if (face.m_pTexCoords != NULL) vis.tIndex = face.m_pTextureIndices[0];
-                            indexV1 = getVertexIndex(curMesh, &fileObj, curVertexMap, vis);
-                        }                
+                            indexTriangle = curMesh->newTriangle(indexV1,indexV2,indexV3);
+                            curMesh->m_triangles->computeNormal(indexTriangle, true);
+                        }
+                        else 
+                        {
+                            indexTriangle = curMesh->newTriangle(
+                                fileObj.m_vertices[indexV1],
+                                fileObj.m_vertices[indexV2],
+                                fileObj.m_vertices[indexV3]
+                            );
+                            curMesh->m_triangles->computeNormal(indexTriangle, true);
+                        }
 
-                        for (int triangleVert = 2; triangleVert < vertCount; triangleVert++)
+                        // assign normals:
+                        if (useNormals)
                         {
-                            int indexV2 = face.m_pVertexIndices[triangleVert-1];
-                            int indexV3 = face.m_pVertexIndices[triangleVert];
-                            if (g_objLoaderShouldGenerateExtraVertices==false) 
-                            {
-                                vertexIndexSet vis(indexV2);
-                                if (face.m_pNormals != NULL) vis.nIndex = face.m_pNormalIndices[triangleVert-1];
-                                if (face.m_pTexCoords) vis.tIndex = face.m_pTextureIndices[triangleVert-1];
-                                indexV2 = getVertexIndex(curMesh, &fileObj, curVertexMap, vis);
-                                vis.vIndex = indexV3;
-                                if (face.m_pNormals != NULL) vis.nIndex = face.m_pNormalIndices[triangleVert];
-                                if (face.m_pTexCoords) vis.tIndex = face.m_pTextureIndices[triangleVert];
-                                indexV3 = getVertexIndex(curMesh, &fileObj, curVertexMap, vis);
-                            }
-
-                            // for debugging, I want to look for degenerate triangles, but
-                            // I don't want to assert here.
-                            if (indexV1 == indexV2 || indexV2 == indexV3 || indexV1 == indexV3) 
-                            {
-                            }
-
-                            unsigned int indexTriangle;
-
-                            // create triangle:
-                            if (g_objLoaderShouldGenerateExtraVertices==false) 
-                            {
-                                indexTriangle = curMesh->newTriangle(indexV1,indexV2,indexV3);
-                                curMesh->m_triangles->computeNormal(indexTriangle, true);
-                            }
-                            else 
-                            {
-                                indexTriangle = curMesh->newTriangle(
-                                    fileObj.m_pVertices[indexV1],
-                                    fileObj.m_pVertices[indexV2],
-                                    fileObj.m_pVertices[indexV3]
-                                );
-                                curMesh->m_triangles->computeNormal(indexTriangle, true);
-                            }
-
-                            // assign normals:
-                            if (face.m_pNormals != NULL)
-                            {
-                                // set normals
-                                curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex0(indexTriangle), face.m_pNormals[0]);
-                                curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex1(indexTriangle), face.m_pNormals[triangleVert-1]);
-                                curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex2(indexTriangle), face.m_pNormals[triangleVert]);
-                            }
-
-                            // assign texture coordinates
-                            if (face.m_pTexCoords != NULL)
-                            {
-                                // set texture coordinates
-                                curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex0(indexTriangle), face.m_pTexCoords[0]);
-                                curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex1(indexTriangle), face.m_pTexCoords[triangleVert-1]);
-                                curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex2(indexTriangle), face.m_pTexCoords[triangleVert]);
-                            }
+                            // set normals
+                            curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex0(indexTriangle), cNormalize(fileObj.m_normals[corners[0].m_normalIndex]));
+                            curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex1(indexTriangle), cNormalize(fileObj.m_normals[corner2.m_normalIndex]));
+                            curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex2(indexTriangle), cNormalize(fileObj.m_normals[corner3.m_normalIndex]));
                         }
-                    }
-                    else 
-                    {
-                        // This faces doesn't have 3 vertices... this line is just
-                        // here for debugging, since this should never happen, but
-                        // I don't want to assert here.
-                    }
 
-                    j++;
+                        // assign texture coordinates
+                        if (useTexCoords)
+                        {
+                            // set texture coordinates
+                            curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex0(indexTriangle), fileObj.m_texCoords[corners[0].m_texCoordIndex]);
+                            curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex1(indexTriangle), fileObj.m_texCoords[corner2.m_texCoordIndex]);
+                            curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex2(indexTriangle), fileObj.m_texCoords[corner3.m_texCoordIndex]);
+                        }
+                    }
                 }
-                i++;
             }
             else
             {
                 // get number of vertices
-                int numVertices = fileObj.m_OBJInfo.m_vertexCount;
-                int j = 0;
+                unsigned int numVertices = (unsigned int)(fileObj.m_vertices.size());
 
                 // get main mesh
                 cMesh* mesh = a_object->getMesh(0);
 
                 // copy vertex and color data
-                while (j < numVertices)
+                for (unsigned int j=0; j<numVertices; j++)
                 {
-                    cColorf color = fileObj.m_pColors[j];
-                    cVector3d vertex = fileObj.m_pVertices[j];
-                    mesh->newVertex(vertex, cVector3d(1,0,0), cVector3d(0,0,0), color);
-                    j++;
+                    mesh->newVertex(fileObj.m_vertices[j], cVector3d(1,0,0), cVector3d(0,0,0), fileObj.m_colors[j]);
                 }
 
                 if (numVertices > 0)
                 {
-                    cColorf color = fileObj.m_pColors[j];
+                    cColorf color = fileObj.m_colors[numVertices-1];
                     if (color.m_flag_color)
                     {
                         mesh->setUseVertexColors(true);
@@ -346,7 +340,6 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
                 }
             }
         }
-        delete [] vertexMaps;
 
         // compute boundary boxes
         a_object->computeBoundaryBox(true);
@@ -593,44 +586,212 @@ bool cSaveFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
 // OBJ PARSER IMPLEMENTATION:
 //==============================================================================
 
-cOBJModel::cOBJModel()
+static const double _powersOfTen[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                       1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                       1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+//------------------------------------------------------------------------------
+
+static inline bool _isBlank(const char a_char)
 {
-    m_pVertices = NULL;
-    m_pColors = NULL;
-    m_pFaces = NULL;
-    m_pNormals = NULL;
-    m_pTexCoords = NULL;
-    m_pMaterials = NULL;
+    return ((a_char == ' ') || (a_char == '\t') || (a_char == '\r'));
 }
 
 //------------------------------------------------------------------------------
 
-cOBJModel::~cOBJModel()
+static inline const char* _skipBlanks(const char* a_str, const char* a_end)
+{
+    while ((a_str < a_end) && _isBlank(*a_str)) { a_str++; }
+    return (a_str);
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _skipToken(const char* a_str, const char* a_end)
+{
+    while ((a_str < a_end) && !_isBlank(*a_str) && (*a_str != '\n')) { a_str++; }
+    return (a_str);
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _skipLine(const char* a_str, const char* a_end)
 {
-    if (m_pVertices) delete [] m_pVertices;
-    if (m_pColors) delete [] m_pColors;
-    if (m_pNormals) delete [] m_pNormals;
-    if (m_pTexCoords) delete [] m_pTexCoords;
-    if (m_pMaterials) delete [] m_pMaterials;
-    if (m_pFaces)
+    const char* eol = (const char*)memchr(a_str, '\n', a_end - a_str);
+    return ((eol == NULL) ? a_end : eol + 1);
+}
+
+//------------------------------------------------------------------------------
+
+static std::string _readLine(const char* a_str, const char* a_end)
+{
+    // read the rest of the line, without leading and trailing blanks
+    const char* first = _skipBlanks(a_str, a_end);
+    const char* last = first;
+    while ((last < a_end) && (*last != '\n')) { last++; }
+    while ((last > first) && _isBlank(*(last-1))) { last--; }
+    return (std::string(first, last));
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _parseInt(const char* a_str, const char* a_end, int& a_value)
+{
+    const char* p = a_str;
+    bool negative = false;
+    if ((p < a_end) && ((*p == '-') || (*p == '+')))
     {
-        for (unsigned int i=0; i<m_OBJInfo.m_faceCount; i++)
+        negative = (*p == '-');
+        p++;
+    }
+
+    const char* digits = p;
+    int value = 0;
+    while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+    {
+        value = 10 * value + (*p - '0');
+        p++;
+    }
+    if (p == digits) { return (NULL); }
+
+    a_value = negative ? -value : value;
+    return (p);
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _parseFloat(const char* a_str, const char* a_end, double& a_value)
+{
+    const char* p = a_str;
+    bool negative = false;
+    if ((p < a_end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // read up to 18 significant digits of the mantissa
+    unsigned long long mantissa = 0;
+    int exponent = 0;
+    bool valid = false;
+    while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+    {
+        if (mantissa < 100000000000000000ULL) { mantissa = 10 * mantissa + (*p - '0'); }
+        else { exponent++; }
+        valid = true;
+        p++;
+    }
+    if ((p < a_end) && (*p == '.'))
+    {
+        p++;
+        while ((p < a_end) && (*p >= '0') && (*p <= '9'))
         {
-            // delete every pointer in the face structure
-            if (m_pFaces[i].m_pNormals) delete [] m_pFaces[i].m_pNormals;
-            if (m_pFaces[i].m_pNormalIndices) delete [] m_pFaces[i].m_pNormalIndices;
-            if (m_pFaces[i].m_pTexCoords)  delete [] m_pFaces[i].m_pTexCoords;
-            if (m_pFaces[i].m_pTextureIndices) delete [] m_pFaces[i].m_pTextureIndices;
-            if (m_pFaces[i].m_pVertices)  delete [] m_pFaces[i].m_pVertices;
-            if (m_pFaces[i].m_pColors)  delete [] m_pFaces[i].m_pColors;
-            if (m_pFaces[i].m_pVertexIndices)  delete [] m_pFaces[i].m_pVertexIndices;
+            if (mantissa < 100000000000000000ULL) { mantissa = 10 * mantissa + (*p - '0'); exponent--; }
+            valid = true;
+            p++;
         }
-        delete [] m_pFaces;
     }
-    for(unsigned int i=0; i<m_groupNames.size(); i++) 
+
+    // special values (nan, inf) and unusual notations are left to the C library
+    if (!valid)
     {
-        delete [] m_groupNames[i];
+        const char* end = _skipToken(a_str, a_end);
+        char str[64];
+        size_t length = cMin((size_t)(end - a_str), sizeof(str) - 1);
+        if (length == 0) { return (NULL); }
+        memcpy(str, a_str, length);
+        str[length] = '\0';
+
+        char* last;
+        a_value = strtod(str, &last);
+        if (last == str) { return (NULL); }
+        return (a_str + (last - str));
     }
+
+    // exponent
+    if ((p < a_end) && ((*p == 'e') || (*p == 'E')))
+    {
+        int value;
+        const char* next = _parseInt(p + 1, a_end, value);
+        if (next != NULL)
+        {
+            exponent += cClamp(value, -1000, 1000);
+            p = next;
+        }
+    }
+
+    // the conversion is exact when both the mantissa and the power of ten are 
+    // representable as doubles
+    double value = (double)(mantissa);
+    if (mantissa == 0)
+    {
+        value = 0.0;
+    }
+    else if ((mantissa < (1ULL << 53)) && (exponent >= -22) && (exponent <= 22))
+    {
+        if (exponent < 0) { value /= _powersOfTen[-exponent]; }
+        else              { value *= _powersOfTen[exponent]; }
+    }
+    else
+    {
+        value *= pow(10.0, (double)(exponent));
+    }
+
+    a_value = negative ? -value : value;
+    return (p);
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _parseFloats(const char* a_str, const char* a_end, double* a_values, const int a_maxCount, int& a_count)
+{
+    a_count = 0;
+    while (a_count < a_maxCount)
+    {
+        a_str = _skipBlanks(a_str, a_end);
+        const char* next = _parseFloat(a_str, a_end, a_values[a_count]);
+        if (next == NULL) { break; }
+
+        // values are stored in single precision in the file
+        a_values[a_count] = (double)((float)(a_values[a_count]));
+        a_str = next;
+        a_count++;
+    }
+    return (a_str);
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _parseIndex(const char* a_str, const char* a_end, const size_t a_count,
+                                      int& a_index, std::vector<unsigned int>& a_relativeCorners, const unsigned int a_corner)
+{
+    int value;
+    const char* next = _parseInt(a_str, a_end, value);
+    if (next == NULL) { return (a_str); }
+
+    if (value > 0)
+    {
+        a_index = value - 1;
+    }
+    else if (value < 0)
+    {
+        // relative index, offset later by the number of elements in previous chunks
+        a_index = (int)(a_count) + value;
+        a_relativeCorners.push_back(a_corner);
+    }
+    return (next);
+}
+
+//------------------------------------------------------------------------------
+
+cOBJModel::cOBJModel()
+{
+}
+
+//------------------------------------------------------------------------------
+
+cOBJModel::~cOBJModel()
+{
 }
 
 //------------------------------------------------------------------------------
@@ -638,200 +799,107 @@ cOBJModel::~cOBJModel()
 bool cOBJModel::LoadModel(const char a_fileName[])
 {
     /////////////////////////////////////////////////////////////////////////
-    // LOAD A OBJ FILE AND RENDER ITS DATA INTO A DISPLAY LIST
+    // MAP THE OBJ FILE INTO MEMORY
     /////////////////////////////////////////////////////////////////////////
 
-    cOBJFileInfo currentIndex;          // current array index
-    char str[C_OBJ_MAX_STR_SIZE] = "";  // buffer string for reading the file
     char basePath[C_OBJ_SIZE_PATH];     // path were all paths in the OBJ start
-    unsigned int curMaterial = 0;       // current material
 
     // get base path
-    strcpy(basePath, a_fileName);
+    strncpy(basePath, a_fileName, C_OBJ_SIZE_PATH - 1);
+    basePath[C_OBJ_SIZE_PATH - 1] = '\0';
     makePath(basePath);
 
-    /////////////////////////////////////////////////////////////////////////
-    // OPEN THE OBJ FILE
-    /////////////////////////////////////////////////////////////////////////
-    FILE *hFile = fopen(a_fileName, "r");
-
-    // success opening file?
-    if (!hFile)
+    cFileMap file;
+    if (!file.open(a_fileName))
     {
         return (false);
     }
 
-    /////////////////////////////////////////////////////////////////////////
-    // ALLOCATE SPACE FOR STRUCTURES THAT HOLD THE MODEL DATA
-    /////////////////////////////////////////////////////////////////////////
+    const char* data = file.getData();
+    size_t size = file.getSize();
 
-    // which data types are stored in the file? how many of each type?
-    getFileInfo(hFile, &m_OBJInfo, basePath);
-
-    // vertices and faces
-    if (m_pVertices) delete [] m_pVertices;
-    if (m_pColors) delete [] m_pColors;
-    if (m_pFaces) delete [] m_pFaces;
-    m_pVertices = new cVector3d[m_OBJInfo.m_vertexCount];
-    m_pColors = new cColorf[m_OBJInfo.m_vertexCount];
-    m_pFaces = new cFace[m_OBJInfo.m_faceCount];
-
-    // allocate space for optional model data only if present.
-    if (m_pNormals) { delete [] m_pNormals; m_pNormals = NULL; }
-    if (m_pTexCoords) { delete [] m_pTexCoords; m_pTexCoords = NULL; }
-    if (m_pMaterials) { delete [] m_pMaterials; m_pMaterials = NULL; }
-    if (m_OBJInfo.m_normalCount)
-        m_pNormals = new cVector3d[m_OBJInfo.m_normalCount];
-    if (m_OBJInfo.m_texCoordCount)
-        m_pTexCoords = new cVector3d[m_OBJInfo.m_texCoordCount];
-    if (m_OBJInfo.m_materialCount)
-        m_pMaterials = new cMaterialInfo[m_OBJInfo.m_materialCount];
-
-    // init structure that holds the current array index
-    currentIndex.init();
 
     /////////////////////////////////////////////////////////////////////////
-    // READ THE FILE CONTENTS
+    // PARSE CHUNKS OF COMPLETE LINES IN PARALLEL
     /////////////////////////////////////////////////////////////////////////
 
-    // start reading the file from the start
-    rewind(hFile);
+    cThreadPool* threadPool = cThreadPool::getSharedThreadPool();
+    size_t maxChunks = 4 * cMax(1u, threadPool->getNumThreads());
+    unsigned int numChunks = (unsigned int)(cMax((size_t)(1), cMin(size / C_OBJ_MIN_CHUNK_SIZE, maxChunks)));
 
-    // quit reading when end of file has been reached
-    while (!feof(hFile))
+    // chunk boundaries are moved to the beginning of the next line
+    vector<const char*> bounds(numChunks + 1);
+    bounds[0] = data;
+    bounds[numChunks] = data + size;
+    for (unsigned int i=1; i<numChunks; i++)
     {
-        // get next string
-        readNextString(str, sizeof(str), hFile);
-
-        // next three elements are floats of a vertex
-        if (!strncmp(str, C_OBJ_VERTEX_ID, sizeof(C_OBJ_VERTEX_ID)))
-        {
-            // read three floats out of the file
-            float fx = 0.0f, fy = 0.0f, fz = 0.0f, cr = 0.0f, cg = 0.0f, cb = 0.0f;
-            if (fscanf(hFile, "%f %f %f %f %f %f", &fx, &fy, &fz, &cr, &cg, &cb) > 0)
-            {
-                m_pVertices[currentIndex.m_vertexCount](0)  = fx;
-                m_pVertices[currentIndex.m_vertexCount](1)  = fy;
-                m_pVertices[currentIndex.m_vertexCount](2)  = fz;
-                m_pColors[currentIndex.m_vertexCount].set(cr, cg, cb);
-                m_pColors[currentIndex.m_vertexCount].m_flag_color = true;
-            }
-            else if (fscanf(hFile, "%f %f %f", &fx, &fy, &fz) > 0)
-            {
-                m_pVertices[currentIndex.m_vertexCount](0)  = fx;
-                m_pVertices[currentIndex.m_vertexCount](1)  = fy;
-                m_pVertices[currentIndex.m_vertexCount](2)  = fz;
-                m_pColors[currentIndex.m_vertexCount].set(0,0,0);
-                m_pColors[currentIndex.m_vertexCount].m_flag_color = false;
-            }
+        const char* p = cMax(data + (size * i) / numChunks, bounds[i-1]);
+        bounds[i] = _skipLine(p, data + size);
+    }
 
-            // next vertex
-            currentIndex.m_vertexCount++;
-        }
+    vector<cOBJChunk> chunks(numChunks);
+    threadPool->parallelFor(numChunks, [&](unsigned int a_index)
+    {
+        parseChunk(bounds[a_index], bounds[a_index+1], chunks[a_index]);
+    });
 
-        // next two elements are floats of a texture coordinate
-        else if (!strncmp(str, C_OBJ_TEXCOORD_ID, sizeof(C_OBJ_TEXCOORD_ID)))
-        {
-            // read two floats out of the file
-            float fx = 0.0f, fy = 0.0f, fz = 0.0f;
-            if (fscanf(hFile, "%f %f %f", &fx, &fy, &fz) > 0)
-            {
-                m_pTexCoords[currentIndex.m_texCoordCount](0)  = fx;
-                m_pTexCoords[currentIndex.m_texCoordCount](1)  = fy;
-                m_pTexCoords[currentIndex.m_texCoordCount](2)  = fz;
-            }
 
-            // next texture coordinate
-            currentIndex.m_texCoordCount++;
-        }
+    /////////////////////////////////////////////////////////////////////////
+    // MERGE CHUNKS IN FILE ORDER
+    /////////////////////////////////////////////////////////////////////////
 
-        // next three elements are floats of a vertex normal
-        else if (!strncmp(str, C_OBJ_NORMAL_ID, sizeof(C_OBJ_NORMAL_ID)))
-        {
-            // read three floats out of the file
-            float fx = 0.0f, fy = 0.0f, fz = 0.0f;
-            if (fscanf(hFile, "%f %f %f", &fx, &fy, &fz) > 0)
-            {
-                m_pNormals[currentIndex.m_normalCount](0)  = fx;
-                m_pNormals[currentIndex.m_normalCount](1)  = fy;
-                m_pNormals[currentIndex.m_normalCount](2)  = fz;
-            }
+    size_t numVertices = 0, numTexCoords = 0, numNormals = 0, numCorners = 0, numFaces = 0;
+    for (unsigned int i=0; i<numChunks; i++)
+    {
+        numVertices  += chunks[i].m_vertices.size();
+        numTexCoords += chunks[i].m_texCoords.size();
+        numNormals   += chunks[i].m_normals.size();
+        numCorners   += chunks[i].m_corners.size();
+        numFaces     += chunks[i].m_faces.size();
+    }
 
-            // next normal
-            currentIndex.m_normalCount++;
-        }
+    m_vertices.reserve(numVertices);
+    m_colors.reserve(numVertices);
+    m_texCoords.reserve(numTexCoords);
+    m_normals.reserve(numNormals);
+    m_corners.reserve(numCorners);
+    m_faces.reserve(numFaces);
 
-        // rest of the line contains face information
-        else if (!strncmp(str, C_OBJ_FACE_ID, sizeof(C_OBJ_FACE_ID)))
-        {
-            // read the rest of the line (the complete face)
-            getTokenParameter(str, sizeof(str) ,hFile);
+    unsigned int curMaterial = 0;       // current material
+    int curGroup = -1;                  // current group
+    for (unsigned int i=0; i<numChunks; i++)
+    {
+        mergeChunk(chunks[i], curMaterial, curGroup, basePath);
 
-            // convert string into a face structure
-            parseFaceString(str, &m_pFaces[currentIndex.m_faceCount],
-            m_pVertices, m_pNormals, m_pTexCoords, curMaterial);
-            
-            // next face
-            currentIndex.m_faceCount++;
-        }
+        // release chunk memory
+        cOBJChunk empty;
+        std::swap(chunks[i], empty);
+    }
 
-        // rest of the line contains face information
-        else if (!strncmp(str, C_OBJ_NAME_ID, sizeof(C_OBJ_NAME_ID)))
-        {
-            // read the rest of the line (the complete face)
-            getTokenParameter(str, sizeof(str) ,hFile);
 
-            char* name = new char[strlen(str)+1];
-            strcpy(name,str);
-            m_groupNames.push_back(name);
-        }
+    /////////////////////////////////////////////////////////////////////////
+    // VALIDATE INDICES
+    /////////////////////////////////////////////////////////////////////////
 
-        // process material information only if needed
-        if (m_pMaterials)
+    // faces that refer to missing vertices are discarded. references to 
+    // missing texture coordinates or normals are ignored.
+    numFaces = m_faces.size();
+    for (unsigned int i=0; i<numFaces; i++)
+    {
+        cOBJFace& face = m_faces[i];
+        for (unsigned int j=0; j<face.m_numCorners; j++)
         {
-            // rest of the line contains the name of a material
-            if (!strncmp(str, C_OBJ_USE_MTL_ID, sizeof(C_OBJ_USE_MTL_ID)))
-            {
-                // read the rest of the line (the complete material name)
-                getTokenParameter(str, sizeof(str), hFile);
-
-                // are any materials loaded ?
-                if (m_pMaterials)
-                {
-                    // find material array index for the material name
-                    for (unsigned i=0; i<m_OBJInfo.m_materialCount; i++)
-                    if (!strncmp(m_pMaterials[i].m_name, str, sizeof(str)))
-                    {
-                        curMaterial = i;
-                        break;
-                    }
-                }
-            }
-
-            // rest of the line contains the filename of a material library
-            else if (!strncmp(str, C_OBJ_MTL_LIB_ID, sizeof(C_OBJ_MTL_LIB_ID)))
+            cOBJCorner& corner = m_corners[face.m_firstCorner + j];
+            if ((corner.m_vertexIndex < 0) || ((size_t)(corner.m_vertexIndex) >= numVertices))
             {
-                // read the rest of the line (the complete filename)
-                getTokenParameter(str, sizeof(str), hFile);
-
-                // append material library filename to the model's base path
-                char libraryFile[C_OBJ_SIZE_PATH];
-                strcpy(libraryFile, basePath);
-                strcat(libraryFile, str);
-
-                // append .mtl
-                // strcat(szLibraryFile, ".mtl");
-
-                // load the material library
-                loadMaterialLib(libraryFile, m_pMaterials,
-                    &currentIndex.m_materialCount, basePath);
+                face.m_numCorners = 0;
+                break;
             }
+            if ((size_t)(corner.m_texCoordIndex) >= numTexCoords) { corner.m_texCoordIndex = -1; }
+            if ((size_t)(corner.m_normalIndex) >= numNormals) { corner.m_normalIndex = -1; }
         }
     }
 
-    // close OBJ file
-    fclose(hFile);
-
     /////////////////////////////////////////////////////////////////////////
     // SUCCESS
     /////////////////////////////////////////////////////////////////////////
@@ -840,222 +908,237 @@ bool cOBJModel::LoadModel(const char a_fileName[])
 
 //------------------------------------------------------------------------------
 
-void cOBJModel::parseFaceString(char a_faceString[], cFace *a_faceOut,
-                const cVector3d *a_pVertices,
-                const cVector3d *a_pNormals,
-                const cVector3d *a_pTexCoords,
-                const unsigned int a_materialIndex)
+void cOBJModel::parseChunk(const char* a_begin, const char* a_end, cOBJChunk& a_chunk)
 {
     /////////////////////////////////////////////////////////////////////////
-    // CONVERT FACE STRING FROM THE OBJ FILE INTO A FACE STRUCTURE
+    // PARSE ALL LINES OF A CHUNK
     /////////////////////////////////////////////////////////////////////////
 
-    unsigned int i;
-    int iVertex = 0;
-    int iTextureCoord = 0;
-    int iNormal = 0;
-
-    // pointer to the face string. will be incremented later to
-    // advance to the next triplet in the string.
-    char *pFaceString = a_faceString;
+    const char* p = a_begin;
+    while (p < a_end)
+    {
+        // read identifier
+        p = _skipBlanks(p, a_end);
+        const char* id = p;
+        p = _skipToken(p, a_end);
+        size_t length = p - id;
+
+        // next three elements are floats of a vertex, optionally followed by a color
+        if ((length == 1) && (id[0] == 'v'))
+        {
+            double values[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+            int count;
+            p = _parseFloats(p, a_end, values, 6, count);
 
-    // save the string positions of all triplets
-    int iTripletPos[C_OBJ_MAX_VERTICES];
-    int iCurTriplet = 0;
+            a_chunk.m_vertices.push_back(cVector3d(values[0], values[1], values[2]));
 
-    // init the face structure
-    a_faceOut->init();
+            cColorf color;
+            color.set((float)values[3], (float)values[4], (float)values[5], 1.0f);
+            color.setModificationFlags(count >= 6);
+            a_chunk.m_colors.push_back(color);
+        }
 
-    // the first vertex always starts at position 0 in the string
-    iTripletPos[0] = 0;
-    a_faceOut->m_numVertices = 1;
-    iCurTriplet++;
-      
-    if (m_groupNames.size() > 0) a_faceOut->m_groupIndex = (int)(m_groupNames.size() - 1);
-    else a_faceOut->m_groupIndex = -1;
+        // next two or three elements are floats of a texture coordinate
+        else if ((length == 2) && (id[0] == 'v') && (id[1] == 't'))
+        {
+            double values[3] = { 0.0, 0.0, 0.0 };
+            int count;
+            p = _parseFloats(p, a_end, values, 3, count);
 
-    /////////////////////////////////////////////////////////////////////////
-    // GET NUMBER OF VERTICES IN THE FACE
-    /////////////////////////////////////////////////////////////////////////
+            a_chunk.m_texCoords.push_back(cVector3d(values[0], values[1], values[2]));
+        }
 
-    // loop trough the whole string
-    bool detectedSpace = false;
-    for (i=0; i<strlen(a_faceString); i++)
-    {
-        if (!detectedSpace)
+        // next three elements are floats of a vertex normal
+        else if ((length == 2) && (id[0] == 'v') && (id[1] == 'n'))
         {
-            // each triplet is separated by spaces
-            if (a_faceString[i] == ' ')
-            {
-                detectedSpace = true;
-            }
+            double values[3] = { 0.0, 0.0, 0.0 };
+            int count;
+            p = _parseFloats(p, a_end, values, 3, count);
+
+            a_chunk.m_normals.push_back(cVector3d(values[0], values[1], values[2]));
         }
-        else
+
+        // rest of the line contains face information (i, i/j, i/j/k, i//k)
+        else if ((length == 1) && (id[0] == 'f'))
         {
-            if (a_faceString[i] != ' ')
+            cOBJFace face;
+            face.m_firstCorner = (unsigned int)(a_chunk.m_corners.size());
+            face.m_numCorners = 0;
+            face.m_materialIndex = 0;
+            face.m_groupIndex = -1;
+
+            while (true)
             {
-                // one more vertex
-                a_faceOut->m_numVertices++;
-                
-                // save position of triplet
-                iTripletPos[iCurTriplet] = i;
-                
-                // next triplet
-                iCurTriplet++;
-
-                // reset for next group of spaces
-                detectedSpace = false;
-            }
-        }
-    }
+                p = _skipBlanks(p, a_end);
+                if ((p >= a_end) || (*p == '\n')) { break; }
 
+                unsigned int index = (unsigned int)(a_chunk.m_corners.size());
+                cOBJCorner corner;
+                corner.m_vertexIndex = -1;
+                corner.m_texCoordIndex = -1;
+                corner.m_normalIndex = -1;
 
-    /////////////////////////////////////////////////////////////////////////
-    // CHECK DATA FORMAT OF FACE: (i, i/j, i/j/k, i//k)
-    /////////////////////////////////////////////////////////////////////////
+                p = _parseIndex(p, a_end, a_chunk.m_vertices.size(), corner.m_vertexIndex, a_chunk.m_relativeCorners[0], index);
+                if ((p < a_end) && (*p == '/'))
+                {
+                    p++;
+                    if ((p < a_end) && (*p != '/'))
+                    {
+                        p = _parseIndex(p, a_end, a_chunk.m_texCoords.size(), corner.m_texCoordIndex, a_chunk.m_relativeCorners[1], index);
+                    }
+                    if ((p < a_end) && (*p == '/'))
+                    {
+                        p++;
+                        p = _parseIndex(p, a_end, a_chunk.m_normals.size(), corner.m_normalIndex, a_chunk.m_relativeCorners[2], index);
+                    }
+                }
 
-    // mode
-    int mode = 0;
+                // skip anything left in malformed triplets
+                p = _skipToken(p, a_end);
 
-    // copy a vertex block
-    char vertexStr[100];
-    strncpy (vertexStr, pFaceString, iTripletPos[1]);
+                a_chunk.m_corners.push_back(corner);
+                face.m_numCorners++;
+            }
 
-    char* p = strstr(vertexStr, "//");
-    if (p != NULL)
-    {
-        // format: i//k
-        mode = 3;
-    }
-    else
-    {
-        char* first = strstr(vertexStr, "/");
-        if (first == NULL)
+            a_chunk.m_faces.push_back(face);
+        }
+
+        // rest of the line contains a group name
+        else if ((length == 1) && (id[0] == 'g'))
         {
-            // format i
-            mode = 1;
+            cOBJCommand command;
+            command.m_type = C_OBJ_COMMAND_NAME;
+            command.m_faceIndex = (unsigned int)(a_chunk.m_faces.size());
+            command.m_argument = _readLine(p, a_end);
+            a_chunk.m_commands.push_back(command);
         }
-        else
+
+        // rest of the line contains the name of a material
+        else if ((length == 6) && (strncmp(id, C_OBJ_USE_MTL_ID, 6) == 0))
         {
-            char* second = strstr(first, "/");
-            if (second != NULL)
-            {
-                // format i/j/k
-                mode = 4;
-            }
-            else
-            {
-                // format: i/j
-                mode = 2;
-            }
+            cOBJCommand command;
+            command.m_type = C_OBJ_COMMAND_USE_MTL;
+            command.m_faceIndex = (unsigned int)(a_chunk.m_faces.size());
+            command.m_argument = _readLine(p, a_end);
+            a_chunk.m_commands.push_back(command);
+        }
+
+        // rest of the line contains the filename of a material library
+        else if ((length == 6) && (strncmp(id, C_OBJ_MTL_LIB_ID, 6) == 0))
+        {
+            cOBJCommand command;
+            command.m_type = C_OBJ_COMMAND_MTL_LIB;
+            command.m_faceIndex = (unsigned int)(a_chunk.m_faces.size());
+            command.m_argument = _readLine(p, a_end);
+            a_chunk.m_commands.push_back(command);
         }
+
+        // comments and unsupported statements are ignored
+        p = _skipLine(p, a_end);
     }
+}
 
+//------------------------------------------------------------------------------
+
+void cOBJModel::mergeChunk(cOBJChunk& a_chunk, 
+                           unsigned int& a_curMaterial, 
+                           int& a_curGroup, 
+                           const char a_basePath[])
+{
     /////////////////////////////////////////////////////////////////////////
-    // ALLOCATE SPACE FOR STRUCTURES THAT HOLD THE FACE DATA
+    // APPEND CHUNK DATA TO THE MODEL
     /////////////////////////////////////////////////////////////////////////
 
-    // vertices
-    a_faceOut->m_pVertices = new cVector3d[a_faceOut->m_numVertices];
-    a_faceOut->m_pVertexIndices = new int[a_faceOut->m_numVertices];
-
-    // allocate space for normals and texture coordinates only if present
-    if ((mode == 3) || (mode == 4))
+    // resolve relative indices
+    int offsets[3] = { (int)(m_vertices.size()), (int)(m_texCoords.size()), (int)(m_normals.size()) };
+    for (unsigned int i=0; i<a_chunk.m_relativeCorners[0].size(); i++)
     {
-        a_faceOut->m_pNormals = new cVector3d[a_faceOut->m_numVertices];
-        a_faceOut->m_pNormalIndices = new int[a_faceOut->m_numVertices];
+        a_chunk.m_corners[a_chunk.m_relativeCorners[0][i]].m_vertexIndex += offsets[0];
     }
-    else
+    for (unsigned int i=0; i<a_chunk.m_relativeCorners[1].size(); i++)
     {
-        a_faceOut->m_pNormals = NULL;
-        a_faceOut->m_pNormalIndices = NULL;
+        a_chunk.m_corners[a_chunk.m_relativeCorners[1][i]].m_texCoordIndex += offsets[1];
     }
-
-    // allocate space for texture coordinates
-    if ((mode == 2) || (mode == 4)) 
-    {  
-        a_faceOut->m_pTexCoords = new cVector3d[a_faceOut->m_numVertices];
-        a_faceOut->m_pTextureIndices = new int[a_faceOut->m_numVertices];
-    }
-    else 
+    for (unsigned int i=0; i<a_chunk.m_relativeCorners[2].size(); i++)
     {
-        a_faceOut->m_pTexCoords = NULL;
-        a_faceOut->m_pTextureIndices = NULL;
+        a_chunk.m_corners[a_chunk.m_relativeCorners[2][i]].m_normalIndex += offsets[2];
     }
 
+    unsigned int cornerOffset = (unsigned int)(m_corners.size());
+
+    m_vertices.insert(m_vertices.end(), a_chunk.m_vertices.begin(), a_chunk.m_vertices.end());
+    m_colors.insert(m_colors.end(), a_chunk.m_colors.begin(), a_chunk.m_colors.end());
+    m_texCoords.insert(m_texCoords.end(), a_chunk.m_texCoords.begin(), a_chunk.m_texCoords.end());
+    m_normals.insert(m_normals.end(), a_chunk.m_normals.begin(), a_chunk.m_normals.end());
+    m_corners.insert(m_corners.end(), a_chunk.m_corners.begin(), a_chunk.m_corners.end());
+
+
     /////////////////////////////////////////////////////////////////////////
-    // COPY VERTEX, NORMAL, MATERIAL AND TEXTURE DATA INTO THE STRUCTURE
+    // APPLY MATERIAL AND GROUP COMMANDS TO FACES
     /////////////////////////////////////////////////////////////////////////
 
-    // set material
-    a_faceOut->m_materialIndex = a_materialIndex;
+    unsigned int numFaces = (unsigned int)(a_chunk.m_faces.size());
+    unsigned int numCommands = (unsigned int)(a_chunk.m_commands.size());
+    unsigned int curCommand = 0;
 
-    // process per-vertex data
-    for (i=0; i<(unsigned int) a_faceOut->m_numVertices; i++)
+    for (unsigned int i=0; i<=numFaces; i++)
     {
-        // read one triplet from the face string
-
-        // are vertices, normals and texture coordinates present ?
-        if (mode == 4)
-        {
-            sscanf(pFaceString, "%i/%i/%i",
-            &iVertex, &iTextureCoord, &iNormal);
-        }
-        else if (mode == 3)
-        {
-            // vertices and normals but no texture coordinates
-            sscanf(pFaceString, "%i//%i", &iVertex, &iNormal);
-        }
-        else if (mode == 2)
-        {
-            // vertices and texture coordinates but no normals
-            sscanf(pFaceString, "%i/%i", &iVertex, &iTextureCoord);
-        }
-        else if (mode == 1)
+        // process commands that precede the face
+        while ((curCommand < numCommands) && (a_chunk.m_commands[curCommand].m_faceIndex <= i))
         {
-            // only vertices
-            sscanf(pFaceString, "%i", &iVertex);
-        }
+            const cOBJCommand& command = a_chunk.m_commands[curCommand];
+
+            if (command.m_type == C_OBJ_COMMAND_MTL_LIB)
+            {
+                // append material library filename to the model's base path
+                string libraryFile = string(a_basePath) + command.m_argument;
+
+                // load the material library
+                loadMaterialLib(libraryFile.c_str(), a_basePath);
+            }
+            else if (command.m_type == C_OBJ_COMMAND_USE_MTL)
+            {
+                // find material array index for the material name
+                for (unsigned int j=0; j<m_materials.size(); j++)
+                {
+                    if (command.m_argument == m_materials[j].m_name)
+                    {
+                        a_curMaterial = j;
+                        break;
+                    }
+                }
+            }
+            else if (command.m_type == C_OBJ_COMMAND_NAME)
+            {
+                m_groupNames.push_back(command.m_argument);
+                a_curGroup = (int)(m_groupNames.size() - 1);
+            }
 
-        // copy vertex into the face. Also check for normals and texture
-        // coordinates and copy them if present.
-        memcpy(&a_faceOut->m_pVertices[i], &m_pVertices[iVertex - 1],
-        sizeof(cVector3d));
-        a_faceOut->m_pVertexIndices[i] = iVertex-1;
-
-        if ((mode == 2) || (mode == 4)) 
-        {    
-            memcpy(&a_faceOut->m_pTexCoords[i],
-            &m_pTexCoords[iTextureCoord - 1], sizeof(cVector3d));
-            a_faceOut->m_pTextureIndices[i] = iTextureCoord-1;
+            curCommand++;
         }
-        if ((mode == 3) || (mode == 4)) 
+
+        // append face
+        if (i < numFaces)
         {
-            memcpy(&a_faceOut->m_pNormals[i],
-            &m_pNormals[iNormal - 1], sizeof(cVector3d));
-            a_faceOut->m_pNormals[i].normalize();
-            a_faceOut->m_pNormalIndices[i] = iNormal-1;
+            cOBJFace face = a_chunk.m_faces[i];
+            face.m_firstCorner += cornerOffset;
+            face.m_materialIndex = a_curMaterial;
+            face.m_groupIndex = a_curGroup;
+            m_faces.push_back(face);
         }
-
-        // set string pointer to the next triplet
-        pFaceString = &a_faceString[iTripletPos[i+1]];
     }
 }
 
 //------------------------------------------------------------------------------
 
 bool cOBJModel::loadMaterialLib(const char a_fileName[],
-                cMaterialInfo* a_pMaterials,
-                unsigned int* a_curMaterialIndex,
-                char a_basePath[])
+                const char a_basePath[])
 {
     //----------------------------------------------------------------------
     // loads a material library file (.mtl)
     //----------------------------------------------------------------------
 
     char str[C_OBJ_MAX_STR_SIZE];       // buffer used while reading the file.
-    bool bFirstMaterial = true;         // only increase index after first
-                                        // material has been set.
 
     /////////////////////////////////////////////////////////////////////////
     // OPEN LIBRARY FILE
@@ -1073,47 +1156,49 @@ bool cOBJModel::loadMaterialLib(const char a_fileName[],
     // READ ALL MATERIAL DEFINITIONS
     /////////////////////////////////////////////////////////////////////////
 
+    // properties are only read once a material has been declared
+    cMaterialInfo* material = NULL;
+
     // quit reading when end of file has been reached
     while (!feof(hFile))
     {
         // get next string
+        str[0] = '\0';
         readNextString(str, sizeof(str), hFile);
 
         // is it a "new material" identifier ?
         if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
         {
-            // only increase index after first material has been set
-            if (bFirstMaterial == true)
-            {
-                // first material has been set
-                bFirstMaterial = false;
-            }
-            else
-            {
-                // use next index
-                (*a_curMaterialIndex)++;
-            }
+            // add material
+            m_materials.push_back(cMaterialInfo());
+            material = &(m_materials.back());
 
             // read material name
             getTokenParameter(str, sizeof(str), hFile);
 
             // store material name in the structure
-            strcpy(m_pMaterials[*a_curMaterialIndex].m_name, str);
+            strncpy(material->m_name, str, sizeof(material->m_name) - 1);
+            material->m_name[sizeof(material->m_name) - 1] = '\0';
+        }
+
+        if (material == NULL)
+        {
+            continue;
         }
 
         // transparency
         if (!strncmp(str, C_OBJ_MTL_ALPHA_ID_ALT, sizeof(C_OBJ_MTL_ALPHA_ID_ALT)))
         {
             // read into current material
-            if (fscanf(hFile, "%f", &m_pMaterials[*a_curMaterialIndex].m_alpha) < 0) return(false);
-            m_pMaterials[*a_curMaterialIndex].m_alpha = 1.0 - m_pMaterials[*a_curMaterialIndex].m_alpha;
+            if (fscanf(hFile, "%f", &material->m_alpha) < 0) break;
+            material->m_alpha = 1.0f - material->m_alpha;
         }
 
         // opacity
         if (!strncmp(str, C_OBJ_MTL_ALPHA_ID, sizeof(C_OBJ_MTL_ALPHA_ID)))
         {
             // read into current material
-            if (fscanf(hFile, "%f", &m_pMaterials[*a_curMaterialIndex].m_alpha) < 0) return(false);
+            if (fscanf(hFile, "%f", &material->m_alpha) < 0) break;
         }
 
         // ambient material properties
@@ -1121,9 +1206,9 @@ bool cOBJModel::loadMaterialLib(const char a_fileName[],
         {
             // read into current material
             if (fscanf(hFile, "%f %f %f",
-                &m_pMaterials[*a_curMaterialIndex].m_ambient[0],
-                &m_pMaterials[*a_curMaterialIndex].m_ambient[1],
-                &m_pMaterials[*a_curMaterialIndex].m_ambient[2]) < 0) return(false);
+                &material->m_ambient[0],
+                &material->m_ambient[1],
+                &material->m_ambient[2]) < 0) break;
         }
 
         // diffuse material properties
@@ -1131,9 +1216,9 @@ bool cOBJModel::loadMaterialLib(const char a_fileName[],
         {
             // read into current material
             if (fscanf(hFile, "%f %f %f",
-                &m_pMaterials[*a_curMaterialIndex].m_diffuse[0],
-                &m_pMaterials[*a_curMaterialIndex].m_diffuse[1],
-                &m_pMaterials[*a_curMaterialIndex].m_diffuse[2]) < 0) return(false);
+                &material->m_diffuse[0],
+                &material->m_diffuse[1],
+                &material->m_diffuse[2]) < 0) break;
         }
 
         // specular material properties
@@ -1141,9 +1226,9 @@ bool cOBJModel::loadMaterialLib(const char a_fileName[],
         {
             // read into current material
             if (fscanf(hFile, "%f %f %f",
-                &m_pMaterials[*a_curMaterialIndex].m_specular[0],
-                &m_pMaterials[*a_curMaterialIndex].m_specular[1],
-                &m_pMaterials[*a_curMaterialIndex].m_specular[2]) < 0) return(false);
+                &material->m_specular[0],
+                &material->m_specular[1],
+                &material->m_specular[2]) < 0) break;
         }
 
         // texture map name
@@ -1153,126 +1238,35 @@ bool cOBJModel::loadMaterialLib(const char a_fileName[],
             getTokenParameter(str, sizeof(str), hFile);
 
             // append material library filename to the model's base path
-            char textureFile[C_OBJ_SIZE_PATH];
-            strcpy(textureFile, a_basePath);
-            strcat(textureFile, str);
+            string textureFile = string(a_basePath) + str;
             
             // store texture filename in the structure
-            strcpy(m_pMaterials[*a_curMaterialIndex].m_texture, textureFile);
+            strncpy(material->m_texture, textureFile.c_str(), sizeof(material->m_texture) - 1);
+            material->m_texture[sizeof(material->m_texture) - 1] = '\0';
             
-            // load texture and store its ID in the structure
-            m_pMaterials[*a_curMaterialIndex].m_textureID = 1;//LoadTexture(szTextureFile);
+            // texture is loaded when the mesh is created
+            material->m_textureID = 1;
         }
 
         // shininess
         if (!strncmp(str, C_OBJ_MTL_SHININESS_ID, sizeof(C_OBJ_MTL_SHININESS_ID)))
         {
             // read into current material
-            if (fscanf(hFile, "%f", &m_pMaterials[*a_curMaterialIndex].m_shininess) > 0)
+            if (fscanf(hFile, "%f", &material->m_shininess) > 0)
             {
                 // OBJ files use a shininess from 0 to 1000; Scale for OpenGL
-                m_pMaterials[*a_curMaterialIndex].m_shininess *= 1.28f;
+                material->m_shininess *= 1.28f;
             }
         }
     }
 
     fclose(hFile);
 
-    // increment index cause LoadMaterialLib() assumes that the passed
-    // index is always empty
-    (*a_curMaterialIndex)++;
-
     return (true);
 }
 
 //------------------------------------------------------------------------------
 
-void cOBJModel::getFileInfo(FILE *a_hStream, cOBJFileInfo *a_info, const char a_constBasePath[])
-{
-    /////////////////////////////////////////////////////////////////////////
-    // READ THE COUNT OF ALL IMPORTANT IDENTIFIERS OUT OF THE GIVEN STREAM
-    /////////////////////////////////////////////////////////////////////////
-
-    char str[C_OBJ_MAX_STR_SIZE];    // Buffer for reading the file
-    char basePath[C_OBJ_SIZE_PATH];  // Needed to append a filename to the base path
-
-    // init structure
-    a_info->init();
-
-    // rollback the stream
-    rewind(a_hStream);
-
-    // quit reading when end of file has been reached
-    while (!feof(a_hStream))
-    {
-        // get next string
-        readNextString(str, sizeof(str), a_hStream);
-
-        // vertex?
-        if (!strncmp(str, C_OBJ_VERTEX_ID, sizeof(C_OBJ_VERTEX_ID)))
-        a_info->m_vertexCount++;
-
-        // texture coordinate?
-        if (!strncmp(str, C_OBJ_TEXCOORD_ID, sizeof(C_OBJ_TEXCOORD_ID)))
-        a_info->m_texCoordCount++;
-        
-        // vertex normal?
-        if (!strncmp(str, C_OBJ_NORMAL_ID, sizeof(C_OBJ_NORMAL_ID)))
-        a_info->m_normalCount++;
-        
-        // face?
-        if (!strncmp(str, C_OBJ_FACE_ID, sizeof(C_OBJ_FACE_ID)))
-        a_info->m_faceCount++;
-
-        // material library definition?
-        if (!strncmp(str, C_OBJ_MTL_LIB_ID, sizeof(C_OBJ_MTL_LIB_ID)))
-        {
-            // read the filename of the library
-            getTokenParameter(str, sizeof(str), a_hStream);
-
-            // copy the model's base path into a none-constant string
-            strcpy(basePath, a_constBasePath);
-
-            // append material library filename to the model's base path
-            strcat(basePath, str);
-
-            // append .mtl
-            //strcat(szBasePath, ".mtl");
-
-            // open the library file
-            FILE *hMaterialLib = fopen(basePath, "r");
-
-            // success?
-            if (hMaterialLib)
-            {
-                // quit reading when end of file has been reached
-                while (!feof(hMaterialLib))
-                {
-                    // read next string
-                    if (fscanf(hMaterialLib, "%1024s" ,str) > 0)
-                    {
-
-                        // is it a "new material" identifier ?
-                        if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
-                        {
-                            // one more material defined
-                            a_info->m_materialCount++;
-                        }
-                    }
-                }
-
-                // close material library
-                fclose(hMaterialLib);
-            }
-        }
-
-       // clear string two avoid counting something twice
-       memset(str, '\0', sizeof(str));
-    }
-}
-
-//------------------------------------------------------------------------------
-
 void cOBJModel::readNextString(char *a_str, int a_size, FILE *a_hStream)
 {
     /////////////////////////////////////////////////////////////////////////
@@ -1364,27 +1358,84 @@ void cOBJModel::getTokenParameter(char a_str[],
 
 //------------------------------------------------------------------------------
 
-unsigned int getVertexIndex(cMesh* a_mesh, cOBJModel* a_model,
-                            vertexIndexSet_uint_map* a_vertexMap, vertexIndexSet& vis) 
+unsigned int cOBJVertexTable::getVertexIndex(cMesh* a_mesh, 
+                                             const cOBJModel* a_model,
+                                             const cOBJCorner& a_corner) 
 {
-    unsigned int index;
+    // keep the table at most half full
+    if (2 * (m_numEntries + 1) > m_keys.size())
+    {
+        grow();
+    }
 
-    // have we seen this vertex before?
-    vertexIndexSet_uint_map::iterator vertexMapIter = a_vertexMap->find(vis);
+    // hash the vertex, texture coordinate and normal indices
+    unsigned int mask = (unsigned int)(m_keys.size() - 1);
+    unsigned int hash = ((unsigned int)(a_corner.m_vertexIndex) * 0x9E3779B1u) ^ 
+                        ((unsigned int)(a_corner.m_texCoordIndex) * 0x85EBCA77u) ^ 
+                        ((unsigned int)(a_corner.m_normalIndex) * 0xC2B2AE3Du);
+    unsigned int slot = (hash ^ (hash >> 15)) & mask;
 
-    // if we have, just grab the new index for this vertex
-    if (vertexMapIter != a_vertexMap->end()) 
+    // probe until the vertex or an empty slot is found
+    while (true)
     {
-        index = (*vertexMapIter).second;
-        return (index);
+        cOBJCorner& key = m_keys[slot];
+
+        // if we have seen this vertex before, just grab its index
+        if ((key.m_vertexIndex == a_corner.m_vertexIndex) &&
+            (key.m_texCoordIndex == a_corner.m_texCoordIndex) &&
+            (key.m_normalIndex == a_corner.m_normalIndex))
+        {
+            return (m_values[slot]);
+        }
+
+        // otherwise create a new vertex and store the mapping in the table
+        if (key.m_vertexIndex < 0)
+        {
+            key = a_corner;
+            m_values[slot] = a_mesh->newVertex(a_model->m_vertices[a_corner.m_vertexIndex]);
+            m_numEntries++;
+            return (m_values[slot]);
+        }
+
+        slot = (slot + 1) & mask;
     }
+}
 
-    // otherwise create a new vertex and put the mapping in our map
-    else 
+//------------------------------------------------------------------------------
+
+void cOBJVertexTable::grow()
+{
+    vector<cOBJCorner> keys;
+    vector<unsigned int> values;
+    keys.swap(m_keys);
+    values.swap(m_values);
+
+    cOBJCorner empty;
+    empty.m_vertexIndex = -1;
+    empty.m_texCoordIndex = -1;
+    empty.m_normalIndex = -1;
+
+    size_t size = cMax((size_t)(64), 2 * keys.size());
+    m_keys.assign(size, empty);
+    m_values.assign(size, 0);
+
+    // reinsert entries
+    unsigned int mask = (unsigned int)(size - 1);
+    for (size_t i=0; i<keys.size(); i++)
     {
-        index = a_mesh->newVertex(a_model->m_pVertices[vis.vIndex]);
-        (*a_vertexMap)[vis] = index;
-        return (index);
+        const cOBJCorner& key = keys[i];
+        if (key.m_vertexIndex < 0) { continue; }
+
+        unsigned int hash = ((unsigned int)(key.m_vertexIndex) * 0x9E3779B1u) ^ 
+                            ((unsigned int)(key.m_texCoordIndex) * 0x85EBCA77u) ^ 
+                            ((unsigned int)(key.m_normalIndex) * 0xC2B2AE3Du);
+        unsigned int slot = (hash ^ (hash >> 15)) & mask;
+        while (m_keys[slot].m_vertexIndex >= 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        m_keys[slot] = key;
+        m_values[slot] = values[i];
     }
 }
 
@@ -48,7 +48,8 @@
 //------------------------------------------------------------------------------
 #include "world/CMultiMesh.h"
 //------------------------------------------------------------------------------
-#include <map>
+#include <string>
+#include <cstdio>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -101,56 +102,6 @@ extern bool g_objLoaderShouldGenerateExtraVertices;
 // INTERNAL DEFINITIONS FOR OBJ FILE LOADER:
 //============================================================================== 
 
-//! A face vertex, as defined in an .obj file (a vertex/normal/texture set)
-struct vertexIndexSet 
-{
-    int vIndex;
-    int nIndex;
-    int tIndex;
-
-    vertexIndexSet() 
-    {
-        vIndex = nIndex = tIndex = 0;
-    }
-    vertexIndexSet(int vIndex, int nIndex, int tIndex) 
-    {
-        this->vIndex = vIndex;
-        this->nIndex = nIndex;
-        this->tIndex = tIndex;
-    }
-    vertexIndexSet(int vIndex) 
-    {
-        this->vIndex = vIndex;
-        this->nIndex = 0;
-        this->tIndex = 0;
-    }
-};
-
-//------------------------------------------------------------------------------
-
-struct ltVertexIndexSet
-{
-    bool operator()(vertexIndexSet v1, vertexIndexSet v2) const
-    {
-        if (v1.vIndex < v2.vIndex) return 1;
-        if (v2.vIndex < v1.vIndex) return 0;
-        if (v1.nIndex < v2.nIndex) return 1;
-        if (v2.nIndex < v1.nIndex) return 0;
-        if (v1.tIndex < v2.tIndex) return 1;
-        return 0;
-    }
-};
-
-//------------------------------------------------------------------------------
-
-typedef std::map<vertexIndexSet,unsigned int,ltVertexIndexSet> vertexIndexSet_uint_map;
-
-//------------------------------------------------------------------------------
-
-//==============================================================================
-//  INTERNAL IMPLEMENTATION
-//==============================================================================
-
 // OBJ maximum length of a path
 #define C_OBJ_SIZE_PATH		255
 
@@ -177,65 +128,56 @@ typedef std::map<vertexIndexSet,unsigned int,ltVertexIndexSet> vertexIndexSet_ui
 // Maximum size of a string that could be read out of the OBJ file
 #define C_OBJ_MAX_STR_SIZE 1024
 
-// Maximum number of vertices a that a single face can have
-#define C_OBJ_MAX_VERTICES 256
+// Minimum number of bytes parsed by each thread
+#define C_OBJ_MIN_CHUNK_SIZE 1048576
 
-// Image File information.
-struct cOBJFileInfo
+// A face vertex, as defined in an .obj file (a vertex/texture/normal set). Missing indices are set to -1.
+struct cOBJCorner
 {
-    cOBJFileInfo()
-    {
-        init();
-    }
-
-    void init()
-    {
-        m_vertexCount = 0;
-        m_texCoordCount = 0;
-        m_normalCount = 0;
-        m_faceCount = 0;
-        m_materialCount = 0;
-    }
-
-    unsigned int m_vertexCount;
-    unsigned int m_texCoordCount;
-    unsigned int m_normalCount;
-    unsigned int m_faceCount;
-    unsigned int m_materialCount;
+    int m_vertexIndex;
+    int m_texCoordIndex;
+    int m_normalIndex;
 };
 
 // Information about a surface face.
-struct cFace
+struct cOBJFace
 {
-    unsigned int m_numVertices;
+    unsigned int m_firstCorner;
+    unsigned int m_numCorners;
     unsigned int m_materialIndex;
     int          m_groupIndex;
-    int*         m_pVertexIndices;
-    cVector3d*   m_pVertices;
-    cColorf*     m_pColors;
-    int*         m_pNormalIndices;
-    cVector3d*   m_pNormals;
-    int*         m_pTextureIndices;
-    cVector3d*   m_pTexCoords;
-
-    cFace()
-    {
-        init();
-    }
+};
 
-    void init()
-    {
-        m_numVertices = 0;
-        m_materialIndex = -1;
-        m_groupIndex = -1;
-        m_pVertexIndices = NULL;
-        m_pVertices = NULL;
-        m_pColors = NULL;
-        m_pNormalIndices = NULL;
-        m_pNormals = NULL;
-        m_pTextureIndices = NULL;
-        m_pTexCoords = NULL;
-    }
+// Commands that change the state applied to the following faces.
+enum cOBJCommandType
+{
+    C_OBJ_COMMAND_MTL_LIB,
+    C_OBJ_COMMAND_USE_MTL,
+    C_OBJ_COMMAND_NAME
+};
+
+// A state command, together with the number of faces that precede it in its chunk.
+struct cOBJCommand
+{
+    cOBJCommandType m_type;
+    unsigned int    m_faceIndex;
+    std::string     m_argument;
+};
+
+// Data parsed from a contiguous range of lines of an OBJ file. Indices are 
+// zero-based; relative (negative) indices are resolved within the chunk and 
+// listed in m_relativeCorners so that they can be offset once the number of
+// elements in the preceding chunks is known.
+struct cOBJChunk
+{
+    std::vector<cVector3d>    m_vertices;
+    std::vector<cColorf>      m_colors;
+    std::vector<cVector3d>    m_texCoords;
+    std::vector<cVector3d>    m_normals;
+    std::vector<cOBJCorner>   m_corners;
+    std::vector<cOBJFace>     m_faces;
+    std::vector<cOBJCommand>  m_commands;
+    std::vector<unsigned int> m_relativeCorners[3];
 };
 
 // Information about a material property
@@ -278,6 +220,11 @@ struct cMaterialInfo
 
     \brief
     Implementation of an OBJ file loader.
+
+    \details
+    The file is mapped into memory and split into chunks of complete lines 
+    that are parsed in parallel. The chunks are then concatenated in file 
+    order, at which point material and group commands are applied to faces.
 */
 //==============================================================================
 class cOBJModel
@@ -307,28 +254,28 @@ class cOBJModel
     //--------------------------------------------------------------------------
     
     //! List of vertices.
-    cVector3d* m_pVertices;
+    std::vector<cVector3d> m_vertices;
 
     //! List of colors.
-    cColorf* m_pColors;
+    std::vector<cColorf> m_colors;
+
+    //! List of face vertices.
+    std::vector<cOBJCorner> m_corners;
 
     //! List of faces.
-    cFace* m_pFaces;
+    std::vector<cOBJFace> m_faces;
     
     //! List of normals.
-    cVector3d* m_pNormals;
+    std::vector<cVector3d> m_normals;
     
     //! List of texture coordinates.
-    cVector3d* m_pTexCoords;
+    std::vector<cVector3d> m_texCoords;
     
     //! List of material and texture properties.
-    cMaterialInfo* m_pMaterials;
-    
-    //! Information about image file.
-    cOBJFileInfo m_OBJInfo;
+    std::vector<cMaterialInfo> m_materials;
 
     //! List of names obtained from 'g' commands, with the most recent at the back...
-    std::vector<char*> m_groupNames;
+    std::vector<std::string> m_groupNames;
 
 
     //--------------------------------------------------------------------------
@@ -337,6 +284,12 @@ class cOBJModel
 
     private:
 
+    //! Parse a range of complete lines of the OBJ file.
+    void parseChunk(const char* a_begin, const char* a_end, cOBJChunk& a_chunk);
+
+    //! Append a parsed chunk to the model and apply its commands.
+    void mergeChunk(cOBJChunk& a_chunk, unsigned int& a_curMaterial, int& a_curGroup, const char a_basePath[]);
+
     //! Read next string of file.
     void readNextString(char *a_str, int a_size, FILE *a_hStream);
     
@@ -347,22 +300,43 @@ class cOBJModel
     void makePath(char a_fileAndPath[]);
     
     //! Load material file [mtl].
-    bool loadMaterialLib(const char a_fFileName[], cMaterialInfo *a_pMaterials,
-        unsigned int *a_curMaterialIndex, char a_basePath[]);
+    bool loadMaterialLib(const char a_fFileName[], const char a_basePath[]);
+};
 
-    //! Parse information about face.
-    void  parseFaceString(char a_faceString[], cFace *a_faceOut, const cVector3d *a_pVertices,
-        const cVector3d *a_pNormals, const cVector3d *a_pTexCoords, const unsigned int a_materialIndex);
 
-    //! Read information about file.
-    void  getFileInfo(FILE *a_hStream, cOBJFileInfo *a_stat, const char a_constBasePath[]);
-};
+//==============================================================================
+/*!
+    \class      cOBJVertexTable
+    \ingroup    files
+
+    \brief
+    Open-addressing hash table mapping face vertices to mesh vertices.
+*/
+//==============================================================================
+class cOBJVertexTable
+{
+    public:
 
-//! Internal: get a (possibly new) vertex index for a vertex.
-unsigned int getVertexIndex(cMesh* a_Mesh, 
-                            cOBJModel* a_model, 
-                            vertexIndexSet_uint_map* a_VertexMap, 
-                            vertexIndexSet& vis);
+    //! Constructor of cOBJVertexTable.
+    cOBJVertexTable() { m_numEntries = 0; }
+
+    //! Get a (possibly new) mesh vertex index for a face vertex.
+    unsigned int getVertexIndex(cMesh* a_mesh, const cOBJModel* a_model, const cOBJCorner& a_corner);
+
+    private:
+
+    //! Double the capacity of the table.
+    void grow();
+
+    //! Keys of the table. Empty slots have a vertex index of -1.
+    std::vector<cOBJCorner> m_keys;
+
+    //! Mesh vertex index of each slot.
+    std::vector<unsigned int> m_values;
+
+    //! Number of occupied slots.
+    unsigned int m_numEntries;
+};
 
 //------------------------------------------------------------------------------
 #endif  // DOXYGEN_SHOULD_SKIP_THIS
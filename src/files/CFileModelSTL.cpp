@@ -44,8 +44,12 @@
 //------------------------------------------------------------------------------
 #include "files/CFileModelSTL.h"
 //------------------------------------------------------------------------------
+#include "system/CFileMap.h"
+//------------------------------------------------------------------------------
 #include "stdint.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <fstream>
 //------------------------------------------------------------------------------
@@ -76,6 +80,231 @@ struct cTriangleSTL
     int m_attribute;
 };
 
+// collects vertices and triangles while a file is read. If welding is 
+// enabled, vertices with identical coordinates are merged through a hash 
+// table keyed on their single precision coordinates.
+struct cMeshBuilderSTL
+{
+    bool m_weld;
+    vector<float> m_positions;
+    vector<unsigned int> m_indices;
+    vector<unsigned int> m_slots;
+    unsigned int m_numSlots;
+
+    cMeshBuilderSTL(const bool a_weld, const unsigned int a_numTriangles) : m_weld(a_weld), m_numSlots(0)
+    {
+        m_indices.reserve(3 * (size_t)a_numTriangles);
+        if (m_weld)
+        {
+            // closed meshes hold about half as many vertices as triangles
+            m_positions.reserve(3 * (size_t)(a_numTriangles / 2 + 3));
+            resize(a_numTriangles + 64);
+        }
+        else
+        {
+            m_positions.reserve(9 * (size_t)a_numTriangles);
+        }
+    }
+
+    unsigned int hash(const float* a_pos) const
+    {
+        uint32_t key[3];
+        memcpy(key, a_pos, sizeof(key));
+        uint32_t h = (key[0] * 73856093u) ^ (key[1] * 19349663u) ^ (key[2] * 83492791u);
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        return (h);
+    }
+
+    // resizes the hash table to hold a_numVertices entries at most half full
+    void resize(const unsigned int a_numVertices)
+    {
+        m_numSlots = 64;
+        while (m_numSlots < 2 * a_numVertices) { m_numSlots *= 2; }
+        m_slots.assign(m_numSlots, 0);
+
+        unsigned int numVertices = (unsigned int)(m_positions.size() / 3);
+        for (unsigned int i=0; i<numVertices; i++)
+        {
+            unsigned int slot = hash(&m_positions[3*i]) & (m_numSlots - 1);
+            while (m_slots[slot] != 0) { slot = (slot + 1) & (m_numSlots - 1); }
+            m_slots[slot] = i + 1;
+        }
+    }
+
+    void addVertex(const float* a_pos)
+    {
+        // negative zero is merged with zero
+        float pos[3] = { a_pos[0] + 0.0f, a_pos[1] + 0.0f, a_pos[2] + 0.0f };
+        unsigned int numVertices = (unsigned int)(m_positions.size() / 3);
+
+        if (m_weld)
+        {
+            unsigned int slot = hash(pos) & (m_numSlots - 1);
+            while (m_slots[slot] != 0)
+            {
+                unsigned int index = m_slots[slot] - 1;
+                if (memcmp(&m_positions[3*index], pos, sizeof(pos)) == 0)
+                {
+                    m_indices.push_back(index);
+                    return;
+                }
+                slot = (slot + 1) & (m_numSlots - 1);
+            }
+            m_slots[slot] = numVertices + 1;
+        }
+
+        m_positions.insert(m_positions.end(), pos, pos + 3);
+        m_indices.push_back(numVertices);
+
+        if (m_weld && (2 * (numVertices + 1) > m_numSlots))
+        {
+            resize(2 * (numVertices + 1));
+        }
+    }
+
+    unsigned int getNumTriangles() const { return ((unsigned int)(m_indices.size() / 3)); }
+};
+
+//------------------------------------------------------------------------------
+
+static const float _powersOfTen[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+//------------------------------------------------------------------------------
+
+static inline bool _isSpace(const char a_char)
+{
+    return ((a_char == ' ') || (a_char == '\t') || (a_char == '\r') || (a_char == '\n'));
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _skipSpaces(const char* a_str, const char* a_end)
+{
+    while ((a_str < a_end) && _isSpace(*a_str)) { a_str++; }
+    return (a_str);
+}
+
+//------------------------------------------------------------------------------
+
+static inline const char* _skipToken(const char* a_str, const char* a_end)
+{
+    while ((a_str < a_end) && !_isSpace(*a_str)) { a_str++; }
+    return (a_str);
+}
+
+//------------------------------------------------------------------------------
+
+static inline bool _isToken(const char* a_str, const char* a_tokenEnd, const char* a_keyword, const size_t a_length)
+{
+    return (((size_t)(a_tokenEnd - a_str) == a_length) && (memcmp(a_str, a_keyword, a_length) == 0));
+}
+
+//------------------------------------------------------------------------------
+
+static inline bool _parseFloat(const char* a_str, const char* a_end, float& a_value)
+{
+    const char* p = a_str;
+    bool negative = false;
+    if ((p < a_end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // plain decimal numbers with up to 9 significant digits are converted 
+    // exactly; everything else is left to the C library
+    unsigned int mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+    {
+        mantissa = 10 * mantissa + (*p - '0');
+        digits++;
+        p++;
+    }
+    if ((p < a_end) && (*p == '.'))
+    {
+        p++;
+        while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+        {
+            mantissa = 10 * mantissa + (*p - '0');
+            digits++;
+            exponent--;
+            p++;
+        }
+    }
+
+    if ((digits > 0) && (digits <= 9) && (exponent >= -10) && ((p == a_end) || _isSpace(*p)))
+    {
+        double value = (double)(mantissa) / (double)(_powersOfTen[-exponent]);
+        a_value = (float)(negative ? -value : value);
+        return (true);
+    }
+
+    char str[64];
+    size_t length = (size_t)(_skipToken(a_str, a_end) - a_str);
+    if ((length == 0) || (length >= sizeof(str))) { return (false); }
+    memcpy(str, a_str, length);
+    str[length] = '\0';
+
+    char* last;
+    a_value = (float)(strtod(str, &last));
+    return (last == (str + length));
+}
+
+//------------------------------------------------------------------------------
+
+static bool _parseASCII(const char* a_data, const char* a_end, cMeshBuilderSTL& a_builder)
+{
+    // vertices of the current facet
+    vector<float> polygon;
+    polygon.reserve(9);
+
+    const char* p = a_data;
+    while (true)
+    {
+        // read next token
+        p = _skipSpaces(p, a_end);
+        if (p == a_end) { break; }
+        const char* token = p;
+        p = _skipToken(p, a_end);
+
+        if (_isToken(token, p, "vertex", 6))
+        {
+            for (int i=0; i<3; i++)
+            {
+                float value;
+                p = _skipSpaces(p, a_end);
+                if (!_parseFloat(p, a_end, value)) { return (false); }
+                polygon.push_back(value);
+                p = _skipToken(p, a_end);
+            }
+        }
+        else if (_isToken(token, p, "endloop", 7))
+        {
+            // facets with more than three vertices are triangulated as a fan
+            unsigned int numVertices = (unsigned int)(polygon.size() / 3);
+            for (unsigned int i=2; i<numVertices; i++)
+            {
+                a_builder.addVertex(&polygon[0]);
+                a_builder.addVertex(&polygon[3*(i-1)]);
+                a_builder.addVertex(&polygon[3*i]);
+            }
+            polygon.clear();
+        }
+        else if (_isToken(token, p, "solid", 5) || _isToken(token, p, "endsolid", 8))
+        {
+            // skip solid name
+            const char* eol = (const char*)memchr(p, '\n', a_end - p);
+            p = (eol == NULL) ? a_end : eol;
+        }
+    }
+
+    return (true);
+}
+
 //------------------------------------------------------------------------------
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -83,81 +312,118 @@ struct cTriangleSTL
 
 //==============================================================================
 /*!
-    This function loads an STL (binary format) 3D model from a file into a cMultiMesh structure.
+    This function loads an STL 3D model (binary or ASCII format) from a file 
+    into a cMultiMesh structure. The file is memory-mapped and read in a single 
+    pass; binary files are identified by their header and size, and files that 
+    start with the keyword __solid__ and do not match the binary layout are 
+    parsed as ASCII.\n
+
+    If global variable \ref g_meshLoaderShouldOptimize is enabled, vertices 
+    with identical coordinates are merged while the file is read and the mesh 
+    is then optimized; otherwise each triangle keeps its own three vertices.
+    The reduction of vertices and triangles, counted from the three vertices 
+    of each facet of the file, is returned in \p a_report if provided.\n
+
     If the operation succeeds, then the functions returns __true__ and the
     3D model is loaded into cMultiMesh as a single mesh.
     If the operation fails, then the function returns __false__.
 
     \param  a_object    Multimesh object.
     \param  a_filename  Filename.
+    \param  a_report    Optional result of the optimization.
 
     \return __true__ if in case of success, __false__ otherwise.
 */
 //==============================================================================
-bool cLoadFileSTL(cMultiMesh* a_object, const std::string& a_filename)
+bool cLoadFileSTL(cMultiMesh* a_object, const std::string& a_filename, cMeshOptimizationReport* a_report)
 {
     // sanity check
     if (a_object == NULL)
         return (C_ERROR);
 
-    // open file
-    ifstream file(a_filename.c_str(), ios::binary);
-    if (!file)
+    // map file into memory
+    cFileMap file;
+    if (!file.open(a_filename))
         return (C_ERROR);
 
-    // get length of file
-    file.seekg (0, file.end);
-    int length = (int)(file.tellg());
-    file.seekg (0, file.beg);
-    if (length < 84)
+    const char* data = file.getData();
+    size_t size = file.getSize();
+
+    // check file format
+    unsigned int numTriangles = 0;
+    if (size >= sizeof(cHeaderSTL))
     {
-        file.close();
-        return (C_ERROR);
+        memcpy(&numTriangles, data + 80, sizeof(numTriangles));
     }
-
-    // read header
-    cHeaderSTL header;
-    file.read((char*)(&header), 84);
-
-    // read number of triangles
-    unsigned int numTriangles = header.m_numTriangles;
-    if (numTriangles == 0)
+    bool binary = (size >= sizeof(cHeaderSTL)) && (numTriangles > 0) &&
+                  ((uint64_t)(numTriangles) * 50 <= (uint64_t)(size - sizeof(cHeaderSTL)));
+    bool ascii = (size >= 5) && (memcmp(data, "solid", 5) == 0) &&
+                 !(binary && ((uint64_t)(numTriangles) * 50 == (uint64_t)(size - sizeof(cHeaderSTL))));
+
+    // read ASCII file
+    cMeshBuilderSTL builder(g_meshLoaderShouldOptimize, ascii ? (unsigned int)(size / 256) : numTriangles);
+    if (ascii)
     {
-        file.close();
-        return (C_ERROR);
+        // some binary files start with "solid" too; fall back to binary if no facet was found
+        if (!_parseASCII(data, data + size, builder) || (builder.getNumTriangles() == 0))
+        {
+            if (!binary)
+                return (C_ERROR);
+            builder = cMeshBuilderSTL(g_meshLoaderShouldOptimize, numTriangles);
+            ascii = false;
+        }
     }
 
-    // check if the length of the file correspond to the number of triangles found
-    double num = (double)(length - sizeof(cHeaderSTL)) / 50.0;
-    if ((num != floor(num)) && ((int)num != numTriangles))
+    // read binary file
+    if (!ascii)
     {
-        file.close();
-        return (C_ERROR);
+        if (!binary)
+            return (C_ERROR);
+
+        const char* facet = data + sizeof(cHeaderSTL);
+        for (unsigned int i=0; i<numTriangles; i++)
+        {
+            // facets are 50 bytes long and not aligned
+            float values[12];
+            memcpy(values, facet, sizeof(values));
+            builder.addVertex(&values[3]);
+            builder.addVertex(&values[6]);
+            builder.addVertex(&values[9]);
+            facet += 50;
+        }
     }
 
     // create mesh
     cMesh* mesh = a_object->newMesh();
 
-    // load triangles
-    for (int i=0; i<(int)numTriangles; i++)
+    // copy vertices
+    unsigned int numVertices = (unsigned int)(builder.m_positions.size() / 3);
+    mesh->m_vertices->newVertices(numVertices);
+    for (unsigned int i=0; i<numVertices; i++)
     {
-        cTriangleSTL triangle;
+        const float* pos = &builder.m_positions[3*i];
+        mesh->m_vertices->m_localPos[i].set(pos[0], pos[1], pos[2]);
+    }
 
-        // read triangle data from file
-        file.read((char*)(&triangle), 50);
+    // copy triangles
+    mesh->m_triangles->newTriangles(&builder.m_indices[0], builder.getNumTriangles());
 
-        // create triangle entity
-        mesh->newTriangle(cVector3d(triangle.m_vertex0[0], triangle.m_vertex0[1], triangle.m_vertex0[2]),
-                          cVector3d(triangle.m_vertex1[0], triangle.m_vertex1[1], triangle.m_vertex1[2]),
-                          cVector3d(triangle.m_vertex2[0], triangle.m_vertex2[1], triangle.m_vertex2[2]));
+    // reorder triangles and vertices
+    if (g_meshLoaderShouldOptimize)
+    {
+        cMeshOptimizationReport report = mesh->optimize();
+
+        // vertices merged while reading count as removed by the optimization
+        report.m_numVerticesBefore = 3 * builder.getNumTriangles();
+        if (a_report != NULL)
+        {
+            *a_report = report;
+        }
     }
 
     // compute normals
     mesh->computeAllNormals();
 
-    // close file
-    file.close();
-
     // return success
     return (C_SUCCESS);
 }
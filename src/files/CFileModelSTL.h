@@ -69,7 +69,7 @@ namespace chai3d {
 //@{
 
 //! This function loads an STL model file.
-bool cLoadFileSTL(cMultiMesh* a_object, const std::string& a_filename);
+bool cLoadFileSTL(cMultiMesh* a_object, const std::string& a_filename, cMeshOptimizationReport* a_report = NULL);
 
 //! This function saves an STL model file.
 bool cSaveFileSTL(cMultiMesh* a_object, const std::string& a_filename);
@@ -47,8 +47,11 @@
 #include "pugixml.hpp"
 using namespace pugi;
 //------------------------------------------------------------------------------
+#include <cstdlib>
+#include <locale>
 #include <string>
 #include <sstream>
+#include <unordered_map>
 using namespace std;
 //------------------------------------------------------------------------------
 
@@ -67,6 +70,11 @@ struct XML
     xml_document  m_document;
     std::string   m_filename;
 
+    // child nodes already located by name and index, keyed by parent node,
+    // index and name. entries stay valid while nodes are only appended, and
+    // the cache is cleared whenever nodes are removed or renamed.
+    std::unordered_map<std::string, xml_node> m_childCache;
+
     XML()
     {
         m_filename = "";
@@ -74,11 +82,184 @@ struct XML
     }
 };
 
+// powers of ten that are exactly representable as doubles
+static const double C_XML_POW10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool _isSpace(const char a_char)
+{
+    return ((a_char == ' ') || (a_char == '\t') || (a_char == '\n') || (a_char == '\r'));
+}
+
+static inline bool _isDigit(const char a_char)
+{
+    return ((a_char >= '0') && (a_char <= '9'));
+}
+
+static inline std::string _childKey(const xml_node& a_parent, const char* a_name, const int a_index)
+{
+    xml_node_struct* parent = a_parent.internal_object();
+    std::string key((const char*)&parent, sizeof(parent));
+    key.append((const char*)&a_index, sizeof(a_index));
+    key.append(a_name);
+    return (key);
+}
+
+static xml_node _findChild(XML* a_xml, const xml_node& a_parent, const char* a_name, int a_index)
+{
+    // negative indices designate the first child, as in gotoChild()
+    if (a_index < 0) { a_index = 0; }
+
+    // look for the child in the cache
+    std::string key = _childKey(a_parent, a_name, a_index);
+    std::unordered_map<std::string, xml_node>::const_iterator it = a_xml->m_childCache.find(key);
+    if (it != a_xml->m_childCache.end())
+    {
+        return (it->second);
+    }
+
+    // start from the previous sibling if it is cached, from the first child otherwise
+    xml_node node;
+    int index = 0;
+    if (a_index > 0)
+    {
+        it = a_xml->m_childCache.find(_childKey(a_parent, a_name, a_index - 1));
+        if (it != a_xml->m_childCache.end())
+        {
+            node = it->second;
+            index = a_index - 1;
+        }
+    }
+    if (node.empty())
+    {
+        node = a_parent.child(a_name);
+    }
+
+    for (; index<a_index; index++)
+    {
+        node = node.next_sibling(a_name);
+    }
+
+    if (!node.empty())
+    {
+        a_xml->m_childCache[key] = node;
+    }
+
+    return (node);
+}
+
 //------------------------------------------------------------------------------
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
 
 
+//==============================================================================
+/*!
+    This function parses a decimal number at the beginning of a string in the
+    same way as a stream would, but without locale dependency or memory
+    allocation. Numbers whose significand and power of ten are exactly
+    representable are converted directly; others are handed over to a
+    stream using the classic locale, so that results are always correctly
+    rounded.
+
+    \param  a_str   Pointer to the string, advanced past the number on success.
+    \param  a_val   Parsed value, 0.0 if no number could be read.
+
+    \return __true__ if a number was read, __false__ otherwise.
+*/
+//==============================================================================
+static bool parseDouble(const char*& a_str, double& a_val)
+{
+    const char* p = a_str;
+    while (_isSpace(*p)) { p++; }
+    const char* start = p;
+
+    // sign
+    bool negative = (*p == '-');
+    if ((*p == '-') || (*p == '+')) { p++; }
+
+    // significand: keep up to 19 significant digits
+    unsigned long long significand = 0;
+    int numDigits = 0;
+    int numSignificantDigits = 0;
+    int exponent = 0;
+    while (_isDigit(*p))
+    {
+        if (numSignificantDigits < 19)
+        {
+            significand = 10 * significand + (*p - '0');
+            if (significand > 0) { numSignificantDigits++; }
+        }
+        else
+        {
+            exponent++;
+        }
+        numDigits++;
+        p++;
+    }
+    if (*p == '.')
+    {
+        p++;
+        while (_isDigit(*p))
+        {
+            if (numSignificantDigits < 19)
+            {
+                significand = 10 * significand + (*p - '0');
+                if (significand > 0) { numSignificantDigits++; }
+                exponent--;
+            }
+            numDigits++;
+            p++;
+        }
+    }
+
+    if (numDigits == 0)
+    {
+        a_val = 0.0;
+        return (false);
+    }
+
+    // exponent
+    if ((*p == 'e') || (*p == 'E'))
+    {
+        const char* q = p + 1;
+        bool negativeExponent = (*q == '-');
+        if ((*q == '-') || (*q == '+')) { q++; }
+        if (_isDigit(*q))
+        {
+            int value = 0;
+            while (_isDigit(*q))
+            {
+                if (value < 100000) { value = 10 * value + (*q - '0'); }
+                q++;
+            }
+            exponent += negativeExponent ? -value : value;
+            p = q;
+        }
+    }
+
+    a_str = p;
+
+    // exact conversion
+    if ((significand <= (1ULL << 53)) && (exponent >= -22) && (exponent <= 22))
+    {
+        double value = (double)significand;
+        value = (exponent < 0) ? value / C_XML_POW10[-exponent] : value * C_XML_POW10[exponent];
+        a_val = negative ? -value : value;
+        return (true);
+    }
+
+    // correctly rounded conversion
+    std::istringstream i(std::string(start, p));
+    i.imbue(std::locale::classic());
+    if (!(i >> a_val)) { a_val = 0.0; }
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This function converts a __string__ into a __long int__.
@@ -88,12 +269,9 @@ struct XML
     \return The converted __long int__ value if the string is valid, 0 otherwise.
 */
 //==============================================================================
-static inline long int strToInt(const std::string& a_str)
+static inline long int strToInt(const char* a_str)
 {
-  std::istringstream i(a_str);
-  int x = 0;
-  if (!(i >> x)) return 0;
-  else return x;
+    return (strtol(a_str, NULL, 10));
 }
 
 
@@ -106,12 +284,43 @@ static inline long int strToInt(const std::string& a_str)
     \return The converted __double__ value if the string is valid, 0.0 otherwise.
 */
 //==============================================================================
-static inline double strToDouble(const std::string& a_str)
+static inline double strToDouble(const char* a_str)
 {
-  std::istringstream i(a_str);
-  double x = 0.0;
-  if (!(i >> x)) return 0.0;
-  else return x;
+    double x;
+    parseDouble(a_str, x);
+    return x;
+}
+
+
+//==============================================================================
+/*!
+    This function parses a list of numbers separated by white spaces, commas
+    or semicolons.
+
+    \param  a_str       Input __string__ to convert.
+    \param  a_values    Parsed values.
+
+    \return __true__ if the whole string was parsed, __false__ otherwise.
+*/
+//==============================================================================
+static bool strToDoubles(const char* a_str, vector<double>& a_values)
+{
+    a_values.clear();
+    while (true)
+    {
+        while (_isSpace(*a_str) || (*a_str == ',') || (*a_str == ';')) { a_str++; }
+        if (*a_str == 0)
+        {
+            return true;
+        }
+
+        double value;
+        if (!parseDouble(a_str, value))
+        {
+            return false;
+        }
+        a_values.push_back(value);
+    }
 }
 
 
@@ -173,6 +382,9 @@ bool cFileXML::loadFromFile(const string& a_filename)
     // store filename for use by the save() method
     ((XML*)(m_xml))->m_filename = a_filename;
 
+    // forget nodes of the previous document
+    ((XML*)(m_xml))->m_childCache.clear();
+
     // load XML content (even if file is empty with no document elements)
     xml_parse_result res = ((XML*)(m_xml))->m_document.load_file(a_filename.c_str());
     if (res.status == status_ok || res.status == status_no_document_element)
@@ -248,6 +460,7 @@ void cFileXML::clear()
 {
     // remove all XML data
     ((XML*)(m_xml))->m_document.reset();
+    ((XML*)(m_xml))->m_childCache.clear();
 
     return gotoRoot();
 }
@@ -284,14 +497,8 @@ void cFileXML::gotoRoot()
 //==============================================================================
 int cFileXML::gotoChild(const string& a_name, int a_index, bool a_create)
 {
-    // navigate to first child with matching name
-    xml_node node = ((XML*)(m_xml))->m_currentNode.child(a_name.c_str());
-
     // navigate to the matching child at the desired index
-    for (int index=0; index<a_index; index++)
-    {
-        node = node.next_sibling(a_name.c_str());
-    }
+    xml_node node = _findChild((XML*)(m_xml), ((XML*)(m_xml))->m_currentNode, a_name.c_str(), a_index);
 
     // if desired node exists, set current node to it and return 0
     if (!node.empty())
@@ -347,6 +554,7 @@ bool cFileXML::removeChild(const string& a_name, int a_index)
     if (!node.empty ())
     {
         ((XML*)(m_xml))->m_currentNode.remove_child(node);
+        ((XML*)(m_xml))->m_childCache.clear();
 
         return true;
     }
@@ -375,6 +583,84 @@ bool cFileXML::gotoParent()
 }
 
 
+//==============================================================================
+/*!
+    Set the current node pointer to the node designated by a path. A path is
+    a list of child names separated by '/', each optionally followed by an
+    index in brackets when several children have the same name, for instance
+    "scene/object[2]/position". Paths are relative to the current node,
+    unless they start with '/', in which case they are relative to the root.
+    The names ".." and "." designate the parent and the current node. \n
+
+    Nodes located by this method and by \ref gotoChild() are cached, so that
+    repeated lookups and indexed access to long lists of siblings do not need
+    to scan the XML data again.
+
+    \param  a_path  Path of the node to navigate to.
+
+    \return __true__ if in case of success, __false__ otherwise. On failure
+            the current node is left unchanged.
+*/
+//==============================================================================
+bool cFileXML::gotoPath(const string& a_path)
+{
+    XML* xml = (XML*)(m_xml);
+    xml_node node = xml->m_currentNode;
+    size_t pos = 0;
+
+    // absolute path
+    if ((a_path.length() > 0) && (a_path[0] == '/'))
+    {
+        node = xml->m_document;
+        pos = 1;
+    }
+
+    string name;
+    while (pos < a_path.length())
+    {
+        // extract next path element
+        size_t end = a_path.find('/', pos);
+        if (end == string::npos)
+        {
+            end = a_path.length();
+        }
+
+        size_t nameEnd = a_path.find('[', pos);
+        int index = 0;
+        if (nameEnd < end)
+        {
+            index = (int)strToInt(a_path.c_str() + nameEnd + 1);
+        }
+        else
+        {
+            nameEnd = end;
+        }
+        name.assign(a_path, pos, nameEnd - pos);
+
+        // navigate
+        if (name == "..")
+        {
+            node = node.parent();
+        }
+        else if ((name.length() > 0) && (name != "."))
+        {
+            node = _findChild(xml, node, name.c_str(), index);
+        }
+
+        if (node.empty())
+        {
+            return false;
+        }
+
+        pos = end + 1;
+    }
+
+    xml->m_currentNode = node;
+
+    return true;
+}
+
+
 //==============================================================================
 /*!
     Set the current node pointer to the first child of the current node.
@@ -475,7 +761,8 @@ bool cFileXML::setName(const string& a_name)
     // otherwise, assign name to current node
     else 
     {
-      ((XML*)(m_xml))->m_currentNode.set_value(a_name.c_str());
+      ((XML*)(m_xml))->m_currentNode.set_name(a_name.c_str());
+      ((XML*)(m_xml))->m_childCache.clear();
 
       return true;
     }
@@ -532,10 +819,15 @@ bool cFileXML::getValue(bool& a_val) const
 //==============================================================================
 bool cFileXML::getValue(long int& a_val) const
 {
-    string tmp;
+    // check that we are not trying to get the root node value
+    if (((XML*)(m_xml))->m_currentNode == ((XML*)(m_xml))->m_document)
+    {
+      return false;
+    }
 
-    // retrieve current node value as a string
-    if (getValue(tmp))
+    // retrieve current node value
+    const char* tmp = ((XML*)(m_xml))->m_currentNode.child_value();
+    if (*tmp != 0)
     {
         // convert string to __long int__
         a_val = strToInt(tmp);
@@ -563,10 +855,15 @@ bool cFileXML::getValue(long int& a_val) const
 //==============================================================================
 bool cFileXML::getValue(double& a_val) const
 {
-    string tmp;
+    // check that we are not trying to get the root node value
+    if (((XML*)(m_xml))->m_currentNode == ((XML*)(m_xml))->m_document)
+    {
+      return false;
+    }
 
-    // retrieve current node value as a string
-    if (getValue(tmp))
+    // retrieve current node value
+    const char* tmp = ((XML*)(m_xml))->m_currentNode.child_value();
+    if (*tmp != 0)
     {
         // convert string to __double__
         a_val = strToDouble(tmp);
@@ -617,6 +914,66 @@ bool cFileXML::getValue(string& a_val) const
 }
 
 
+//==============================================================================
+/*!
+    Get the list of numbers held by the value of the current node. Numbers
+    may be separated by white spaces, commas or semicolons, as in
+    "0.1 0.2 0.3" or "0.1, 0.2, 0.3".
+
+    \param  a_values  Holds the numbers of the current node value on success.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileXML::getValues(vector<double>& a_values) const
+{
+    // check that we are not trying to get the root node value
+    if (((XML*)(m_xml))->m_currentNode == ((XML*)(m_xml))->m_document)
+    {
+      return false;
+    }
+
+    // parse current node value
+    return strToDoubles(((XML*)(m_xml))->m_currentNode.child_value(), a_values);
+}
+
+
+//==============================================================================
+/*!
+    Get the values of all children of the current node with a specific name,
+    in the order in which they appear. This is much faster than reading each
+    child with \ref getValue() and an increasing index.
+
+    \param  a_name    Name of the child nodes.
+    \param  a_values  Holds the value of each child node on success.
+
+    \return __true__ if at least one child was found and all values are
+            valid numbers, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileXML::getChildValues(const string& a_name, vector<double>& a_values) const
+{
+    a_values.clear();
+
+    // retrieve the value of each child with matching name
+    xml_node node = ((XML*)(m_xml))->m_currentNode.child(a_name.c_str());
+    while (!node.empty())
+    {
+        const char* tmp = node.child_value();
+        double value;
+        if (!parseDouble(tmp, value))
+        {
+            return false;
+        }
+        a_values.push_back(value);
+
+        node = node.next_sibling(a_name.c_str());
+    }
+
+    return (a_values.size() > 0);
+}
+
+
 //==============================================================================
 /*!
     Set current node value.
@@ -767,10 +1124,9 @@ bool cFileXML::getAttribute(const string& a_attribute, bool& a_val) const
 //==============================================================================
 bool cFileXML::getAttribute(const string& a_attribute, long int& a_val) const
 {
-    string tmp;
-
-    // retrieve attribute value as a string
-    if(getAttribute(a_attribute, tmp))
+    // retrieve attribute value
+    const char* tmp = ((XML*)(m_xml))->m_currentNode.attribute(a_attribute.c_str()).as_string();
+    if (*tmp != 0)
     {
         // convert to __long int__
         a_val = strToInt(tmp);
@@ -799,10 +1155,9 @@ bool cFileXML::getAttribute(const string& a_attribute, long int& a_val) const
 //==============================================================================
 bool cFileXML::getAttribute(const string& a_attribute, double& a_val) const
 {
-    string tmp;
-
-    // retrieve attribute value as a string
-    if (getAttribute(a_attribute, tmp))
+    // retrieve attribute value
+    const char* tmp = ((XML*)(m_xml))->m_currentNode.attribute(a_attribute.c_str()).as_string();
+    if (*tmp != 0)
     {
         // convert to __double__
         a_val = strToDouble(tmp);
@@ -941,6 +1296,112 @@ bool cFileXML::setAttribute(const string& a_attribute, const string a_val)
 }
 
 
+//==============================================================================
+/*!
+    Get the value of the node designated by a path relative to the current
+    node. The current node is left unchanged. See \ref gotoPath() for the
+    path syntax.
+
+    \param  a_path  Path of the node.
+    \param  a_val   Holds the value of the node on success.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileXML::getPathValue(const string& a_path, bool& a_val)
+{
+    xml_node node = ((XML*)(m_xml))->m_currentNode;
+    bool res = gotoPath(a_path) && getValue(a_val);
+    ((XML*)(m_xml))->m_currentNode = node;
+    return res;
+}
+
+
+//==============================================================================
+/*!
+    Get the value of the node designated by a path relative to the current
+    node. The current node is left unchanged. See \ref gotoPath() for the
+    path syntax.
+
+    \param  a_path  Path of the node.
+    \param  a_val   Holds the value of the node on success.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileXML::getPathValue(const string& a_path, long int& a_val)
+{
+    xml_node node = ((XML*)(m_xml))->m_currentNode;
+    bool res = gotoPath(a_path) && getValue(a_val);
+    ((XML*)(m_xml))->m_currentNode = node;
+    return res;
+}
+
+
+//==============================================================================
+/*!
+    Get the value of the node designated by a path relative to the current
+    node. The current node is left unchanged. See \ref gotoPath() for the
+    path syntax.
+
+    \param  a_path  Path of the node.
+    \param  a_val   Holds the value of the node on success.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileXML::getPathValue(const string& a_path, double& a_val)
+{
+    xml_node node = ((XML*)(m_xml))->m_currentNode;
+    bool res = gotoPath(a_path) && getValue(a_val);
+    ((XML*)(m_xml))->m_currentNode = node;
+    return res;
+}
+
+
+//==============================================================================
+/*!
+    Get the value of the node designated by a path relative to the current
+    node. The current node is left unchanged. See \ref gotoPath() for the
+    path syntax.
+
+    \param  a_path  Path of the node.
+    \param  a_val   Holds the value of the node on success.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileXML::getPathValue(const string& a_path, string& a_val)
+{
+    xml_node node = ((XML*)(m_xml))->m_currentNode;
+    bool res = gotoPath(a_path) && getValue(a_val);
+    ((XML*)(m_xml))->m_currentNode = node;
+    return res;
+}
+
+
+//==============================================================================
+/*!
+    Get the list of numbers held by the node designated by a path relative
+    to the current node. The current node is left unchanged. See
+    \ref gotoPath() for the path syntax and \ref getValues() for the list
+    format.
+
+    \param  a_path    Path of the node.
+    \param  a_values  Holds the numbers of the node value on success.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileXML::getPathValues(const string& a_path, vector<double>& a_values)
+{
+    xml_node node = ((XML*)(m_xml))->m_currentNode;
+    bool res = gotoPath(a_path) && getValues(a_values);
+    ((XML*)(m_xml))->m_currentNode = node;
+    return res;
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
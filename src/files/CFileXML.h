@@ -46,6 +46,7 @@
 #define CFileXML
 //------------------------------------------------------------------------------
 #include <string>
+#include <vector>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -116,6 +117,9 @@ public:
     //! Set current node to the parent of the current node.
     bool gotoParent();
 
+    //! Set current node to the node designated by a path such as "scene/object[2]/position".
+    bool gotoPath(const std::string& a_path);
+
     //! Set the name of the current node.
     bool setName(const std::string& a_name);
 
@@ -221,6 +225,12 @@ public:
     //! Get the value of the current node.
     bool getValue(std::string& a_val) const;
 
+    //! Get the list of numbers held by the value of the current node.
+    bool getValues(std::vector<double>& a_values) const;
+
+    //! Get the values of all children of the current node with a specific name.
+    bool getChildValues(const std::string& a_name, std::vector<double>& a_values) const;
+
     //! Get the value of a specific attribute of the current node.
     bool getAttribute(const std::string& a_attribute, bool& a_val) const;
 
@@ -382,6 +392,27 @@ public:
 
     //! Get the value of a specific attribute of a specific child node of the current node.
     bool getAttribute(const std::string& a_name, int a_index, const std::string& a_attribute, std::string& a_val) { if (gotoChild(a_name, a_index, false) < 0) return false; bool res = getAttribute(a_attribute, a_val); gotoParent(); return res; }
+
+    //! Get the value of the node designated by a path relative to the current node.
+    bool getPathValue(const std::string& a_path, bool& a_val);
+
+    //! Get the value of the node designated by a path relative to the current node.
+    bool getPathValue(const std::string& a_path, long int& a_val);
+
+    //! Get the value of the node designated by a path relative to the current node.
+    bool getPathValue(const std::string& a_path, int& a_val) { long int tmp; bool res = getPathValue(a_path, tmp); a_val = (int)tmp; return res; }
+
+    //! Get the value of the node designated by a path relative to the current node.
+    bool getPathValue(const std::string& a_path, double& a_val);
+
+    //! Get the value of the node designated by a path relative to the current node.
+    bool getPathValue(const std::string& a_path, float& a_val) { double tmp; bool res = getPathValue(a_path, tmp); a_val = (float)tmp; return res; }
+
+    //! Get the value of the node designated by a path relative to the current node.
+    bool getPathValue(const std::string& a_path, std::string& a_val);
+
+    //! Get the list of numbers held by the node designated by a path relative to the current node.
+    bool getPathValues(const std::string& a_path, std::vector<double>& a_values);
 };
 
 //@}
@@ -0,0 +1,1179 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CCompressedImage.h"
+#include "files/CFileImageDDS.h"
+#include "files/CFileImageKTX.h"
+#include "math/CMaths.h"
+#include "system/CString.h"
+#include "system/CThreadPool.h"
+//------------------------------------------------------------------------------
+#include <climits>
+#include <cstring>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Block kernels used to encode and decode 4x4 pixel blocks in the S3TC
+// formats. Color endpoints are placed along the principal axis of the block
+// colors and refined by least squares; alpha endpoints are the block extrema.
+//------------------------------------------------------------------------------
+
+//! Number of 4x4 blocks processed by each task when a level is split across threads.
+static const unsigned int C_COMPRESSED_IMAGE_BLOCKS_PER_TASK = 1024;
+
+static inline unsigned short _pack565(const int* a_rgb)
+{
+    int r = (a_rgb[0] * 31 + 127) / 255;
+    int g = (a_rgb[1] * 63 + 127) / 255;
+    int b = (a_rgb[2] * 31 + 127) / 255;
+    return ((unsigned short)((r << 11) | (g << 5) | b));
+}
+
+static inline void _unpack565(const unsigned short a_color, int* a_rgb)
+{
+    int r = (a_color >> 11) & 31;
+    int g = (a_color >> 5) & 63;
+    int b = a_color & 31;
+    a_rgb[0] = (r << 3) | (r >> 2);
+    a_rgb[1] = (g << 2) | (g >> 4);
+    a_rgb[2] = (b << 3) | (b >> 2);
+}
+
+static void _colorPalette(const unsigned short a_color0,
+                          const unsigned short a_color1,
+                          const bool a_fourColors,
+                          int a_palette[4][3])
+{
+    _unpack565(a_color0, a_palette[0]);
+    _unpack565(a_color1, a_palette[1]);
+    for (int c=0; c<3; c++)
+    {
+        if (a_fourColors)
+        {
+            a_palette[2][c] = (2 * a_palette[0][c] + a_palette[1][c]) / 3;
+            a_palette[3][c] = (a_palette[0][c] + 2 * a_palette[1][c]) / 3;
+        }
+        else
+        {
+            a_palette[2][c] = (a_palette[0][c] + a_palette[1][c]) / 2;
+            a_palette[3][c] = 0;
+        }
+    }
+}
+
+static unsigned int _colorIndices(const unsigned char* a_rgba,
+                                  const bool* a_transparent,
+                                  int a_palette[4][3],
+                                  const int a_numColors,
+                                  unsigned int& a_error)
+{
+    unsigned int indices = 0;
+    a_error = 0;
+    for (int i=0; i<16; i++)
+    {
+        if (a_transparent[i])
+        {
+            indices |= 3u << (2 * i);
+            continue;
+        }
+
+        const unsigned char* p = a_rgba + 4 * i;
+        unsigned int best = 0;
+        unsigned int bestError = 0xffffffff;
+        for (int k=0; k<a_numColors; k++)
+        {
+            int dr = (int)p[0] - a_palette[k][0];
+            int dg = (int)p[1] - a_palette[k][1];
+            int db = (int)p[2] - a_palette[k][2];
+            unsigned int error = (unsigned int)(dr * dr + dg * dg + db * db);
+            if (error < bestError)
+            {
+                bestError = error;
+                best = k;
+            }
+        }
+        indices |= best << (2 * i);
+        a_error += bestError;
+    }
+    return (indices);
+}
+
+static unsigned int _encodeColorEndpoints(const unsigned char* a_rgba,
+                                          const bool* a_transparent,
+                                          const bool a_fourColors,
+                                          const int* a_color0,
+                                          const int* a_color1,
+                                          unsigned short& a_packed0,
+                                          unsigned short& a_packed1,
+                                          unsigned int& a_indices)
+{
+    unsigned short e0 = _pack565(a_color0);
+    unsigned short e1 = _pack565(a_color1);
+
+    // four color mode requires color0 > color1, three color mode color0 <= color1
+    if ((a_fourColors && (e0 < e1)) || (!a_fourColors && (e0 > e1)))
+    {
+        unsigned short t = e0; e0 = e1; e1 = t;
+    }
+
+    // equal endpoints are decoded in three color mode, which still reproduces them
+    bool fourColors = (e0 > e1);
+    int palette[4][3];
+    _colorPalette(e0, e1, fourColors, palette);
+
+    unsigned int error;
+    a_indices = _colorIndices(a_rgba, a_transparent, palette, fourColors ? 4 : 3, error);
+    a_packed0 = e0;
+    a_packed1 = e1;
+    return (error);
+}
+
+static void _encodeColorBlock(const unsigned char* a_rgba,
+                              unsigned char* a_dst,
+                              const bool a_punchThroughAlpha)
+{
+    // identify transparent pixels
+    bool transparent[16];
+    int numOpaque = 0;
+    for (int i=0; i<16; i++)
+    {
+        transparent[i] = a_punchThroughAlpha && (a_rgba[4 * i + 3] < 128);
+        if (!transparent[i]) { numOpaque++; }
+    }
+    bool fourColors = (numOpaque == 16);
+
+    // fully transparent block
+    if (numOpaque == 0)
+    {
+        memset(a_dst, 0, 4);
+        memset(a_dst + 4, 0xff, 4);
+        return;
+    }
+
+    // mean and covariance of the opaque pixels
+    double mean[3] = { 0.0, 0.0, 0.0 };
+    for (int i=0; i<16; i++)
+    {
+        if (transparent[i]) { continue; }
+        for (int c=0; c<3; c++) { mean[c] += a_rgba[4 * i + c]; }
+    }
+    for (int c=0; c<3; c++) { mean[c] /= numOpaque; }
+
+    double cov[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    for (int i=0; i<16; i++)
+    {
+        if (transparent[i]) { continue; }
+        double r = a_rgba[4 * i + 0] - mean[0];
+        double g = a_rgba[4 * i + 1] - mean[1];
+        double b = a_rgba[4 * i + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // principal axis by power iteration
+    double axis[3] = { 1.0, 1.0, 1.0 };
+    for (int k=0; k<8; k++)
+    {
+        double x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        double y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        double z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        double norm = cMax(fabs(x), cMax(fabs(y), fabs(z)));
+        if (norm < 1e-9) { break; }
+        axis[0] = x / norm; axis[1] = y / norm; axis[2] = z / norm;
+    }
+
+    // extreme pixels along the axis
+    int minIndex = -1;
+    int maxIndex = -1;
+    double minDot = 0.0;
+    double maxDot = 0.0;
+    for (int i=0; i<16; i++)
+    {
+        if (transparent[i]) { continue; }
+        double d = (a_rgba[4 * i + 0] - mean[0]) * axis[0] +
+                   (a_rgba[4 * i + 1] - mean[1]) * axis[1] +
+                   (a_rgba[4 * i + 2] - mean[2]) * axis[2];
+        if ((minIndex < 0) || (d < minDot)) { minDot = d; minIndex = i; }
+        if ((maxIndex < 0) || (d > maxDot)) { maxDot = d; maxIndex = i; }
+    }
+
+    // inset endpoints by 1/16 of their range to reduce the average error
+    int color0[3], color1[3];
+    for (int c=0; c<3; c++)
+    {
+        int a = a_rgba[4 * maxIndex + c];
+        int b = a_rgba[4 * minIndex + c];
+        int inset = (a - b) / 16;
+        color0[c] = cClamp(a - inset, 0, 255);
+        color1[c] = cClamp(b + inset, 0, 255);
+    }
+
+    unsigned short e0, e1;
+    unsigned int indices;
+    unsigned int error = _encodeColorEndpoints(a_rgba, transparent, fourColors, color0, color1, e0, e1, indices);
+
+    // refine endpoints by least squares in four color mode
+    if (fourColors && (error > 0) && (e0 > e1))
+    {
+        static const double weights[4] = { 1.0, 0.0, 2.0 / 3.0, 1.0 / 3.0 };
+        double aa = 0.0, bb = 0.0, ab = 0.0;
+        double ax[3] = { 0.0, 0.0, 0.0 };
+        double bx[3] = { 0.0, 0.0, 0.0 };
+        for (int i=0; i<16; i++)
+        {
+            double a = weights[(indices >> (2 * i)) & 3];
+            double b = 1.0 - a;
+            aa += a * a; bb += b * b; ab += a * b;
+            for (int c=0; c<3; c++)
+            {
+                ax[c] += a * a_rgba[4 * i + c];
+                bx[c] += b * a_rgba[4 * i + c];
+            }
+        }
+
+        double det = aa * bb - ab * ab;
+        if (fabs(det) > 1e-6)
+        {
+            int refined0[3], refined1[3];
+            for (int c=0; c<3; c++)
+            {
+                refined0[c] = cClamp((int)((ax[c] * bb - bx[c] * ab) / det + 0.5), 0, 255);
+                refined1[c] = cClamp((int)((bx[c] * aa - ax[c] * ab) / det + 0.5), 0, 255);
+            }
+
+            unsigned short r0, r1;
+            unsigned int refinedIndices;
+            unsigned int refinedError = _encodeColorEndpoints(a_rgba, transparent, fourColors, refined0, refined1, r0, r1, refinedIndices);
+            if (refinedError < error)
+            {
+                e0 = r0; e1 = r1; indices = refinedIndices;
+            }
+        }
+    }
+
+    a_dst[0] = (unsigned char)(e0 & 0xff);
+    a_dst[1] = (unsigned char)(e0 >> 8);
+    a_dst[2] = (unsigned char)(e1 & 0xff);
+    a_dst[3] = (unsigned char)(e1 >> 8);
+    a_dst[4] = (unsigned char)(indices & 0xff);
+    a_dst[5] = (unsigned char)((indices >> 8) & 0xff);
+    a_dst[6] = (unsigned char)((indices >> 16) & 0xff);
+    a_dst[7] = (unsigned char)(indices >> 24);
+}
+
+static void _encodeExplicitAlphaBlock(const unsigned char* a_rgba, unsigned char* a_dst)
+{
+    for (int i=0; i<8; i++)
+    {
+        unsigned int a0 = (a_rgba[4 * (2 * i) + 3] * 15 + 127) / 255;
+        unsigned int a1 = (a_rgba[4 * (2 * i + 1) + 3] * 15 + 127) / 255;
+        a_dst[i] = (unsigned char)(a0 | (a1 << 4));
+    }
+}
+
+static void _encodeInterpolatedAlphaBlock(const unsigned char* a_rgba, unsigned char* a_dst)
+{
+    int alphaMin = 255;
+    int alphaMax = 0;
+    for (int i=0; i<16; i++)
+    {
+        alphaMin = cMin(alphaMin, (int)a_rgba[4 * i + 3]);
+        alphaMax = cMax(alphaMax, (int)a_rgba[4 * i + 3]);
+    }
+
+    // eight alpha mode: index 0 is alpha0, 1 is alpha1, 2..7 interpolate from alpha0 to alpha1
+    unsigned long long bits = 0;
+    int range = alphaMax - alphaMin;
+    if (range > 0)
+    {
+        for (int i=0; i<16; i++)
+        {
+            int t = ((alphaMax - a_rgba[4 * i + 3]) * 7 + range / 2) / range;
+            unsigned long long index = (t == 0) ? 0 : ((t == 7) ? 1 : t + 1);
+            bits |= index << (3 * i);
+        }
+    }
+
+    a_dst[0] = (unsigned char)alphaMax;
+    a_dst[1] = (unsigned char)alphaMin;
+    for (int i=0; i<6; i++)
+    {
+        a_dst[2 + i] = (unsigned char)((bits >> (8 * i)) & 0xff);
+    }
+}
+
+static void _decodeColorBlock(const unsigned char* a_src,
+                              unsigned char* a_rgba,
+                              const bool a_forceFourColors,
+                              const bool a_punchThroughAlpha)
+{
+    unsigned short e0 = (unsigned short)(a_src[0] | (a_src[1] << 8));
+    unsigned short e1 = (unsigned short)(a_src[2] | (a_src[3] << 8));
+    bool fourColors = a_forceFourColors || (e0 > e1);
+
+    int palette[4][3];
+    _colorPalette(e0, e1, fourColors, palette);
+
+    unsigned int indices = a_src[4] | (a_src[5] << 8) | (a_src[6] << 16) | ((unsigned int)a_src[7] << 24);
+    for (int i=0; i<16; i++)
+    {
+        unsigned int index = (indices >> (2 * i)) & 3;
+        unsigned char* p = a_rgba + 4 * i;
+        p[0] = (unsigned char)palette[index][0];
+        p[1] = (unsigned char)palette[index][1];
+        p[2] = (unsigned char)palette[index][2];
+        p[3] = (a_punchThroughAlpha && !fourColors && (index == 3)) ? 0 : 0xff;
+    }
+}
+
+static void _decodeExplicitAlphaBlock(const unsigned char* a_src, unsigned char* a_rgba)
+{
+    for (int i=0; i<16; i++)
+    {
+        unsigned int a = (a_src[i / 2] >> (4 * (i & 1))) & 0x0f;
+        a_rgba[4 * i + 3] = (unsigned char)(a * 17);
+    }
+}
+
+static void _decodeInterpolatedAlphaBlock(const unsigned char* a_src, unsigned char* a_rgba)
+{
+    int palette[8];
+    palette[0] = a_src[0];
+    palette[1] = a_src[1];
+    if (palette[0] > palette[1])
+    {
+        for (int k=1; k<7; k++)
+        {
+            palette[k + 1] = ((7 - k) * palette[0] + k * palette[1]) / 7;
+        }
+    }
+    else
+    {
+        for (int k=1; k<5; k++)
+        {
+            palette[k + 1] = ((5 - k) * palette[0] + k * palette[1]) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    unsigned long long bits = 0;
+    for (int i=0; i<6; i++)
+    {
+        bits |= (unsigned long long)a_src[2 + i] << (8 * i);
+    }
+    for (int i=0; i<16; i++)
+    {
+        a_rgba[4 * i + 3] = (unsigned char)palette[(bits >> (3 * i)) & 7];
+    }
+}
+
+static void _encodeBlock(const unsigned char* a_rgba, unsigned char* a_dst, const GLenum a_format)
+{
+    switch (a_format)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+            _encodeColorBlock(a_rgba, a_dst, false);
+            break;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+            _encodeColorBlock(a_rgba, a_dst, true);
+            break;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+            _encodeExplicitAlphaBlock(a_rgba, a_dst);
+            _encodeColorBlock(a_rgba, a_dst + 8, false);
+            break;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            _encodeInterpolatedAlphaBlock(a_rgba, a_dst);
+            _encodeColorBlock(a_rgba, a_dst + 8, false);
+            break;
+    }
+}
+
+static void _decodeBlock(const unsigned char* a_src, unsigned char* a_rgba, const GLenum a_format)
+{
+    switch (a_format)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+            _decodeColorBlock(a_src, a_rgba, false, false);
+            break;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+            _decodeColorBlock(a_src, a_rgba, false, true);
+            break;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+            _decodeColorBlock(a_src + 8, a_rgba, true, false);
+            _decodeExplicitAlphaBlock(a_src, a_rgba);
+            break;
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            _decodeColorBlock(a_src + 8, a_rgba, true, false);
+            _decodeInterpolatedAlphaBlock(a_src, a_rgba);
+            break;
+    }
+}
+
+static void _forEachBlockRowRange(const unsigned int a_width,
+                                  const unsigned int a_height,
+                                  const function<void(unsigned int, unsigned int)>& a_rowRange)
+{
+    unsigned int numBlocksX = (a_width + 3) / 4;
+    unsigned int numBlocksY = (a_height + 3) / 4;
+    unsigned int rowsPerTask = cMax(1u, C_COMPRESSED_IMAGE_BLOCKS_PER_TASK / numBlocksX);
+    unsigned int numTasks = (numBlocksY + rowsPerTask - 1) / rowsPerTask;
+
+    cThreadPool::getSharedThreadPool()->parallelFor(numTasks, [&](unsigned int a_task)
+    {
+        unsigned int first = a_task * rowsPerTask;
+        a_rowRange(first, cMin(first + rowsPerTask, numBlocksY));
+    });
+}
+
+static void _compressLevel(const unsigned char* a_rgba,
+                           const unsigned int a_width,
+                           const unsigned int a_height,
+                           const GLenum a_format,
+                           unsigned char* a_dst)
+{
+    unsigned int blockSize = cCompressedImage::queryBytesPerBlock(a_format);
+    unsigned int numBlocksX = (a_width + 3) / 4;
+
+    _forEachBlockRowRange(a_width, a_height, [&](unsigned int a_first, unsigned int a_last)
+    {
+        unsigned char block[64];
+        for (unsigned int by=a_first; by<a_last; by++)
+        {
+            for (unsigned int bx=0; bx<numBlocksX; bx++)
+            {
+                // fetch block, replicating edge pixels of partial blocks
+                for (unsigned int y=0; y<4; y++)
+                {
+                    unsigned int sy = cMin(4 * by + y, a_height - 1);
+                    for (unsigned int x=0; x<4; x++)
+                    {
+                        unsigned int sx = cMin(4 * bx + x, a_width - 1);
+                        memcpy(block + 4 * (4 * y + x), a_rgba + 4 * (sy * a_width + sx), 4);
+                    }
+                }
+                _encodeBlock(block, a_dst + blockSize * (by * numBlocksX + bx), a_format);
+            }
+        }
+    });
+}
+
+static void _decompressLevel(const unsigned char* a_src,
+                             const unsigned int a_width,
+                             const unsigned int a_height,
+                             const GLenum a_format,
+                             unsigned char* a_rgba)
+{
+    unsigned int blockSize = cCompressedImage::queryBytesPerBlock(a_format);
+    unsigned int numBlocksX = (a_width + 3) / 4;
+
+    _forEachBlockRowRange(a_width, a_height, [&](unsigned int a_first, unsigned int a_last)
+    {
+        unsigned char block[64];
+        for (unsigned int by=a_first; by<a_last; by++)
+        {
+            unsigned int rows = cMin(4u, a_height - 4 * by);
+            for (unsigned int bx=0; bx<numBlocksX; bx++)
+            {
+                _decodeBlock(a_src + blockSize * (by * numBlocksX + bx), block, a_format);
+
+                // store the pixels of the block that lie inside the image
+                unsigned int cols = cMin(4u, a_width - 4 * bx);
+                for (unsigned int y=0; y<rows; y++)
+                {
+                    memcpy(a_rgba + 4 * ((4 * by + y) * a_width + 4 * bx), block + 16 * y, 4 * cols);
+                }
+            }
+        }
+    });
+}
+
+static void _downsampleLevel(const unsigned char* a_rgba,
+                             const unsigned int a_width,
+                             const unsigned int a_height,
+                             vector<unsigned char>& a_dst)
+{
+    unsigned int width = cMax(1u, a_width / 2);
+    unsigned int height = cMax(1u, a_height / 2);
+    a_dst.resize(4 * width * height);
+
+    // 2x2 box filter, clamped at the edges of odd sized levels
+    for (unsigned int y=0; y<height; y++)
+    {
+        const unsigned char* row0 = a_rgba + 4 * a_width * cMin(2 * y, a_height - 1);
+        const unsigned char* row1 = a_rgba + 4 * a_width * cMin(2 * y + 1, a_height - 1);
+        unsigned char* dst = &a_dst[4 * width * y];
+        for (unsigned int x=0; x<width; x++)
+        {
+            unsigned int x0 = 4 * cMin(2 * x, a_width - 1);
+            unsigned int x1 = 4 * cMin(2 * x + 1, a_width - 1);
+            for (unsigned int c=0; c<4; c++)
+            {
+                dst[c] = (unsigned char)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+            }
+            dst += 4;
+        }
+    }
+}
+
+static void _flipBlockRows(unsigned char* a_block, const GLenum a_format, const unsigned int a_numRows)
+{
+    unsigned char* color = a_block;
+
+    if (a_format == GL_COMPRESSED_RGBA_S3TC_DXT3_EXT)
+    {
+        // explicit alpha: two bytes per row
+        for (unsigned int i=0; i<a_numRows/2; i++)
+        {
+            unsigned int j = a_numRows - 1 - i;
+            swap(a_block[2 * i], a_block[2 * j]);
+            swap(a_block[2 * i + 1], a_block[2 * j + 1]);
+        }
+        color = a_block + 8;
+    }
+    else if (a_format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+    {
+        // interpolated alpha: twelve bits per row
+        unsigned long long bits = 0;
+        for (int i=0; i<6; i++)
+        {
+            bits |= (unsigned long long)a_block[2 + i] << (8 * i);
+        }
+        unsigned long long flipped = bits;
+        for (unsigned int i=0; i<a_numRows; i++)
+        {
+            unsigned long long row = (bits >> (12 * i)) & 0xfff;
+            unsigned int j = a_numRows - 1 - i;
+            flipped &= ~(0xfffull << (12 * j));
+            flipped |= row << (12 * j);
+        }
+        for (int i=0; i<6; i++)
+        {
+            a_block[2 + i] = (unsigned char)((flipped >> (8 * i)) & 0xff);
+        }
+        color = a_block + 8;
+    }
+
+    // color indices: one byte per row
+    for (unsigned int i=0; i<a_numRows/2; i++)
+    {
+        swap(color[4 + i], color[4 + a_numRows - 1 - i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Default constructor of cCompressedImage.
+*/
+//==============================================================================
+cCompressedImage::cCompressedImage()
+{
+    m_width = 0;
+    m_height = 0;
+    m_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+
+//==============================================================================
+/*!
+    This method creates a copy of itself.
+
+    \return Pointer to new compressed image.
+*/
+//==============================================================================
+cCompressedImagePtr cCompressedImage::copy()
+{
+    cCompressedImagePtr image = cCompressedImage::create();
+    image->m_filename = m_filename;
+    image->m_width = m_width;
+    image->m_height = m_height;
+    image->m_format = m_format;
+    image->m_data = m_data;
+    image->m_levelOffsets = m_levelOffsets;
+
+    return (image);
+}
+
+
+//==============================================================================
+/*!
+    This method allocates a compressed image by defining its size, compressed
+    format and number of mipmap levels. Level __i__ has a size of
+    max(1, width >> i) by max(1, height >> i) pixels. Image data is cleared
+    to zero.
+
+    \param  a_width      Width of the base level in pixels.
+    \param  a_height     Height of the base level in pixels.
+    \param  a_format     Compressed format (GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+                         GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+                         GL_COMPRESSED_RGBA_S3TC_DXT3_EXT or
+                         GL_COMPRESSED_RGBA_S3TC_DXT5_EXT).
+    \param  a_numLevels  Number of mipmap levels, including the base level.
+
+    \return __true__ if the image was allocated, __false__ otherwise.
+*/
+//==============================================================================
+bool cCompressedImage::allocate(const unsigned int a_width,
+                                const unsigned int a_height,
+                                const GLenum a_format,
+                                const unsigned int a_numLevels)
+{
+    // sanity check (also rejects images whose size does not fit in memory offsets)
+    size_t size = querySize(a_format, a_width, a_height, a_numLevels);
+    if (size == 0)
+    {
+        return (false);
+    }
+
+    // compute level offsets
+    m_levelOffsets.resize(a_numLevels);
+    unsigned int offset = 0;
+    for (unsigned int i=0; i<a_numLevels; i++)
+    {
+        m_levelOffsets[i] = offset;
+        offset += queryLevelSize(a_format, cMax(1u, a_width >> i), cMax(1u, a_height >> i));
+    }
+
+    // allocate data
+    m_data.assign(size, 0);
+    m_width = a_width;
+    m_height = a_height;
+    m_format = a_format;
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method deletes all image data from memory.
+*/
+//==============================================================================
+void cCompressedImage::erase()
+{
+    m_width = 0;
+    m_height = 0;
+    vector<unsigned char>().swap(m_data);
+    m_levelOffsets.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method returns the width of a mipmap level.
+
+    \param  a_level  Mipmap level.
+
+    \return Width in pixels.
+*/
+//==============================================================================
+unsigned int cCompressedImage::getLevelWidth(const unsigned int a_level) const
+{
+    return (cMax(1u, m_width >> a_level));
+}
+
+
+//==============================================================================
+/*!
+    This method returns the height of a mipmap level.
+
+    \param  a_level  Mipmap level.
+
+    \return Height in pixels.
+*/
+//==============================================================================
+unsigned int cCompressedImage::getLevelHeight(const unsigned int a_level) const
+{
+    return (cMax(1u, m_height >> a_level));
+}
+
+
+//==============================================================================
+/*!
+    This method returns the size in bytes of a mipmap level.
+
+    \param  a_level  Mipmap level.
+
+    \return Size in bytes, or 0 if the level does not exist.
+*/
+//==============================================================================
+unsigned int cCompressedImage::getLevelSize(const unsigned int a_level) const
+{
+    if (a_level >= m_levelOffsets.size())
+    {
+        return (0);
+    }
+    return (queryLevelSize(m_format, getLevelWidth(a_level), getLevelHeight(a_level)));
+}
+
+
+//==============================================================================
+/*!
+    This method returns a pointer to the data of a mipmap level.
+
+    \param  a_level  Mipmap level.
+
+    \return Pointer to level data, or __nullptr__ if the level does not exist.
+*/
+//==============================================================================
+unsigned char* cCompressedImage::getLevelData(const unsigned int a_level)
+{
+    if (a_level >= m_levelOffsets.size())
+    {
+        return (nullptr);
+    }
+    return (&m_data[m_levelOffsets[a_level]]);
+}
+
+
+//==============================================================================
+/*!
+    This method compresses an image on the CPU. Images of any pixel format
+    are converted to RGBA first. If mipmaps are requested, the complete
+    chain down to 1x1 pixels is generated with a box filter and compressed.
+    Blocks are compressed in parallel using the shared thread pool.
+
+    \param  a_image            Source image (GL_UNSIGNED_BYTE pixels).
+    \param  a_format           Compressed format.
+    \param  a_generateMipmaps  If __true__, all mipmap levels are generated.
+
+    \return __true__ if compression succeeded, __false__ otherwise.
+*/
+//==============================================================================
+bool cCompressedImage::compress(cImagePtr a_image,
+                                const GLenum a_format,
+                                const bool a_generateMipmaps)
+{
+    // sanity check
+    if ((a_image == nullptr) || (!a_image->isInitialized()) ||
+        (a_image->getType() != GL_UNSIGNED_BYTE) ||
+        (queryBytesPerBlock(a_format) == 0))
+    {
+        return (false);
+    }
+
+    // convert image to RGBA if needed
+    cImagePtr image = a_image;
+    if (image->getFormat() != GL_RGBA)
+    {
+        image = a_image->copy();
+        if (!image->convert(GL_RGBA))
+        {
+            return (false);
+        }
+    }
+
+    unsigned int width = image->getWidth();
+    unsigned int height = image->getHeight();
+    unsigned int numLevels = a_generateMipmaps ? queryNumLevels(width, height) : 1;
+    if (!allocate(width, height, a_format, numLevels))
+    {
+        return (false);
+    }
+
+    // compress each level, downsampling the previous one
+    const unsigned char* level = image->getData();
+    vector<unsigned char> buffer, next;
+    for (unsigned int i=0; i<numLevels; i++)
+    {
+        unsigned int levelWidth = getLevelWidth(i);
+        unsigned int levelHeight = getLevelHeight(i);
+        _compressLevel(level, levelWidth, levelHeight, a_format, getLevelData(i));
+
+        if (i + 1 < numLevels)
+        {
+            _downsampleLevel(level, levelWidth, levelHeight, next);
+            buffer.swap(next);
+            level = &buffer[0];
+        }
+    }
+
+    m_filename = a_image->getFilename();
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method decompresses a mipmap level into an RGBA image.
+
+    \param  a_image  Destination image.
+    \param  a_level  Mipmap level.
+
+    \return __true__ if decompression succeeded, __false__ otherwise.
+*/
+//==============================================================================
+bool cCompressedImage::decompress(cImagePtr a_image, const unsigned int a_level)
+{
+    // sanity check
+    if ((a_image == nullptr) || (a_level >= getNumLevels()))
+    {
+        return (false);
+    }
+
+    unsigned int width = getLevelWidth(a_level);
+    unsigned int height = getLevelHeight(a_level);
+    if (!a_image->allocate(width, height, GL_RGBA, GL_UNSIGNED_BYTE))
+    {
+        return (false);
+    }
+
+    _decompressLevel(getLevelData(a_level), width, height, m_format, a_image->getData());
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method flips all mipmap levels horizontally, so that the top row
+    becomes the bottom row. Blocks are reordered and their rows flipped in
+    place. Levels whose height is larger than four pixels but not a multiple
+    of four are decompressed, flipped and compressed again.
+*/
+//==============================================================================
+void cCompressedImage::flipHorizontal()
+{
+    unsigned int blockSize = queryBytesPerBlock(m_format);
+
+    for (unsigned int i=0; i<getNumLevels(); i++)
+    {
+        unsigned int width = getLevelWidth(i);
+        unsigned int height = getLevelHeight(i);
+        unsigned char* data = getLevelData(i);
+
+        // partial block rows cannot be flipped in place
+        if ((height > 4) && (height % 4 != 0))
+        {
+            vector<unsigned char> pixels(4 * width * height);
+            vector<unsigned char> line(4 * width);
+            _decompressLevel(data, width, height, m_format, &pixels[0]);
+            for (unsigned int y=0; y<height/2; y++)
+            {
+                unsigned char* row0 = &pixels[4 * width * y];
+                unsigned char* row1 = &pixels[4 * width * (height - 1 - y)];
+                memcpy(&line[0], row0, 4 * width);
+                memcpy(row0, row1, 4 * width);
+                memcpy(row1, &line[0], 4 * width);
+            }
+            _compressLevel(&pixels[0], width, height, m_format, data);
+            continue;
+        }
+
+        // reverse block rows
+        unsigned int rowSize = blockSize * ((width + 3) / 4);
+        unsigned int numBlockRows = (height + 3) / 4;
+        vector<unsigned char> line(rowSize);
+        for (unsigned int y=0; y<numBlockRows/2; y++)
+        {
+            unsigned char* row0 = data + rowSize * y;
+            unsigned char* row1 = data + rowSize * (numBlockRows - 1 - y);
+            memcpy(&line[0], row0, rowSize);
+            memcpy(row0, row1, rowSize);
+            memcpy(row1, &line[0], rowSize);
+        }
+
+        // flip pixel rows inside each block
+        unsigned int numRows = cMin(4u, height);
+        for (unsigned int j=0; j<getLevelSize(i); j+=blockSize)
+        {
+            _flipBlockRows(data + j, m_format, numRows);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method loads a compressed image file by passing a filename as
+    argument. Supported formats are __dds__ and __ktx__.
+
+    \param  a_filename  Filename.
+
+    \return __true__ if the file was loaded successfully, __false__ otherwise.
+*/
+//==============================================================================
+bool cCompressedImage::loadFromFile(const string& a_filename)
+{
+    // find extension
+    string fileType = cStrToLower(cGetFileExtension(a_filename));
+
+    // result for loading file
+    bool result = false;
+
+    //--------------------------------------------------------------------
+    // .DDS FORMAT
+    //--------------------------------------------------------------------
+    if (fileType == "dds")
+    {
+        result = cLoadFileDDS(this, a_filename);
+    }
+
+    //--------------------------------------------------------------------
+    // .KTX FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "ktx")
+    {
+        result = cLoadFileKTX(this, a_filename);
+    }
+
+    if (result)
+    {
+        m_filename = a_filename;
+    }
+    else
+    {
+        erase();
+    }
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method saves a compressed image file by passing a filename as
+    argument. Supported formats are __dds__ and __ktx__.
+
+    \param  a_filename  Filename.
+
+    \return __true__ if the file was saved successfully, __false__ otherwise.
+*/
+//==============================================================================
+bool cCompressedImage::saveToFile(const string& a_filename)
+{
+    // sanity check
+    if (!isInitialized())
+    {
+        return (false);
+    }
+
+    // find extension
+    string fileType = cStrToLower(cGetFileExtension(a_filename));
+
+    // result for saving file
+    bool result = false;
+
+    //--------------------------------------------------------------------
+    // .DDS FORMAT
+    //--------------------------------------------------------------------
+    if (fileType == "dds")
+    {
+        result = cSaveFileDDS(this, a_filename);
+    }
+
+    //--------------------------------------------------------------------
+    // .KTX FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "ktx")
+    {
+        result = cSaveFileKTX(this, a_filename);
+    }
+
+    if (result)
+    {
+        m_filename = a_filename;
+    }
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of bytes per 4x4 block of a compressed
+    format.
+
+    \param  a_format  Compressed format.
+
+    \return Bytes per block, or 0 if the format is not supported.
+*/
+//==============================================================================
+unsigned int cCompressedImage::queryBytesPerBlock(const GLenum a_format)
+{
+    switch (a_format)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+            return (8);
+
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            return (16);
+
+        default:
+            return (0);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the size in bytes of an image of a given compressed
+    format and size.
+
+    \param  a_format  Compressed format.
+    \param  a_width   Width in pixels.
+    \param  a_height  Height in pixels.
+
+    \return Size in bytes, or 0 if the format is not supported or the size
+            does not fit in an __unsigned int__.
+*/
+//==============================================================================
+unsigned int cCompressedImage::queryLevelSize(const GLenum a_format,
+                                              const unsigned int a_width,
+                                              const unsigned int a_height)
+{
+    return ((unsigned int)(querySize(a_format, a_width, a_height, 1)));
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of levels of a complete mipmap chain for
+    an image of a given size.
+
+    \param  a_width   Width in pixels.
+    \param  a_height  Height in pixels.
+
+    \return Number of levels, including the base level.
+*/
+//==============================================================================
+unsigned int cCompressedImage::queryNumLevels(const unsigned int a_width,
+                                              const unsigned int a_height)
+{
+    unsigned int size = cMax(a_width, a_height);
+    unsigned int numLevels = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        numLevels++;
+    }
+    return (numLevels);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the size in bytes of an image of a given compressed
+    format and size, including the requested number of mipmap levels. Sizes
+    are computed without overflow: images whose total size does not fit in
+    an __unsigned int__ (the type of level offsets) are reported as invalid.
+    File loaders use this method to check image dimensions against the size
+    of the file before allocating memory.
+
+    \param  a_format     Compressed format.
+    \param  a_width      Width of the base level in pixels.
+    \param  a_height     Height of the base level in pixels.
+    \param  a_numLevels  Number of mipmap levels, including the base level.
+
+    \return Size in bytes, or 0 if the image is invalid or too large.
+*/
+//==============================================================================
+size_t cCompressedImage::querySize(const GLenum a_format,
+                                   const unsigned int a_width,
+                                   const unsigned int a_height,
+                                   const unsigned int a_numLevels)
+{
+    // sanity check
+    size_t bytesPerBlock = queryBytesPerBlock(a_format);
+    if ((a_width == 0) || (a_height == 0) || (bytesPerBlock == 0) ||
+        (a_numLevels == 0) || (a_numLevels > queryNumLevels(a_width, a_height)))
+    {
+        return (0);
+    }
+
+    // add level sizes, checking each operation against the maximum size
+    const size_t maxSize = (size_t)(UINT_MAX);
+    size_t size = 0;
+    for (unsigned int i=0; i<a_numLevels; i++)
+    {
+        unsigned int width = cMax(1u, a_width >> i);
+        unsigned int height = cMax(1u, a_height >> i);
+        size_t blocksX = (size_t)(width / 4) + ((width % 4) != 0);
+        size_t blocksY = (size_t)(height / 4) + ((height % 4) != 0);
+
+        if ((blocksX > maxSize / bytesPerBlock) ||
+            (blocksY > maxSize / (blocksX * bytesPerBlock)))
+        {
+            return (0);
+        }
+
+        size_t levelSize = blocksX * blocksY * bytesPerBlock;
+        if (levelSize > maxSize - size)
+        {
+            return (0);
+        }
+
+        size += levelSize;
+    }
+
+    return (size);
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,247 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CCompressedImageH
+#define CCompressedImageH
+//------------------------------------------------------------------------------
+#include "graphics/CImage.h"
+//------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CCompressedImage.h
+
+    \brief
+    Implements a block compressed 2D image data structure.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cCompressedImage;
+typedef std::shared_ptr<cCompressedImage> cCompressedImagePtr;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cCompressedImage
+    \ingroup    graphics
+
+    \brief
+    This class implements a block compressed 2D image data structure.
+
+    \details
+    This class stores a 2D image and its mipmap levels in one of the S3TC
+    (BC1, BC2, BC3) block compressed formats supported by graphics hardware:
+    GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+    GL_COMPRESSED_RGBA_S3TC_DXT3_EXT and GL_COMPRESSED_RGBA_S3TC_DXT5_EXT. \n
+
+    Compressed images can be loaded from __dds__ and __ktx__ files, or created
+    on the CPU from a \ref cImage by calling \ref compress(). Rows are stored
+    bottom-up, as in \ref cImage, so that level data can be passed to OpenGL
+    as is.
+*/
+//==============================================================================
+class cCompressedImage
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Default constructor of cCompressedImage.
+    cCompressedImage();
+
+    //! Destructor of cCompressedImage.
+    virtual ~cCompressedImage() {}
+
+    //! Shared cCompressedImage allocator.
+    static cCompressedImagePtr create() { return (std::make_shared<cCompressedImage>()); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - GENERAL COMMANDS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method creates a copy itself.
+    cCompressedImagePtr copy();
+
+    //! This method allocates a compressed image by defining its size, compressed format and number of mipmap levels.
+    bool allocate(const unsigned int a_width,
+                  const unsigned int a_height,
+                  const GLenum a_format,
+                  const unsigned int a_numLevels = 1);
+
+    //! This method deletes all image data from memory.
+    void erase();
+
+    //! This method returns __true__ if the image has been allocated in memory, __false__ otherwise.
+    inline bool isInitialized() const { return (m_levelOffsets.size() > 0); }
+
+    //! This method returns the width of the base level.
+    inline unsigned int getWidth() const { return (m_width); }
+
+    //! This method returns the height of the base level.
+    inline unsigned int getHeight() const { return (m_height); }
+
+    //! This method returns the compressed format of the image.
+    inline GLenum getFormat() const { return (m_format); }
+
+    //! This method returns the number of mipmap levels stored, including the base level.
+    inline unsigned int getNumLevels() const { return ((unsigned int)(m_levelOffsets.size())); }
+
+    //! This method returns the width of a mipmap level.
+    unsigned int getLevelWidth(const unsigned int a_level) const;
+
+    //! This method returns the height of a mipmap level.
+    unsigned int getLevelHeight(const unsigned int a_level) const;
+
+    //! This method returns the size in bytes of a mipmap level.
+    unsigned int getLevelSize(const unsigned int a_level) const;
+
+    //! This method returns a pointer to the data of a mipmap level.
+    unsigned char* getLevelData(const unsigned int a_level);
+
+    //! This method returns the size in bytes of all mipmap levels.
+    inline unsigned int getSizeInBytes() const { return ((unsigned int)(m_data.size())); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - COMPRESSION:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method compresses an image on the CPU, optionally generating all mipmap levels.
+    bool compress(cImagePtr a_image,
+                  const GLenum a_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+                  const bool a_generateMipmaps = true);
+
+    //! This method decompresses a mipmap level into an RGBA image.
+    bool decompress(cImagePtr a_image, const unsigned int a_level = 0);
+
+    //! This method flips all mipmap levels horizontally.
+    void flipHorizontal();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - FILES:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method loads a compressed image file (__dds__ or __ktx__) by passing a filename as argument.
+    bool loadFromFile(const std::string& a_filename);
+
+    //! This method saves a compressed image file (__dds__ or __ktx__) by passing a filename as argument.
+    bool saveToFile(const std::string& a_filename);
+
+    //! This method returns the filename from which this image was last loaded or saved.
+    std::string getFilename() const { return (m_filename); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of bytes per 4x4 block of a compressed format, or 0 if the format is not supported.
+    static unsigned int queryBytesPerBlock(const GLenum a_format);
+
+    //! This method returns the size in bytes of an image of a given compressed format and size.
+    static unsigned int queryLevelSize(const GLenum a_format,
+                                       const unsigned int a_width,
+                                       const unsigned int a_height);
+
+    //! This method returns the number of levels of a complete mipmap chain for an image of a given size.
+    static unsigned int queryNumLevels(const unsigned int a_width,
+                                       const unsigned int a_height);
+
+    //! This method returns the size in bytes of an image and its mipmap levels, or 0 if the image is invalid or too large.
+    static size_t querySize(const GLenum a_format,
+                            const unsigned int a_width,
+                            const unsigned int a_height,
+                            const unsigned int a_numLevels);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Image filename.
+    std::string m_filename;
+
+    //! Width in pixels of the base level.
+    unsigned int m_width;
+
+    //! Height in pixels of the base level.
+    unsigned int m_height;
+
+    //! Compressed format of the image.
+    GLenum m_format;
+
+    //! Compressed data of all mipmap levels, stored contiguously.
+    std::vector<unsigned char> m_data;
+
+    //! Offset in bytes of each mipmap level in the data array.
+    std::vector<unsigned int> m_levelOffsets;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -109,6 +109,9 @@ public:
 
         // initialize OpenGL buffer ID 
         m_elementBuffer         = 0;
+
+        // initialize modification counter
+        m_modificationCounter   = 0;
     }
 
 
@@ -126,8 +129,10 @@ public:
         m_allocated.clear();
         m_indices.clear();
         m_freeElements.clear();
+        m_modifiedElements.clear();
         m_flagMarkForUpdate     = true;
         m_flagMarkForResize     = true;
+        m_modificationCounter++;
     }
 
 
@@ -150,6 +155,9 @@ public:
     //! This method removes non used elements. This compresses the array.
     void compress();
 
+    //! This method returns a counter that is incremented each time the vertex indices of an element change.
+    unsigned int getModificationCounter() const { return (m_modificationCounter); }
+
 
     //--------------------------------------------------------------------------
     /*!
@@ -238,6 +246,12 @@ public:
     //! If __true__ then element array size has changed.
     bool m_flagMarkForResize;
 
+    //! Counter incremented each time the vertex indices of an element change.
+    unsigned int m_modificationCounter;
+
+    //! Elements modified since the last GPU update. If empty while data is flagged as modified, all elements are updated.
+    cModifiedRanges m_modifiedElements;
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS: (OPENGL)
@@ -50,6 +50,16 @@
 #include "files/CFileImagePPM.h"
 #include "files/CFileImageRAW.h"
 #include "math/CMaths.h"
+#include "system/CThreadPool.h"
+//------------------------------------------------------------------------------
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define C_IMAGE_USE_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(C_IMAGE_USE_SSE2) && (defined(__SSSE3__) || defined(__AVX__))
+#define C_IMAGE_USE_SSSE3
+#include <tmmintrin.h>
+#endif
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -136,6 +146,9 @@ void cImage::defaults()
     // will not take care of freeing the image data.
     m_responsibleForMemoryAllocation = false;
 
+    // image properties may be changed by allocate()
+    m_fixedProperties   = false;
+
     // default border color is black
     m_borderColor.set(0x00, 0x00, 0x00, 0x00);
 }
@@ -163,7 +176,15 @@ void cImage::cleanup()
 //==============================================================================
 /*!
     This method allocates a new image by defining its width, height and pixel
-    format.
+    format. If the image already holds a buffer of the required size, including
+    memory assigned with \ref setData(), that buffer is reused instead of being
+    reallocated. \n
+
+    If the image properties have been locked with \ref setFixedProperties(),
+    this method returns __false__ without modifying the image unless the
+    requested properties match the current ones. On success, the current
+    buffer is then kept as is, since the caller (typically an image decoder)
+    is about to overwrite every pixel.
 
     \param  a_width   Width of image
     \param  a_height  Height of image
@@ -184,35 +205,52 @@ bool cImage::allocate(const unsigned int a_width,
         return (false);
     }
 
+    // locked images only accept their current properties and buffer
+    if (m_fixedProperties)
+    {
+        return ((m_data != NULL) &&
+                (m_width == a_width) &&
+                (m_height == a_height) &&
+                (m_format == a_format) &&
+                (m_type == a_type));
+    }
+
+    // the current buffer can be reused if it already has the required size
+    unsigned int memorySize = a_width * a_height * bytesPerPixel;
+    bool reuse = (m_allocated && (m_data != NULL) && (m_memorySize == memorySize));
+
     // allocate memory
     m_width             = a_width;
     m_height            = a_height;
     m_bytesPerPixel     = bytesPerPixel;
     m_format            = a_format;
     m_type              = a_type;
-    m_memorySize        = m_width * m_height * m_bytesPerPixel;
+    m_memorySize        = memorySize;
 
-    // delete current image data
-    if (m_data && m_responsibleForMemoryAllocation)
+    if (!reuse)
     {
-        delete [] m_data;
-    }
+        // delete current image data
+        if (m_data && m_responsibleForMemoryAllocation)
+        {
+            delete [] m_data;
+        }
 
-    // allocated new image data
-    m_data = new unsigned char[m_memorySize];
+        // allocated new image data
+        m_data = new unsigned char[m_memorySize];
 
-    // check if memory has been allocated, otherwise cleanup
-    if (m_data == NULL)
-    {
-        // allocation failed
-        cleanup();
-        return (false);
-    }
-    else
-    {
-        // image data has been allocated
-        m_allocated = true;
-        m_responsibleForMemoryAllocation = true;
+        // check if memory has been allocated, otherwise cleanup
+        if (m_data == NULL)
+        {
+            // allocation failed
+            cleanup();
+            return (false);
+        }
+        else
+        {
+            // image data has been allocated
+            m_allocated = true;
+            m_responsibleForMemoryAllocation = true;
+        }
     }
 
     // clear image
@@ -433,10 +471,340 @@ bool cImage::setProperties(const unsigned int a_width,
 }
 
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Row kernels used to convert, copy and modify pixel data one image row at a
+// time. Luminance is computed as (r+g+b)/3; the vectorized kernels evaluate
+// the division as (sum * 43691) >> 17, which is exact for all sums up to 765.
+//------------------------------------------------------------------------------
+
+//! Function converting a row of a_count pixels from one pixel format to another.
+typedef void (*cImageRowConversion)(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count);
+
+//! Number of pixels processed by each task when an image operation is split across threads.
+static const unsigned int C_IMAGE_PIXELS_PER_TASK = 65536;
+
+template <unsigned int N>
+static void _rowCopy(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    memcpy(a_dst, a_src, N * a_count);
+}
+
+static void _rowRGBtoRGBA(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    unsigned int i = 0;
+#ifdef C_IMAGE_USE_SSSE3
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+    for (; i + 6 <= a_count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(a_src + 3 * i));
+        _mm_storeu_si128((__m128i*)(a_dst + 4 * i), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+    }
+#endif
+    const unsigned char* src = a_src + 3 * i;
+    unsigned char* dst = a_dst + 4 * i;
+    for (; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = 0xff;
+        src += 3;
+        dst += 4;
+    }
+}
+
+static void _rowRGBAtoRGB(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    unsigned int i = 0;
+#ifdef C_IMAGE_USE_SSSE3
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (; i + 6 <= a_count; i += 4)
+    {
+        // the last 4 bytes written are overwritten by the next iteration or the scalar tail
+        __m128i v = _mm_loadu_si128((const __m128i*)(a_src + 4 * i));
+        _mm_storeu_si128((__m128i*)(a_dst + 3 * i), _mm_shuffle_epi8(v, shuffle));
+    }
+#endif
+    const unsigned char* src = a_src + 4 * i;
+    unsigned char* dst = a_dst + 3 * i;
+    for (; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        src += 4;
+        dst += 3;
+    }
+}
+
+#ifdef C_IMAGE_USE_SSE2
+static inline __m128i _luminance8(const __m128i& a_rgba0, const __m128i& a_rgba1)
+{
+    // sums the r, g and b components of two groups of 4 RGBA pixels and divides by 3
+    const __m128i mask = _mm_set1_epi32(0xff);
+    __m128i s0 = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(a_rgba0, mask),
+                                             _mm_and_si128(_mm_srli_epi32(a_rgba0, 8), mask)),
+                                             _mm_and_si128(_mm_srli_epi32(a_rgba0, 16), mask));
+    __m128i s1 = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(a_rgba1, mask),
+                                             _mm_and_si128(_mm_srli_epi32(a_rgba1, 8), mask)),
+                                             _mm_and_si128(_mm_srli_epi32(a_rgba1, 16), mask));
+    __m128i s = _mm_packs_epi32(s0, s1);
+    return (_mm_srli_epi16(_mm_mulhi_epu16(s, _mm_set1_epi16((short)43691)), 1));
+}
+#endif
+
+static void _rowRGBtoL(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    unsigned int i = 0;
+#ifdef C_IMAGE_USE_SSSE3
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    for (; i + 10 <= a_count; i += 8)
+    {
+        __m128i v0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(a_src + 3 * i)), shuffle);
+        __m128i v1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(a_src + 3 * i + 12)), shuffle);
+        __m128i l = _luminance8(v0, v1);
+        _mm_storel_epi64((__m128i*)(a_dst + i), _mm_packus_epi16(l, l));
+    }
+#endif
+    const unsigned char* src = a_src + 3 * i;
+    unsigned char* dst = a_dst + i;
+    for (; i < a_count; i++)
+    {
+        dst[0] = (unsigned char)(((unsigned short)(src[0]) +
+                                  (unsigned short)(src[1]) +
+                                  (unsigned short)(src[2])) / 3);
+        src += 3;
+        dst++;
+    }
+}
+
+static void _rowRGBAtoL(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    unsigned int i = 0;
+#ifdef C_IMAGE_USE_SSE2
+    for (; i + 8 <= a_count; i += 8)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(a_src + 4 * i));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(a_src + 4 * i + 16));
+        __m128i l = _luminance8(v0, v1);
+        _mm_storel_epi64((__m128i*)(a_dst + i), _mm_packus_epi16(l, l));
+    }
+#endif
+    const unsigned char* src = a_src + 4 * i;
+    unsigned char* dst = a_dst + i;
+    for (; i < a_count; i++)
+    {
+        dst[0] = (unsigned char)(((unsigned short)(src[0]) +
+                                  (unsigned short)(src[1]) +
+                                  (unsigned short)(src[2])) / 3);
+        src += 4;
+        dst++;
+    }
+}
+
+static void _rowRGBtoLA(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    const unsigned char* src = a_src;
+    unsigned char* dst = a_dst;
+    for (unsigned int i = 0; i < a_count; i++)
+    {
+        dst[0] = (unsigned char)(((unsigned short)(src[0]) +
+                                  (unsigned short)(src[1]) +
+                                  (unsigned short)(src[2])) / 3);
+        dst[1] = 0xff;
+        src += 3;
+        dst += 2;
+    }
+}
+
+static void _rowRGBAtoLA(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    const unsigned char* src = a_src;
+    unsigned char* dst = a_dst;
+    for (unsigned int i = 0; i < a_count; i++)
+    {
+        dst[0] = (unsigned char)(((unsigned short)(src[0]) +
+                                  (unsigned short)(src[1]) +
+                                  (unsigned short)(src[2])) / 3);
+        dst[1] = src[3];
+        src += 4;
+        dst += 2;
+    }
+}
+
+static void _rowLtoRGB(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    const unsigned char* src = a_src;
+    unsigned char* dst = a_dst;
+    for (unsigned int i = 0; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        dst[1] = src[0];
+        dst[2] = src[0];
+        src++;
+        dst += 3;
+    }
+}
+
+static void _rowLtoRGBA(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    unsigned int i = 0;
+#ifdef C_IMAGE_USE_SSE2
+    const __m128i alpha = _mm_set1_epi8(-1);
+    for (; i + 16 <= a_count; i += 16)
+    {
+        __m128i l = _mm_loadu_si128((const __m128i*)(a_src + i));
+        __m128i llLo = _mm_unpacklo_epi8(l, l);
+        __m128i llHi = _mm_unpackhi_epi8(l, l);
+        __m128i laLo = _mm_unpacklo_epi8(l, alpha);
+        __m128i laHi = _mm_unpackhi_epi8(l, alpha);
+        _mm_storeu_si128((__m128i*)(a_dst + 4 * i),      _mm_unpacklo_epi16(llLo, laLo));
+        _mm_storeu_si128((__m128i*)(a_dst + 4 * i + 16), _mm_unpackhi_epi16(llLo, laLo));
+        _mm_storeu_si128((__m128i*)(a_dst + 4 * i + 32), _mm_unpacklo_epi16(llHi, laHi));
+        _mm_storeu_si128((__m128i*)(a_dst + 4 * i + 48), _mm_unpackhi_epi16(llHi, laHi));
+    }
+#endif
+    const unsigned char* src = a_src + i;
+    unsigned char* dst = a_dst + 4 * i;
+    for (; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        dst[1] = src[0];
+        dst[2] = src[0];
+        dst[3] = 0xff;
+        src++;
+        dst += 4;
+    }
+}
+
+static void _rowLtoLA(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    const unsigned char* src = a_src;
+    unsigned char* dst = a_dst;
+    for (unsigned int i = 0; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        dst[1] = 0xff;
+        src++;
+        dst += 2;
+    }
+}
+
+static void _rowLAtoL(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    const unsigned char* src = a_src;
+    unsigned char* dst = a_dst;
+    for (unsigned int i = 0; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        src += 2;
+        dst++;
+    }
+}
+
+static void _rowLAtoRGB(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    const unsigned char* src = a_src;
+    unsigned char* dst = a_dst;
+    for (unsigned int i = 0; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        dst[1] = src[0];
+        dst[2] = src[0];
+        src += 2;
+        dst += 3;
+    }
+}
+
+static void _rowLAtoRGBA(const unsigned char* a_src, unsigned char* a_dst, const unsigned int a_count)
+{
+    const unsigned char* src = a_src;
+    unsigned char* dst = a_dst;
+    for (unsigned int i = 0; i < a_count; i++)
+    {
+        dst[0] = src[0];
+        dst[1] = src[0];
+        dst[2] = src[0];
+        dst[3] = src[1];
+        src += 2;
+        dst += 4;
+    }
+}
+
+static inline unsigned int _numComponents(const GLenum a_format)
+{
+    switch (a_format)
+    {
+        case GL_LUMINANCE:          return (1);
+        case GL_LUMINANCE_ALPHA:    return (2);
+        case GL_RGB:                return (3);
+        case GL_RGBA:               return (4);
+        default:                    return (0);
+    }
+}
+
+static cImageRowConversion _getRowConversion(const GLenum a_srcFormat, const GLenum a_dstFormat)
+{
+    // index 0 = L, 1 = LA, 2 = RGB, 3 = RGBA
+    static const cImageRowConversion conversions[4][4] =
+    {
+        { _rowCopy<1>,  _rowLtoLA,    _rowLtoRGB,    _rowLtoRGBA  },
+        { _rowLAtoL,    _rowCopy<2>,  _rowLAtoRGB,   _rowLAtoRGBA },
+        { _rowRGBtoL,   _rowRGBtoLA,  _rowCopy<3>,   _rowRGBtoRGBA },
+        { _rowRGBAtoL,  _rowRGBAtoLA, _rowRGBAtoRGB, _rowCopy<4>  }
+    };
+
+    unsigned int src = _numComponents(a_srcFormat);
+    unsigned int dst = _numComponents(a_dstFormat);
+    if ((src == 0) || (dst == 0))
+    {
+        return (NULL);
+    }
+
+    return (conversions[src-1][dst-1]);
+}
+
+static void _forEachRowBlock(const unsigned int a_numRows,
+                             const unsigned int a_rowLength,
+                             const std::function<void(unsigned int, unsigned int)>& a_function)
+{
+    // split rows in blocks of roughly C_IMAGE_PIXELS_PER_TASK pixels
+    unsigned int rowsPerBlock = cMax(1u, C_IMAGE_PIXELS_PER_TASK / cMax(1u, a_rowLength));
+    unsigned int numBlocks = (a_numRows + rowsPerBlock - 1) / rowsPerBlock;
+
+    // small images are processed on the calling thread
+    if (numBlocks <= 1)
+    {
+        a_function(0, a_numRows);
+        return;
+    }
+
+    cThreadPool::getSharedThreadPool()->parallelFor(numBlocks, [&](unsigned int a_block)
+    {
+        unsigned int first = a_block * rowsPerBlock;
+        unsigned int last = cMin(first + rowsPerBlock, a_numRows);
+        a_function(first, last);
+    });
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
 //==============================================================================
 /*!
     This method copies a section of this current image to a different location
-    or onto a different destination image.
+    or onto a different destination image. Large areas are converted in 
+    parallel by blocks of rows. If the source and destination images share 
+    memory, including when copying within the same image with overlapping 
+    areas, the source is first copied so that the result does not depend on
+    the order in which rows are processed.
 
     \param  a_sourcePosX   X coordinate of top left pixel to copy.
     \param  a_sourcePosY   Y coordinate of top left pixel to copy.
@@ -455,9 +823,6 @@ void cImage::copyTo(const unsigned int a_sourcePosX,
                     const unsigned int a_destPosX,
                     const unsigned int a_destPosY)
 {
-    // temp variables
-    unsigned int i,j;
-
     // sanity check
     if ((!m_allocated) || (a_destImage == nullptr))
         { return; }
@@ -465,10 +830,15 @@ void cImage::copyTo(const unsigned int a_sourcePosX,
     if (!a_destImage->isInitialized())
         { return; }
 
-    // if source and destination images are the same object, then we need
-    // to create a copied image of the source. (overwriting problem)
+    // if source and destination share memory (same image, or images whose
+    // data overlap), rows converted in parallel could read pixels that were
+    // already overwritten. we then convert from a copy of the source.
     cImagePtr temp_image = cImagePtr();
-    if (a_destImage->getData() == getData())
+    const unsigned char* src_begin = m_data;
+    const unsigned char* src_end = m_data + m_memorySize;
+    const unsigned char* dst_begin = a_destImage->m_data;
+    const unsigned char* dst_end = a_destImage->m_data + a_destImage->m_memorySize;
+    if ((src_begin < dst_end) && (dst_begin < src_end))
     {
         temp_image = copy();
     }
@@ -526,282 +896,29 @@ void cImage::copyTo(const unsigned int a_sourcePosX,
         (src_dx == src_w) && (src_dy == src_h))
     {
         memcpy(dst_img_data, src_img_data, m_memorySize);
+        return;
     }
 
-    // src format: RGB
-    else if (src_format == GL_RGB)
+    // select the row kernel for this pair of formats
+    cImageRowConversion convertRow = _getRowConversion(src_format, dst_format);
+    if (convertRow == NULL)
     {
-        // information about src image
-        int src_bpp = 3;
-        int src_segment_size = src_dx * src_bpp;
-        int src_offset = (src_w - src_dx) * src_bpp;
-        unsigned int src_index = src_bpp * (src_x + src_y * src_w);
-        unsigned char* src_data = &(src_img_data[src_index]);
-
-        // dst format: RGB
-        if (dst_format == GL_RGB)
-        {
-            int dst_bpp = 3;
-            int dst_offset = dst_w * dst_bpp;
-            src_offset = src_w * src_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                memcpy(dst_data, src_data, src_segment_size);
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-
-        // dst format: RGBA
-        if (dst_format == GL_RGBA)
-        {
-            int dst_bpp = 4;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = *src_data; dst_data++; src_data++;
-                    *dst_data = *src_data; dst_data++; src_data++;
-                    *dst_data = *src_data; dst_data++; src_data++;
-                    *dst_data = 0xff; dst_data++;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-
-        // dst format: LUMINANCE
-        else if (dst_format == GL_LUMINANCE)
-        {
-            int dst_bpp = 1;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = (unsigned char)(((unsigned short)(src_data[0]) +
-                                                 (unsigned short)(src_data[1]) +
-                                                 (unsigned short)(src_data[2]))  / 3);
-                    dst_data++; src_data+=3;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-
-        // dst format: LUMINANCE_ALPHA
-        else if (dst_format == GL_LUMINANCE_ALPHA)
-        {
-            int dst_bpp = 2;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = (unsigned char)(((unsigned short)(src_data[0]) +
-                                                 (unsigned short)(src_data[1]) +
-                                                 (unsigned short)(src_data[2]))  / 3);
-                    dst_data++;
-                    *dst_data = 0xff;
-                    dst_data++;
-                    src_data+=3;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
+        return;
     }
 
-    // src format: RGBA
-    else if (src_format == GL_RGBA)
-    {
-        // information about src image
-        int src_bpp = 4;
-        int src_segment_size = src_dx * src_bpp;
-        int src_offset = (src_w - src_dx) * src_bpp;
-        unsigned int src_index = src_bpp * (src_x + src_y * src_w);
-        unsigned char* src_data = &(src_img_data[src_index]);
-
-        // dst format: RGB
-        if (dst_format == GL_RGB)
-        {
-            int dst_bpp = 3;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = *src_data; dst_data++; src_data++;
-                    *dst_data = *src_data; dst_data++; src_data++;
-                    *dst_data = *src_data; dst_data++; src_data+=2;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
+    unsigned int src_bpp = _numComponents(src_format);
+    unsigned int dst_bpp = _numComponents(dst_format);
 
-        // dst format: RGBA
-        if (dst_format == GL_RGBA)
-        {
-            int dst_bpp = 4;
-            int dst_offset = dst_w * dst_bpp;
-            src_offset = src_w * src_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                memcpy(dst_data, src_data, src_segment_size);
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-
-        // dst format: LUMINANCE
-        if (dst_format == GL_LUMINANCE)
-        {
-            int dst_bpp = 1;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = (unsigned char)(((unsigned short)(src_data[0]) +
-                                                 (unsigned short)(src_data[1]) +
-                                                 (unsigned short)(src_data[2]))  / 3);
-                    dst_data++; src_data+=4;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-
-        // dst format: LUMINANCE_ALPHA
-        else if (dst_format == GL_LUMINANCE_ALPHA)
-        {
-            int dst_bpp = 2;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = (unsigned char)(((unsigned short)(src_data[0]) +
-                                                 (unsigned short)(src_data[1]) +
-                                                 (unsigned short)(src_data[2]))  / 3);
-                    dst_data++;
-                    *dst_data = src_data[3];
-                    dst_data++;
-                    src_data+=4;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-    }
-
-    // src format: LUMINANCE
-    else if (src_format == GL_LUMINANCE)
+    // convert rows, splitting large areas across the shared thread pool
+    _forEachRowBlock(src_dy, src_dx, [&](unsigned int a_firstRow, unsigned int a_lastRow)
     {
-        // information about src image
-        int src_bpp = 1;
-        int src_segment_size = src_dx * src_bpp;
-        int src_offset = (src_w - src_dx) * src_bpp;
-        unsigned int src_index = src_bpp * (src_x + src_y * src_w);
-        unsigned char* src_data = &(src_img_data[src_index]);
-
-        // dst format: RGB
-        if (dst_format == GL_RGB)
-        {
-            int dst_bpp = 3;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = *src_data; dst_data++;
-                    *dst_data = *src_data; dst_data++;
-                    *dst_data = *src_data; dst_data++;
-                    src_data++;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-
-        // dst format: RGBA
-        if (dst_format == GL_RGBA)
+        for (unsigned int i=a_firstRow; i<a_lastRow; i++)
         {
-            int dst_bpp = 4;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = *src_data; dst_data++;
-                    *dst_data = *src_data; dst_data++;
-                    *dst_data = *src_data; dst_data++;
-                    *dst_data = 0xff; dst_data++;
-                    src_data++;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
+            const unsigned char* src_data = &(src_img_data[src_bpp * (src_x + (src_y + i) * src_w)]);
+            unsigned char* dst_data = &(dst_img_data[dst_bpp * (dst_x + (dst_y + i) * dst_w)]);
+            convertRow(src_data, dst_data, src_dx);
         }
-
-        // dst format: LUMINANCE
-        if (dst_format == GL_LUMINANCE)
-        {
-            int dst_bpp = 1;
-            int dst_offset = dst_w * dst_bpp;
-            src_offset = src_w * src_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                memcpy(dst_data, src_data, src_segment_size);
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-
-        // dst format: LUMINANCE_ALPHA
-        if (dst_format == GL_LUMINANCE_ALPHA)
-        {
-            int dst_bpp = 2;
-            int dst_offset = (dst_w - src_dx) * dst_bpp;
-            unsigned int dst_index = dst_bpp * (dst_x + dst_y * dst_w);
-            unsigned char* dst_data = &(dst_img_data[dst_index]);
-            for (i=0; i<src_dy; i++)
-            {
-                for (j=0; j<src_dx; j++)
-                {
-                    *dst_data = *src_data; dst_data++;
-                    *dst_data = 0xff; dst_data++;
-                    src_data++;
-                }
-                src_data += src_offset;
-                dst_data += dst_offset;
-            }
-        }
-    }
+    });
 }
 
 
@@ -1294,9 +1411,6 @@ void cImage::setTransparentColor(const cColorb &a_color,
     // check if image exists
     if (!m_allocated) { return; }
 
-    // image size
-    unsigned int size = m_width * m_height;
-
     // verify format, convert otherwise
     if (m_format != GL_RGBA)
     {
@@ -1309,17 +1423,33 @@ void cImage::setTransparentColor(const cColorb &a_color,
         unsigned char r = a_color.getR();
         unsigned char g = a_color.getG();
         unsigned char b = a_color.getB();
-        unsigned char* data = (unsigned char*)m_data;
-        unsigned int i;
-        for (i=0; i<size; i++)
+        unsigned char* data = m_data;
+        _forEachRowBlock(m_height, m_width, [&](unsigned int a_firstRow, unsigned int a_lastRow)
         {
-            if ((data[0] == r) && (data[1] == g) && (data[2] == b))
+            unsigned int i = a_firstRow * m_width;
+            unsigned int last = a_lastRow * m_width;
+#ifdef C_IMAGE_USE_SSE2
+            const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+            const __m128i key = _mm_set1_epi32((int)(r | (g << 8) | (b << 16)));
+            const __m128i alpha = _mm_set1_epi32((int)((unsigned int)a_transparencyLevel << 24));
+            for (; i + 4 <= last; i += 4)
             {
-                data[3] = a_transparencyLevel;
+                __m128i v = _mm_loadu_si128((const __m128i*)(data + 4 * i));
+                __m128i rgb = _mm_and_si128(v, rgbMask);
+                __m128i match = _mm_cmpeq_epi32(rgb, key);
+                v = _mm_or_si128(_mm_and_si128(match, _mm_or_si128(rgb, alpha)), _mm_andnot_si128(match, v));
+                _mm_storeu_si128((__m128i*)(data + 4 * i), v);
             }
-
-            data+=4;
-        }
+#endif
+            for (; i < last; i++)
+            {
+                unsigned char* pixel = data + 4 * i;
+                if ((pixel[0] == r) && (pixel[1] == g) && (pixel[2] == b))
+                {
+                    pixel[3] = a_transparencyLevel;
+                }
+            }
+        });
     }
 }
 
@@ -1338,9 +1468,6 @@ void cImage::setTransparency(const unsigned char a_transparencyLevel)
     // check if image exists
     if (!m_allocated) { return; }
 
-    // image size
-    unsigned int size = m_width * m_height;
-
     // verify format, convert otherwise
     if (m_format != GL_RGBA)
     {
@@ -1350,13 +1477,25 @@ void cImage::setTransparency(const unsigned char a_transparencyLevel)
     // format: RGBA
     if (m_format == GL_RGBA)
     {
-        unsigned char* data = &m_data[3];
-        unsigned int i;
-        for (i=0; i<size; i++)
+        unsigned char* data = m_data;
+        _forEachRowBlock(m_height, m_width, [&](unsigned int a_firstRow, unsigned int a_lastRow)
         {
-            *data = a_transparencyLevel;
-            data+=4;
-        }
+            unsigned int i = a_firstRow * m_width;
+            unsigned int last = a_lastRow * m_width;
+#ifdef C_IMAGE_USE_SSE2
+            const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+            const __m128i alpha = _mm_set1_epi32((int)((unsigned int)a_transparencyLevel << 24));
+            for (; i + 4 <= last; i += 4)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i*)(data + 4 * i));
+                _mm_storeu_si128((__m128i*)(data + 4 * i), _mm_or_si128(_mm_and_si128(v, rgbMask), alpha));
+            }
+#endif
+            for (; i < last; i++)
+            {
+                data[4 * i + 3] = a_transparencyLevel;
+            }
+        });
     }
 }
 
@@ -1373,19 +1512,22 @@ void cImage::flipHorizontal()
 
     // image line size
     unsigned int lineWidth = m_bytesPerPixel*m_width;
-    unsigned char *data = new unsigned char[lineWidth];
+    unsigned char* data = m_data;
+    unsigned int height = m_height;
 
-    // flip
-    for(unsigned int i=0; i<m_height/2; i++)
+    // flip by swapping pairs of lines
+    _forEachRowBlock(height/2, m_width, [&](unsigned int a_firstRow, unsigned int a_lastRow)
     {
-        unsigned char *botLine = m_data+i*lineWidth;
-        unsigned char *topLine = m_data+(m_height-i-1)*lineWidth;
-        memcpy(data,    topLine, lineWidth);
-        memcpy(topLine, botLine, lineWidth);
-        memcpy(botLine, data,    lineWidth);
-    }
-
-    delete [] data;
+        vector<unsigned char> line(lineWidth);
+        for (unsigned int i=a_firstRow; i<a_lastRow; i++)
+        {
+            unsigned char *botLine = data+i*lineWidth;
+            unsigned char *topLine = data+(height-i-1)*lineWidth;
+            memcpy(&line[0], topLine, lineWidth);
+            memcpy(topLine, botLine, lineWidth);
+            memcpy(botLine, &line[0], lineWidth);
+        }
+    });
 }
 
 
@@ -1423,8 +1565,8 @@ void cImage::setTransparentColor(const unsigned char a_r,
 //==============================================================================
 bool cImage::loadFromFile(const string& a_filename)
 {
-    // cleanup previous image
-    cleanup();
+    // the current image buffer is kept so that decoders can reuse it if the
+    // new image has the same size. it is released if loading fails.
 
     // find extension
     string extension = cGetFileExtension(a_filename);
@@ -1432,6 +1574,7 @@ bool cImage::loadFromFile(const string& a_filename)
     // we need a file extension to figure out file type
     if (extension.length() == 0)
     {
+        cleanup();
         return (false);
     }
 
@@ -1489,6 +1632,12 @@ bool cImage::loadFromFile(const string& a_filename)
         result = cLoadFileRAW(this, a_filename);
     }
 
+    // cleanup if image could not be loaded
+    if (!result)
+    {
+        cleanup();
+    }
+
     return (result);
 }
 
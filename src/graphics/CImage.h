@@ -122,6 +122,12 @@ public:
     //! This method deletes all image data from memory.
     void erase() { cleanup(); }
 
+    //! This method locks the size, pixel format and pixel type of the image, so that \ref allocate() only accepts the current properties and keeps the current buffer.
+    void setFixedProperties(const bool a_fixedProperties) { m_fixedProperties = a_fixedProperties; }
+
+    //! This method returns __true__ if the size, pixel format and pixel type of the image are locked, __false__ otherwise.
+    bool getFixedProperties() const { return (m_fixedProperties); }
+
     //! This method returns the number of images stored. (1 only for class \ref cImage).
     virtual unsigned int getImageCount() const { return (1); }
 
@@ -465,6 +471,9 @@ protected:
 
     //! If __true__, then this object actually performed the memory allocation for this object.
     bool m_responsibleForMemoryAllocation;
+
+    //! If __true__, then \ref allocate() fails unless the requested properties match the current image.
+    bool m_fixedProperties;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,313 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef CModifiedRangesH
+#define CModifiedRangesH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CModifiedRanges.h
+
+    \brief
+    Implements a record of modified elements inside an array.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \struct     cModifiedSpan
+    \ingroup    graphics
+
+    \brief
+    This structure describes a contiguous span of array elements.
+*/
+//==============================================================================
+struct cModifiedSpan
+{
+    //! Index number of the first element of the span.
+    unsigned int m_first;
+
+    //! Number of elements in the span.
+    unsigned int m_count;
+};
+
+
+//==============================================================================
+/*!
+    \class      cModifiedRanges
+    \ingroup    graphics
+
+    \brief
+    This class records which elements of an array have been modified.
+
+    \details
+    cModifiedRanges stores the index numbers of array elements that have been
+    modified since the array was last transferred to the GPU. Before an
+    update, the indices are sorted and coalesced into contiguous spans so
+    that only the modified portions of an OpenGL buffer need to be
+    transferred. \n
+
+    If the number of recorded indices exceeds the size of the array, the
+    record collapses into a single flag that marks the complete array as
+    modified.
+*/
+//==============================================================================
+class cModifiedRanges
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cModifiedRanges.
+    cModifiedRanges() { m_all = false; }
+
+    //! Destructor of cModifiedRanges.
+    ~cModifiedRanges() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method marks an element as modified.
+
+        \param  a_index        Index number of modified element.
+        \param  a_numElements  Number of elements in the array.
+    */
+    //--------------------------------------------------------------------------
+    inline void mark(const unsigned int a_index, const unsigned int a_numElements)
+    {
+        if (m_all) { return; }
+        if (m_indices.size() >= a_numElements)
+        {
+            markAll();
+            return;
+        }
+        m_indices.push_back(a_index);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method marks all elements of the array as modified.
+    */
+    //--------------------------------------------------------------------------
+    inline void markAll()
+    {
+        m_all = true;
+        m_indices.clear();
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method adds the elements recorded in another range to this one.
+
+        \param  a_ranges       Ranges to be merged.
+        \param  a_numElements  Number of elements in the array.
+    */
+    //--------------------------------------------------------------------------
+    inline void merge(const cModifiedRanges& a_ranges, const unsigned int a_numElements)
+    {
+        if (m_all) { return; }
+        if (a_ranges.m_all || (m_indices.size() + a_ranges.m_indices.size() > a_numElements))
+        {
+            markAll();
+            return;
+        }
+        m_indices.insert(m_indices.end(), a_ranges.m_indices.begin(), a_ranges.m_indices.end());
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method clears the record.
+    */
+    //--------------------------------------------------------------------------
+    inline void clear()
+    {
+        m_all = false;
+        m_indices.clear();
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns __true__ if no element has been recorded.
+
+        \return __true__ if the record is empty, __false__ otherwise.
+    */
+    //--------------------------------------------------------------------------
+    inline bool isEmpty() const
+    {
+        return ((!m_all) && (m_indices.size() == 0));
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns __true__ if the complete array has been marked
+        as modified.
+
+        \return __true__ if all elements are marked, __false__ otherwise.
+    */
+    //--------------------------------------------------------------------------
+    inline bool isAll() const
+    {
+        return (m_all);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method converts the recorded elements into a sorted list of
+        contiguous spans. Spans separated by fewer than __a_maxGap__ unmodified
+        elements are merged, which trades a few redundant elements for fewer
+        buffer transfer calls. An empty record, or a record marked as
+        complete, returns a single span covering the whole array.
+
+        \param  a_numElements  Number of elements in the array.
+        \param  a_maxGap       Largest gap of unmodified elements merged into a span.
+        \param  a_spans        Returned list of spans.
+
+        \return Number of elements covered by the spans.
+    */
+    //--------------------------------------------------------------------------
+    unsigned int computeSpans(const unsigned int a_numElements,
+                              const unsigned int a_maxGap,
+                              std::vector<cModifiedSpan>& a_spans)
+    {
+        a_spans.clear();
+        if (a_numElements == 0) { return (0); }
+
+        // complete array
+        if (isEmpty() || m_all)
+        {
+            cModifiedSpan span;
+            span.m_first = 0;
+            span.m_count = a_numElements;
+            a_spans.push_back(span);
+            return (a_numElements);
+        }
+
+        // sort indices
+        std::sort(m_indices.begin(), m_indices.end());
+
+        // coalesce
+        unsigned int total = 0;
+        unsigned int first = m_indices[0];
+        unsigned int last = first;
+        unsigned int num = (unsigned int)(m_indices.size());
+        for (unsigned int i=1; i<=num; i++)
+        {
+            if (i < num)
+            {
+                unsigned int index = m_indices[i];
+                if (index <= last + a_maxGap + 1)
+                {
+                    if (index > last) { last = index; }
+                    continue;
+                }
+            }
+
+            // close current span
+            if (first < a_numElements)
+            {
+                if (last >= a_numElements) { last = a_numElements - 1; }
+                cModifiedSpan span;
+                span.m_first = first;
+                span.m_count = last - first + 1;
+                a_spans.push_back(span);
+                total += span.m_count;
+            }
+
+            // start next span
+            if (i < num)
+            {
+                first = m_indices[i];
+                last = first;
+            }
+        }
+
+        return (total);
+    }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__ then all elements are marked as modified.
+    bool m_all;
+
+    //! Index numbers of modified elements.
+    std::vector<unsigned int> m_indices;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -43,6 +43,7 @@
 
 //------------------------------------------------------------------------------
 #include "CMultiImage.h"
+#include "system/CThreadPool.h"
 //------------------------------------------------------------------------------
 #include <iomanip>
 #include <iostream>
@@ -62,6 +63,9 @@ namespace chai3d {
 //==============================================================================
 cMultiImage::cMultiImage() : cImage()
 {
+    // default brick size used to track modified regions
+    m_brickSize = 16;
+
     // init internal variables
     defaults();
 }
@@ -90,6 +94,12 @@ void cMultiImage::defaults()
     m_currentIndex = 0;
     m_array        = NULL;
 
+    m_brickCountX  = 0;
+    m_brickCountY  = 0;
+    m_brickCountZ  = 0;
+    m_brickModificationCounter.clear();
+    m_modificationCounter = 0;
+
     cImage::defaults();
 }
 
@@ -190,6 +200,9 @@ bool cMultiImage::allocate(const unsigned int a_width,
     m_currentIndex = 0;
     m_data         = m_array;
 
+    // initialize modification tracking
+    resetBricks();
+
     // success
     return (true);
 }
@@ -406,6 +419,9 @@ bool cMultiImage::addImage(cImage &a_image,
     // adjust image count
     m_imageCount += 1;
 
+    // initialize modification tracking
+    resetBricks();
+
     return (true);
 }
 
@@ -499,6 +515,9 @@ bool cMultiImage::removeImage(unsigned long a_index)
         m_currentIndex = 0;
     }
 
+    // initialize modification tracking
+    resetBricks();
+
     return (true);
 }
 
@@ -861,6 +880,9 @@ void cMultiImage::setVoxelColor(const unsigned int a_x,
             unsigned char* data = (unsigned char*)m_array;
             data[index] = a_color.getA();
         }
+
+        // record modification
+        markVoxelModified(a_x, a_y, a_z);
     }
 }
 
@@ -913,6 +935,9 @@ void cMultiImage::setVoxelColor(const unsigned int a_x,
             unsigned char* data = (unsigned char*)m_array;
             data[index] = a_grayLevel;
         }
+
+        // record modification
+        markVoxelModified(a_x, a_y, a_z);
     }
 }
 
@@ -975,6 +1000,304 @@ void cMultiImage::setTransparency(const unsigned char a_transparencyLevel)
 }
 
 
+//==============================================================================
+/*!
+    This method sets the size of the bricks used to track modified regions of
+    the image set. The volume is divided into cubic bricks of __a_brickSize__
+    voxels along each axis, and every call to \ref setVoxelColor() or
+    \ref markVoxelModified() records the brick that contains the voxel.
+    Consumers such as 3D textures or incremental polygonizers can then query
+    the bricks modified since their last update by calling
+    \ref getModifiedBricks(). \n
+
+    Changing the brick size clears all modification records.
+
+    \param  a_brickSize  Size of a brick in voxels.
+*/
+//==============================================================================
+void cMultiImage::setBrickSize(const unsigned int a_brickSize)
+{
+    m_brickSize = cMax(a_brickSize, (unsigned int)1);
+    resetBricks();
+}
+
+
+//==============================================================================
+/*!
+    This method resizes the brick grid to match the current size of the image
+    set and clears all modification records. The modification counter is 
+    preserved so that consumers holding a previous counter value remain valid.
+*/
+//==============================================================================
+void cMultiImage::resetBricks()
+{
+    if ((m_width == 0) || (m_height == 0) || (m_imageCount == 0))
+    {
+        m_brickCountX = 0;
+        m_brickCountY = 0;
+        m_brickCountZ = 0;
+        m_brickModificationCounter.clear();
+        return;
+    }
+
+    m_brickCountX = (m_width + m_brickSize - 1) / m_brickSize;
+    m_brickCountY = (m_height + m_brickSize - 1) / m_brickSize;
+    m_brickCountZ = ((unsigned int)m_imageCount + m_brickSize - 1) / m_brickSize;
+
+    m_brickModificationCounter.assign(m_brickCountX * m_brickCountY * m_brickCountZ, 0);
+}
+
+
+//==============================================================================
+/*!
+    This method marks a voxel as modified. This method is called automatically
+    by \ref setVoxelColor(). It should be called explicitly when voxel data is
+    modified directly through \ref getArray() or \ref getVoxelData().
+
+    \param  a_x  X coordinate of the voxel.
+    \param  a_y  Y coordinate of the voxel.
+    \param  a_z  Z coordinate of the voxel.
+*/
+//==============================================================================
+void cMultiImage::markVoxelModified(const unsigned int a_x,
+                                    const unsigned int a_y,
+                                    const unsigned int a_z)
+{
+    // sanity check
+    if ((a_x >= m_width) || (a_y >= m_height) || (a_z >= m_imageCount)) { return; }
+    if (m_brickModificationCounter.size() == 0) { return; }
+
+    // increment counter and stamp brick
+    m_modificationCounter++;
+    unsigned int index = (a_x / m_brickSize) + m_brickCountX * ((a_y / m_brickSize) + m_brickCountY * (a_z / m_brickSize));
+    m_brickModificationCounter[index] = m_modificationCounter;
+}
+
+
+//==============================================================================
+/*!
+    This method marks a box of voxels as modified. The box is clamped to the
+    size of the image set.
+
+    \param  a_minX  X coordinate of the lowest voxel.
+    \param  a_minY  Y coordinate of the lowest voxel.
+    \param  a_minZ  Z coordinate of the lowest voxel.
+    \param  a_maxX  X coordinate of the highest voxel.
+    \param  a_maxY  Y coordinate of the highest voxel.
+    \param  a_maxZ  Z coordinate of the highest voxel.
+*/
+//==============================================================================
+void cMultiImage::markRegionModified(const unsigned int a_minX,
+                                     const unsigned int a_minY,
+                                     const unsigned int a_minZ,
+                                     const unsigned int a_maxX,
+                                     const unsigned int a_maxY,
+                                     const unsigned int a_maxZ)
+{
+    // sanity check
+    if (m_brickModificationCounter.size() == 0) { return; }
+    if ((a_minX >= m_width) || (a_minY >= m_height) || (a_minZ >= m_imageCount)) { return; }
+    if ((a_maxX < a_minX) || (a_maxY < a_minY) || (a_maxZ < a_minZ)) { return; }
+
+    // compute range of bricks
+    unsigned int bx0 = a_minX / m_brickSize;
+    unsigned int by0 = a_minY / m_brickSize;
+    unsigned int bz0 = a_minZ / m_brickSize;
+    unsigned int bx1 = cMin(a_maxX, m_width - 1) / m_brickSize;
+    unsigned int by1 = cMin(a_maxY, m_height - 1) / m_brickSize;
+    unsigned int bz1 = cMin(a_maxZ, (unsigned int)(m_imageCount - 1)) / m_brickSize;
+
+    // increment counter and stamp bricks
+    m_modificationCounter++;
+    for (unsigned int bz=bz0; bz<=bz1; bz++)
+    {
+        for (unsigned int by=by0; by<=by1; by++)
+        {
+            for (unsigned int bx=bx0; bx<=bx1; bx++)
+            {
+                m_brickModificationCounter[bx + m_brickCountX * (by + m_brickCountY * bz)] = m_modificationCounter;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the list of bricks that have been modified after the
+    modification counter reached the value passed as argument. A consumer 
+    typically reads \ref getModificationCounter() before calling this method
+    and uses that value for its next query.
+
+    \param  a_sinceCounter   Value of the modification counter at the last query.
+    \param  a_brickIndices   Returned list of modified brick indices.
+*/
+//==============================================================================
+void cMultiImage::getModifiedBricks(const unsigned long long a_sinceCounter, 
+                                    std::vector<unsigned int>& a_brickIndices) const
+{
+    a_brickIndices.clear();
+
+    unsigned int numBricks = (unsigned int)(m_brickModificationCounter.size());
+    for (unsigned int i=0; i<numBricks; i++)
+    {
+        if (m_brickModificationCounter[i] > a_sinceCounter)
+        {
+            a_brickIndices.push_back(i);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the bricks modified after the modification counter
+    reached the value passed as argument, merged into a small number of 
+    non-overlapping boxes of voxels. Adjacent modified bricks are grown greedily
+    along __x__, then __y__, then __z__, so that many small scattered edits 
+    result in a few large boxes that can be transferred efficiently (for 
+    instance to the GPU using glTexSubImage3D).
+
+    \param  a_sinceCounter  Value of the modification counter at the last query.
+    \param  a_regions       Returned list of modified regions.
+
+    \return Total number of voxels covered by the returned regions.
+*/
+//==============================================================================
+unsigned int cMultiImage::getModifiedRegions(const unsigned long long a_sinceCounter, 
+                                             std::vector<cMultiImageRegion>& a_regions) const
+{
+    a_regions.clear();
+
+    // flag modified bricks
+    unsigned int numBricks = (unsigned int)(m_brickModificationCounter.size());
+    std::vector<bool> pending(numBricks, false);
+    bool modified = false;
+    for (unsigned int i=0; i<numBricks; i++)
+    {
+        if (m_brickModificationCounter[i] > a_sinceCounter)
+        {
+            pending[i] = true;
+            modified = true;
+        }
+    }
+    if (!modified) { return (0); }
+
+    unsigned int cx = m_brickCountX;
+    unsigned int cy = m_brickCountY;
+    unsigned int cz = m_brickCountZ;
+    unsigned int numVoxels = 0;
+
+    for (unsigned int bz=0; bz<cz; bz++)
+    {
+        for (unsigned int by=0; by<cy; by++)
+        {
+            for (unsigned int bx=0; bx<cx; bx++)
+            {
+                if (!pending[bx + cx * (by + cy * bz)]) { continue; }
+
+                // grow along x
+                unsigned int ex = bx;
+                while (((ex+1) < cx) && pending[(ex+1) + cx * (by + cy * bz)])
+                {
+                    ex++;
+                }
+
+                // grow along y while the full row is pending
+                unsigned int ey = by;
+                bool grow = true;
+                while (grow && ((ey+1) < cy))
+                {
+                    for (unsigned int x=bx; x<=ex; x++)
+                    {
+                        if (!pending[x + cx * ((ey+1) + cy * bz)]) { grow = false; break; }
+                    }
+                    if (grow) { ey++; }
+                }
+
+                // grow along z while the full rectangle is pending
+                unsigned int ez = bz;
+                grow = true;
+                while (grow && ((ez+1) < cz))
+                {
+                    for (unsigned int y=by; (y<=ey) && grow; y++)
+                    {
+                        for (unsigned int x=bx; x<=ex; x++)
+                        {
+                            if (!pending[x + cx * (y + cy * (ez+1))]) { grow = false; break; }
+                        }
+                    }
+                    if (grow) { ez++; }
+                }
+
+                // consume bricks
+                for (unsigned int z=bz; z<=ez; z++)
+                {
+                    for (unsigned int y=by; y<=ey; y++)
+                    {
+                        for (unsigned int x=bx; x<=ex; x++)
+                        {
+                            pending[x + cx * (y + cy * z)] = false;
+                        }
+                    }
+                }
+
+                // store region
+                cMultiImageRegion region;
+                region.m_minX = bx * m_brickSize;
+                region.m_minY = by * m_brickSize;
+                region.m_minZ = bz * m_brickSize;
+                region.m_maxX = cMin((ex + 1) * m_brickSize, m_width) - 1;
+                region.m_maxY = cMin((ey + 1) * m_brickSize, m_height) - 1;
+                region.m_maxZ = cMin((ez + 1) * m_brickSize, (unsigned int)m_imageCount) - 1;
+                a_regions.push_back(region);
+
+                numVoxels += (region.m_maxX - region.m_minX + 1) * 
+                             (region.m_maxY - region.m_minY + 1) * 
+                             (region.m_maxZ - region.m_minZ + 1);
+            }
+        }
+    }
+
+    return (numVoxels);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the range of voxels covered by a brick. The maximum
+    values are inclusive and clamped to the size of the image set.
+
+    \param  a_brickIndex  Index of the brick.
+    \param  a_minX        Returned X coordinate of the lowest voxel.
+    \param  a_minY        Returned Y coordinate of the lowest voxel.
+    \param  a_minZ        Returned Z coordinate of the lowest voxel.
+    \param  a_maxX        Returned X coordinate of the highest voxel.
+    \param  a_maxY        Returned Y coordinate of the highest voxel.
+    \param  a_maxZ        Returned Z coordinate of the highest voxel.
+*/
+//==============================================================================
+void cMultiImage::getBrickRange(const unsigned int a_brickIndex,
+                                unsigned int& a_minX,
+                                unsigned int& a_minY,
+                                unsigned int& a_minZ,
+                                unsigned int& a_maxX,
+                                unsigned int& a_maxY,
+                                unsigned int& a_maxZ) const
+{
+    unsigned int bx = a_brickIndex % m_brickCountX;
+    unsigned int by = (a_brickIndex / m_brickCountX) % m_brickCountY;
+    unsigned int bz = a_brickIndex / (m_brickCountX * m_brickCountY);
+
+    a_minX = bx * m_brickSize;
+    a_minY = by * m_brickSize;
+    a_minZ = bz * m_brickSize;
+    a_maxX = cMin(a_minX + m_brickSize, m_width) - 1;
+    a_maxY = cMin(a_minY + m_brickSize, m_height) - 1;
+    a_maxZ = cMin(a_minZ + m_brickSize, (unsigned int)m_imageCount) - 1;
+}
+
+
 //==============================================================================
 /*!
     This method returns a pointer to voxel memory data.
@@ -1137,6 +1460,12 @@ int cMultiImage::loadFromFiles(const std::string& a_basename,
     must match the properties of the first image, otherwise it will be ignored.
     This routine erases and replaces any previous content.
 
+    Images are decoded in parallel using the shared thread pool. Each file
+    after the first one is decoded directly into its slice of the preallocated
+    array by \ref addFromFilePrealloc(), which checks the image header against
+    the properties of the set before writing any pixel. The slice of a file
+    that does not match or fails to decode is cleared to zero.
+
     \param  a_filename  The vector containing the filenames.
 
     \return The number of images actually loaded in the set.
@@ -1153,31 +1482,56 @@ int cMultiImage::loadFromFiles(const std::vector<std::string>& a_filename)
     cleanup();
 
     // load first image to get parameters
-    if (!addFromFile(a_filename[0]))
+    cImage image;
+    if (!image.loadFromFile(a_filename[0]))
         return false;
 
-    // set total image count
-    m_imageCount = (unsigned long)(a_filename.size());
+    // update image properties and set total image count
+    m_bytesPerPixel = image.getBytesPerPixel();
+    m_width         = image.getWidth();
+    m_height        = image.getHeight();
+    m_format        = image.getFormat();
+    m_type          = image.getType();
+    m_memorySize    = m_width * m_height * m_bytesPerPixel;
+    m_imageCount    = (unsigned long)(a_filename.size());
 
     // pre-allocate array for all images
-    unsigned char* array = new unsigned char[m_imageCount * m_memorySize];
+    m_array = new unsigned char[m_imageCount * m_memorySize];
+    m_currentIndex = 0;
+    m_data  = m_array;
+    m_allocated = true;
+    m_responsibleForMemoryAllocation = true;
 
-    // copy existing first image into reallocated array
-    std::copy(m_array, m_array+m_memorySize, array);
+    // copy first image into the array
+    addImagePrealloc(image, 0);
 
-    // delete old array and reassign
-    unsigned char *tmp = m_array;
-    m_array = array;
-    m_data  = m_array + m_currentIndex * m_memorySize;
-    delete [] tmp;
+    // initialize modification tracking
+    resetBricks();
 
-    // load each following file, count those that fit
-    for (unsigned int i=0; i<m_imageCount; i++)
+    // the first image has already been loaded
+    loaded = 1;
+
+    // decode the following files in parallel, each one directly into its
+    // slice of the preallocated array
+    unsigned int numFiles = (unsigned int)(m_imageCount - 1);
+    std::vector<char> result(m_imageCount, 0);
+    cThreadPool::getSharedThreadPool()->parallelFor(numFiles, [&](unsigned int a_task)
     {
-        if (addFromFilePrealloc(a_filename[i], i))
+        unsigned int index = a_task + 1;
+        if (addFromFilePrealloc(a_filename[index], index))
+        {
+            result[index] = 1;
+        }
+        else
         {
-            loaded++;
+            unsigned char* slice = m_array + index*m_memorySize;
+            std::fill(slice, slice+m_memorySize, 0);
         }
+    });
+
+    for (unsigned int i=1; i<m_imageCount; i++)
+    {
+        loaded += result[i];
     }
 
     // return number of files actually loaded
@@ -1218,9 +1572,15 @@ bool cMultiImage::addFromFile(const string& a_filename,
 //==============================================================================
 /*!
     This method adds an image file to a preallocated image set. The set must be
-    preallocated by calling \ref loadFromFiles(). This method checks that the
-    new image matches the properties of the images already in the set. If the
-    image properties do not match, the image is not loaded and an error is returned.
+    preallocated by calling \ref loadFromFiles(). The file is decoded directly
+    into its slice of the set, without any intermediate image. The image
+    header is checked against the properties of the images already in the set
+    before any pixel is written: if the width, height or pixel format do not
+    match, the slice is left untouched and an error is returned. \n
+
+    Note that a file whose header is valid but whose pixel data turns out to be
+    corrupted or truncated is only detected while decoding. In that case an
+    error is returned, but the slice may already be partially overwritten.
 
     \param  a_filename  The path and filename of the image to be added to the set.
     \param  a_index     The index in the set where the image should be added.
@@ -1232,16 +1592,27 @@ bool cMultiImage::addFromFile(const string& a_filename,
 bool cMultiImage::addFromFilePrealloc(const string& a_filename,
                                       unsigned long a_index)
 {
-    cImage image;
+    // check index validity
+    if (a_index >= m_imageCount)
+    {
+        return (false);
+    }
 
-    // load image from file
-    if (!image.loadFromFile(a_filename))
+    // map an image onto the slice, with the properties of the set. the image
+    // does not own the slice memory and does not release it on failure.
+    cImage image;
+    image.setData(m_array + a_index*m_memorySize, m_memorySize, false);
+    if (!image.setProperties(m_width, m_height, m_format, m_type))
     {
         return (false);
     }
 
-    // add new image to data set
-    return (addImagePrealloc(image, a_index));
+    // lock the properties of the image, so that the decoder fails on any
+    // header that does not match the set, before writing to the slice
+    image.setFixedProperties(true);
+
+    // decode the file directly into the slice
+    return (image.loadFromFile(a_filename));
 }
 
 
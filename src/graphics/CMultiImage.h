@@ -46,6 +46,7 @@
 #define CMultiImageH
 //------------------------------------------------------------------------------
 #include "graphics/CImage.h"
+#include "system/CMutex.h"
 //------------------------------------------------------------------------------
 #include <string>
 #include <vector>
@@ -67,6 +68,17 @@ class cMultiImage;
 typedef std::shared_ptr<cMultiImage> cMultiImagePtr;
 //------------------------------------------------------------------------------
 
+//! Describes a box of voxels. Maximum coordinates are inclusive.
+struct cMultiImageRegion
+{
+    unsigned int m_minX;
+    unsigned int m_minY;
+    unsigned int m_minZ;
+    unsigned int m_maxX;
+    unsigned int m_maxY;
+    unsigned int m_maxZ;
+};
+
 //==============================================================================
 /*!
     \class      cMultiImage
@@ -233,6 +245,59 @@ public:
         const unsigned char a_grayLevel);
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - MODIFICATION TRACKING:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the size (in voxels) of the bricks used to track modified regions.
+    void setBrickSize(const unsigned int a_brickSize);
+
+    //! This method returns the size (in voxels) of the bricks used to track modified regions.
+    unsigned int getBrickSize() const { return (m_brickSize); }
+
+    //! This method returns the number of bricks along each axis.
+    void getBrickCount(unsigned int& a_countX, unsigned int& a_countY, unsigned int& a_countZ) const { a_countX = m_brickCountX; a_countY = m_brickCountY; a_countZ = m_brickCountZ; }
+
+    //! This method returns the current value of the modification counter.
+    unsigned long long getModificationCounter() const { return (m_modificationCounter); }
+
+    //! This method acquires the lock that serializes voxel modifications with readers of the image data (texture upload, polygonization).
+    void acquireLock() { m_lock.acquire(); }
+
+    //! This method releases the lock acquired by \ref acquireLock().
+    void releaseLock() { m_lock.release(); }
+
+    //! This method marks a voxel as modified.
+    void markVoxelModified(const unsigned int a_x,
+        const unsigned int a_y,
+        const unsigned int a_z);
+
+    //! This method marks a box of voxels as modified.
+    void markRegionModified(const unsigned int a_minX,
+        const unsigned int a_minY,
+        const unsigned int a_minZ,
+        const unsigned int a_maxX,
+        const unsigned int a_maxY,
+        const unsigned int a_maxZ);
+
+    //! This method returns the list of bricks modified after a given value of the modification counter.
+    void getModifiedBricks(const unsigned long long a_sinceCounter, std::vector<unsigned int>& a_brickIndices) const;
+
+    //! This method returns the modified bricks coalesced into a small number of boxes of voxels.
+    unsigned int getModifiedRegions(const unsigned long long a_sinceCounter, std::vector<cMultiImageRegion>& a_regions) const;
+
+    //! This method returns the range of voxels covered by a brick.
+    void getBrickRange(const unsigned int a_brickIndex,
+        unsigned int& a_minX,
+        unsigned int& a_minY,
+        unsigned int& a_minZ,
+        unsigned int& a_maxX,
+        unsigned int& a_maxY,
+        unsigned int& a_maxZ) const;
+
+
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - MEMORY DATA:
     //--------------------------------------------------------------------------
@@ -283,6 +348,9 @@ protected:
     //! Add an image to a preallocated set if size and format are compatible.
     bool addImagePrealloc(cImage &a_image, unsigned long a_index);
 
+    //! This method resizes the brick grid to match the image set and clears all modification records.
+    void resetBricks();
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -298,6 +366,34 @@ protected:
 
     //! Index of the currently selected image.
     unsigned long m_currentIndex;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - MODIFICATION TRACKING:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Size of a brick along each axis (in voxels).
+    unsigned int m_brickSize;
+
+    //! Number of bricks along __x__.
+    unsigned int m_brickCountX;
+
+    //! Number of bricks along __y__.
+    unsigned int m_brickCountY;
+
+    //! Number of bricks along __z__.
+    unsigned int m_brickCountZ;
+
+    //! Value of the modification counter when each brick was last modified.
+    std::vector<unsigned long long> m_brickModificationCounter;
+
+    //! Modification counter. Incremented each time a voxel or region is marked as modified.
+    unsigned long long m_modificationCounter;
+
+    //! Lock protecting voxel data and modification tracking when images are modified from another thread.
+    cMutex m_lock;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,240 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CMultiImageViewH
+#define CMultiImageViewH
+//------------------------------------------------------------------------------
+#include "graphics/CMultiImage.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CMultiImageView.h
+
+    \brief
+    Implements typed views over the voxels of a cMultiImage.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//! Describes voxels stored in GL_LUMINANCE format.
+struct cVoxelFormatLuminance
+{
+    enum { FORMAT = GL_LUMINANCE, BYTES_PER_VOXEL = 1 };
+    static inline unsigned char getAlpha(const unsigned char* a_voxel) { return (a_voxel[0]); }
+    static inline void getColor(const unsigned char* a_voxel, cColorb& a_color) { a_color.set(a_voxel[0], a_voxel[0], a_voxel[0], a_voxel[0]); }
+    static inline void setColor(unsigned char* a_voxel, const cColorb& a_color) { a_voxel[0] = a_color.getA(); }
+    static inline void setAlpha(unsigned char* a_voxel, const unsigned char a_alpha) { a_voxel[0] = a_alpha; }
+};
+
+//! Describes voxels stored in GL_RGB format.
+struct cVoxelFormatRGB
+{
+    enum { FORMAT = GL_RGB, BYTES_PER_VOXEL = 3 };
+    static inline unsigned char getAlpha(const unsigned char* a_voxel) { return (0xff); }
+    static inline void getColor(const unsigned char* a_voxel, cColorb& a_color) { a_color.set(a_voxel[0], a_voxel[1], a_voxel[2]); }
+    static inline void setColor(unsigned char* a_voxel, const cColorb& a_color) { a_voxel[0] = a_color.getR(); a_voxel[1] = a_color.getG(); a_voxel[2] = a_color.getB(); }
+    static inline void setAlpha(unsigned char* a_voxel, const unsigned char a_alpha) { }
+};
+
+//! Describes voxels stored in GL_RGBA format.
+struct cVoxelFormatRGBA
+{
+    enum { FORMAT = GL_RGBA, BYTES_PER_VOXEL = 4 };
+    static inline unsigned char getAlpha(const unsigned char* a_voxel) { return (a_voxel[3]); }
+    static inline void getColor(const unsigned char* a_voxel, cColorb& a_color) { a_color.set(a_voxel[0], a_voxel[1], a_voxel[2], a_voxel[3]); }
+    static inline void setColor(unsigned char* a_voxel, const cColorb& a_color) { a_voxel[0] = a_color.getR(); a_voxel[1] = a_color.getG(); a_voxel[2] = a_color.getB(); a_voxel[3] = a_color.getA(); }
+    static inline void setAlpha(unsigned char* a_voxel, const unsigned char a_alpha) { a_voxel[3] = a_alpha; }
+};
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \class      cMultiImageView
+    \ingroup    graphics
+
+    \brief
+    This class implements a typed view over the voxels of a cMultiImage.
+
+    \details
+    cMultiImage::getVoxelColor() checks the voxel coordinates and the pixel
+    format of the image on every call. cMultiImageView is specialized at 
+    compile time for one pixel format (\ref cVoxelFormatLuminance, 
+    \ref cVoxelFormatRGB or \ref cVoxelFormatRGBA) and provides direct access
+    to slices, rows and voxels of the image without bounds checking, which
+    allows tight loops over a volume to be compiled without branches. \n
+
+    The format of the image must be tested once with \ref isValid() before 
+    accessing voxels. A view does not own the image data and becomes invalid 
+    if the image is reallocated. Voxels modified through a view must be 
+    reported with cMultiImage::markVoxelModified() or 
+    cMultiImage::markRegionModified().
+*/
+//==============================================================================
+template <class T> class cMultiImageView
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cMultiImageView.
+    cMultiImageView(cMultiImage* a_image)
+    {
+        m_valid = ((a_image != NULL) && 
+                   (a_image->getArray() != NULL) &&
+                   (a_image->getFormat() == (GLenum)(T::FORMAT)) &&
+                   (a_image->getType() == GL_UNSIGNED_BYTE));
+
+        m_data = (m_valid) ? a_image->getArray() : NULL;
+        m_width = (m_valid) ? a_image->getWidth() : 0;
+        m_height = (m_valid) ? a_image->getHeight() : 0;
+        m_depth = (m_valid) ? a_image->getImageCount() : 0;
+        m_rowStride = m_width * T::BYTES_PER_VOXEL;
+        m_sliceStride = m_height * m_rowStride;
+    }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns __true__ if the image matches the format of this view, __false__ otherwise.
+    inline bool isValid() const { return (m_valid); }
+
+    //! This method returns the width of the volume.
+    inline unsigned int getWidth() const { return (m_width); }
+
+    //! This method returns the height of the volume.
+    inline unsigned int getHeight() const { return (m_height); }
+
+    //! This method returns the number of slices of the volume.
+    inline unsigned int getDepth() const { return (m_depth); }
+
+    //! This method returns __true__ if a voxel coordinate lies inside the volume, __false__ otherwise.
+    inline bool contains(const int a_x, const int a_y, const int a_z) const
+    {
+        return (((unsigned int)a_x < m_width) && ((unsigned int)a_y < m_height) && ((unsigned int)a_z < m_depth));
+    }
+
+    //! This method returns a pointer to the first voxel of a slice. No bounds checking is performed.
+    inline unsigned char* getSlice(const unsigned int a_z) const { return (m_data + a_z * m_sliceStride); }
+
+    //! This method returns a pointer to the first voxel of a row. No bounds checking is performed.
+    inline unsigned char* getRow(const unsigned int a_y, const unsigned int a_z) const { return (m_data + a_z * m_sliceStride + a_y * m_rowStride); }
+
+    //! This method returns a pointer to a voxel. No bounds checking is performed.
+    inline unsigned char* getVoxel(const unsigned int a_x, const unsigned int a_y, const unsigned int a_z) const { return (getRow(a_y, a_z) + a_x * T::BYTES_PER_VOXEL); }
+
+    //! This method returns the alpha component of a voxel. No bounds checking is performed.
+    inline unsigned char getAlpha(const unsigned int a_x, const unsigned int a_y, const unsigned int a_z) const { return (T::getAlpha(getVoxel(a_x, a_y, a_z))); }
+
+    //! This method returns the alpha component of a voxel, or a default value if the voxel lies outside of the volume.
+    inline unsigned char getAlphaChecked(const int a_x, const int a_y, const int a_z, const unsigned char a_outside = 0) const
+    {
+        return (contains(a_x, a_y, a_z) ? T::getAlpha(getVoxel(a_x, a_y, a_z)) : a_outside);
+    }
+
+    //! This method returns the color of a voxel. No bounds checking is performed.
+    inline void getColor(const unsigned int a_x, const unsigned int a_y, const unsigned int a_z, cColorb& a_color) const { T::getColor(getVoxel(a_x, a_y, a_z), a_color); }
+
+    //! This method sets the alpha component of a voxel. No bounds checking is performed.
+    inline void setAlpha(const unsigned int a_x, const unsigned int a_y, const unsigned int a_z, const unsigned char a_alpha) const { T::setAlpha(getVoxel(a_x, a_y, a_z), a_alpha); }
+
+    //! This method sets the color of a voxel. No bounds checking is performed.
+    inline void setColor(const unsigned int a_x, const unsigned int a_y, const unsigned int a_z, const cColorb& a_color) const { T::setColor(getVoxel(a_x, a_y, a_z), a_color); }
+
+    //! This method returns the alpha component of a voxel within a row. No bounds checking is performed.
+    static inline unsigned char getAlphaInRow(const unsigned char* a_row, const unsigned int a_x) { return (T::getAlpha(a_row + a_x * T::BYTES_PER_VOXEL)); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__, the image matches the format of this view.
+    bool m_valid;
+
+    //! Pointer to voxel data.
+    unsigned char* m_data;
+
+    //! Width of volume.
+    unsigned int m_width;
+
+    //! Height of volume.
+    unsigned int m_height;
+
+    //! Number of slices of volume.
+    unsigned int m_depth;
+
+    //! Number of bytes between two rows.
+    unsigned int m_rowStride;
+
+    //! Number of bytes between two slices.
+    unsigned int m_sliceStride;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
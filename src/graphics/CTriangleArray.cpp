@@ -536,6 +536,74 @@ void cTriangleArray::compress()
     unsigned size = j+1;
     m_allocated.resize(size);
     m_indices.resize(3*size);
+    m_freeElements.clear();
+
+    // mark for update
+    m_flagMarkForResize = true;
+    m_modificationCounter++;
+}
+
+
+//==============================================================================
+/*!
+    This method rebuilds the triangle array so that triangle __i__ becomes the 
+    triangle previously stored at index __a_triangleOrder[i]__. Triangles that 
+    are not listed are removed. \n
+
+    __IMPORTANT:__ \n
+    After calling this method, it is important to immediately update any
+    collision detector as the collision tree may refer to triangles by their
+    previous index number.\n
+
+    \param  a_triangleOrder  Index numbers of the triangles to keep, in their new order.
+*/
+//==============================================================================
+void cTriangleArray::reorder(const std::vector<unsigned int>& a_triangleOrder)
+{
+    unsigned int size = (unsigned int)(a_triangleOrder.size());
+
+    std::vector<unsigned int> indices(3 * size);
+    for (unsigned int i=0; i<size; i++)
+    {
+        unsigned int index = a_triangleOrder[i];
+        indices[3*i+0] = m_indices[3*index+0];
+        indices[3*i+1] = m_indices[3*index+1];
+        indices[3*i+2] = m_indices[3*index+2];
+    }
+
+    m_indices.swap(indices);
+    m_allocated.assign(size, true);
+    m_freeElements.clear();
+    m_modifiedElements.clear();
+
+    // mark for update
+    m_flagMarkForResize = true;
+    m_flagMarkForUpdate = true;
+    m_modificationCounter++;
+}
+
+
+//==============================================================================
+/*!
+    This method replaces every vertex index __i__ referenced by the triangles 
+    with __a_vertexMap[i]__. It is used after vertices have been merged or 
+    reordered.
+
+    \param  a_vertexMap  New index number of each vertex.
+*/
+//==============================================================================
+void cTriangleArray::remapVertices(const std::vector<unsigned int>& a_vertexMap)
+{
+    unsigned int size = (unsigned int)(m_indices.size());
+    for (unsigned int i=0; i<size; i++)
+    {
+        m_indices[i] = a_vertexMap[m_indices[i]];
+    }
+
+    // mark for update
+    m_modifiedElements.markAll();
+    m_flagMarkForUpdate = true;
+    m_modificationCounter++;
 }
 
 
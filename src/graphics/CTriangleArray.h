@@ -143,8 +143,10 @@ public:
         m_allocated.clear();
         m_indices.clear();
         m_freeElements.clear();
+        m_modifiedElements.clear();
         m_flagMarkForUpdate     = true;
         m_flagMarkForResize     = true;
+        m_modificationCounter++;
     }
 
 
@@ -167,6 +169,12 @@ public:
     //! This method removes all non allocated triangles.
     void compress();
 
+    //! This method rebuilds the array with a selection of its triangles in a new order.
+    void reorder(const std::vector<unsigned int>& a_triangleOrder);
+
+    //! This method replaces the vertex indices of all triangles using a lookup table.
+    void remapVertices(const std::vector<unsigned int>& a_vertexMap);
+
 
     //--------------------------------------------------------------------------
     /*!
@@ -202,6 +210,7 @@ public:
             m_allocated.push_back(true);
 
             m_flagMarkForResize = true;
+            m_modificationCounter++;
 
             // store index of new triangle
             index = (int)(m_allocated.size())-1;
@@ -215,6 +224,41 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method creates a number of new triangles from a list of vertex 
+        indices (three per triangle). The triangles are appended to the end of 
+        the array in a single operation; the free triangle list is not used.
+
+        \param  a_vertexIndices  List of vertex indices.
+        \param  a_numTriangles   Number of triangles to create.
+
+        \return Index number of the first new triangle.
+    */
+    //--------------------------------------------------------------------------
+    int newTriangles(const unsigned int* a_vertexIndices,
+                     const unsigned int a_numTriangles)
+    {
+        // store index of first new triangle
+        int index = (int)(m_allocated.size());
+
+        // sanity check
+        if (a_numTriangles == 0) { return (index); }
+
+        // store new indices
+        m_indices.insert(m_indices.end(), a_vertexIndices, a_vertexIndices + 3 * a_numTriangles);
+        m_allocated.resize(m_allocated.size() + a_numTriangles, true);
+
+        // mark for update
+        m_flagMarkForUpdate = true;
+        m_flagMarkForResize = true;
+        m_modificationCounter++;
+
+        // return index to first new triangle
+        return (index);
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method deallocates a selected triangle from the array. The three 
@@ -266,6 +310,8 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_modifiedElements.mark(a_triangleIndex, getNumElements());
+        m_modificationCounter++;
     }
 
 
@@ -284,6 +330,8 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_modifiedElements.mark(a_triangleIndex, getNumElements());
+        m_modificationCounter++;
     };
 
 
@@ -317,6 +365,8 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_modifiedElements.mark(a_triangleIndex, getNumElements());
+        m_modificationCounter++;
     };
 
 
@@ -350,6 +400,8 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_modifiedElements.mark(a_triangleIndex, getNumElements());
+        m_modificationCounter++;
     };
 
 
@@ -483,72 +535,91 @@ public:
 
     //--------------------------------------------------------------------------
     /*!
-         This method computes the normal matrix vectors for all triangles.
+        This method computes the surface tangent and bitangent of a selected
+        triangle from its vertex positions and texture coordinates.
+
+        \param  a_triangleIndex  Index number of selected triangle.
+        \param  a_tangent        Returned tangent vector.
+        \param  a_bitangent      Returned bitangent vector.
+
+        \return __true__ if the texture coordinates define a valid frame, __false__ otherwise.
     */
     //--------------------------------------------------------------------------
-    inline void computeBTN()
+    inline bool computeTangents(const unsigned int a_triangleIndex,
+                                cVector3d& a_tangent,
+                                cVector3d& a_bitangent) const
     {
-        unsigned int numTriangles = getNumElements();
-        for (unsigned i=0; i<numTriangles; i++)
-        {
-            cVector3d T,B;
+        unsigned int index0 = getVertexIndex0(a_triangleIndex);
+        unsigned int index1 = getVertexIndex1(a_triangleIndex);
+        unsigned int index2 = getVertexIndex2(a_triangleIndex);
 
-            unsigned int index0 = getVertexIndex0(i);
-            unsigned int index1 = getVertexIndex1(i);
-            unsigned int index2 = getVertexIndex2(i);
+        // calculate the vectors from the current vertex to the two other vertices in the triangle
+        cVector3d v1v0 = m_vertices->getLocalPos(index1) - m_vertices->getLocalPos(index0);
+        cVector3d v2v0 = m_vertices->getLocalPos(index2) - m_vertices->getLocalPos(index0);
 
-            // calculate the vectors from the current vertex to the two other vertices in the triangle
-            cVector3d v1v0 = m_vertices->getLocalPos(index1) - m_vertices->getLocalPos(index0);
-            cVector3d v2v0 = m_vertices->getLocalPos(index2) - m_vertices->getLocalPos(index0);
+        cVector3d tex0 = m_vertices->getTexCoord(index0);
+        cVector3d tex1 = m_vertices->getTexCoord(index1);
+        cVector3d tex2 = m_vertices->getTexCoord(index2);
 
-            cVector3d tex0 = m_vertices->getTexCoord(index0);
-            cVector3d tex1 = m_vertices->getTexCoord(index1);
-            cVector3d tex2 = m_vertices->getTexCoord(index2);
+        // calculate c1c0_T and c1c0_B
+        double c1c0_T = tex1.x() - tex0.x();
+        double c1c0_B = tex1.y() - tex0.y();
 
-            // calculate c1c0_T and c1c0_B
-            double c1c0_T = tex1.x() - tex0.x();
-            double c1c0_B = tex1.y() - tex0.y();
+        // calculate c2c0_T and c2c0_B
+        double c2c0_T = tex2.x() - tex0.x();
+        double c2c0_B = tex2.y() - tex0.y();
 
-            // calculate c2c0_T and c2c0_B
-            double c2c0_T = tex2.x() - tex0.x();
-            double c2c0_B = tex2.y() - tex0.y();
+        double fDenominator = c1c0_T * c2c0_B - c2c0_T * c1c0_B;
+        if (fabs(fDenominator) < C_TINY)
+        {
+            // we won't risk a divide by zero, so set the tangent matrix to the identity matrix
+            a_tangent = cVector3d(1.0, 0.0, 0.0);
+            a_bitangent = cVector3d(0.0, 1.0, 0.0);
+            return (false);
+        }
 
-            double fDenominator = c1c0_T * c2c0_B - c2c0_T * c1c0_B;
-            if (fabs(fDenominator) < C_TINY)
-            {
-                // we won't risk a divide by zero, so set the tangent matrix to the identity matrix
-                T = cVector3d(1.0, 0.0, 0.0);
-                B = cVector3d(0.0, 1.0, 0.0);
-            }
-            else
-            {
-                // calculate the reciprocal value once and for all (to achieve speed)
-                double fScale1 = 1.0f / fDenominator;
+        // calculate the reciprocal value once and for all (to achieve speed)
+        double fScale1 = 1.0f / fDenominator;
 
-                // T and B are calculated just as the equation in the article states
-                T = cVector3d((c2c0_B * v1v0.x() - c1c0_B * v2v0.x()) * fScale1,
+        // T and B are calculated just as the equation in the article states
+        a_tangent = cVector3d((c2c0_B * v1v0.x() - c1c0_B * v2v0.x()) * fScale1,
                               (c2c0_B * v1v0.y() - c1c0_B * v2v0.y()) * fScale1,
                               (c2c0_B * v1v0.z() - c1c0_B * v2v0.z()) * fScale1);
 
-                B = cVector3d((-c2c0_T * v1v0.x() + c1c0_T * v2v0.x()) * fScale1,
-                              (-c2c0_T * v1v0.y() + c1c0_T * v2v0.y()) * fScale1,
-                              (-c2c0_T * v1v0.z() + c1c0_T * v2v0.z()) * fScale1);
+        a_bitangent = cVector3d((-c2c0_T * v1v0.x() + c1c0_T * v2v0.x()) * fScale1,
+                                (-c2c0_T * v1v0.y() + c1c0_T * v2v0.y()) * fScale1,
+                                (-c2c0_T * v1v0.z() + c1c0_T * v2v0.z()) * fScale1);
+
+        return (true);
+    }
+
 
-                // Calculate the reciprocal value once and for all (to achieve speed)
-                /*
-                double fScale2 = 1.0f / ((T.x() * B.y() * N.z() - T.z() * B.y() * N.x()) +
-                                         (B.x() * N.y() * T.z() - B.z() * N.y() * T.x()) +
-                                         (N.x() * T.y() * B.z() - N.z() * T.y() * B.x()));
-                */
+    //--------------------------------------------------------------------------
+    /*!
+         This method computes the normal matrix vectors for all triangles.
+    */
+    //--------------------------------------------------------------------------
+    inline void computeBTN()
+    {
+        unsigned int numTriangles = getNumElements();
+        for (unsigned i=0; i<numTriangles; i++)
+        {
+            cVector3d T,B;
 
+            unsigned int index0 = getVertexIndex0(i);
+            unsigned int index1 = getVertexIndex1(i);
+            unsigned int index2 = getVertexIndex2(i);
+
+            if (computeTangents(i, T, B))
+            {
                 // compute tangent and bi-tangent vector for vertex 0
                 cVector3d N0 = m_vertices->getNormal(index0);
                 cVector3d T0 = cProjectPointOnPlane(T, cVector3d(0, 0, 0), N0);
                 cVector3d B0 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N0);
                 T0.normalize();
                 B0.normalize();
-                m_vertices->m_tangent[index0] = T0;
-                m_vertices->m_bitangent[index0] = B0;
+                m_vertices->setTangent(index0, T0);
+                m_vertices->setBitangent(index0, B0);
 
                 // compute tangent and bi-tangent vector for vertex 1
                 cVector3d N1 = m_vertices->getNormal(index1);
@@ -556,8 +627,8 @@ public:
                 cVector3d B1 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N1);
                 T1.normalize();
                 B1.normalize();
-                m_vertices->m_tangent[index1] = T1;
-                m_vertices->m_bitangent[index1] = B1;
+                m_vertices->setTangent(index1, T1);
+                m_vertices->setBitangent(index1, B1);
 
                 // compute tangent and bi-tangent vector for vertex 2
                 cVector3d N2 = m_vertices->getNormal(index2);
@@ -565,8 +636,8 @@ public:
                 cVector3d B2 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N2);
                 T2.normalize();
                 B2.normalize();
-                m_vertices->m_tangent[index2] = T2;
-                m_vertices->m_bitangent[index2] = B2;
+                m_vertices->setTangent(index2, T2);
+                m_vertices->setBitangent(index2, B2);
 
                 // mark for update
                 m_vertices->m_flagTangentData = true;
@@ -576,6 +647,23 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method allocates or updates the OpenGL element and vertex buffers 
+        without rendering them. It can be called ahead of time, for instance to 
+        spread the transfer of newly loaded models over several frames.
+    */
+    //--------------------------------------------------------------------------
+    inline void updateBuffers()
+    {
+#ifdef C_USE_OPENGL
+        updateElementBuffer();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        m_vertices->updateBuffers();
+#endif
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method renders the OpenGL vertex buffer object.
@@ -583,6 +671,30 @@ public:
     //--------------------------------------------------------------------------
     inline void renderInitialize()
     { 
+#ifdef C_USE_OPENGL
+        // update element buffer
+        unsigned int numtriangles = getNumElements();
+        updateElementBuffer();
+
+        // initialize rendering of vertices
+        m_vertices->renderInitialize();
+        
+        // render object
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBuffer);
+        glDrawElements(GL_TRIANGLES, 3 * numtriangles, GL_UNSIGNED_INT, (void*)0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+#endif
+    }
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method allocates the OpenGL element buffer if needed, binds it 
+        and transfers all modified triangles.
+    */
+    //--------------------------------------------------------------------------
+    inline void updateElementBuffer()
+    { 
 #ifdef C_USE_OPENGL
         unsigned int numtriangles = getNumElements();
 
@@ -599,26 +711,24 @@ public:
         if (m_flagMarkForResize)
         {
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, 3 * numtriangles * sizeof(unsigned int), &(m_indices[0]), GL_STATIC_DRAW);
-            m_flagMarkForResize = true;
+            m_flagMarkForResize = false;
+            m_flagMarkForUpdate = false;
+            m_modifiedElements.clear();
         }
 
-        // update data if needed
+        // update modified triangles if needed
         if (m_flagMarkForUpdate)
         {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBuffer);
-            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, 3 * numtriangles * sizeof(unsigned int), &(m_indices[0]));
+            m_modifiedElements.computeSpans(numtriangles, 16, m_spans);
+            for (unsigned int i=0; i<m_spans.size(); i++)
+            {
+                unsigned int offset = 3 * m_spans[i].m_first;
+                glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(unsigned int), 3 * m_spans[i].m_count * sizeof(unsigned int), &(m_indices[offset]));
+            }
 
+            m_modifiedElements.clear();
             m_flagMarkForUpdate = false;
         }
-
-        // initialize rendering of vertices
-        m_vertices->renderInitialize();
-        
-        // render object
-        glEnableClientState(GL_VERTEX_ARRAY);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementBuffer);
-        glDrawElements(GL_TRIANGLES, 3 * numtriangles, GL_UNSIGNED_INT, (void*)0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 #endif
     }
 
@@ -708,6 +818,16 @@ public:
         normal.zero();
         return (normal);
     }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Temporary list of spans transferred during an update.
+    std::vector<cModifiedSpan> m_spans;
 };
 
 //------------------------------------------------------------------------------
@@ -48,6 +48,7 @@
 #include "math/CVector3d.h"
 #include "math/CMatrix3d.h"
 #include "graphics/CColor.h"
+#include "graphics/CModifiedRanges.h"
 #include "shaders/CShader.h"
 //------------------------------------------------------------------------------
 #include <vector>
@@ -149,6 +150,7 @@ public:
     //--------------------------------------------------------------------------
     cVertexArray(const cVertexArrayOptions& a_options)
     {
+        m_modificationCounter = 0;
         clear();
         m_useNormalData     = a_options.m_useNormalData;
         m_useTexCoordData   = a_options.m_useTexCoordData;
@@ -170,6 +172,15 @@ public:
         m_colorBuffer       = (GLuint)(-1);
         m_tangentBuffer     = (GLuint)(-1);
         m_bitangentBuffer   = (GLuint)(-1);
+        m_interleavedBuffer = (GLuint)(-1);
+        m_useInterleavedBuffer = false;
+        m_interleavedStride = 0;
+        m_numBytesUploaded  = 0;
+        m_totalBytesUploaded = 0;
+        m_partialUpdateThreshold = 0.5;
+        m_useGlobalPosData  = true;
+        m_globalFramePos.zero();
+        m_globalFrameRot.identity();
     }
 
 
@@ -232,8 +243,11 @@ public:
         m_tangent.clear();
         m_bitangent.clear();
         m_userData.clear();
+        m_interleavedData.clear();
         m_numVertices = 0;
+        clearModifiedRanges();
         m_flagBufferResize = true;
+        m_modificationCounter++;
     }
 
 
@@ -268,6 +282,10 @@ public:
         vertexArray->m_useTangentData = m_useTangentData;
         vertexArray->m_useBitangentData = m_useBitangentData;
         vertexArray->m_useUserData = m_useUserData;
+        vertexArray->m_useInterleavedBuffer = m_useInterleavedBuffer;
+        vertexArray->m_useGlobalPosData = m_useGlobalPosData;
+        vertexArray->m_globalFramePos = m_globalFramePos;
+        vertexArray->m_globalFrameRot = m_globalFrameRot;
         vertexArray->m_numVertices = m_numVertices;
 
         // return new vertex array
@@ -330,6 +348,8 @@ public:
     {
         m_localPos[a_vertexIndex].set(a_x, a_y, a_z);
         m_flagPositionData = true;
+        m_modificationCounter++;
+        m_modifiedPosition.mark(a_vertexIndex, m_numVertices);
     }
 
 
@@ -346,6 +366,8 @@ public:
     {
         m_localPos[a_vertexIndex] = a_pos;
         m_flagPositionData = true;
+        m_modificationCounter++;
+        m_modifiedPosition.mark(a_vertexIndex, m_numVertices);
     }
 
 
@@ -363,6 +385,8 @@ public:
     {
         m_localPos[a_vertexIndex].add(a_translation);
         m_flagPositionData = true;
+        m_modificationCounter++;
+        m_modifiedPosition.mark(a_vertexIndex, m_numVertices);
     }
 
 
@@ -384,7 +408,9 @@ public:
     /*!
         This method returns the global position of a selected vertex. This value 
         is only correct if the computeGlobalPositions() method has been called 
-        previously.
+        previously. If global position data is not stored, the value is 
+        computed on request from the last known position and orientation of
+        the parent object.
 
         \param  a_vertexIndex  Vertex index number.
         \return Global position of vertex in world coordinates.
@@ -392,7 +418,15 @@ public:
     //--------------------------------------------------------------------------
     inline cVector3d getGlobalPos(const unsigned int a_vertexIndex) const 
     { 
-        return (m_globalPos[a_vertexIndex]); 
+        if (m_useGlobalPosData)
+        {
+            return (m_globalPos[a_vertexIndex]); 
+        }
+
+        cVector3d pos;
+        m_globalFrameRot.mulr(m_localPos[a_vertexIndex], pos);
+        pos.add(m_globalFramePos);
+        return (pos);
     }
 
 
@@ -411,6 +445,8 @@ public:
         {
             m_normal[a_vertexIndex] = a_normal;
             m_flagNormalData = true;
+            m_modificationCounter++;
+            m_modifiedNormal.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -434,6 +470,8 @@ public:
         {
             m_normal[a_vertexIndex].set(a_x, a_y, a_z);
             m_flagNormalData = true;
+            m_modificationCounter++;
+            m_modifiedNormal.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -467,6 +505,7 @@ public:
         {
             m_texCoord[a_vertexIndex] = a_texCoord;
             m_flagTexCoordData = true;
+            m_modifiedTexCoord.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -491,6 +530,7 @@ public:
         {
             m_texCoord[a_vertexIndex].set(a_tx, a_ty,a_tz);
             m_flagTexCoordData = true;
+            m_modifiedTexCoord.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -524,6 +564,7 @@ public:
         {
             m_color[a_vertexIndex] = a_color;
             m_flagColorData = true;
+            m_modifiedColor.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -550,6 +591,7 @@ public:
         {
             m_color[a_vertexIndex].set(a_red, a_green, a_blue, a_alpha);
             m_flagColorData = true;
+            m_modifiedColor.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -569,6 +611,7 @@ public:
         {
             m_color[a_vertexIndex] = a_color.getColorf();
             m_flagColorData = true;
+            m_modifiedColor.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -602,6 +645,8 @@ public:
         {
             m_tangent[a_vertexIndex] = a_tangent;
             m_flagTangentData = true;
+            m_modificationCounter++;
+            m_modifiedTangent.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -625,6 +670,8 @@ public:
         {
             m_tangent[a_vertexIndex].set(a_x, a_y, a_z);
             m_flagTangentData = true;
+            m_modificationCounter++;
+            m_modifiedTangent.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -658,6 +705,8 @@ public:
         {
             m_bitangent[a_vertexIndex] = a_bitangent;
             m_flagBitangentData = true;
+            m_modificationCounter++;
+            m_modifiedBitangent.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -681,6 +730,8 @@ public:
         {
             m_bitangent[a_vertexIndex].set(a_x, a_y, a_z);
             m_flagBitangentData = true;
+            m_modificationCounter++;
+            m_modifiedBitangent.mark(a_vertexIndex, m_numVertices);
         }
     }
 
@@ -732,6 +783,37 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method marks the normal data of all vertices for GPU update. It
+        should be called after writing directly into \ref m_normal.
+    */
+    //--------------------------------------------------------------------------
+    inline void markNormalDataForUpdate()
+    {
+        m_flagNormalData = true;
+        m_modificationCounter++;
+        m_modifiedNormal.markAll();
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method marks the tangent and bitangent data of all vertices for 
+        GPU update. It should be called after writing directly into 
+        \ref m_tangent and \ref m_bitangent.
+    */
+    //--------------------------------------------------------------------------
+    inline void markTangentDataForUpdate()
+    {
+        m_flagTangentData = true;
+        m_flagBitangentData = true;
+        m_modificationCounter++;
+        m_modifiedTangent.markAll();
+        m_modifiedBitangent.markAll();
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method computes the global position of vertex given the global 
@@ -746,11 +828,100 @@ public:
                                       const cVector3d& a_globalPos, 
                                       const cMatrix3d& a_globalRot)
     {
+        if (!m_useGlobalPosData)
+        {
+            m_globalFramePos = a_globalPos;
+            m_globalFrameRot = a_globalRot;
+            return;
+        }
+
         a_globalRot.mulr(m_localPos[a_vertexIndex], m_globalPos[a_vertexIndex]);
         m_globalPos[a_vertexIndex].add(a_globalPos);
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method computes the global position of all vertices given the 
+        global position and global rotation matrix of the parent object.
+        If global position data is not stored, only the position and 
+        orientation of the parent are recorded.
+
+        \param  a_globalPos    Global position vector of parent.
+        \param  a_globalRot    Global rotation matrix of parent.
+    */
+    //--------------------------------------------------------------------------
+    inline void computeGlobalPositions(const cVector3d& a_globalPos, 
+                                       const cMatrix3d& a_globalRot)
+    {
+        m_globalFramePos = a_globalPos;
+        m_globalFrameRot = a_globalRot;
+
+        if (!m_useGlobalPosData) { return; }
+
+        for (unsigned int i=0; i<m_numVertices; i++)
+        {
+            a_globalRot.mulr(m_localPos[i], m_globalPos[i]);
+            m_globalPos[i].add(a_globalPos);
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method enables or disables the storage of global vertex positions.
+        When disabled, the global position array is released and 
+        \ref getGlobalPos() computes each value on request. Collision detection
+        and haptic rendering operate in local coordinates and are not affected.
+
+        \param  a_useGlobalPosData  If __true__ then global positions are stored.
+    */
+    //--------------------------------------------------------------------------
+    inline void setUseGlobalPosData(const bool a_useGlobalPosData)
+    {
+        if (a_useGlobalPosData == m_useGlobalPosData) { return; }
+        m_useGlobalPosData = a_useGlobalPosData;
+
+        if (m_useGlobalPosData)
+        {
+            m_globalPos.resize(m_numVertices);
+            computeGlobalPositions(m_globalFramePos, m_globalFrameRot);
+        }
+        else
+        {
+            std::vector<cVector3d>().swap(m_globalPos);
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method checks if global positions are stored for each vertex in
+        this array.
+
+        \return __true__ if data is stored, __false__ otherwise.
+    */
+    //--------------------------------------------------------------------------
+    inline bool getUseGlobalPosData() const 
+    { 
+        return (m_useGlobalPosData); 
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the amount of memory allocated for global vertex 
+        positions.
+
+        \return Size in bytes.
+    */
+    //--------------------------------------------------------------------------
+    inline unsigned int getGlobalPosDataSize() const 
+    { 
+        return ((unsigned int)(m_globalPos.capacity() * sizeof(cVector3d))); 
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method returns the number of vertices allocated in this array.
@@ -850,12 +1021,145 @@ public:
 
     //--------------------------------------------------------------------------
     /*!
-        This method allocates or updates all OpenGL buffers.
+        This method enables or disables the interleaved single-precision 
+        vertex buffer. \n
+
+        When enabled, the double-precision arrays remain the reference data
+        used by the haptic and collision algorithms, but the graphics card 
+        receives a packed copy of all vertex attributes converted to single 
+        precision and stored in a single interleaved OpenGL buffer. Only the 
+        vertices modified since the last update are converted and transferred.
+
+        \param  a_enabled  If __true__ then the interleaved buffer is used.
+    */
+    //--------------------------------------------------------------------------
+    inline void setUseInterleavedBuffer(const bool a_enabled)
+    {
+        if (a_enabled == m_useInterleavedBuffer) { return; }
+        m_useInterleavedBuffer = a_enabled;
+        m_flagBufferResize = true;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns __true__ if the interleaved single-precision vertex 
+        buffer is used for rendering.
+
+        \return __true__ if the interleaved buffer is enabled, __false__ otherwise.
     */
     //--------------------------------------------------------------------------
-    inline void renderInitialize()
+    inline bool getUseInterleavedBuffer() const 
     { 
+        return (m_useInterleavedBuffer); 
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the number of bytes transferred to the GPU during
+        the last call to \ref renderInitialize().
+
+        \return Number of bytes uploaded.
+    */
+    //--------------------------------------------------------------------------
+    inline unsigned int getNumBytesUploaded() const
+    {
+        return (m_numBytesUploaded);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the total number of bytes transferred to the GPU 
+        since the array was created or the statistics were last reset.
+
+        \return Total number of bytes uploaded.
+    */
+    //--------------------------------------------------------------------------
+    inline unsigned long long getTotalBytesUploaded() const
+    {
+        return (m_totalBytesUploaded);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns a counter that is incremented every time the 
+        position, normal, tangent or bitangent data is modified through this
+        class, or when vertices are added or removed. Data written directly 
+        into the public arrays is not tracked until it is marked for update.
+
+        \return Modification counter.
+    */
+    //--------------------------------------------------------------------------
+    inline unsigned int getModificationCounter() const
+    {
+        return (m_modificationCounter);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method resets the GPU upload statistics.
+    */
+    //--------------------------------------------------------------------------
+    inline void resetUploadStatistics()
+    {
+        m_numBytesUploaded = 0;
+        m_totalBytesUploaded = 0;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method sets the fraction of modified vertices above which an 
+        OpenGL buffer is replaced completely instead of updating the individual 
+        modified spans. A complete update orphans the previous buffer storage,
+        which avoids stalling on data still in use by the graphics pipeline.
+
+        \param  a_threshold  Fraction of modified vertices (0.0 to 1.0).
+    */
+    //--------------------------------------------------------------------------
+    inline void setPartialUpdateThreshold(const double a_threshold)
+    {
+        m_partialUpdateThreshold = cClamp(a_threshold, 0.0, 1.0);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the fraction of modified vertices above which an 
+        OpenGL buffer is replaced completely.
+
+        \return Fraction of modified vertices.
+    */
+    //--------------------------------------------------------------------------
+    inline double getPartialUpdateThreshold() const
+    {
+        return (m_partialUpdateThreshold);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method allocates or updates all OpenGL buffers without binding 
+        them for rendering. It can be called ahead of time, for instance to 
+        spread the transfer of newly loaded models over several frames.
+    */
+    //--------------------------------------------------------------------------
+    inline void updateBuffers()
+    {
 #ifdef C_USE_OPENGL
+        m_numBytesUploaded = 0;
+
+        // update interleaved single-precision buffer
+        if (m_useInterleavedBuffer)
+        {
+            updateInterleavedBuffer();
+            return;
+        }
+
         // create buffers first time
         if (m_positionBuffer == (GLuint)(-1))
         {
@@ -894,79 +1198,111 @@ public:
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
                 glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_localPos[0]), GL_STATIC_DRAW);
+                m_numBytesUploaded += m_numVertices * sizeof(cVector3d);
             }
 
             if (m_useNormalData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
                 glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_normal[0]), GL_STATIC_DRAW);
+                m_numBytesUploaded += m_numVertices * sizeof(cVector3d);
             }
 
             if (m_useTexCoordData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
                 glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]), GL_STATIC_DRAW);
+                m_numBytesUploaded += m_numVertices * sizeof(cVector3d);
             }
 
             if (m_useColorData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
                 glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cColorf), &(m_color[0]), GL_STATIC_DRAW);
+                m_numBytesUploaded += m_numVertices * sizeof(cColorf);
             }
 
             if (m_useTangentData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
                 glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_tangent[0]), GL_STATIC_DRAW);
+                m_numBytesUploaded += m_numVertices * sizeof(cVector3d);
             }
         
             if (m_useBitangentData)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
                 glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]), GL_STATIC_DRAW);
+                m_numBytesUploaded += m_numVertices * sizeof(cVector3d);
             }
 
             m_flagBufferResize = false;
+            m_flagPositionData = false;
+            m_flagNormalData = false;
+            m_flagTexCoordData = false;
+            m_flagColorData = false;
+            m_flagTangentData = false;
+            m_flagBitangentData = false;
         }
 
-        // update buffers if needed
+        // update modified spans of buffers
         if (m_flagPositionData)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_localPos[0]));
+            updateBuffer(m_positionBuffer, &(m_localPos[0]), sizeof(cVector3d), m_modifiedPosition);
             m_flagPositionData = false;
         }
         if (m_flagNormalData)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_normal[0]));
+            updateBuffer(m_normalBuffer, &(m_normal[0]), sizeof(cVector3d), m_modifiedNormal);
             m_flagNormalData = false;
         }
         if (m_flagTexCoordData)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]));
+            updateBuffer(m_texCoordBuffer, &(m_texCoord[0]), sizeof(cVector3d), m_modifiedTexCoord);
             m_flagTexCoordData = false;
         }
         if (m_flagColorData)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cColorf), &(m_color[0]));
+            updateBuffer(m_colorBuffer, &(m_color[0]), sizeof(cColorf), m_modifiedColor);
             m_flagColorData = false;
         }
         if (m_flagTangentData)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_tangent[0]));
+            updateBuffer(m_tangentBuffer, &(m_tangent[0]), sizeof(cVector3d), m_modifiedTangent);
             m_flagTangentData = false;
         }
         if (m_flagBitangentData)
         {
-            glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]));
+            updateBuffer(m_bitangentBuffer, &(m_bitangent[0]), sizeof(cVector3d), m_modifiedBitangent);
             m_flagBitangentData = false;
         }
 
+        // clear modified ranges
+        clearModifiedRanges();
+        m_totalBytesUploaded += m_numBytesUploaded;
+#endif
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method allocates or updates all OpenGL buffers and binds them for
+        rendering.
+    */
+    //--------------------------------------------------------------------------
+    inline void renderInitialize()
+    { 
+#ifdef C_USE_OPENGL
+        // update buffers
+        updateBuffers();
+
+        // render from interleaved single-precision buffer
+        if (m_useInterleavedBuffer)
+        {
+            renderInitializeInterleaved();
+            return;
+        }
+
         // bind buffers and set client state
         {
             glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
@@ -1053,6 +1389,38 @@ public:
 #endif
     }
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method rebuilds the array from a selection of its own vertices.
+        After the operation, vertex __i__ holds all the data previously stored
+        in vertex __a_sourceIndices[i]__. The same source vertex may be 
+        selected several times. This method is used to remove or reorder 
+        vertices; the caller is responsible for updating any index that refers 
+        to them.
+
+        \param  a_sourceIndices  Index number of the source vertex for each new vertex.
+    */
+    //--------------------------------------------------------------------------
+    void remap(const std::vector<unsigned int>& a_sourceIndices)
+    {
+        unsigned int numVertices = (unsigned int)(a_sourceIndices.size());
+
+        remapData(m_localPos, a_sourceIndices);
+        if (m_useGlobalPosData) { remapData(m_globalPos, a_sourceIndices); }
+        if (m_useNormalData)    { remapData(m_normal, a_sourceIndices); }
+        if (m_useTexCoordData)  { remapData(m_texCoord, a_sourceIndices); }
+        if (m_useColorData)     { remapData(m_color, a_sourceIndices); }
+        if (m_useTangentData)   { remapData(m_tangent, a_sourceIndices); }
+        if (m_useBitangentData) { remapData(m_bitangent, a_sourceIndices); }
+        if (m_useUserData)      { remapData(m_userData, a_sourceIndices); }
+
+        m_numVertices = numVertices;
+        clearModifiedRanges();
+        m_flagBufferResize = true;
+        m_modificationCounter++;
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method allocate data for vertex array.
@@ -1080,7 +1448,10 @@ public:
         // update position data allocation
         cVector3d pos(0.0, 0.0, 0.0);
         m_localPos.resize(m_numVertices, pos);
-        m_globalPos.resize(m_numVertices, pos);
+        if (m_useGlobalPosData)
+        {
+            m_globalPos.resize(m_numVertices, pos);
+        }
 
         // update normal data allocation
         m_useNormalData = a_useNormalData;
@@ -1204,6 +1575,342 @@ public:
 
         // update buffer size
         m_flagBufferResize = true;
+        m_modificationCounter++;
+    }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method rebuilds an attribute array from a selection of its 
+        elements.
+
+        \param  a_data           Attribute array.
+        \param  a_sourceIndices  Index number of the source element for each new element.
+    */
+    //--------------------------------------------------------------------------
+    template <typename T> static void remapData(std::vector<T>& a_data,
+                                                const std::vector<unsigned int>& a_sourceIndices)
+    {
+        std::vector<T> data(a_sourceIndices.size());
+        for (unsigned int i=0; i<a_sourceIndices.size(); i++)
+        {
+            data[i] = a_data[a_sourceIndices[i]];
+        }
+        a_data.swap(data);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method clears the record of modified vertices of all attributes.
+    */
+    //--------------------------------------------------------------------------
+    inline void clearModifiedRanges()
+    {
+        m_modifiedPosition.clear();
+        m_modifiedNormal.clear();
+        m_modifiedTexCoord.clear();
+        m_modifiedColor.clear();
+        m_modifiedTangent.clear();
+        m_modifiedBitangent.clear();
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method adds the modified vertices of an attribute to a combined 
+        record. An attribute flagged as modified without any recorded vertex 
+        is considered modified in its entirety.
+
+        \param  a_ranges    Combined record.
+        \param  a_flag      Modification flag of the attribute.
+        \param  a_modified  Modified vertices of the attribute.
+    */
+    //--------------------------------------------------------------------------
+    inline void mergeModifiedRanges(cModifiedRanges& a_ranges,
+                                    const bool a_flag,
+                                    const cModifiedRanges& a_modified)
+    {
+        if (!a_flag) { return; }
+        if (a_modified.isEmpty())
+        {
+            a_ranges.markAll();
+        }
+        else
+        {
+            a_ranges.merge(a_modified, m_numVertices);
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method transfers the modified spans of an attribute array to its 
+        OpenGL buffer. If the modified vertices exceed the partial update 
+        threshold, the buffer storage is orphaned and replaced in a single 
+        transfer.
+
+        \param  a_buffer       OpenGL buffer.
+        \param  a_data         Pointer to the first element of the attribute array.
+        \param  a_elementSize  Size in bytes of one element.
+        \param  a_ranges       Modified vertices of the attribute.
+    */
+    //--------------------------------------------------------------------------
+    inline void updateBuffer(const GLuint a_buffer,
+                             const void* a_data,
+                             const unsigned int a_elementSize,
+                             cModifiedRanges& a_ranges)
+    {
+#ifdef C_USE_OPENGL
+        unsigned int count = a_ranges.computeSpans(m_numVertices, 16, m_spans);
+        if (count == 0) { return; }
+
+        const unsigned char* data = (const unsigned char*)(a_data);
+        glBindBuffer(GL_ARRAY_BUFFER, a_buffer);
+
+        if (count > m_partialUpdateThreshold * m_numVertices)
+        {
+            glBufferData(GL_ARRAY_BUFFER, m_numVertices * a_elementSize, data, GL_DYNAMIC_DRAW);
+            m_numBytesUploaded += m_numVertices * a_elementSize;
+        }
+        else
+        {
+            for (unsigned int i=0; i<m_spans.size(); i++)
+            {
+                unsigned int offset = m_spans[i].m_first * a_elementSize;
+                unsigned int size = m_spans[i].m_count * a_elementSize;
+                glBufferSubData(GL_ARRAY_BUFFER, offset, size, data + offset);
+                m_numBytesUploaded += size;
+            }
+        }
+#endif
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method converts the attributes of a selected vertex to single 
+        precision and stores them in the interleaved buffer.
+
+        \param  a_vertexIndex  Index number of vertex.
+    */
+    //--------------------------------------------------------------------------
+    inline void packInterleavedVertex(const unsigned int a_vertexIndex)
+    {
+        float* dst = &(m_interleavedData[a_vertexIndex * m_interleavedStride]);
+
+        const cVector3d& pos = m_localPos[a_vertexIndex];
+        *dst++ = (float)pos(0); *dst++ = (float)pos(1); *dst++ = (float)pos(2);
+
+        if (m_useNormalData)
+        {
+            const cVector3d& v = m_normal[a_vertexIndex];
+            *dst++ = (float)v(0); *dst++ = (float)v(1); *dst++ = (float)v(2);
+        }
+        if (m_useTexCoordData)
+        {
+            const cVector3d& v = m_texCoord[a_vertexIndex];
+            *dst++ = (float)v(0); *dst++ = (float)v(1); *dst++ = (float)v(2);
+        }
+        if (m_useColorData)
+        {
+            const cColorf& c = m_color[a_vertexIndex];
+            *dst++ = c.getR(); *dst++ = c.getG(); *dst++ = c.getB(); *dst++ = c.getA();
+        }
+        if (m_useTangentData)
+        {
+            const cVector3d& v = m_tangent[a_vertexIndex];
+            *dst++ = (float)v(0); *dst++ = (float)v(1); *dst++ = (float)v(2);
+        }
+        if (m_useBitangentData)
+        {
+            const cVector3d& v = m_bitangent[a_vertexIndex];
+            *dst++ = (float)v(0); *dst++ = (float)v(1); *dst++ = (float)v(2);
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method updates the interleaved single-precision vertex buffer. 
+        Only vertices located inside the modified range are converted and 
+        transferred to the GPU, unless the buffer has been resized.
+        Spans of modified vertices are combined across all attributes.
+    */
+    //--------------------------------------------------------------------------
+    inline void updateInterleavedBuffer()
+    {
+#ifdef C_USE_OPENGL
+        // create buffer first time
+        if (m_interleavedBuffer == (GLuint)(-1))
+        {
+            glGenBuffers(1, &m_interleavedBuffer);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_interleavedBuffer);
+
+        // any attribute modified?
+        bool modified = m_flagPositionData || m_flagNormalData || m_flagTexCoordData ||
+                        m_flagColorData || m_flagTangentData || m_flagBitangentData;
+
+        // rebuild and reallocate complete buffer
+        if (m_flagBufferResize)
+        {
+            m_interleavedStride = 3;
+            if (m_useNormalData)    { m_interleavedStride += 3; }
+            if (m_useTexCoordData)  { m_interleavedStride += 3; }
+            if (m_useColorData)     { m_interleavedStride += 4; }
+            if (m_useTangentData)   { m_interleavedStride += 3; }
+            if (m_useBitangentData) { m_interleavedStride += 3; }
+
+            m_interleavedData.resize(m_numVertices * m_interleavedStride);
+            for (unsigned int i=0; i<m_numVertices; i++)
+            {
+                packInterleavedVertex(i);
+            }
+
+            unsigned int size = m_numVertices * m_interleavedStride * sizeof(float);
+            glBufferData(GL_ARRAY_BUFFER, size, (m_numVertices > 0) ? &(m_interleavedData[0]) : NULL, GL_STATIC_DRAW);
+            m_numBytesUploaded += size;
+
+            m_flagBufferResize = false;
+        }
+
+        // update modified spans only
+        else if (modified && (m_numVertices > 0))
+        {
+            // combine modified vertices of all attributes
+            cModifiedRanges ranges;
+            mergeModifiedRanges(ranges, m_flagPositionData, m_modifiedPosition);
+            mergeModifiedRanges(ranges, m_flagNormalData, m_modifiedNormal);
+            mergeModifiedRanges(ranges, m_flagTexCoordData, m_modifiedTexCoord);
+            mergeModifiedRanges(ranges, m_flagColorData, m_modifiedColor);
+            mergeModifiedRanges(ranges, m_flagTangentData, m_modifiedTangent);
+            mergeModifiedRanges(ranges, m_flagBitangentData, m_modifiedBitangent);
+
+            unsigned int count = ranges.computeSpans(m_numVertices, 16, m_spans);
+            for (unsigned int i=0; i<m_spans.size(); i++)
+            {
+                unsigned int last = m_spans[i].m_first + m_spans[i].m_count;
+                for (unsigned int j=m_spans[i].m_first; j<last; j++)
+                {
+                    packInterleavedVertex(j);
+                }
+            }
+
+            unsigned int vertexSize = m_interleavedStride * sizeof(float);
+            if (count > m_partialUpdateThreshold * m_numVertices)
+            {
+                glBufferData(GL_ARRAY_BUFFER, m_numVertices * vertexSize, &(m_interleavedData[0]), GL_DYNAMIC_DRAW);
+                m_numBytesUploaded += m_numVertices * vertexSize;
+            }
+            else
+            {
+                for (unsigned int i=0; i<m_spans.size(); i++)
+                {
+                    unsigned int offset = m_spans[i].m_first * m_interleavedStride;
+                    unsigned int size = m_spans[i].m_count * vertexSize;
+                    glBufferSubData(GL_ARRAY_BUFFER, offset * sizeof(float), size, &(m_interleavedData[offset]));
+                    m_numBytesUploaded += size;
+                }
+            }
+        }
+
+        // clear flags
+        m_flagPositionData = false;
+        m_flagNormalData = false;
+        m_flagTexCoordData = false;
+        m_flagColorData = false;
+        m_flagTangentData = false;
+        m_flagBitangentData = false;
+        clearModifiedRanges();
+        m_totalBytesUploaded += m_numBytesUploaded;
+#endif
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method binds the interleaved single-precision vertex buffer for
+        rendering.
+    */
+    //--------------------------------------------------------------------------
+    inline void renderInitializeInterleaved()
+    {
+#ifdef C_USE_OPENGL
+        glBindBuffer(GL_ARRAY_BUFFER, m_interleavedBuffer);
+
+        // bind attributes
+        GLsizei stride = m_interleavedStride * sizeof(float);
+        unsigned int offset = 0;
+
+        glEnableVertexAttribArray(C_VB_POSITION);
+        glVertexAttribPointer(C_VB_POSITION, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glVertexPointer(3, GL_FLOAT, stride, (void*)0);
+        offset += 3;
+
+        if (m_useNormalData)
+        {
+            glEnableVertexAttribArray(C_VB_NORMAL);
+            glVertexAttribPointer(C_VB_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset * sizeof(float)));
+            offset += 3;
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_NORMAL);
+        }
+
+        if (m_useTexCoordData)
+        {
+            glEnableVertexAttribArray(C_VB_TEXCOORD);
+            glVertexAttribPointer(C_VB_TEXCOORD, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset * sizeof(float)));
+            offset += 3;
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_TEXCOORD);
+        }
+
+        if (m_useColorData)
+        {
+            glEnableVertexAttribArray(C_VB_COLOR);
+            glVertexAttribPointer(C_VB_COLOR, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset * sizeof(float)));
+            offset += 4;
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_COLOR);
+        }
+
+        if (m_useTangentData)
+        {
+            glEnableVertexAttribArray(C_VB_TANGENT);
+            glVertexAttribPointer(C_VB_TANGENT, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset * sizeof(float)));
+            offset += 3;
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_TANGENT);
+        }
+
+        if (m_useBitangentData)
+        {
+            glEnableVertexAttribArray(C_VB_BITANGENT);
+            glVertexAttribPointer(C_VB_BITANGENT, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset * sizeof(float)));
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_BITANGENT);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
     }
 
 
@@ -1265,6 +1972,57 @@ protected:
     //! If __true__ then surface bitangent data will be allocated for each new vertex.
     bool m_useUserData;
 
+    //! If __true__ then vertex data is rendered from an interleaved single-precision buffer.
+    bool m_useInterleavedBuffer;
+
+    //! If __true__ then global positions are stored for each vertex.
+    bool m_useGlobalPosData;
+
+    //! Global position of parent object, used when global positions are not stored.
+    cVector3d m_globalFramePos;
+
+    //! Global rotation of parent object, used when global positions are not stored.
+    cMatrix3d m_globalFrameRot;
+
+    //! Fraction of modified vertices above which a buffer is replaced completely.
+    double m_partialUpdateThreshold;
+
+    //! Position data modified since the last GPU update.
+    cModifiedRanges m_modifiedPosition;
+
+    //! Normal data modified since the last GPU update.
+    cModifiedRanges m_modifiedNormal;
+
+    //! Texture coordinate data modified since the last GPU update.
+    cModifiedRanges m_modifiedTexCoord;
+
+    //! Color data modified since the last GPU update.
+    cModifiedRanges m_modifiedColor;
+
+    //! Tangent data modified since the last GPU update.
+    cModifiedRanges m_modifiedTangent;
+
+    //! Bitangent data modified since the last GPU update.
+    cModifiedRanges m_modifiedBitangent;
+
+    //! Temporary list of spans transferred during an update.
+    std::vector<cModifiedSpan> m_spans;
+
+    //! Interleaved single-precision copy of the vertex attributes sent to the GPU.
+    std::vector<float> m_interleavedData;
+
+    //! Number of floats stored per vertex in the interleaved buffer.
+    unsigned int m_interleavedStride;
+
+    //! Number of bytes transferred to the GPU during the last update.
+    unsigned int m_numBytesUploaded;
+
+    //! Total number of bytes transferred to the GPU.
+    unsigned long long m_totalBytesUploaded;
+
+    //! Counter incremented every time geometric vertex data is modified.
+    unsigned int m_modificationCounter;
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -1320,6 +2078,9 @@ public:
 
     //! OpenGL Buffer for storing triangle indices.
     GLuint m_bitangentBuffer;
+
+    //! OpenGL Buffer for storing interleaved single-precision vertex data.
+    GLuint m_interleavedBuffer;
 };
 
 //------------------------------------------------------------------------------
@@ -48,7 +48,10 @@
 //------------------------------------------------------------------------------
 #include "TheoraPlayer.h"
 #include "OpenAL_AudioInterface.h"
+#include "TheoraFrameQueue.h"
+#include "TheoraAsync.h"
 #include <algorithm>
+#include <chrono>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -57,6 +60,21 @@ using namespace std;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// video manager giving access to the mutex held by its worker threads while decoding
+class cTheoraVideoManager : public TheoraVideoManager
+{
+public:
+    TheoraMutex* getWorkMutex() { return (mWorkMutex); }
+};
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
 // static members
 cMutex       cVideo::m_sharedLock;
 unsigned int cVideo::m_clipCount = 0;
@@ -76,7 +94,7 @@ cVideo::cVideo()
     // allocate video manager
     if (m_clipCount == 0)
     {
-        m_manager = new TheoraVideoManager;
+        m_manager = new cTheoraVideoManager;
         m_audio   = new OpenAL_AudioInterfaceFactory;
 
         // assign audio output to manager
@@ -89,6 +107,12 @@ cVideo::cVideo()
     // it is now safe to check/modify static members
     m_sharedLock.release();
 
+    // default number of frames decoded ahead of playback
+    m_prefetchDepth = 4;
+
+    // background decoder is not running
+    m_decoding = false;
+
     // init internal variables
     defaults();
 }
@@ -157,6 +181,10 @@ void cVideo::defaults()
     // video management objects are not allocated
     m_clip       = NULL;
     m_data       = NULL;
+
+    // ring buffer is empty
+    m_readIndex      = 0;
+    m_numReadyFrames = 0;
 }
 
 
@@ -171,17 +199,19 @@ void cVideo::cleanup()
     // stop playback
     stop();
 
+    // the decoder must not access the clip anymore
+    stopDecoder();
+
     // delete video data
     if (m_clip != NULL )
     {
         ((TheoraVideoManager*)m_manager)->destroyVideoClip((TheoraVideoClip*)m_clip);
     }
 
-    // delete local buffer
-    if (m_data != NULL)
-    {
-        delete [] m_data;
-    }
+    // delete ring buffer
+    m_frameData.clear();
+    m_frameTimes.clear();
+    m_frameNumbers.clear();
 
     // reset to default values
     defaults();
@@ -237,7 +267,7 @@ bool cVideo::loadFromFile(const string& a_filename)
             m_filename = a_filename;
             m_name = cGetFilename(a_filename, false);
 
-            m_data = new unsigned char[3 * m_width*m_height];
+            allocateFrames();
 
             reset();
 
@@ -364,6 +394,9 @@ void cVideo::reset()
 {
     if (m_clip)
     {
+        // the decoder must be idle while the clip is rewound
+        stopDecoder();
+
         // put the movie back to the beginning
         m_clock.stop();
         m_clock.reset();
@@ -371,12 +404,9 @@ void cVideo::reset()
         ((TheoraVideoClip*)m_clip)->stop();
         m_frameIndex = 0;
 
-        // get initial frame
-        TheoraVideoFrame *frame = NULL;
-        while (!frame) frame = ((TheoraVideoClip*)m_clip)->getNextFrame();
-
-        // flip first frame
-        storeFrame(frame);
+        // restart decoding and get initial frame
+        startDecoder();
+        presentFirstFrame();
 
         // mark frame as first frame
         m_firstFrame = true;
@@ -438,15 +468,15 @@ bool cVideo::seekFrame(unsigned int a_index)
         return (C_ERROR);
     }
 
+    // the decoder must be idle while the clip is moved
+    stopDecoder();
+
     // move clip to desired time
     ((TheoraVideoClip*)m_clip)->seekToFrame(a_index);
 
-    // get initial frame
-    TheoraVideoFrame *frame = NULL;
-    while (!frame) frame = ((TheoraVideoClip*)m_clip)->getNextFrame();
-
-    // flip frame
-    storeFrame(frame);
+    // restart decoding and get initial frame
+    startDecoder();
+    presentFirstFrame();
 
     return (C_SUCCESS);
 }
@@ -468,24 +498,47 @@ bool cVideo::update()
         return (C_ERROR);
     }
 
+    TheoraVideoClip *clip = (TheoraVideoClip*)m_clip;
     bool newFrame = C_ERROR;
+    bool done = false;
 
     // check if a new frame is available
-    if (!((TheoraVideoClip*)m_clip)->isDone())
+    if (!clip->isDone())
     {
-        // update video timebase
+        // update video timebase (only this clip, as the manager is shared
+        // with all other videos)
+        // the clip is shared with the decoder worker threads of the manager
         double t = m_clock.getCurrentTimeSeconds();
-        ((TheoraVideoManager*)m_manager)->update((float)(t-m_lastUpdate));
+        TheoraMutex::ScopeLock lock(((cTheoraVideoManager*)m_manager)->getWorkMutex());
+        clip->update((float)(t-m_lastUpdate));
+        clip->decodedAudioCheck();
+        lock.release();
         m_lastUpdate = t;
+    }
+
+    // display the most recent decoded frame that is due, and skip late ones
+    {
+        double time = clip->getTimePosition();
+        unsigned int numSlots = (unsigned int)(m_frameTimes.size());
 
-        // check if a new one is available
-        TheoraVideoFrame *frame = ((TheoraVideoClip*)m_clip)->getNextFrame();
-        if (frame)
+        std::lock_guard<std::mutex> lock(m_frameLock);
+        while ((m_numReadyFrames > 0) && (m_frameTimes[m_readIndex] <= time))
         {
-            m_frameIndex++;
+            m_data = &m_frameData[(size_t)m_readIndex * 3 * m_width * m_height];
+            m_frameIndex = m_frameNumbers[m_readIndex];
+            m_readIndex = (m_readIndex + 1) % numSlots;
+            m_numReadyFrames--;
             newFrame = C_SUCCESS;
-            storeFrame(frame);
         }
+
+        // the stream ends once the clip is done and all decoded frames are displayed
+        done = clip->isDone() && (m_numReadyFrames == 0);
+    }
+
+    // wake up decoder if slots were freed
+    if (newFrame)
+    {
+        m_frameCondition.notify_all();
     }
 
     // report beginning of stream
@@ -496,7 +549,7 @@ bool cVideo::update()
     }
 
     // report end of stream
-    if (((TheoraVideoClip*)m_clip)->isDone())
+    if (done)
     {
         reset();
         newFrame = C_SUCCESS;
@@ -531,6 +584,7 @@ cVideoPtr cVideo::copy()
     }
 
     // otherwise load same video
+    video->setPrefetchDepth(m_prefetchDepth);
     video->loadFromFile(m_filename);
 
     // set state
@@ -701,17 +755,218 @@ bool cVideo::getFrame(int a_index, cImage &a_image)
 
 //==============================================================================
 /*!
-    This method flips a new frame the right way around before making it available
-    to the outside world.
+    This method sets the number of frames decoded ahead of playback by the
+    background decoding thread. Deeper buffers absorb longer decoding hiccups
+    at the expense of memory (one RGB frame per slot). If a video is loaded,
+    the ring buffer is reallocated and the current frame is decoded again.
+
+    \param  a_depth  Number of frames decoded ahead of playback (at least 1).
+*/
+//==============================================================================
+void cVideo::setPrefetchDepth(unsigned int a_depth)
+{
+    if (a_depth < 1)
+    {
+        a_depth = 1;
+    }
+
+    if (a_depth == m_prefetchDepth)
+    {
+        return;
+    }
+
+    m_prefetchDepth = a_depth;
+
+    // reallocate ring buffer and decode current frame again
+    if (m_clip)
+    {
+        stopDecoder();
+        allocateFrames();
+
+        if (seekFrame(m_frameIndex) == C_ERROR)
+        {
+            reset();
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of decoded frames currently stored in the
+    ring buffer and waiting to be displayed.
+
+    \return Number of decoded frames waiting for display.
+*/
+//==============================================================================
+unsigned int cVideo::getNumPrefetchedFrames()
+{
+    std::lock_guard<std::mutex> lock(m_frameLock);
+    return (m_numReadyFrames);
+}
+
+
+//==============================================================================
+/*!
+    This method allocates the ring buffer of decoded frames. The buffer holds
+    one slot more than the prefetch depth, so that the frame currently
+    displayed is never overwritten by the decoder.
+*/
+//==============================================================================
+void cVideo::allocateFrames()
+{
+    unsigned int numSlots = m_prefetchDepth + 1;
+
+    m_frameData.assign((size_t)numSlots * 3 * m_width * m_height, 0);
+    m_frameTimes.assign(numSlots, 0.0);
+    m_frameNumbers.assign(numSlots, 0);
+
+    m_readIndex = 0;
+    m_numReadyFrames = 0;
+    m_data = &m_frameData[0];
+}
+
+
+//==============================================================================
+/*!
+    This method starts the background decoding thread, which fills the ring
+    buffer with frames ahead of playback.
+*/
+//==============================================================================
+void cVideo::startDecoder()
+{
+    if (!m_clip || m_decoding)
+    {
+        return;
+    }
+
+    m_decoding = true;
+    m_decoder = std::thread(&cVideo::decode, this);
+}
+
+
+//==============================================================================
+/*!
+    This method stops the background decoding thread and discards all frames
+    waiting in the ring buffer. The frame currently displayed remains valid.
+*/
+//==============================================================================
+void cVideo::stopDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_frameLock);
+        m_decoding = false;
+    }
+    m_frameCondition.notify_all();
+
+    if (m_decoder.joinable())
+    {
+        m_decoder.join();
+    }
+
+    // discard buffered frames
+    m_numReadyFrames = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method waits until the decoding thread provides the first frame
+    following a reset or a seek, and makes it the current frame regardless of
+    its display time.
+*/
+//==============================================================================
+void cVideo::presentFirstFrame()
+{
+    std::unique_lock<std::mutex> lock(m_frameLock);
+    m_frameCondition.wait(lock, [this]{ return (m_numReadyFrames > 0); });
+
+    m_data = &m_frameData[(size_t)m_readIndex * 3 * m_width * m_height];
+    m_frameIndex = m_frameNumbers[m_readIndex];
+    m_readIndex = (m_readIndex + 1) % (unsigned int)(m_frameTimes.size());
+    m_numReadyFrames--;
+    lock.unlock();
+
+    m_frameCondition.notify_all();
+}
+
+
+//==============================================================================
+/*!
+    This method is executed by the background decoding thread. Frames are
+    taken from the clip as soon as they are decoded, flipped into the next
+    free slot of the ring buffer, and released back to the clip so that it
+    can keep decoding ahead. The thread sleeps while the ring buffer is full.
+*/
+//==============================================================================
+void cVideo::decode()
+{
+    TheoraVideoClip *clip = (TheoraVideoClip*)m_clip;
+    unsigned int numSlots = (unsigned int)(m_frameTimes.size());
+
+    // the first frame after a reset or a seek is only reported once the clip
+    // has completed the seek, after which frames are taken in order
+    bool synchronized = false;
+
+    while (true)
+    {
+        unsigned int slot;
+
+        // wait for a free slot
+        {
+            std::unique_lock<std::mutex> lock(m_frameLock);
+            m_frameCondition.wait(lock, [this]{ return (!m_decoding || (m_numReadyFrames < m_prefetchDepth)); });
+            if (!m_decoding)
+            {
+                return;
+            }
+            slot = (m_readIndex + m_numReadyFrames) % numSlots;
+        }
+
+        // get next decoded frame
+        TheoraVideoFrame *frame = synchronized ? clip->getFrameQueue()->getFirstAvailableFrame() : clip->getNextFrame();
+        if (frame == NULL)
+        {
+            std::unique_lock<std::mutex> lock(m_frameLock);
+            m_frameCondition.wait_for(lock, std::chrono::milliseconds(1), [this]{ return (!m_decoding); });
+            continue;
+        }
+        synchronized = true;
+
+        // flip frame into slot
+        storeFrame(frame, slot);
+
+        // publish frame before releasing it, so that the end of the stream
+        // is never detected while a frame is in transit
+        {
+            std::lock_guard<std::mutex> lock(m_frameLock);
+            m_numReadyFrames++;
+        }
+        m_frameCondition.notify_all();
+
+        // release frame
+        clip->popFrame();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method flips a new frame the right way around and stores it in a
+    slot of the ring buffer.
+
+    \param  a_frame  Decoded video frame.
+    \param  a_slot   Ring buffer slot.
 */
 //==============================================================================
-void cVideo::storeFrame(void *frame)
+void cVideo::storeFrame(void *a_frame, unsigned int a_slot)
 {
+    TheoraVideoFrame *frame = (TheoraVideoFrame*)a_frame;
     unsigned int  lineWidth = 3*m_width;
-    unsigned char *dst  = m_data;
-    unsigned char *src  = ((TheoraVideoFrame*)frame)->getBuffer() + (m_height-1)*lineWidth;
+    unsigned char *dst  = &m_frameData[(size_t)a_slot * lineWidth * m_height];
+    unsigned char *src  = frame->getBuffer() + (m_height-1)*lineWidth;
 
-    // copy/flip frame to local buffer
+    // copy/flip frame to ring buffer
     for(unsigned int i=0; i<m_height; i++)
     {
         memcpy(dst, src, lineWidth);
@@ -719,8 +974,9 @@ void cVideo::storeFrame(void *frame)
         src -= lineWidth;
     }
 
-    // pop frame from stack
-    ((TheoraVideoClip*)m_clip)->popFrame();
+    // store frame timing
+    m_frameTimes[a_slot] = frame->mTimeToDisplay;
+    m_frameNumbers[a_slot] = (unsigned int)(frame->getFrameNumber());
 }
 
 
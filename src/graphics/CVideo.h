@@ -49,7 +49,11 @@
 #include "timers/CPrecisionClock.h"
 #include "system/CMutex.h"
 //------------------------------------------------------------------------------
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
@@ -78,7 +82,12 @@ typedef std::shared_ptr<cVideo> cVideoPtr;
 
     \details
     This class implements support for video files of the OGG/Vorbis format.
-    Audio is also supported.
+    Audio is also supported.\n
+
+    Frames are decoded ahead of time by a background thread and stored,
+    already flipped, in a ring buffer whose depth can be set with
+    \ref setPrefetchDepth(). Retrieving the current frame therefore only
+    involves selecting the most recent buffered frame that is due for display.
 */
 //==============================================================================
 class cVideo
@@ -181,6 +190,15 @@ public:
     //! This method returns a copy of any frame.
     bool getFrame(int a_index, cImage &a_image);
 
+    //! This method sets the number of frames decoded ahead of playback.
+    void setPrefetchDepth(unsigned int a_depth);
+
+    //! This method returns the number of frames decoded ahead of playback.
+    unsigned int getPrefetchDepth() const { return (m_prefetchDepth); }
+
+    //! This method returns the number of decoded frames currently waiting for display.
+    unsigned int getNumPrefetchedFrames();
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - FILES:
@@ -216,8 +234,23 @@ protected:
     //! This method reset the video to the first frame and make it ready to play again.
     void reset();
 
-    //! This method stores a frame locally (and flip horizontally).
-    inline void storeFrame(void *frame);
+    //! This method stores a frame in the ring buffer (and flip horizontally).
+    inline void storeFrame(void *a_frame, unsigned int a_slot);
+
+    //! This method allocates the ring buffer of decoded frames.
+    void allocateFrames();
+
+    //! This method starts the background decoding thread.
+    void startDecoder();
+
+    //! This method stops the background decoding thread and discards all buffered frames.
+    void stopDecoder();
+
+    //! This method is executed by the background decoding thread.
+    void decode();
+
+    //! This method waits for the first frame following a reset or a seek and makes it current.
+    void presentFirstFrame();
 
 
     //--------------------------------------------------------------------------
@@ -265,9 +298,39 @@ protected:
     //! Video clip object.
     void *m_clip;
 
-    //! Video frame data.
+    //! Video frame data (points to the ring buffer slot currently displayed).
     unsigned char *m_data;
 
+    //! Number of frames decoded ahead of playback.
+    unsigned int m_prefetchDepth;
+
+    //! Ring buffer of decoded frames (one slot more than the prefetch depth).
+    std::vector<unsigned char> m_frameData;
+
+    //! Display time of each ring buffer slot.
+    std::vector<double> m_frameTimes;
+
+    //! Frame number of each ring buffer slot.
+    std::vector<unsigned int> m_frameNumbers;
+
+    //! Ring buffer slot of the next frame to display.
+    unsigned int m_readIndex;
+
+    //! Number of decoded frames waiting for display.
+    unsigned int m_numReadyFrames;
+
+    //! If __true__, the background decoding thread is running.
+    bool m_decoding;
+
+    //! Background decoding thread.
+    std::thread m_decoder;
+
+    //! Lock protecting the ring buffer.
+    std::mutex m_frameLock;
+
+    //! Condition signaled when a frame is decoded or a slot is freed.
+    std::condition_variable m_frameCondition;
+
     //! Shared clip counter
     static unsigned int m_clipCount;
 
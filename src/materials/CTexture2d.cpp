@@ -44,6 +44,7 @@
 
 //------------------------------------------------------------------------------
 #include "materials/CTexture2d.h"
+#include "system/CString.h"
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -92,6 +93,10 @@ cTexture2dPtr cTexture2d::copy()
 
     // create copy of image data
     obj->m_image = m_image->copy();
+    if (m_compressedImage != nullptr)
+    {
+        obj->m_compressedImage = m_compressedImage->copy();
+    }
 
     // copy all variables
     obj->m_enabled                  = m_enabled;
@@ -156,6 +161,86 @@ void cTexture2d::reset()
 }
 
 
+//==============================================================================
+/*!
+    This method loads a texture image from a file. Block compressed __dds__
+    and __ktx__ files are loaded into \ref m_compressedImage without being
+    decoded, and mipmaps are enabled if the file contains mipmap levels.
+    Other files are loaded into \ref m_image.
+
+    \param  a_fileName  Filename.
+
+    \return __true__ if the file was loaded successfully, __false__ otherwise.
+*/
+//==============================================================================
+bool cTexture2d::loadFromFile(const string& a_fileName)
+{
+    string fileType = cStrToLower(cGetFileExtension(a_fileName));
+
+    //--------------------------------------------------------------------
+    // COMPRESSED IMAGE
+    //--------------------------------------------------------------------
+    if ((fileType == "dds") || (fileType == "ktx"))
+    {
+        cCompressedImagePtr image = cCompressedImage::create();
+        if (!image->loadFromFile(a_fileName))
+        {
+            return (false);
+        }
+
+        m_compressedImage = image;
+        if (image->getNumLevels() > 1)
+        {
+            setUseMipmaps(true);
+        }
+        markForDeleteAndUpdate();
+
+        return (true);
+    }
+
+    //--------------------------------------------------------------------
+    // UNCOMPRESSED IMAGE
+    //--------------------------------------------------------------------
+    if (m_compressedImage != nullptr)
+    {
+        m_compressedImage = nullptr;
+        markForDeleteAndUpdate();
+    }
+
+    return (m_image->loadFromFile(a_fileName));
+}
+
+
+//==============================================================================
+/*!
+    This method compresses the texture image on the CPU and stores the result
+    in \ref m_compressedImage, which is then uploaded to the graphics card
+    instead of \ref m_image. If mipmaps are enabled, all mipmap levels are
+    generated and compressed as well. \ref m_image is left unchanged.
+
+    \param  a_format  Compressed format (GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+                       GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+                       GL_COMPRESSED_RGBA_S3TC_DXT3_EXT or
+                       GL_COMPRESSED_RGBA_S3TC_DXT5_EXT).
+
+    \return __true__ if the image was compressed, __false__ otherwise.
+*/
+//==============================================================================
+bool cTexture2d::compress(const GLenum a_format)
+{
+    cCompressedImagePtr image = cCompressedImage::create();
+    if (!image->compress(m_image, a_format, m_useMipmaps))
+    {
+        return (false);
+    }
+
+    m_compressedImage = image;
+    markForDeleteAndUpdate();
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This method enables texturing and set this texture as the current texture.
@@ -174,7 +259,8 @@ void cTexture2d::renderInitialize(cRenderOptions& a_options)
     if (!a_options.m_render_textures) { return; }
 
     // check image texture
-    if (m_image->isInitialized() == 0) return;
+    if ((m_image->isInitialized() == 0) &&
+        ((m_compressedImage == nullptr) || (!m_compressedImage->isInitialized()))) return;
 
     // Only check residency in memory if we weren't going to
     // update the texture anyway...
@@ -282,6 +368,60 @@ void cTexture2d::update(cRenderOptions& a_options)
         m_deleteTextureFlag = false;
     }
 
+    // upload compressed image
+    if ((m_compressedImage != nullptr) && m_compressedImage->isInitialized())
+    {
+        bool supported = true;
+#ifdef GLEW_VERSION
+        supported = (GLEW_EXT_texture_compression_s3tc != 0);
+#endif
+
+        if (supported)
+        {
+            if (m_textureID == 0)
+            {
+                glGenTextures(1, &m_textureID);
+            }
+            glBindTexture(GL_TEXTURE_2D, m_textureID);
+
+            glTexParameteri(GL_TEXTURE_2D ,GL_TEXTURE_WRAP_S, m_wrapModeS);
+            glTexParameteri(GL_TEXTURE_2D ,GL_TEXTURE_WRAP_T, m_wrapModeT);
+            glTexParameteri(GL_TEXTURE_2D ,GL_TEXTURE_MAG_FILTER, m_magFunction);
+            glTexParameteri(GL_TEXTURE_2D ,GL_TEXTURE_MIN_FILTER, m_minFunction);
+
+            // mipmap levels are stored in the image, or not used at all
+            unsigned int numLevels = m_useMipmaps ? m_compressedImage->getNumLevels() : 1;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+
+            for (unsigned int i=0; i<numLevels; i++)
+            {
+                glCompressedTexImage2D(GL_TEXTURE_2D,
+                                       i,
+                                       m_compressedImage->getFormat(),
+                                       (GLsizei)m_compressedImage->getLevelWidth(i),
+                                       (GLsizei)m_compressedImage->getLevelHeight(i),
+                                       0,
+                                       (GLsizei)m_compressedImage->getLevelSize(i),
+                                       m_compressedImage->getLevelData(i));
+            }
+
+            return;
+        }
+
+        // compressed formats not supported by the graphics card: decompress
+        // the base level and upload it as a regular image
+        if (m_compressedImage->decompress(m_image))
+        {
+            m_compressedImage = nullptr;
+        }
+
+        if (m_textureID != 0)
+        {
+            glDeleteTextures(1, &m_textureID);
+            m_textureID = 0;
+        }
+    }
+
     if (m_textureID == 0)
     {
         glGenTextures(1, &m_textureID);
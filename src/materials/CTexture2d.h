@@ -47,6 +47,7 @@
 #define CTexture2dH
 //------------------------------------------------------------------------------
 #include "graphics/CColor.h"
+#include "graphics/CCompressedImage.h"
 #include "graphics/CImage.h"
 #include "materials/CTexture1d.h"
 //------------------------------------------------------------------------------
@@ -78,7 +79,14 @@ typedef std::shared_ptr<cTexture2d> cTexture2dPtr;
     This class implements a 2D texture map.
 
     \details
-    This class implements a 2D texture map.
+    This class implements a 2D texture map. \n
+
+    A texture can also be uploaded from a block compressed image stored in
+    \ref m_compressedImage, either loaded from a __dds__ or __ktx__ file or
+    created from \ref m_image by calling \ref compress(). When present, the
+    compressed image and its mipmap levels are passed to the graphics card
+    as is. Compressed files are not decoded into \ref m_image; call
+    m_compressedImage->decompress(m_image) if pixel data is needed on the CPU.
 */
 //==============================================================================
 class cTexture2d : public cTexture1d
@@ -108,6 +116,12 @@ public:
     //! This method creates a copy of itself.
     cTexture2dPtr copy();
 
+    //! This method loads a texture image from a file. Compressed __dds__ and __ktx__ files are loaded into the compressed image.
+    virtual bool loadFromFile(const std::string& a_fileName);
+
+    //! This method compresses the texture image on the CPU, including mipmap levels if mipmaps are enabled.
+    bool compress(const GLenum a_format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+
     //! This method enables texturing and sets this texture as the current texture.
     virtual void renderInitialize(cRenderOptions& a_options);
 
@@ -121,6 +135,16 @@ public:
     GLint getWrapModeT() const { return (m_wrapModeT); }
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Block compressed image uploaded instead of __m_image__ when available.
+    cCompressedImagePtr m_compressedImage;
+
+
     //--------------------------------------------------------------------------
     // PROTECTED METHODS:
     //--------------------------------------------------------------------------
@@ -150,4 +174,4 @@ protected:
 
 //------------------------------------------------------------------------------
 #endif
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
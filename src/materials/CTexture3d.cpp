@@ -60,8 +60,9 @@ cTexture3d::cTexture3d()
 {
     // partial update members
     m_markPartialUpdate = false;
-    m_voxelUpdateMin.zero();
-    m_voxelUpdateMax.zero();
+    m_modificationCounter = 0;
+    m_partialUpdateThreshold = 0.5;
+    m_numVoxelsUploaded = 0;
 
     // set default texture unit
     m_textureUnit = GL_TEXTURE0;
@@ -233,6 +234,22 @@ void cTexture3d::renderInitialize(cRenderOptions& a_options)
     // enable texturing
     glEnable(GL_TEXTURE_3D);
 
+    // voxels modified since the last update are transferred automatically
+    if ((m_updateTextureFlag == false) && (m_textureID != 0))
+    {
+        cMultiImage* image = dynamic_cast<cMultiImage*>(m_image.get());
+        if (image != NULL)
+        {
+            image->acquireLock();
+            if (image->getModificationCounter() != m_modificationCounter)
+            {
+                m_updateTextureFlag = true;
+                m_markPartialUpdate = true;
+            }
+            image->releaseLock();
+        }
+    }
+
     // setup texture or update
     if (m_updateTextureFlag)
     {
@@ -311,27 +328,54 @@ void cTexture3d::renderFinalize(cRenderOptions& a_options)
 
 //==============================================================================
 /*!
-    This method marks this texture for partial GPU update from RAM.
+    This method marks this texture for partial GPU update from RAM. The region
+    is recorded in the modification tracker of the associated image, and is 
+    merged with any other region modified since the last update.
 
     \param  a_voxelUpdateMin  Lowest voxel to be updated.
     \param  a_voxelUpdateMax  Highest voxel to be updated.
 */
 //==============================================================================
 void cTexture3d::markForPartialUpdate(const cVector3d a_voxelUpdateMin, const cVector3d a_voxelUpdateMax)
+{
+    // sanity check
+    cMultiImage* image = dynamic_cast<cMultiImage*>(m_image.get());
+    if (image == NULL) 
+    {
+        markForUpdate();
+        return;
+    }
+
+    // record region to be updated
+    image->markRegionModified((unsigned int)cMax((int)(a_voxelUpdateMin.x()), 0),
+                              (unsigned int)cMax((int)(a_voxelUpdateMin.y()), 0),
+                              (unsigned int)cMax((int)(a_voxelUpdateMin.z()), 0),
+                              (unsigned int)cMax((int)(a_voxelUpdateMax.x()), 0),
+                              (unsigned int)cMax((int)(a_voxelUpdateMax.y()), 0),
+                              (unsigned int)cMax((int)(a_voxelUpdateMax.z()), 0));
+
+    // mark texture for partial update
+    markForPartialUpdate();
+}
+
+
+//==============================================================================
+/*!
+    This method marks this texture for partial GPU update from RAM. All voxels
+    modified through the associated image since the last update are coalesced
+    into a small number of boxes and transferred using glTexSubImage3D. If the 
+    modified regions cover more than the fraction of the volume set by 
+    \ref setPartialUpdateThreshold(), the complete texture is transferred 
+    instead.
+*/
+//==============================================================================
+void cTexture3d::markForPartialUpdate()
 {
     // mark texture for update
     markForUpdate();
 
     // mark texture for partial update
     m_markPartialUpdate = true;
-
-    // store region to be updated.
-    m_voxelUpdateMin.x(cClamp((int)(a_voxelUpdateMin.x()), 0, (int)m_image->getWidth()));
-    m_voxelUpdateMin.y(cClamp((int)(a_voxelUpdateMin.y()), 0, (int)m_image->getHeight()));
-    m_voxelUpdateMin.z(cClamp((int)(a_voxelUpdateMin.z()), 0, (int)m_image->getImageCount()));
-    m_voxelUpdateMax.x(cClamp((int)(a_voxelUpdateMax.x()), 0, (int)m_image->getWidth()));
-    m_voxelUpdateMax.y(cClamp((int)(a_voxelUpdateMax.y()), 0, (int)m_image->getHeight()));
-    m_voxelUpdateMax.z(cClamp((int)(a_voxelUpdateMax.z()), 0, (int)m_image->getImageCount()));
 }
 
 
@@ -346,6 +390,13 @@ void cTexture3d::update(cRenderOptions& a_options)
 {
 #ifdef C_USE_OPENGL
 
+    // voxels may be modified from another thread while they are transferred
+    cMultiImage* lockedImage = dynamic_cast<cMultiImage*>(m_image.get());
+    if (lockedImage != NULL)
+    {
+        lockedImage->acquireLock();
+    }
+
     if (m_deleteTextureFlag)
     {
         if (m_textureID != 0)
@@ -387,6 +438,11 @@ void cTexture3d::update(cRenderOptions& a_options)
             m_image->getType(),
             reinterpret_cast<cMultiImage*>(m_image.get())->getArray()
             );
+
+        // the complete volume is now on the GPU
+        m_markPartialUpdate = false;
+        m_numVoxelsUploaded = m_image->getWidth() * m_image->getHeight() * m_image->getImageCount();
+        m_modificationCounter = reinterpret_cast<cMultiImage*>(m_image.get())->getModificationCounter();
     }
     else
     {
@@ -401,52 +457,68 @@ void cTexture3d::update(cRenderOptions& a_options)
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         glPixelStorei(GL_PACK_ALIGNMENT, 1);
         
-        if (m_markPartialUpdate)
+        cMultiImage* image = reinterpret_cast<cMultiImage*>(m_image.get());
+        unsigned long long counter = image->getModificationCounter();
+        unsigned int numVoxelsFull = m_image->getWidth() * m_image->getHeight() * m_image->getImageCount();
+
+        // retrieve regions modified since last update
+        bool partialUpdate = m_markPartialUpdate;
+        m_markPartialUpdate = false;
+        if (partialUpdate)
         {
-            m_markPartialUpdate = false;
-
-            GLint offsetX = (GLint)(m_voxelUpdateMin.x());
-            GLint offsetY = (GLint)(m_voxelUpdateMin.y());
-            GLint offsetZ = (GLint)(m_voxelUpdateMin.z());
-            
-            GLsizei sizeFullX = m_image->getWidth();
-            GLsizei sizeFullY = m_image->getHeight();
-            GLsizei sizeFullZ = m_image->getImageCount();
-            
-            offsetX = cClamp(offsetX, 0, sizeFullX);
-            offsetY = cClamp(offsetY, 0, sizeFullY);
-            offsetZ = cClamp(offsetZ, 0, sizeFullZ);
-            
-            GLsizei sizeX = (GLsizei)(abs((int)m_voxelUpdateMax.x() - offsetX) + 1);
-            GLsizei sizeY = (GLsizei)(abs((int)m_voxelUpdateMax.y() - offsetY) + 1);
-            GLsizei sizeZ = (GLsizei)(abs((int)m_voxelUpdateMax.z() - offsetZ) + 1);
-            
-            sizeX = cClamp(sizeX, 0, sizeFullX-offsetX);
-            sizeY = cClamp(sizeY, 0, sizeFullY-offsetY);
-            sizeZ = cClamp(sizeZ, 0, sizeFullZ-offsetZ);
+            unsigned int numVoxels = image->getModifiedRegions(m_modificationCounter, m_updateRegions);
+            if ((double)(numVoxels) > m_partialUpdateThreshold * (double)(numVoxelsFull))
+            {
+                partialUpdate = false;
+            }
+        }
+
+        if (partialUpdate)
+        {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_image->getWidth());
+            glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, m_image->getHeight());
+
+            m_numVoxelsUploaded = 0;
+            for (unsigned int i=0; i<m_updateRegions.size(); i++)
+            {
+                const cMultiImageRegion& region = m_updateRegions[i];
+
+                GLint offsetX = (GLint)(region.m_minX);
+                GLint offsetY = (GLint)(region.m_minY);
+                GLint offsetZ = (GLint)(region.m_minZ);
+
+                GLsizei sizeX = (GLsizei)(region.m_maxX - region.m_minX + 1);
+                GLsizei sizeY = (GLsizei)(region.m_maxY - region.m_minY + 1);
+                GLsizei sizeZ = (GLsizei)(region.m_maxZ - region.m_minZ + 1);
 
 #ifdef MACOSX
-            offsetY = 0;
-            sizeY = (GLsizei)m_image->getHeight();
+                offsetY = 0;
+                sizeY = (GLsizei)m_image->getHeight();
 #endif
 
-            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_image->getWidth());
-            glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, m_image->getHeight());
-            glPixelStorei(GL_UNPACK_SKIP_PIXELS, offsetX);
-            glPixelStorei(GL_UNPACK_SKIP_ROWS, offsetY);
-            glPixelStorei(GL_UNPACK_SKIP_IMAGES, offsetZ);
+                glPixelStorei(GL_UNPACK_SKIP_PIXELS, offsetX);
+                glPixelStorei(GL_UNPACK_SKIP_ROWS, offsetY);
+                glPixelStorei(GL_UNPACK_SKIP_IMAGES, offsetZ);
+
+                glTexSubImage3D(GL_TEXTURE_3D,
+                                0,
+                                offsetX,
+                                offsetY,
+                                offsetZ,
+                                sizeX,
+                                sizeY,
+                                sizeZ,
+                                m_image->getFormat(),
+                                m_image->getType(),
+                                image->getArray());
+
+                m_numVoxelsUploaded += sizeX * sizeY * sizeZ;
+            }
 
-            glTexSubImage3D(GL_TEXTURE_3D,
-                            0,
-                            offsetX,
-                            offsetY,
-                            offsetZ,
-                            sizeX,
-                            sizeY,
-                            sizeZ,
-                            m_image->getFormat(),
-                            m_image->getType(),
-                            reinterpret_cast<cMultiImage*>(m_image.get())->getArray());
+            // restore unpacking settings
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+            glPixelStorei(GL_UNPACK_SKIP_IMAGES, 0);
         }
         else
         {
@@ -466,8 +538,18 @@ void cTexture3d::update(cRenderOptions& a_options)
                             (GLsizei)m_image->getImageCount(),
                             m_image->getFormat(),
                             m_image->getType(),
-                            reinterpret_cast<cMultiImage*>(m_image.get())->getArray());
+                            image->getArray());
+
+            m_numVoxelsUploaded = numVoxelsFull;
         }
+
+        // all modifications are now on the GPU
+        m_modificationCounter = counter;
+    }
+
+    if (lockedImage != NULL)
+    {
+        lockedImage->releaseLock();
     }
 
 #endif
@@ -121,6 +121,18 @@ public:
     //! This method marks this texture for partial GPU update from RAM.
     void markForPartialUpdate(const cVector3d a_voxelUpdateMin, const cVector3d a_voxelUpdateMax);
 
+    //! This method marks this texture for partial GPU update of all voxels modified since the last update.
+    void markForPartialUpdate();
+
+    //! This method sets the fraction of modified voxels above which the complete texture is uploaded instead of individual regions.
+    void setPartialUpdateThreshold(const double a_threshold) { m_partialUpdateThreshold = cClamp(a_threshold, 0.0, 1.0); }
+
+    //! This method returns the fraction of modified voxels above which the complete texture is uploaded.
+    double getPartialUpdateThreshold() const { return (m_partialUpdateThreshold); }
+
+    //! This method returns the number of voxels transferred to the GPU during the last update.
+    unsigned int getNumVoxelsUploaded() const { return (m_numVoxelsUploaded); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -144,11 +156,17 @@ protected:
     //! If __true__ the partial update is performed.
     bool m_markPartialUpdate;
 
-    //! Minimum voxel coordinate to be updated.
-    cVector3d m_voxelUpdateMin;
+    //! Value of the image modification counter when the texture was last transferred to the GPU.
+    unsigned long long m_modificationCounter;
+
+    //! Fraction of modified voxels above which the complete texture is uploaded.
+    double m_partialUpdateThreshold;
+
+    //! Number of voxels transferred to the GPU during the last update.
+    unsigned int m_numVoxelsUploaded;
 
-    //! Maximum voxel coordinate to be updated.
-    cVector3d m_voxelUpdateMax;
+    //! List of regions transferred during a partial update.
+    std::vector<cMultiImageRegion> m_updateRegions;
 
     //! Texture wrap parameter along __r__ (GL_REPEAT or GL_CLAMP).
     GLint m_wrapModeR;
@@ -60,6 +60,16 @@ cTextureVideo::cTextureVideo() : cTexture2d()
 {
     // create video
     m_video = cVideo::create();
+
+    // stream frames through pixel buffer objects
+    m_usePixelBuffers = true;
+    m_pixelBuffers[0] = 0;
+    m_pixelBuffers[1] = 0;
+    m_pixelBufferIndex = 0;
+
+    // no texture allocated yet
+    m_textureWidth = 0;
+    m_textureHeight = 0;
 }
 
 
@@ -70,7 +80,15 @@ cTextureVideo::cTextureVideo() : cTexture2d()
 //==============================================================================
 cTextureVideo::~cTextureVideo()
 {
-    return;
+    if (m_pixelBuffers[0] != 0)
+    {
+        #ifdef C_USE_OPENGL
+        glDeleteBuffers(2, m_pixelBuffers);
+        #endif
+
+        m_pixelBuffers[0] = 0;
+        m_pixelBuffers[1] = 0;
+    }
 }
 
 
@@ -95,6 +113,138 @@ void cTextureVideo::renderInitialize(cRenderOptions& a_options)
 }
 
 
+//==============================================================================
+/*!
+    This method uploads the current video frame to the GPU. The texture storage
+    is allocated once by \ref cTexture2d::update(). Subsequent frames are
+    copied into one of two pixel buffer objects, used in alternation, from
+    which glTexSubImage2D() transfers them asynchronously to the texture. If
+    pixel buffer objects are not available, frames are uploaded directly with
+    glTexSubImage2D().
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cTextureVideo::update(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    // pixel buffer objects are released together with the texture; if the
+    // texture was lost, they were lost with the same context
+    if (m_deleteTextureFlag)
+    {
+        if (m_pixelBuffers[0] != 0)
+        {
+            glDeleteBuffers(2, m_pixelBuffers);
+        }
+        m_pixelBuffers[0] = 0;
+        m_pixelBuffers[1] = 0;
+    }
+    else if (m_textureID == 0)
+    {
+        m_pixelBuffers[0] = 0;
+        m_pixelBuffers[1] = 0;
+    }
+
+    // check for pixel buffer object support
+    bool supported = m_usePixelBuffers;
+#ifdef GLEW_VERSION
+    supported = supported && (GLEW_ARB_pixel_buffer_object != 0);
+#endif
+
+    // allocate texture storage, or upload directly if streaming is not possible
+    if (!supported ||
+        m_deleteTextureFlag ||
+        (m_textureID == 0) ||
+        (m_compressedImage != nullptr) ||
+        (m_textureWidth  != m_image->getWidth()) ||
+        (m_textureHeight != m_image->getHeight()))
+    {
+        if ((m_textureWidth  != m_image->getWidth()) ||
+            (m_textureHeight != m_image->getHeight()))
+        {
+            m_deleteTextureFlag = true;
+        }
+
+        cTexture2d::update(a_options);
+
+        m_textureWidth  = m_image->getWidth();
+        m_textureHeight = m_image->getHeight();
+        return;
+    }
+
+    // create pixel buffer objects
+    if (m_pixelBuffers[0] == 0)
+    {
+        glGenBuffers(2, m_pixelBuffers);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, m_textureID);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT,   1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH,  0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS,   0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+
+    // alternate between buffers so that filling one does not wait for the
+    // transfer from the other to complete
+    m_pixelBufferIndex = 1 - m_pixelBufferIndex;
+    GLsizeiptr size = (GLsizeiptr)m_image->getSizeInBytes();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pixelBuffers[m_pixelBufferIndex]);
+
+    // orphan previous storage so that mapping never blocks
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+
+    // copy frame into pixel buffer object
+    bool mapped = false;
+    void* dst = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (dst != NULL)
+    {
+        memcpy(dst, m_image->getData(), (size_t)size);
+        mapped = (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+    }
+
+    if (mapped)
+    {
+        // transfer from pixel buffer object
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        0,
+                        0,
+                        0,
+                        (GLsizei)m_image->getWidth(),
+                        (GLsizei)m_image->getHeight(),
+                        (GLsizei)m_image->getFormat(),
+                        m_image->getType(),
+                        NULL);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    else
+    {
+        // mapping failed, transfer from client memory
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        0,
+                        0,
+                        0,
+                        (GLsizei)m_image->getWidth(),
+                        (GLsizei)m_image->getHeight(),
+                        (GLsizei)m_image->getFormat(),
+                        m_image->getType(),
+                        m_image->getData());
+    }
+
+    if (m_useMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+#endif
+}
+
+
 //==============================================================================
 /*!
     This method loads a texture video file.
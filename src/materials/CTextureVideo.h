@@ -77,7 +77,10 @@ typedef std::shared_ptr<cTextureVideo> cTextureVideoPtr;
 
     \details
     This class implements a video bitmap texture used for OpenGL texture-mapping
-    of a \ref cVideo object.
+    of a \ref cVideo object. New frames are streamed into the existing texture
+    with glTexSubImage2D() through a pair of pixel buffer objects used in
+    alternation, so that the transfer of one frame does not stall the
+    preparation of the next.
 */
 //==============================================================================
 class cTextureVideo : public cTexture2d
@@ -110,6 +113,12 @@ public:
     //! This method enables texturing and set this texture as the current texture.
     virtual void renderInitialize(cRenderOptions& a_options);
 
+    //! This method enables or disables frame uploads through pixel buffer objects.
+    void setUsePixelBuffers(const bool a_enabled) { m_usePixelBuffers = a_enabled; }
+
+    //! This method returns __true__ if frames are uploaded through pixel buffer objects, __false__ otherwise.
+    bool getUsePixelBuffers() const { return (m_usePixelBuffers); }
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -119,6 +128,38 @@ public:
 
     //! Video object (Use this to get data about the texture itself).
     cVideoPtr m_video;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method uploads the current video frame to GPU.
+    virtual void update(cRenderOptions& a_options);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__, frames are uploaded through pixel buffer objects.
+    bool m_usePixelBuffers;
+
+    //! OpenGL pixel buffer objects used in alternation to upload frames.
+    GLuint m_pixelBuffers[2];
+
+    //! Index of the pixel buffer object used for the last upload.
+    unsigned int m_pixelBufferIndex;
+
+    //! Width of the texture allocated on the GPU.
+    unsigned int m_textureWidth;
+
+    //! Height of the texture allocated on the GPU.
+    unsigned int m_textureHeight;
 };
 
 
@@ -128,4 +169,4 @@ public:
 
 //------------------------------------------------------------------------------
 #endif
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
@@ -0,0 +1,225 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CFileMap.h"
+#include "math/CConstants.h"
+//------------------------------------------------------------------------------
+#include <cstdio>
+//------------------------------------------------------------------------------
+#if defined(LINUX) || defined(MACOSX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cFileMap.
+*/
+//==============================================================================
+cFileMap::cFileMap()
+{
+    m_data = NULL;
+    m_size = 0;
+
+#if defined(WIN32) | defined(WIN64)
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = NULL;
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+    m_mapped = false;
+#endif
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cFileMap.
+*/
+//==============================================================================
+cFileMap::~cFileMap()
+{
+    close();
+}
+
+
+//==============================================================================
+/*!
+    This method maps the content of a file into memory. Any previously mapped
+    file is released first. Empty files are reported as errors.
+
+    \param  a_filename  Filename.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cFileMap::open(const std::string& a_filename)
+{
+    // release previous file
+    close();
+
+#if defined(WIN32) | defined(WIN64)
+    m_file = CreateFileA(a_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(m_file, &size) && (size.QuadPart > 0))
+        {
+            m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (m_mapping != NULL)
+            {
+                m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+                if (m_data != NULL)
+                {
+                    m_size = (size_t)(size.QuadPart);
+                    return (C_SUCCESS);
+                }
+            }
+        }
+        close();
+    }
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+    int descriptor = ::open(a_filename.c_str(), O_RDONLY);
+    if (descriptor >= 0)
+    {
+        struct stat info;
+        if ((fstat(descriptor, &info) == 0) && (info.st_size > 0))
+        {
+            void* data = mmap(NULL, (size_t)(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (data != MAP_FAILED)
+            {
+                madvise(data, (size_t)(info.st_size), MADV_SEQUENTIAL);
+                m_data = (const char*)data;
+                m_size = (size_t)(info.st_size);
+                m_mapped = true;
+            }
+        }
+        ::close(descriptor);
+
+        if (m_mapped)
+        {
+            return (C_SUCCESS);
+        }
+    }
+#endif
+
+    // mapping failed, read the file into memory instead
+    FILE* file = fopen(a_filename.c_str(), "rb");
+    if (file == NULL)
+    {
+        return (C_ERROR);
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size > 0)
+    {
+        m_buffer.resize((size_t)(size));
+        if (fread(&(m_buffer[0]), 1, (size_t)(size), file) == (size_t)(size))
+        {
+            m_data = &(m_buffer[0]);
+            m_size = (size_t)(size);
+        }
+        else
+        {
+            m_buffer.clear();
+        }
+    }
+    fclose(file);
+
+    return (m_data != NULL);
+}
+
+
+//==============================================================================
+/*!
+    This method releases the mapped file.
+*/
+//==============================================================================
+void cFileMap::close()
+{
+#if defined(WIN32) | defined(WIN64)
+    if ((m_data != NULL) && (m_buffer.size() == 0))
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != NULL)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+    if (m_mapped)
+    {
+        munmap((void*)m_data, m_size);
+        m_mapped = false;
+    }
+#endif
+
+    m_buffer.clear();
+    m_data = NULL;
+    m_size = 0;
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,156 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CFileMapH
+#define CFileMapH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CFileMap.h
+    \ingroup    system
+
+    \brief
+    Implements read-only memory-mapped files.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cFileMap
+    \ingroup    system
+
+    \brief
+    This class maps the content of a file into memory.
+
+    \details
+    This class maps a file into the address space of the process so that its 
+    content can be parsed directly from memory, without intermediate copies.
+    The pages of the file are loaded by the operating system as they are 
+    accessed. If the file cannot be mapped, its content is read into a 
+    memory buffer instead.
+*/
+//==============================================================================
+class cFileMap
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cFileMap.
+    cFileMap();
+
+    //! Destructor of cFileMap.
+    virtual ~cFileMap();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method maps a file into memory.
+    bool open(const std::string& a_filename);
+
+    //! This method releases the mapped file.
+    void close();
+
+    //! This method returns __true__ if a file is currently mapped.
+    bool isOpen() const { return (m_data != NULL); }
+
+    //! This method returns a pointer to the content of the file.
+    const char* getData() const { return (m_data); }
+
+    //! This method returns the size of the file in bytes.
+    size_t getSize() const { return (m_size); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Content of the file.
+    const char* m_data;
+
+    //! Size of the file in bytes.
+    size_t m_size;
+
+    //! Content of the file, if it could not be mapped.
+    std::vector<char> m_buffer;
+
+#if defined(WIN32) | defined(WIN64)
+    //! File handle.
+    HANDLE m_file;
+
+    //! File mapping handle.
+    HANDLE m_mapping;
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+    //! If __true__, then \ref m_data points to a memory mapping.
+    bool m_mapped;
+#endif
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
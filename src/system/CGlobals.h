@@ -333,6 +333,10 @@ typedef double                      GLclampd;
 #define GL_CLAMP_TO_EDGE            0x812F
 #define GL_NEAREST                  0x2600
 #define GL_NEAREST_MIPMAP_NEAREST   0x2700
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT     0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT    0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT    0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT    0x83F3
 
 #endif // C_USE_OPENGL
 
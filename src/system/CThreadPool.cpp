@@ -0,0 +1,281 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CThreadPool.h"
+//------------------------------------------------------------------------------
+#include "math/CMaths.h"
+#include <atomic>
+#include <memory>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cThreadPool.
+
+    \param  a_numThreads  Number of worker threads. If zero, one thread is 
+                          created per hardware core, minus the calling thread.
+*/
+//==============================================================================
+cThreadPool::cThreadPool(const unsigned int a_numThreads)
+{
+    m_numPendingTasks = 0;
+    m_stop = false;
+
+    unsigned int numThreads = a_numThreads;
+    if (numThreads == 0)
+    {
+        unsigned int numCores = std::thread::hardware_concurrency();
+        numThreads = (numCores > 1) ? (numCores - 1) : 1;
+    }
+
+    for (unsigned int i=0; i<numThreads; i++)
+    {
+        m_threads.push_back(std::thread(&cThreadPool::run, this));
+    }
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cThreadPool. Pending tasks are completed before the worker
+    threads terminate.
+*/
+//==============================================================================
+cThreadPool::~cThreadPool()
+{
+    waitForCompletion();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_conditionTask.notify_all();
+
+    for (unsigned int i=0; i<m_threads.size(); i++)
+    {
+        m_threads[i].join();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method submits a task to be executed by a worker thread.
+
+    \param  a_task  Task to be executed.
+*/
+//==============================================================================
+void cThreadPool::addTask(const std::function<void()>& a_task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(a_task);
+        m_numPendingTasks++;
+    }
+    m_conditionTask.notify_one();
+}
+
+
+//==============================================================================
+/*!
+    This method waits until all submitted tasks have completed. This method
+    must not be called from within a task.
+*/
+//==============================================================================
+void cThreadPool::waitForCompletion()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_numPendingTasks > 0)
+    {
+        m_conditionDone.wait(lock);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method calls a function for every index between 0 and 
+    __a_count__ - 1. Indices are handed out dynamically to the worker threads
+    and to the calling thread, so that iterations of uneven cost are balanced
+    automatically. The method returns once all iterations have completed.
+
+    \param  a_count     Number of iterations.
+    \param  a_function  Function called for each iteration.
+*/
+//==============================================================================
+void cThreadPool::parallelFor(const unsigned int a_count, 
+                              const std::function<void(unsigned int)>& a_function)
+{
+    // sanity check
+    if (a_count == 0) { return; }
+
+    // single iteration or no workers: execute in calling thread
+    if ((a_count == 1) || (m_threads.size() == 0))
+    {
+        for (unsigned int i=0; i<a_count; i++)
+        {
+            a_function(i);
+        }
+        return;
+    }
+
+    // shared loop state. Helper tasks may start after the loop has completed,
+    // therefore the state is reference counted.
+    struct cLoopState
+    {
+        std::function<void(unsigned int)> m_function;
+        unsigned int m_count;
+        std::atomic<unsigned int> m_next;
+        unsigned int m_done;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+    };
+
+    std::shared_ptr<cLoopState> state = std::make_shared<cLoopState>();
+    state->m_function = a_function;
+    state->m_count = a_count;
+    state->m_next = 0;
+    state->m_done = 0;
+
+    std::function<void()> work = [state]()
+    {
+        unsigned int done = 0;
+        unsigned int index;
+        while ((index = state->m_next++) < state->m_count)
+        {
+            state->m_function(index);
+            done++;
+        }
+        if (done > 0)
+        {
+            std::lock_guard<std::mutex> lock(state->m_mutex);
+            state->m_done += done;
+            if (state->m_done == state->m_count)
+            {
+                state->m_condition.notify_all();
+            }
+        }
+    };
+
+    // submit helper tasks
+    unsigned int numHelpers = cMin((unsigned int)(m_threads.size()), a_count - 1);
+    for (unsigned int i=0; i<numHelpers; i++)
+    {
+        addTask(work);
+    }
+
+    // calling thread takes part in the work
+    work();
+
+    // wait for all iterations to complete
+    std::unique_lock<std::mutex> lock(state->m_mutex);
+    while (state->m_done < state->m_count)
+    {
+        state->m_condition.wait(lock);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns a thread pool shared by the library. The pool is 
+    created on first use with one worker thread per hardware core.
+
+    \return Pointer to shared thread pool.
+*/
+//==============================================================================
+cThreadPool* cThreadPool::getSharedThreadPool()
+{
+    static cThreadPool pool;
+    return (&pool);
+}
+
+
+//==============================================================================
+/*!
+    This method is executed by each worker thread. It waits for tasks and 
+    executes them until the pool is destroyed.
+*/
+//==============================================================================
+void cThreadPool::run()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        // wait for next task
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stop && m_tasks.empty())
+            {
+                m_conditionTask.wait(lock);
+            }
+            if (m_stop && m_tasks.empty())
+            {
+                return;
+            }
+            task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+
+        // execute task
+        task();
+
+        // signal completion
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_numPendingTasks--;
+        }
+        m_conditionDone.notify_all();
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
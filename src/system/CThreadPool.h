@@ -0,0 +1,182 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CThreadPoolH
+#define CThreadPoolH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CThreadPool.h
+    \ingroup    system
+
+    \brief
+    Implements a pool of worker threads.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cThreadPool
+    \ingroup    system
+
+    \brief
+    This class implements a pool of worker threads.
+
+    \details
+    A thread pool creates a fixed number of worker threads that execute tasks
+    submitted through \ref addTask(). Tasks are executed in the order they are
+    submitted. \n
+
+    Method \ref parallelFor() distributes the iterations of a loop across the 
+    worker threads and the calling thread, and returns once all iterations 
+    have completed. It may safely be called from within a task. \n
+
+    A pool shared by the whole library can be retrieved by calling 
+    \ref getSharedThreadPool().
+*/
+//==============================================================================
+class cThreadPool
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cThreadPool.
+    cThreadPool(const unsigned int a_numThreads = 0);
+
+    //! Destructor of cThreadPool.
+    virtual ~cThreadPool();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of worker threads.
+    unsigned int getNumThreads() const { return ((unsigned int)(m_threads.size())); }
+
+    //! This method submits a task to be executed by a worker thread.
+    void addTask(const std::function<void()>& a_task);
+
+    //! This method waits until all submitted tasks have completed.
+    void waitForCompletion();
+
+    //! This method executes a function for every index in a range, distributing the work across threads.
+    void parallelFor(const unsigned int a_count, 
+                     const std::function<void(unsigned int)>& a_function);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns a thread pool shared by the library.
+    static cThreadPool* getSharedThreadPool();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method is executed by each worker thread.
+    void run();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Worker threads.
+    std::vector<std::thread> m_threads;
+
+    //! Queue of pending tasks.
+    std::deque< std::function<void()> > m_tasks;
+
+    //! Mutex protecting the task queue.
+    std::mutex m_mutex;
+
+    //! Condition signaled when a task is submitted or the pool is stopped.
+    std::condition_variable m_conditionTask;
+
+    //! Condition signaled when a task completes.
+    std::condition_variable m_conditionDone;
+
+    //! Number of tasks submitted and not yet completed.
+    unsigned int m_numPendingTasks;
+
+    //! If __true__, worker threads terminate.
+    bool m_stop;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
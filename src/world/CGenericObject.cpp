@@ -53,6 +53,7 @@
 #include "effects/CEffectVibration.h"
 #include "effects/CEffectViscosity.h"
 #include "shaders/CShaderProgram.h"
+#include "display/CCamera.h"
 //------------------------------------------------------------------------------
 #include <float.h>
 #include <vector>
@@ -164,6 +165,10 @@ cGenericObject::cGenericObject()
     m_boundaryBoxMax.set(0.0, 0.0, 0.0);
     m_boundaryBoxEmpty = true;
 
+    // frustum culling
+    m_frustumCullingViewID = 0;
+    m_frustumCulled = false;
+
     // collision detector
     m_collisionDetector = NULL; 
     m_showCollisionDetector = false;
@@ -2243,10 +2248,15 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
             cDrawFrame(m_frameSize, m_frameThicknessScale);
         }
 
+        //-----------------------------------------------------------------------
+        // Frustum culling
+        //-----------------------------------------------------------------------
+        bool culled = m_showEnabled && isOutsideFrustum(a_options);
+
         //-----------------------------------------------------------------------
         // Render graphical representation of object
         //-----------------------------------------------------------------------
-        if (m_showEnabled)
+        if (m_showEnabled && !culled)
         {
             // set polygon and face mode
             glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
@@ -2390,6 +2400,37 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
 }
 
 
+//==============================================================================
+/*!
+    This method tests the boundary box of this object against the view frustum
+    of the camera being rendered, using the global position and orientation of
+    the object. The test is performed once per view, and its result is reused
+    by all rendering passes of the view. If no camera is being rendered with
+    frustum culling enabled, this method returns __false__.
+
+    \param  a_options  Rendering options.
+
+    \return __true__ if the object lies outside of the view frustum, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::isOutsideFrustum(cRenderOptions& a_options)
+{
+    cCamera* camera = a_options.m_camera;
+    if ((camera == NULL) || (!camera->getFrustumCullingActive()) || m_boundaryBoxEmpty)
+    {
+        return (false);
+    }
+
+    if (m_frustumCullingViewID != camera->getFrustumCullingViewID())
+    {
+        m_frustumCulled = camera->isBoxOutsideFrustum(m_boundaryBoxMin, m_boundaryBoxMax, m_globalPos, m_globalRot);
+        m_frustumCullingViewID = camera->getFrustumCullingViewID();
+    }
+
+    return (m_frustumCulled);
+}
+
+
 //==============================================================================
 /*!
     This method adjusts the collision segment to take into consideration motion
@@ -779,6 +779,12 @@ protected:
     //! If __true__, then the boundary box does not include any object.
     bool m_boundaryBoxEmpty;
 
+    //! Identifier of the camera view for which \ref m_frustumCulled was last computed.
+    unsigned int m_frustumCullingViewID;
+
+    //! If __true__, the boundary box was found outside of the view frustum during view \ref m_frustumCullingViewID.
+    bool m_frustumCulled;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED MEMBERS - FRAME REPRESENTATION [X,Y,Z]:
@@ -937,6 +943,9 @@ protected:
         const bool a_duplicateMeshData,
         const bool a_buildCollisionDetector);
 
+    //! This method returns __true__ if the boundary box of this object lies outside of the view frustum of the camera being rendered.
+    bool isOutsideFrustum(cRenderOptions& a_options);
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS - INTERACTIONS:
@@ -52,12 +52,15 @@
 #include "files/CFileModel3DS.h"
 #include "files/CFileModelOBJ.h"
 #include "shaders/CShaderProgram.h"
+#include "system/CThreadPool.h"
+#include "display/CCamera.h"
 //------------------------------------------------------------------------------
 #include <algorithm>
 #include <vector>
 #include <list>
 #include <utility>
-#include <set>
+#include <unordered_map>
+#include <queue>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -105,6 +108,13 @@ cMesh::cMesh(cMaterialPtr a_material)
     // width of edge lines
     m_edgeLineWidth = 1.0;
 
+    // vertex to triangle adjacency not yet computed
+    m_vertexTriangleCounter = (unsigned int)(-1);
+    m_triangleNeighborCounter = (unsigned int)(-1);
+
+    // no levels of detail
+    m_lodRendered = 0;
+
     // should the frame (X-Y-Z) be displayed?
     m_showFrame = false;
 
@@ -135,7 +145,12 @@ cMesh::~cMesh()
 {
     // delete any allocated display lists
     m_displayList.invalidate();
-    m_displayListEdges.invalidate();
+
+    // delete overlay buffers
+    deleteOverlayBuffers();
+
+    // delete levels of detail
+    clearLevelsOfDetail();
 }
 
 
@@ -267,6 +282,752 @@ cVector3d cMesh::getCenterOfMass()
 }
 
 
+//==============================================================================
+/*!
+    This method merges vertices that are located within a given distance of 
+    each other and that carry identical normal, texture coordinate and color 
+    data. Candidates are found through a spatial hash grid whose cell size is 
+    at least the tolerance, so that only neighbouring cells are searched. \n
+
+    Vertices that are not merged keep their relative order. Triangles are 
+    updated to refer to the remaining vertices.
+
+    \param  a_tolerance  Largest distance between two merged vertices.
+
+    \return Number of vertices removed.
+*/
+//==============================================================================
+unsigned int cMesh::weldVertices(const double a_tolerance)
+{
+    unsigned int numVertices = m_vertices->getNumElements();
+    if (numVertices < 2) { return (0); }
+
+    // compute cell size
+    updateBoundaryBox();
+    double cellSize = cMax(a_tolerance, 1e-6 * cDistance(m_boundaryBoxMin, m_boundaryBoxMax));
+    if (cellSize <= 0.0) { cellSize = 1.0; }
+    double tolerance2 = a_tolerance * a_tolerance;
+
+    bool useNormals = m_vertices->getUseNormalData();
+    bool useTexCoords = m_vertices->getUseTexCoordData();
+    bool useColors = m_vertices->getUseColorData();
+
+    // hash grid: each cell holds a linked list of representative vertices
+    unordered_map<unsigned long long, unsigned int> cells;
+    cells.reserve(numVertices);
+    vector<unsigned int> next;
+    vector<unsigned int> sources;
+    vector<unsigned int> vertexMap(numVertices);
+    const unsigned int none = (unsigned int)(-1);
+
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        const cVector3d& pos = m_vertices->m_localPos[i];
+        long long cx = (long long)floor(pos(0) / cellSize);
+        long long cy = (long long)floor(pos(1) / cellSize);
+        long long cz = (long long)floor(pos(2) / cellSize);
+
+        // search neighbouring cells for a matching vertex
+        unsigned int match = none;
+        int range = (a_tolerance > 0.0) ? 1 : 0;
+        for (int dx=-range; (dx<=range) && (match==none); dx++)
+        {
+            for (int dy=-range; (dy<=range) && (match==none); dy++)
+            {
+                for (int dz=-range; (dz<=range) && (match==none); dz++)
+                {
+                    unsigned long long key = ((unsigned long long)(cx+dx) * 73856093ULL) ^ 
+                                             ((unsigned long long)(cy+dy) * 19349663ULL) ^ 
+                                             ((unsigned long long)(cz+dz) * 83492791ULL);
+                    unordered_map<unsigned long long, unsigned int>::iterator it = cells.find(key);
+                    if (it == cells.end()) { continue; }
+
+                    for (unsigned int k=it->second; k!=none; k=next[k])
+                    {
+                        unsigned int j = sources[k];
+                        if (cDistanceSq(pos, m_vertices->m_localPos[j]) > tolerance2) { continue; }
+                        if (useNormals && !m_vertices->m_normal[i].equals(m_vertices->m_normal[j], 0.0)) { continue; }
+                        if (useTexCoords && !m_vertices->m_texCoord[i].equals(m_vertices->m_texCoord[j], 0.0)) { continue; }
+                        if (useColors && !(m_vertices->m_color[i] == m_vertices->m_color[j])) { continue; }
+                        match = k;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (match != none)
+        {
+            vertexMap[i] = match;
+        }
+        else
+        {
+            // add vertex as new representative
+            unsigned int index = (unsigned int)(sources.size());
+            unsigned long long key = ((unsigned long long)cx * 73856093ULL) ^ 
+                                     ((unsigned long long)cy * 19349663ULL) ^ 
+                                     ((unsigned long long)cz * 83492791ULL);
+            unordered_map<unsigned long long, unsigned int>::iterator it = cells.find(key);
+            next.push_back((it == cells.end()) ? none : it->second);
+            cells[key] = index;
+            sources.push_back(i);
+            vertexMap[i] = index;
+        }
+    }
+
+    unsigned int numRemoved = numVertices - (unsigned int)(sources.size());
+    if (numRemoved == 0) { return (0); }
+
+    // rebuild vertices and update triangles
+    m_vertices->remap(sources);
+    m_triangles->remapVertices(vertexMap);
+
+    return (numRemoved);
+}
+
+
+//==============================================================================
+/*!
+    This method removes all triangles whose area is less than or equal to a 
+    given value, including triangles that use the same vertex more than once. 
+    The triangle array is compressed afterwards.
+
+    \param  a_minArea  Smallest area of a triangle that is kept.
+
+    \return Number of triangles removed.
+*/
+//==============================================================================
+unsigned int cMesh::removeDegenerateTriangles(const double a_minArea)
+{
+    unsigned int numTriangles = m_triangles->getNumElements();
+    unsigned int numRemoved = 0;
+
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (!m_triangles->getAllocated(i)) { continue; }
+
+        unsigned int index0 = m_triangles->getVertexIndex0(i);
+        unsigned int index1 = m_triangles->getVertexIndex1(i);
+        unsigned int index2 = m_triangles->getVertexIndex2(i);
+
+        if ((index0 == index1) || (index1 == index2) || (index2 == index0) ||
+            (m_triangles->computeArea(i) <= a_minArea))
+        {
+            m_triangles->removeTriangle(i);
+            numRemoved++;
+        }
+    }
+
+    m_triangles->compress();
+
+    return (numRemoved);
+}
+
+
+//==============================================================================
+/*!
+    This method reorders the triangles of the mesh to maximize the reuse of 
+    vertices held in the post-transform vertex cache of the graphics card. The 
+    method implements the linear-speed vertex cache optimization of Tom Forsyth:
+    vertices are scored according to their position in a simulated LRU cache and 
+    their number of remaining triangles, and the triangle with the highest 
+    combined score is emitted next. Deallocated triangles are removed.
+
+    \param  a_cacheSize  Size of the simulated vertex cache.
+*/
+//==============================================================================
+void cMesh::optimizeVertexCache(const unsigned int a_cacheSize)
+{
+    unsigned int numVertices = m_vertices->getNumElements();
+    unsigned int numTriangles = m_triangles->getNumElements();
+    unsigned int cacheSize = cMax(a_cacheSize, 4u);
+
+    // compute vertex to triangle adjacency
+    computeVertexTriangleAdjacency();
+    vector<unsigned int> vertexTriangles = m_vertexTriangles;
+    vector<unsigned int> remaining(numVertices);
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        remaining[i] = m_vertexTriangleOffsets[i+1] - m_vertexTriangleOffsets[i];
+    }
+
+    // vertex score function
+    vector<int> cachePos(numVertices, -1);
+    auto vertexScore = [&](unsigned int a_vertex) -> float
+    {
+        if (remaining[a_vertex] == 0) { return (-1.0f); }
+
+        float score = 0.0f;
+        int position = cachePos[a_vertex];
+        if (position >= 0)
+        {
+            if (position < 3)
+            {
+                score = 0.75f;
+            }
+            else
+            {
+                float scaler = 1.0f / (float)(cacheSize - 3);
+                score = powf(1.0f - (float)(position - 3) * scaler, 1.5f);
+            }
+        }
+        score += 2.0f * powf((float)remaining[a_vertex], -0.5f);
+        return (score);
+    };
+
+    // initialize scores
+    vector<float> vScore(numVertices);
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        vScore[i] = vertexScore(i);
+    }
+
+    unsigned int numAllocated = 0;
+    vector<unsigned char> added(numTriangles, 1);
+    vector<float> tScore(numTriangles, 0.0f);
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (!m_triangles->getAllocated(i)) { continue; }
+        added[i] = 0;
+        numAllocated++;
+        tScore[i] = vScore[m_triangles->m_indices[3*i+0]] + 
+                    vScore[m_triangles->m_indices[3*i+1]] + 
+                    vScore[m_triangles->m_indices[3*i+2]];
+    }
+
+    // emit triangles
+    vector<unsigned int> order;
+    order.reserve(numAllocated);
+    vector<unsigned int> cache, newCache;
+    unsigned int scan = 0;
+    int best = -1;
+
+    while (order.size() < numAllocated)
+    {
+        // no candidate in cache: take next triangle not yet emitted
+        if (best < 0)
+        {
+            while (added[scan]) { scan++; }
+            best = (int)scan;
+        }
+
+        unsigned int triangle = (unsigned int)best;
+        added[triangle] = 1;
+        order.push_back(triangle);
+
+        // remove triangle from the lists of its vertices and update cache
+        newCache.clear();
+        for (unsigned int k=0; k<3; k++)
+        {
+            unsigned int vertex = m_triangles->m_indices[3*triangle+k];
+            unsigned int first = m_vertexTriangleOffsets[vertex];
+            for (unsigned int j=first; j<first+remaining[vertex]; j++)
+            {
+                if (vertexTriangles[j] == triangle)
+                {
+                    vertexTriangles[j] = vertexTriangles[first+remaining[vertex]-1];
+                    remaining[vertex]--;
+                    break;
+                }
+            }
+            if (find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+            {
+                newCache.push_back(vertex);
+            }
+        }
+        for (unsigned int j=0; j<cache.size(); j++)
+        {
+            if (find(newCache.begin(), newCache.begin() + cMin((unsigned int)newCache.size(), 3u), cache[j]) == newCache.begin() + cMin((unsigned int)newCache.size(), 3u))
+            {
+                newCache.push_back(cache[j]);
+            }
+        }
+
+        // update cache positions and scores
+        for (unsigned int j=0; j<newCache.size(); j++)
+        {
+            unsigned int vertex = newCache[j];
+            cachePos[vertex] = (j < cacheSize) ? (int)j : -1;
+            vScore[vertex] = vertexScore(vertex);
+        }
+
+        // update triangle scores and select best candidate
+        best = -1;
+        float bestScore = -1.0f;
+        for (unsigned int j=0; j<newCache.size(); j++)
+        {
+            unsigned int vertex = newCache[j];
+            unsigned int first = m_vertexTriangleOffsets[vertex];
+            for (unsigned int l=first; l<first+remaining[vertex]; l++)
+            {
+                unsigned int t = vertexTriangles[l];
+                tScore[t] = vScore[m_triangles->m_indices[3*t+0]] + 
+                            vScore[m_triangles->m_indices[3*t+1]] + 
+                            vScore[m_triangles->m_indices[3*t+2]];
+                if (tScore[t] > bestScore)
+                {
+                    bestScore = tScore[t];
+                    best = (int)t;
+                }
+            }
+        }
+
+        // trim cache
+        if (newCache.size() > cacheSize) { newCache.resize(cacheSize); }
+        cache.swap(newCache);
+    }
+
+    // apply new triangle order
+    m_triangles->reorder(order);
+}
+
+
+//==============================================================================
+/*!
+    This method renumbers the vertices of the mesh in the order in which they 
+    are first referenced by the triangles, so that the graphics card reads 
+    vertex data sequentially. Vertices that are not used by any triangle are 
+    moved to the end of the array.
+*/
+//==============================================================================
+void cMesh::optimizeVertexFetch()
+{
+    unsigned int numVertices = m_vertices->getNumElements();
+    unsigned int numTriangles = m_triangles->getNumElements();
+    const unsigned int none = (unsigned int)(-1);
+
+    vector<unsigned int> vertexMap(numVertices, none);
+    vector<unsigned int> sources;
+    sources.reserve(numVertices);
+
+    // vertices used by triangles
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (!m_triangles->getAllocated(i)) { continue; }
+        for (unsigned int k=0; k<3; k++)
+        {
+            unsigned int vertex = m_triangles->m_indices[3*i+k];
+            if (vertexMap[vertex] == none)
+            {
+                vertexMap[vertex] = (unsigned int)(sources.size());
+                sources.push_back(vertex);
+            }
+        }
+    }
+
+    // unused vertices
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        if (vertexMap[i] == none)
+        {
+            vertexMap[i] = (unsigned int)(sources.size());
+            sources.push_back(i);
+        }
+    }
+
+    // rebuild vertices and update triangles
+    m_vertices->remap(sources);
+    m_triangles->remapVertices(vertexMap);
+}
+
+
+//==============================================================================
+/*!
+    This method optimizes the mesh for memory usage and rendering speed. 
+    Vertices are first welded, degenerate triangles are removed, triangles are 
+    reordered for vertex cache efficiency, and finally vertices are reordered 
+    for sequential access. Edges are cleared and the collision detector, if 
+    any, is rebuilt.
+
+    \param  a_weldTolerance  Largest distance between two merged vertices.
+
+    \return Number of vertices and triangles before and after optimization.
+*/
+//==============================================================================
+cMeshOptimizationReport cMesh::optimize(const double a_weldTolerance)
+{
+    cMeshOptimizationReport report;
+    report.m_numVerticesBefore = getNumVertices();
+    report.m_numTrianglesBefore = getNumTriangles();
+
+    weldVertices(a_weldTolerance);
+    removeDegenerateTriangles();
+    optimizeVertexCache();
+    optimizeVertexFetch();
+
+    report.m_numVerticesAfter = getNumVertices();
+    report.m_numTrianglesAfter = getNumTriangles();
+
+    // update edges, collision detector and display
+    clearAllEdges();
+    if (m_collisionDetector != NULL)
+    {
+        m_collisionDetector->update();
+    }
+    markForUpdate(false);
+
+    return (report);
+}
+
+
+//==============================================================================
+/*!
+    This method reduces the number of triangles of the mesh to __a_numTriangles__
+    using the quadric error metric of Garland and Heckbert. Edges are collapsed
+    onto one of their two vertices, in order of increasing error, so that the 
+    remaining vertices keep their normal, texture coordinate and color data. 
+    Border edges are preserved by additional constraint planes, and collapses 
+    that would flip a triangle or create a non-manifold edge are rejected. \n
+
+    Unused vertices are removed once the simplification is completed. The mesh 
+    should be welded beforehand (see \ref weldVertices()) since triangles that 
+    do not share vertices cannot be simplified.
+
+    \param  a_numTriangles  Desired number of triangles.
+
+    \return Estimated largest distance between the original and the simplified
+            surface, expressed in local units.
+*/
+//==============================================================================
+double cMesh::simplify(const unsigned int a_numTriangles)
+{
+    // remove deallocated triangles
+    m_triangles->compress();
+
+    unsigned int numVertices = m_vertices->getNumElements();
+    unsigned int numTriangles = m_triangles->getNumElements();
+    if (numTriangles <= a_numTriangles) { return (0.0); }
+
+    vector<unsigned int> indices(m_triangles->m_indices.begin(), m_triangles->m_indices.begin() + 3 * numTriangles);
+    const vector<cVector3d>& pos = m_vertices->m_localPos;
+
+    // symmetric 4x4 quadric of each vertex (10 coefficients)
+    vector<double> quadrics(10 * numVertices, 0.0);
+    auto addPlane = [&](unsigned int a_vertex, const cVector3d& a_n, double a_d, double a_weight)
+    {
+        double* q = &quadrics[10 * a_vertex];
+        q[0] += a_weight * a_n(0) * a_n(0);
+        q[1] += a_weight * a_n(0) * a_n(1);
+        q[2] += a_weight * a_n(0) * a_n(2);
+        q[3] += a_weight * a_n(0) * a_d;
+        q[4] += a_weight * a_n(1) * a_n(1);
+        q[5] += a_weight * a_n(1) * a_n(2);
+        q[6] += a_weight * a_n(1) * a_d;
+        q[7] += a_weight * a_n(2) * a_n(2);
+        q[8] += a_weight * a_n(2) * a_d;
+        q[9] += a_weight * a_d * a_d;
+    };
+    auto evaluate = [&](unsigned int a_vertex, const cVector3d& a_p) -> double
+    {
+        const double* q = &quadrics[10 * a_vertex];
+        double x = a_p(0), y = a_p(1), z = a_p(2);
+        return (q[0]*x*x + 2.0*q[1]*x*y + 2.0*q[2]*x*z + 2.0*q[3]*x +
+                q[4]*y*y + 2.0*q[5]*y*z + 2.0*q[6]*y +
+                q[7]*z*z + 2.0*q[8]*z + q[9]);
+    };
+
+    // triangle planes and vertex to triangle adjacency
+    vector<vector<unsigned int> > vertexTriangles(numVertices);
+    unordered_map<unsigned long long, unsigned int> edgeCount;
+    edgeCount.reserve(3 * numTriangles);
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        const unsigned int* t = &indices[3*i];
+        cVector3d n = cCross(pos[t[1]] - pos[t[0]], pos[t[2]] - pos[t[0]]);
+        if (n.length() > 0.0)
+        {
+            n.normalize();
+            double d = -cDot(n, pos[t[0]]);
+            for (unsigned int k=0; k<3; k++)
+            {
+                addPlane(t[k], n, d, 1.0);
+            }
+        }
+        for (unsigned int k=0; k<3; k++)
+        {
+            vertexTriangles[t[k]].push_back(i);
+            unsigned long long a = cMin(t[k], t[(k+1)%3]);
+            unsigned long long b = cMax(t[k], t[(k+1)%3]);
+            edgeCount[(a << 32) | b]++;
+        }
+    }
+
+    // constraint planes along border edges
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        const unsigned int* t = &indices[3*i];
+        cVector3d n = cCross(pos[t[1]] - pos[t[0]], pos[t[2]] - pos[t[0]]);
+        for (unsigned int k=0; k<3; k++)
+        {
+            unsigned long long a = cMin(t[k], t[(k+1)%3]);
+            unsigned long long b = cMax(t[k], t[(k+1)%3]);
+            if (edgeCount[(a << 32) | b] != 1) { continue; }
+
+            cVector3d nb = cCross(pos[t[(k+1)%3]] - pos[t[k]], n);
+            if (nb.length() == 0.0) { continue; }
+            nb.normalize();
+            double d = -cDot(nb, pos[t[k]]);
+            addPlane(t[k], nb, d, 10.0);
+            addPlane(t[(k+1)%3], nb, d, 10.0);
+        }
+    }
+
+    // candidate collapses, ordered by increasing cost
+    struct cCollapse
+    {
+        double m_cost;
+        unsigned int m_from, m_to, m_stampFrom, m_stampTo;
+        bool operator<(const cCollapse& a_other) const { return (m_cost > a_other.m_cost); }
+    };
+    vector<unsigned int> stamps(numVertices, 0);
+    priority_queue<cCollapse> candidates;
+    auto addCandidate = [&](unsigned int a_from, unsigned int a_to)
+    {
+        cCollapse collapse;
+        collapse.m_cost = evaluate(a_from, pos[a_to]) + evaluate(a_to, pos[a_to]);
+        collapse.m_from = a_from;
+        collapse.m_to = a_to;
+        collapse.m_stampFrom = stamps[a_from];
+        collapse.m_stampTo = stamps[a_to];
+        candidates.push(collapse);
+    };
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        for (unsigned int k=0; k<3; k++)
+        {
+            addCandidate(indices[3*i+k], indices[3*i+(k+1)%3]);
+            addCandidate(indices[3*i+(k+1)%3], indices[3*i+k]);
+        }
+    }
+
+    // collapse edges
+    vector<unsigned char> removed(numTriangles, 0);
+    vector<unsigned int> neighbors;
+    unsigned int numRemaining = numTriangles;
+    double maxCost = 0.0;
+
+    while ((numRemaining > a_numTriangles) && (!candidates.empty()))
+    {
+        cCollapse collapse = candidates.top();
+        candidates.pop();
+
+        unsigned int u = collapse.m_from;
+        unsigned int v = collapse.m_to;
+        if ((collapse.m_stampFrom != stamps[u]) || (collapse.m_stampTo != stamps[v])) { continue; }
+
+        // reject collapses that flip triangles or create non-manifold edges
+        bool valid = true;
+        unsigned int numShared = 0;
+        neighbors.clear();
+        for (unsigned int j=0; (j<vertexTriangles[u].size()) && valid; j++)
+        {
+            unsigned int tri = vertexTriangles[u][j];
+            if (removed[tri]) { continue; }
+
+            const unsigned int* t = &indices[3*tri];
+            if ((t[0] == v) || (t[1] == v) || (t[2] == v))
+            {
+                numShared++;
+                continue;
+            }
+
+            cVector3d p[3] = { pos[t[0]], pos[t[1]], pos[t[2]] };
+            cVector3d n0 = cCross(p[1] - p[0], p[2] - p[0]);
+            for (unsigned int k=0; k<3; k++)
+            {
+                if (t[k] == u) { p[k] = pos[v]; }
+                else { neighbors.push_back(t[k]); }
+            }
+            cVector3d n1 = cCross(p[1] - p[0], p[2] - p[0]);
+            if (cDot(n0, n1) <= 0.0) { valid = false; }
+        }
+        if (!valid || (numShared == 0)) { continue; }
+
+        sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        unsigned int numCommon = 0;
+        for (unsigned int j=0; j<vertexTriangles[v].size(); j++)
+        {
+            unsigned int tri = vertexTriangles[v][j];
+            if (removed[tri]) { continue; }
+            for (unsigned int k=0; k<3; k++)
+            {
+                unsigned int w = indices[3*tri+k];
+                if ((w != u) && (w != v) && binary_search(neighbors.begin(), neighbors.end(), w))
+                {
+                    numCommon++;
+                }
+            }
+        }
+        // each vertex common to both rings is counted twice by the triangles around v
+        if (numCommon > 2 * numShared) { continue; }
+
+        // move triangles of u onto v
+        for (unsigned int j=0; j<vertexTriangles[u].size(); j++)
+        {
+            unsigned int tri = vertexTriangles[u][j];
+            if (removed[tri]) { continue; }
+
+            unsigned int* t = &indices[3*tri];
+            if ((t[0] == v) || (t[1] == v) || (t[2] == v))
+            {
+                removed[tri] = 1;
+                numRemaining--;
+            }
+            else
+            {
+                for (unsigned int k=0; k<3; k++)
+                {
+                    if (t[k] == u) { t[k] = v; }
+                }
+                vertexTriangles[v].push_back(tri);
+            }
+        }
+        vertexTriangles[u].clear();
+
+        // accumulate quadric of u into v
+        for (unsigned int k=0; k<10; k++)
+        {
+            quadrics[10*v+k] += quadrics[10*u+k];
+        }
+        maxCost = cMax(maxCost, collapse.m_cost);
+        stamps[u]++;
+        stamps[v]++;
+
+        // update candidates around v
+        vector<unsigned int>& trianglesV = vertexTriangles[v];
+        unsigned int count = 0;
+        for (unsigned int j=0; j<trianglesV.size(); j++)
+        {
+            unsigned int tri = trianglesV[j];
+            if (removed[tri]) { continue; }
+            trianglesV[count++] = tri;
+            for (unsigned int k=0; k<3; k++)
+            {
+                unsigned int w = indices[3*tri+k];
+                if (w != v)
+                {
+                    addCandidate(v, w);
+                    addCandidate(w, v);
+                }
+            }
+        }
+        trianglesV.resize(count);
+    }
+
+    // keep used vertices only, in order of first use
+    const unsigned int none = (unsigned int)(-1);
+    vector<unsigned int> vertexMap(numVertices, none);
+    vector<unsigned int> sources;
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (removed[i]) { continue; }
+        for (unsigned int k=0; k<3; k++)
+        {
+            unsigned int vertex = indices[3*i+k];
+            if (vertexMap[vertex] == none)
+            {
+                vertexMap[vertex] = (unsigned int)(sources.size());
+                sources.push_back(vertex);
+            }
+        }
+    }
+    m_vertices->remap(sources);
+
+    // rebuild triangles
+    m_triangles->clear();
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (removed[i]) { continue; }
+        m_triangles->newTriangle(vertexMap[indices[3*i+0]], vertexMap[indices[3*i+1]], vertexMap[indices[3*i+2]]);
+    }
+
+    // update edges, collision detector and display
+    clearAllEdges();
+    if (m_collisionDetector != NULL)
+    {
+        m_collisionDetector->update();
+    }
+    markForUpdate(false);
+
+    return (sqrt(cMax(0.0, maxCost)));
+}
+
+
+//==============================================================================
+/*!
+    This method builds __a_numLevels__ simplified versions of the mesh. Each 
+    level holds __a_reductionFactor__ times the number of triangles of the 
+    previous one. Levels of detail are used for graphic rendering only: haptic
+    rendering and collision detection always operate on the full-resolution 
+    mesh. During rendering, the coarsest level whose geometric error projects 
+    to less than \ref cCamera::getLodPixelError() pixels is displayed. \n
+
+    Levels of detail share the material and texture of the mesh. They must be
+    rebuilt if the vertices or triangles of the mesh are modified.
+
+    \param  a_numLevels        Number of simplified levels.
+    \param  a_reductionFactor  Ratio between the number of triangles of two consecutive levels.
+*/
+//==============================================================================
+void cMesh::buildLevelsOfDetail(const unsigned int a_numLevels, const double a_reductionFactor)
+{
+    clearLevelsOfDetail();
+
+    double factor = cClamp(a_reductionFactor, 0.01, 0.99);
+    double numTriangles = (double)getNumTriangles();
+    cMesh* previous = this;
+
+    for (unsigned int i=0; i<a_numLevels; i++)
+    {
+        numTriangles = factor * numTriangles;
+        if (numTriangles < 1.0) { break; }
+
+        // simplify a copy of the previous level
+        cMesh* lod = new cMesh(m_material);
+        lod->m_vertices = previous->m_vertices->copy();
+        lod->m_triangles = previous->m_triangles->copy();
+        lod->m_triangles->m_vertices = lod->m_vertices;
+
+        double error = lod->simplify((unsigned int)numTriangles);
+
+        // stop if the mesh cannot be simplified any further
+        if (lod->getNumTriangles() >= previous->getNumTriangles())
+        {
+            delete lod;
+            break;
+        }
+
+        // errors accumulate from one level to the next
+        if (m_lodErrors.size() > 0)
+        {
+            error += m_lodErrors.back();
+        }
+
+        m_lodMeshes.push_back(lod);
+        m_lodErrors.push_back(error);
+        previous = lod;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method deletes all levels of detail.
+*/
+//==============================================================================
+void cMesh::clearLevelsOfDetail()
+{
+    for (unsigned int i=0; i<m_lodMeshes.size(); i++)
+    {
+        delete m_lodMeshes[i];
+    }
+    m_lodMeshes.clear();
+    m_lodErrors.clear();
+    m_lodRendered = 0;
+}
+
+
 //==============================================================================
 /*!
     This method returns the number of stored triangles.
@@ -487,66 +1248,302 @@ void cMesh::clear()
 //==============================================================================
 /*!
     This method computes all surface normals for every vertex in the mesh, by 
-    averaging the face normals of the triangle that include each vertex.
+    averaging the face normals of the triangle that include each vertex. \n
+
+    The face normals are computed in parallel. Each vertex normal is then 
+    gathered from the list of its adjacent triangles, so that every thread 
+    writes to its own vertices only.
 */
 //==============================================================================
 void cMesh::computeAllNormals()
 {
+    // sanity check
+    if (!m_vertices->getUseNormalData()) { return; }
+
     // read number of vertices and triangles of object
     unsigned int numTriangles = m_triangles->getNumElements();
     unsigned int numVertices = m_vertices->getNumElements();
 
-    // initialize all normals to zero
-    for (unsigned int i=0; i<numVertices; i++)
+    // update vertex to triangle adjacency
+    updateVertexTriangleAdjacency();
+
+    // compute the normal of each triangle
+    const unsigned int blockSize = 4096;
+    m_triangleNormals.resize(numTriangles);
+    cThreadPool::getSharedThreadPool()->parallelFor((numTriangles + blockSize - 1) / blockSize, [&](unsigned int a_block)
+    {
+        unsigned int last = cMin((a_block + 1) * blockSize, numTriangles);
+        for (unsigned int i=a_block * blockSize; i<last; i++)
+        {
+            computeTriangleNormal(i);
+        }
+    });
+
+    // sum contributions of adjacent triangles and normalize
+    cThreadPool::getSharedThreadPool()->parallelFor((numVertices + blockSize - 1) / blockSize, [&](unsigned int a_block)
     {
-        m_vertices->setNormal(i, 0, 0, 0);
+        unsigned int last = cMin((a_block + 1) * blockSize, numVertices);
+        for (unsigned int i=a_block * blockSize; i<last; i++)
+        {
+            computeVertexNormal(i);
+        }
+    });
+
+    // mark for update
+    m_vertices->markNormalDataForUpdate();
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the surface normals of the vertices located around 
+    a set of modified vertices. Only the triangles adjacent to the modified 
+    vertices, and the vertices of these triangles, are processed. If the 
+    triangles of the mesh have changed since the last normal computation, all 
+    normals are computed instead.
+
+    \param  a_modifiedVertices  Index numbers of vertices that have moved.
+*/
+//==============================================================================
+void cMesh::computeNormals(const vector<unsigned int>& a_modifiedVertices)
+{
+    // sanity check
+    if (!m_vertices->getUseNormalData()) { return; }
+
+    // full computation required if topology has changed
+    unsigned int numTriangles = m_triangles->getNumElements();
+    if (updateVertexTriangleAdjacency() || (m_triangleNormals.size() != numTriangles))
+    {
+        computeAllNormals();
+        return;
     }
 
-    // compute the normal of each triangle, add contribution to each vertex
-    for (unsigned int i=0; i<numTriangles; i++)
+    // collect triangles adjacent to modified vertices
+    unsigned int numVertices = m_vertices->getNumElements();
+    vector<unsigned int> triangles;
+    for (unsigned int i=0; i<a_modifiedVertices.size(); i++)
+    {
+        unsigned int vertex = a_modifiedVertices[i];
+        if (vertex >= numVertices) { continue; }
+        for (unsigned int j=m_vertexTriangleOffsets[vertex]; j<m_vertexTriangleOffsets[vertex+1]; j++)
+        {
+            triangles.push_back(m_vertexTriangles[j]);
+        }
+    }
+    sort(triangles.begin(), triangles.end());
+    triangles.erase(unique(triangles.begin(), triangles.end()), triangles.end());
+
+    // update normals of these triangles
+    for (unsigned int i=0; i<triangles.size(); i++)
+    {
+        computeTriangleNormal(triangles[i]);
+    }
+
+    // collect vertices of these triangles
+    vector<unsigned int> vertices;
+    vertices.reserve(3 * triangles.size());
+    for (unsigned int i=0; i<triangles.size(); i++)
+    {
+        vertices.push_back(m_triangles->getVertexIndex0(triangles[i]));
+        vertices.push_back(m_triangles->getVertexIndex1(triangles[i]));
+        vertices.push_back(m_triangles->getVertexIndex2(triangles[i]));
+    }
+    sort(vertices.begin(), vertices.end());
+    vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+
+    // update normals of these vertices
+    for (unsigned int i=0; i<vertices.size(); i++)
     {
-        unsigned int vertexIndex0 = m_triangles->getVertexIndex0(i);
-        unsigned int vertexIndex1 = m_triangles->getVertexIndex1(i);
-        unsigned int vertexIndex2 = m_triangles->getVertexIndex2(i);
+        unsigned int vertex = vertices[i];
+        computeVertexNormal(vertex);
+        m_vertices->setNormal(vertex, m_vertices->m_normal[vertex]);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the normal matrix vectors for all triangles. \n
+
+    Each vertex receives the tangent and bitangent of the last adjacent 
+    triangle that has valid texture coordinates, projected onto the plane 
+    of the vertex normal. Vertices are processed in parallel.
+*/
+//==============================================================================
+void cMesh::computeBTN()
+{
+    // sanity check
+    if (!m_vertices->getUseTangentData() || !m_vertices->getUseBitangentData()) { return; }
 
-        cVector3d vertex0 = m_vertices->getLocalPos(vertexIndex0);
-        cVector3d vertex1 = m_vertices->getLocalPos(vertexIndex1);
-        cVector3d vertex2 = m_vertices->getLocalPos(vertexIndex2);
+    // update vertex to triangle adjacency
+    updateVertexTriangleAdjacency();
 
-        // compute normal vector
-        cVector3d normal, v01, v02;
-        vertex1.subr(vertex0, v01);
-        vertex2.subr(vertex0, v02);
-        v01.crossr(v02, normal);
-        double length = normal.length();
-        if (length > 0.0)
+    // compute tangents of each vertex
+    unsigned int numVertices = m_vertices->getNumElements();
+    const unsigned int blockSize = 4096;
+    cThreadPool::getSharedThreadPool()->parallelFor((numVertices + blockSize - 1) / blockSize, [&](unsigned int a_block)
+    {
+        unsigned int last = cMin((a_block + 1) * blockSize, numVertices);
+        for (unsigned int i=a_block * blockSize; i<last; i++)
         {
-            normal.div(length);
-            m_vertices->m_normal[vertexIndex0].add(normal);
-            m_vertices->m_normal[vertexIndex1].add(normal);
-            m_vertices->m_normal[vertexIndex2].add(normal);
+            // search last adjacent triangle with valid texture coordinates
+            unsigned int first = m_vertexTriangleOffsets[i];
+            unsigned int j = m_vertexTriangleOffsets[i+1];
+            while (j > first)
+            {
+                j--;
+                cVector3d T, B;
+                if (m_triangles->computeTangents(m_vertexTriangles[j], T, B))
+                {
+                    cVector3d N = m_vertices->getNormal(i);
+                    cVector3d Ti = cProjectPointOnPlane(T, cVector3d(0, 0, 0), N);
+                    cVector3d Bi = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N);
+                    Ti.normalize();
+                    Bi.normalize();
+                    m_vertices->m_tangent[i] = Ti;
+                    m_vertices->m_bitangent[i] = Bi;
+                    break;
+                }
+            }
+        }
+    });
+
+    // mark for update
+    m_vertices->markTangentDataForUpdate();
+}
+
+
+//==============================================================================
+/*!
+    This method builds, for each vertex, the list of allocated triangles that 
+    include it. The lists are stored consecutively in compressed row format 
+    and are reused by the normal and tangent computations until the triangles 
+    of the mesh change.
+*/
+//==============================================================================
+void cMesh::computeVertexTriangleAdjacency()
+{
+    unsigned int numTriangles = m_triangles->getNumElements();
+    unsigned int numVertices = m_vertices->getNumElements();
+
+    // count triangles per vertex
+    m_vertexTriangleOffsets.assign(numVertices + 1, 0);
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (!m_triangles->getAllocated(i)) { continue; }
+        for (unsigned int k=0; k<3; k++)
+        {
+            unsigned int vertex = m_triangles->m_indices[3*i+k];
+            if (vertex < numVertices) { m_vertexTriangleOffsets[vertex+1]++; }
         }
     }
 
-    // normalize all triangles
+    // compute offsets
     for (unsigned int i=0; i<numVertices; i++)
     {
-        if (m_vertices->m_normal[i].length() > 0.000000001)
+        m_vertexTriangleOffsets[i+1] += m_vertexTriangleOffsets[i];
+    }
+
+    // store triangles in increasing order
+    m_vertexTriangles.resize(m_vertexTriangleOffsets[numVertices]);
+    vector<unsigned int> count(m_vertexTriangleOffsets.begin(), m_vertexTriangleOffsets.end() - 1);
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (!m_triangles->getAllocated(i)) { continue; }
+        for (unsigned int k=0; k<3; k++)
         {
-            m_vertices->m_normal[i].normalize();
+            unsigned int vertex = m_triangles->m_indices[3*i+k];
+            if (vertex < numVertices) { m_vertexTriangles[count[vertex]++] = i; }
         }
     }
+
+    m_vertexTriangleCounter = m_triangles->getModificationCounter();
 }
 
 
 //==============================================================================
 /*!
-    This method computes the normal matrix vectors for all triangles.
+    This method rebuilds the vertex to triangle adjacency if the triangle array
+    has been modified since it was last computed.
+
+    \return __true__ if the adjacency was rebuilt, __false__ otherwise.
 */
 //==============================================================================
-void cMesh::computeBTN()
+bool cMesh::updateVertexTriangleAdjacency()
 {
-    m_triangles->computeBTN();
+    if ((m_vertexTriangleCounter == m_triangles->getModificationCounter()) &&
+        (m_vertexTriangleOffsets.size() == m_vertices->getNumElements() + 1))
+    {
+        return (false);
+    }
+
+    computeVertexTriangleAdjacency();
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method computes the unit surface normal of a selected triangle and 
+    stores it in the triangle normal cache. Degenerate triangles receive a 
+    null normal.
+
+    \param  a_triangleIndex  Index number of triangle.
+*/
+//==============================================================================
+void cMesh::computeTriangleNormal(const unsigned int a_triangleIndex)
+{
+    const cVector3d& vertex0 = m_vertices->m_localPos[m_triangles->getVertexIndex0(a_triangleIndex)];
+    const cVector3d& vertex1 = m_vertices->m_localPos[m_triangles->getVertexIndex1(a_triangleIndex)];
+    const cVector3d& vertex2 = m_vertices->m_localPos[m_triangles->getVertexIndex2(a_triangleIndex)];
+
+    // compute normal vector
+    cVector3d normal, v01, v02;
+    vertex1.subr(vertex0, v01);
+    vertex2.subr(vertex0, v02);
+    v01.crossr(v02, normal);
+    double length = normal.length();
+    if (length > 0.0)
+    {
+        normal.div(length);
+    }
+    else
+    {
+        normal.zero();
+    }
+    m_triangleNormals[a_triangleIndex] = normal;
+}
+
+
+//==============================================================================
+/*!
+    This method computes the normal of a selected vertex by summing the 
+    normals of its adjacent triangles and normalizing the result.
+
+    \param  a_vertexIndex  Index number of vertex.
+*/
+//==============================================================================
+void cMesh::computeVertexNormal(const unsigned int a_vertexIndex)
+{
+    double x = 0.0, y = 0.0, z = 0.0;
+    unsigned int last = m_vertexTriangleOffsets[a_vertexIndex+1];
+    for (unsigned int j=m_vertexTriangleOffsets[a_vertexIndex]; j<last; j++)
+    {
+        const cVector3d& n = m_triangleNormals[m_vertexTriangles[j]];
+        x += n(0);
+        y += n(1);
+        z += n(2);
+    }
+
+    double length = sqrt(x*x + y*y + z*z);
+    if (length > 0.000000001)
+    {
+        double scale = 1.0 / length;
+        x *= scale;
+        y *= scale;
+        z *= scale;
+    }
+    m_vertices->m_normal[a_vertexIndex].set(x, y, z);
 }
 
 
@@ -588,12 +1585,7 @@ void cMesh::updateGlobalPositions(const bool a_frameOnly)
 {
     if (a_frameOnly) return;
 
-    int numVertices = m_vertices->getNumElements();
-
-    for (int i=0; i<numVertices; i++)
-    {
-        m_vertices->computeGlobalPosition(i, m_globalPos, m_globalRot);
-    }
+    m_vertices->computeGlobalPositions(m_globalPos, m_globalRot);
 }
 
 
@@ -613,7 +1605,15 @@ void cMesh::markForUpdate(const bool a_affectChildren)
 
     // invalidate display list
     m_displayList.invalidate();
-    m_displayListEdges.invalidate();
+
+    // rebuild edges, normals and tangents
+    invalidateOverlayBuffers();
+
+    // update levels of detail
+    for (unsigned int i=0; i<m_lodMeshes.size(); i++)
+    {
+        m_lodMeshes[i]->markForUpdate(false);
+    }
 
     // update display list of cGenericObject and children
     cGenericObject::markForUpdate(a_affectChildren);
@@ -741,6 +1741,10 @@ void cMesh::setNormalsProperties(const double a_length,
 {
     m_normalsLength = cClamp0(a_length);
     m_normalsColor = a_color;
+
+    // normals and tangents are scaled by their length
+    m_normalBuffer.m_flagUpdate = true;
+    m_tangentBuffer.m_flagUpdate = true;
 }
 
 
@@ -823,7 +1827,11 @@ void cMesh::updateBoundaryBox()
     This method creates a list of edges by providing a threshold angle in 
     degrees. All triangles for which the angle between their respective surface
     normals are greater than the select angle threshold are added to the list of 
-    edges.
+    edges, together with all edges located on the boundary of the mesh. Edges are matched by the 
+    position of their end points, so meshes whose triangles do not share 
+    vertices are handled too. The triangle adjacency computed in the process is
+    stored with the mesh and can be retrieved by calling 
+    \ref getTriangleNeighbor().
 
     \param  a_angleThresholdDeg  Threshold angle in degrees.
 */
@@ -833,129 +1841,201 @@ void cMesh::computeAllEdges(double a_angleThresholdDeg)
     // clear current list of edges.
     clearAllEdges();
 
-    // initialize variables
-    int numtriangles = getNumTriangles();
-
-    multiset<cEdge> edges;
-    edges.clear();
-    cEdge edge;
-    multiset<cEdge>::iterator it;
+    // update triangle adjacency and normals
+    computeTriangleAdjacency();
 
     // setup angle threshold
     double angleThresholdRad = cDegToRad(a_angleThresholdDeg);
 
     // process all triangles
-    for (int i=0; i<numtriangles; i++)
-    {
-        int v0 = m_triangles->getVertexIndex0(i);
-        int v1 = m_triangles->getVertexIndex1(i);
-        int v2 = m_triangles->getVertexIndex2(i);
-
-        cVector3d z0 = m_vertices->getLocalPos(v0);
-        cVector3d z1 = m_vertices->getLocalPos(v1);
-        cVector3d z2 = m_vertices->getLocalPos(v2);
-
-        cVector3d n0 = cComputeSurfaceNormal(z0, z1, z2);
-
-        if (n0.length() > 0)
-        {
-            //////////////////////////////////////////////////////////////////
-            // store reference to triangle
-            //////////////////////////////////////////////////////////////////
-            edge.m_triangle = i;
-            
-            //////////////////////////////////////////////////////////////////
-            // edge 01 of triangle.
-            //////////////////////////////////////////////////////////////////
-            edge.set(this, v0, v1);
-            it = edges.find(edge);
-            if (it!=edges.end())
-            {
-                cVector3d n1 = cComputeSurfaceNormal(m_vertices->getLocalPos(m_triangles->getVertexIndex0((*it).m_triangle)),
-                                                     m_vertices->getLocalPos(m_triangles->getVertexIndex1((*it).m_triangle)),
-                                                     m_vertices->getLocalPos(m_triangles->getVertexIndex2((*it).m_triangle)));
+    unsigned int numTriangles = m_triangles->getNumElements();
+    cEdge edge;
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        const cVector3d& n0 = m_triangleNormals[i];
+        if (n0.length() == 0.0) { continue; }
 
-                if (n1.length() > 0.0)
-                {
-                    if (cAngle(n0, n1) >= angleThresholdRad)
-                    {
-                        m_edges.push_back(edge);
-                    }
-                }
+        for (unsigned int k=0; k<3; k++)
+        {
+            int neighbor = m_triangleNeighbors[3*i+k];
 
-                // remove edge as we have already found it dual
-                edges.erase(it);
-            }
-            else
+            // each shared edge is processed once, from the second triangle
+            if ((neighbor >= 0) && ((unsigned int)neighbor > i)) { continue; }
+
+            if ((neighbor < 0) || (cAngle(n0, m_triangleNormals[neighbor]) >= angleThresholdRad))
             {
-                edges.insert(edge);
+                edge.m_triangle = i;
+                edge.set(this, m_triangles->m_indices[3*i+k], m_triangles->m_indices[3*i+((k+1)%3)]);
+                m_edges.push_back(edge);
             }
+        }
+    }
+}
 
 
-            //////////////////////////////////////////////////////////////////
-            // edge 02 of triangle.
-            //////////////////////////////////////////////////////////////////
-            edge.set(this, v0, v2);
-            it = edges.find(edge);
-            if (it!=edges.end())
-            {
-                cVector3d n1 = cComputeSurfaceNormal(m_vertices->getLocalPos(m_triangles->getVertexIndex0((*it).m_triangle)),
-                                                     m_vertices->getLocalPos(m_triangles->getVertexIndex1((*it).m_triangle)),
-                                                     m_vertices->getLocalPos(m_triangles->getVertexIndex2((*it).m_triangle)));
-
+//==============================================================================
+/*!
+    This method builds, for every edge of every triangle, the index of the 
+    triangle that shares it. Edges are identified by the positions of their 
+    end points. All edges are collected in a table which is sorted in parallel, 
+    so that matching edges become consecutive entries. If more than two 
+    triangles share an edge, they are paired in increasing triangle order. 
+    Degenerate triangles have no neighbours. \n
+
+    The unit normal of each triangle is updated at the same time.
+*/
+//==============================================================================
+void cMesh::computeTriangleAdjacency()
+{
+    unsigned int numTriangles = m_triangles->getNumElements();
 
-                if (n1.length() > 0.0)
-                {
-                    if (cAngle(n0, n1) >= angleThresholdRad)
-                    {
-                        m_edges.push_back(edge);
-                    }
-                }
+    // half-edge record
+    struct cHalfEdge
+    {
+        double m_key[6];
+        unsigned int m_triangle;
+        unsigned int m_edge;
 
-                // remove edge as we have already found it dual
-                edges.erase(it);
-            }
-            else
+        bool operator<(const cHalfEdge& a_other) const
+        {
+            for (int i=0; i<6; i++)
             {
-                edges.insert(edge);
+                if (m_key[i] < a_other.m_key[i]) { return (true); }
+                if (m_key[i] > a_other.m_key[i]) { return (false); }
             }
+            if (m_triangle != a_other.m_triangle) { return (m_triangle < a_other.m_triangle); }
+            return (m_edge < a_other.m_edge);
+        }
 
-            //////////////////////////////////////////////////////////////////
-            // edge 12 of triangle.
-            //////////////////////////////////////////////////////////////////
-            edge.set(this, v1, v2);
-            it = edges.find(edge);
-            if (it!=edges.end())
+        bool sameKey(const cHalfEdge& a_other) const
+        {
+            for (int i=0; i<6; i++)
             {
-                cVector3d n1 = cComputeSurfaceNormal(m_vertices->getLocalPos(m_triangles->getVertexIndex0((*it).m_triangle)),
-                                                     m_vertices->getLocalPos(m_triangles->getVertexIndex1((*it).m_triangle)),
-                                                     m_vertices->getLocalPos(m_triangles->getVertexIndex2((*it).m_triangle)));
+                if (m_key[i] != a_other.m_key[i]) { return (false); }
+            }
+            return (true);
+        }
+    };
 
+    // compute triangle normals and half-edges in parallel
+    m_triangleNormals.resize(numTriangles);
+    m_triangleNeighbors.assign(3 * numTriangles, -1);
+    vector<cHalfEdge> halfEdges(3 * numTriangles);
+    vector<unsigned char> valid(numTriangles, 0);
 
-                if (n1.length() > 0.0)
-                {
-                    if (cAngle(n0, n1) >= angleThresholdRad)
-                    {
-                        m_edges.push_back(edge);
-                    }
-                }
+    cThreadPool* pool = cThreadPool::getSharedThreadPool();
+    const unsigned int blockSize = 4096;
+    pool->parallelFor((numTriangles + blockSize - 1) / blockSize, [&](unsigned int a_block)
+    {
+        unsigned int last = cMin((a_block + 1) * blockSize, numTriangles);
+        for (unsigned int i=a_block * blockSize; i<last; i++)
+        {
+            computeTriangleNormal(i);
+            if (!m_triangles->getAllocated(i) || (m_triangleNormals[i].length() == 0.0)) { continue; }
+            valid[i] = 1;
 
-                // remove edge as we have already found it dual
-                edges.erase(it);
+            for (unsigned int k=0; k<3; k++)
+            {
+                const cVector3d& p0 = m_vertices->m_localPos[m_triangles->m_indices[3*i+k]];
+                const cVector3d& p1 = m_vertices->m_localPos[m_triangles->m_indices[3*i+((k+1)%3)]];
+                bool swap = (p1(0) < p0(0)) || ((p1(0) == p0(0)) && ((p1(1) < p0(1)) || ((p1(1) == p0(1)) && (p1(2) < p0(2)))));
+                const cVector3d& a = swap ? p1 : p0;
+                const cVector3d& b = swap ? p0 : p1;
+
+                cHalfEdge& halfEdge = halfEdges[3*i+k];
+                halfEdge.m_key[0] = a(0); halfEdge.m_key[1] = a(1); halfEdge.m_key[2] = a(2);
+                halfEdge.m_key[3] = b(0); halfEdge.m_key[4] = b(1); halfEdge.m_key[5] = b(2);
+                halfEdge.m_triangle = i;
+                halfEdge.m_edge = k;
             }
-            else
+        }
+    });
+
+    // discard degenerate and deallocated triangles
+    unsigned int numHalfEdges = 0;
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (!valid[i]) { continue; }
+        for (unsigned int k=0; k<3; k++)
+        {
+            halfEdges[numHalfEdges++] = halfEdges[3*i+k];
+        }
+    }
+    halfEdges.resize(numHalfEdges);
+
+    // sort blocks in parallel, then merge
+    unsigned int numBlocks = cMax(1u, cMin(numHalfEdges / blockSize, 16u));
+    vector<unsigned int> bounds(numBlocks + 1);
+    for (unsigned int i=0; i<=numBlocks; i++)
+    {
+        bounds[i] = (unsigned int)(((unsigned long long)numHalfEdges * i) / numBlocks);
+    }
+    pool->parallelFor(numBlocks, [&](unsigned int a_block)
+    {
+        sort(halfEdges.begin() + bounds[a_block], halfEdges.begin() + bounds[a_block+1]);
+    });
+    for (unsigned int width=1; width<numBlocks; width*=2)
+    {
+        unsigned int numMerges = (numBlocks + 2 * width - 1) / (2 * width);
+        pool->parallelFor(numMerges, [&](unsigned int a_merge)
+        {
+            unsigned int first = 2 * width * a_merge;
+            unsigned int middle = cMin(first + width, numBlocks);
+            unsigned int last = cMin(first + 2 * width, numBlocks);
+            if (middle < last)
             {
-                edges.insert(edge);
+                inplace_merge(halfEdges.begin() + bounds[first], 
+                              halfEdges.begin() + bounds[middle], 
+                              halfEdges.begin() + bounds[last]);
             }
+        });
+    }
+
+    // pair consecutive half-edges with identical end points
+    unsigned int i = 0;
+    while (i + 1 < numHalfEdges)
+    {
+        if (halfEdges[i].sameKey(halfEdges[i+1]))
+        {
+            const cHalfEdge& e0 = halfEdges[i];
+            const cHalfEdge& e1 = halfEdges[i+1];
+            m_triangleNeighbors[3*e0.m_triangle + e0.m_edge] = e1.m_triangle;
+            m_triangleNeighbors[3*e1.m_triangle + e1.m_edge] = e0.m_triangle;
+            i += 2;
+        }
+        else
+        {
+            i++;
         }
     }
 
-    // store all edges with no dual in the edge list
-    multiset<cEdge>::iterator it2;
-    for (it2 = edges.begin(); it2 != edges.end(); it2++)
+    m_triangleNeighborCounter = m_triangles->getModificationCounter();
+}
+
+
+//==============================================================================
+/*!
+    This method returns the triangle that shares a selected edge of a triangle.
+    Edge 0 joins vertices 0 and 1, edge 1 joins vertices 1 and 2, and edge 2 
+    joins vertices 2 and 0. The adjacency must first be computed by calling
+    \ref computeTriangleAdjacency() or \ref computeAllEdges().
+
+    \param  a_triangleIndex  Index number of triangle.
+    \param  a_edgeIndex      Edge number (0, 1, or 2).
+
+    \return Index number of the neighbouring triangle, or -1 if there is none.
+*/
+//==============================================================================
+int cMesh::getTriangleNeighbor(const unsigned int a_triangleIndex, const unsigned int a_edgeIndex) const
+{
+    if ((m_triangleNeighborCounter != m_triangles->getModificationCounter()) ||
+        (3 * a_triangleIndex + a_edgeIndex >= m_triangleNeighbors.size()) ||
+        (a_edgeIndex > 2))
     {
-        m_edges.push_back(*it2);
+        return (-1);
     }
+
+    return (m_triangleNeighbors[3 * a_triangleIndex + a_edgeIndex]);
 }
 
 
@@ -968,7 +2048,7 @@ void cMesh::clearAllEdges()
 {
     // clear all edges
     m_edges.clear();
-    m_displayListEdges.invalidate();
+    m_edgeBuffer.m_flagUpdate = true;
 }
 
 
@@ -1103,9 +2183,74 @@ void cMesh::render(cRenderOptions& a_options)
     {
         if (m_showTriangles)
         {
-            renderMesh(a_options);
+            selectLevelOfDetail(a_options)->renderMesh(a_options);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method selects the mesh used to render the triangles. The coarsest 
+    level of detail whose geometric error, projected at the point of the 
+    bounding sphere closest to the camera, is smaller than the pixel error of 
+    the camera is returned. The full-resolution mesh is used when no camera is 
+    available, for instance when rendering shadow maps. The material, texture 
+    and rendering flags of this mesh are copied to the selected level.
+
+    \param  a_options  Rendering options.
+
+    \return Mesh to render.
+*/
+//==============================================================================
+cMesh* cMesh::selectLevelOfDetail(cRenderOptions& a_options)
+{
+    m_lodRendered = 0;
+
+    // check if levels of detail are available
+    if ((m_lodMeshes.size() == 0) || (a_options.m_camera == NULL))
+    {
+        return (this);
+    }
+
+    double maxPixelError = a_options.m_camera->getLodPixelError();
+    if (maxPixelError <= 0.0)
+    {
+        return (this);
+    }
+
+    // closest point of the bounding sphere to the camera
+    cVector3d center = m_globalPos + m_globalRot * (0.5 * (m_boundaryBoxMin + m_boundaryBoxMax));
+    double radius = 0.5 * cDistance(m_boundaryBoxMin, m_boundaryBoxMax);
+    cVector3d direction = a_options.m_camera->getGlobalPos() - center;
+    double distance = direction.length();
+    if (distance <= radius)
+    {
+        return (this);
+    }
+    cVector3d point = center + (radius / distance) * direction;
+
+    // select coarsest level within the allowed screen-space error
+    for (int i=(int)(m_lodMeshes.size())-1; i>=0; i--)
+    {
+        if (a_options.m_camera->computeScreenSpaceError(point, m_lodErrors[i]) <= maxPixelError)
+        {
+            cMesh* lod = m_lodMeshes[i];
+            lod->m_material = m_material;
+            lod->m_texture = m_texture;
+            lod->m_normalMap = m_normalMap;
+            lod->m_shaderProgram = m_shaderProgram;
+            lod->m_useMaterialProperty = m_useMaterialProperty;
+            lod->m_useTextureMapping = m_useTextureMapping;
+            lod->m_useVertexColors = m_useVertexColors;
+            lod->m_useDisplayList = m_useDisplayList;
+
+            m_lodRendered = i + 1;
+            return (lod);
         }
     }
+
+    return (this);
 }
 
 
@@ -1128,6 +2273,38 @@ void cMesh::renderNormals(cRenderOptions& a_options)
         return;
     }
 
+    // rebuild vertex buffer if the geometry has changed
+    if (getOverlayBufferNeedsUpdate(m_normalBuffer))
+    {
+        std::vector<float>& vertices = m_normalBuffer.m_vertexData;
+        vertices.clear();
+        vertices.reserve(18 * numtriangles);
+
+        for(unsigned int i=0; i<numtriangles; i++) 
+        {
+            if (m_triangles->getAllocated(i))
+            {
+                for (unsigned int j=0; j<3; j++)
+                {
+                    unsigned int index = m_triangles->m_indices[3*i+j];
+                    cVector3d v = m_vertices->getLocalPos(index);
+                    cVector3d n = m_vertices->getNormal(index);
+                    n.mul(m_normalsLength);
+                    n.add(v);
+
+                    vertices.push_back((float)v(0));
+                    vertices.push_back((float)v(1));
+                    vertices.push_back((float)v(2));
+                    vertices.push_back((float)n(0));
+                    vertices.push_back((float)n(1));
+                    vertices.push_back((float)n(2));
+                }
+            }
+        }
+
+        updateOverlayBuffer(m_normalBuffer);
+    }
+
     // disable lighting
     glDisable(GL_LIGHTING);
 
@@ -1138,39 +2315,7 @@ void cMesh::renderNormals(cRenderOptions& a_options)
     glColor4fv( (const float *)&m_normalsColor);
 
     // render normals
-    glBegin(GL_LINES);
-    for(unsigned int i=0; i<numtriangles; i++) 
-    {
-        if (m_triangles->getAllocated(i))
-        {
-            cVector3d v, n;
-
-            // normal 0
-            v = m_vertices->getLocalPos(m_triangles->getVertexIndex0(i));
-            n = m_vertices->getNormal(m_triangles->getVertexIndex0(i));
-            glVertex3d(v(0) ,v(1) ,v(2) );
-            n.mul(m_normalsLength);
-            n.add(v);
-            glVertex3d(n(0) ,n(1) ,n(2) );
-
-            // normal 1
-            v = m_vertices->getLocalPos(m_triangles->getVertexIndex1(i));
-            n = m_vertices->getNormal(m_triangles->getVertexIndex1(i));
-            glVertex3d(v(0) ,v(1) ,v(2) );
-            n.mul(m_normalsLength);
-            n.add(v);
-            glVertex3d(n(0) ,n(1) ,n(2) );
-
-            // normal 2
-            v = m_vertices->getLocalPos(m_triangles->getVertexIndex2(i));
-            n = m_vertices->getNormal(m_triangles->getVertexIndex2(i));
-            glVertex3d(v(0) ,v(1) ,v(2) );
-            n.mul(m_normalsLength);
-            n.add(v);
-            glVertex3d(n(0) ,n(1) ,n(2) );
-        }
-    }
-    glEnd();
+    renderOverlayBuffer(m_normalBuffer, GL_LINES, 0, m_normalBuffer.m_numVertices);
 
     // enable lighting
     glEnable(GL_LIGHTING);
@@ -1205,79 +2350,77 @@ void cMesh::renderTangents(cRenderOptions& a_options)
         return;
     }
 
+    // rebuild vertex buffer if the geometry has changed. tangents are stored 
+    // in the first half of the buffer, bitangents in the second half.
+    if (getOverlayBufferNeedsUpdate(m_tangentBuffer))
+    {
+        unsigned int numAllocated = 0;
+        for(unsigned int i=0; i<numtriangles; i++) 
+        {
+            if (m_triangles->getAllocated(i))
+            {
+                numAllocated++;
+            }
+        }
+
+        std::vector<float>& vertices = m_tangentBuffer.m_vertexData;
+        vertices.resize(36 * numAllocated);
+        float* tangents = vertices.data();
+        float* bitangents = tangents + 18 * numAllocated;
+
+        for(unsigned int i=0; i<numtriangles; i++) 
+        {
+            if (m_triangles->getAllocated(i))
+            {
+                for (unsigned int j=0; j<3; j++)
+                {
+                    unsigned int index = m_triangles->m_indices[3*i+j];
+                    cVector3d p = m_vertices->getLocalPos(index);
+                    cVector3d n = m_vertices->getNormal(index);
+                    cVector3d u = m_vertices->getTangent(index);
+                    cVector3d v = m_vertices->getBitangent(index);
+
+                    n.mul(-0.01 * m_normalsLength);
+                    p.add(n); // offset point to be above triangle
+                    u.mul(m_normalsLength);
+                    u.add(p);
+                    v.mul(m_normalsLength);
+                    v.add(p);
+
+                    *(tangents++) = (float)p(0);
+                    *(tangents++) = (float)p(1);
+                    *(tangents++) = (float)p(2);
+                    *(tangents++) = (float)u(0);
+                    *(tangents++) = (float)u(1);
+                    *(tangents++) = (float)u(2);
+
+                    *(bitangents++) = (float)p(0);
+                    *(bitangents++) = (float)p(1);
+                    *(bitangents++) = (float)p(2);
+                    *(bitangents++) = (float)v(0);
+                    *(bitangents++) = (float)v(1);
+                    *(bitangents++) = (float)v(2);
+                }
+            }
+        }
+
+        updateOverlayBuffer(m_tangentBuffer);
+    }
+
     // disable lighting
     glDisable(GL_LIGHTING);
 
     // set line width
     glLineWidth(1.0);
 
-    // render normals slightly above triangle surface
-    glBegin(GL_LINES);
-    for(unsigned int i=0; i<numtriangles; i++) 
-    {
-        if (m_triangles->getAllocated(i))
-        {
-            cVector3d p, n, u, v;
-
-            // tangent and bitangent 0
-            p = m_vertices->getLocalPos(m_triangles->getVertexIndex0(i));
-            n = m_vertices->getNormal(m_triangles->getVertexIndex0(i));
-            u = m_vertices->getTangent(m_triangles->getVertexIndex0(i));
-            v = m_vertices->getBitangent(m_triangles->getVertexIndex0(i));
-
-            n.mul(-0.01 * m_normalsLength);
-            p.add(n); // offset point to be above triangle
-            glColor3f(1.0, 0.0, 0.0);
-            glVertex3d(p(0) ,p(1) ,p(2) );
-            u.mul(m_normalsLength);
-            u.add(p);
-            glVertex3d(u(0), u(1), u(2));
-            glColor3f(0.0, 1.0, 0.0);
-            glVertex3d(p(0) ,p(1) ,p(2) );
-            v.mul(m_normalsLength);
-            v.add(p);
-            glVertex3d(v(0), v(1), v(2));
-
-            // tangent and bitangent 1
-            p = m_vertices->getLocalPos(m_triangles->getVertexIndex1(i));
-            n = m_vertices->getNormal(m_triangles->getVertexIndex1(i));
-            u = m_vertices->getTangent(m_triangles->getVertexIndex1(i));
-            v = m_vertices->getBitangent(m_triangles->getVertexIndex1(i));
-
-            n.mul(-0.01 * m_normalsLength);
-            p.add(n); // offset point to be above triangle
-            glColor3f(1.0, 0.0, 0.0);
-            glVertex3d(p(0) ,p(1) ,p(2) );
-            u.mul(m_normalsLength);
-            u.add(p);
-            glVertex3d(u(0), u(1), u(2));
-            glColor3f(0.0, 1.0, 0.0);
-            glVertex3d(p(0) ,p(1) ,p(2) );
-            v.mul(m_normalsLength);
-            v.add(p);
-            glVertex3d(v(0), v(1), v(2));
-
-            // tangent and bitangent 2
-            p = m_vertices->getLocalPos(m_triangles->getVertexIndex2(i));
-            n = m_vertices->getNormal(m_triangles->getVertexIndex2(i));
-            u = m_vertices->getTangent(m_triangles->getVertexIndex2(i));
-            v = m_vertices->getBitangent(m_triangles->getVertexIndex2(i));
-
-            n.mul(-0.01 * m_normalsLength);
-            p.add(n); // offset point to be above triangle
-            glColor3f(1.0, 0.0, 0.0);
-            glVertex3d(p(0) ,p(1) ,p(2) );
-            u.mul(m_normalsLength);
-            u.add(p);
-            glVertex3d(u(0), u(1), u(2));
-            glColor3f(0.0, 1.0, 0.0);
-            glVertex3d(p(0) ,p(1) ,p(2) );
-            v.mul(m_normalsLength);
-            v.add(p);
-            glVertex3d(v(0), v(1), v(2));
-        }
-    }
-    glEnd();
+    // render tangents and bitangents
+    unsigned int count = m_tangentBuffer.m_numVertices / 2;
+
+    glColor3f(1.0, 0.0, 0.0);
+    renderOverlayBuffer(m_tangentBuffer, GL_LINES, 0, count);
+
+    glColor3f(0.0, 1.0, 0.0);
+    renderOverlayBuffer(m_tangentBuffer, GL_LINES, count, count);
 
     // enable lighting
     glEnable(GL_LIGHTING);
@@ -1300,75 +2443,233 @@ void cMesh::renderEdges(cRenderOptions& a_options)
 
     if (m_edges.size() == 0) { return; }
 
+    /////////////////////////////////////////////////////////////////////////
+    // UPDATE VERTEX BUFFER
+    /////////////////////////////////////////////////////////////////////////
+
+    // each edge is stored as a degenerate triangle so that polygon offset 
+    // can be applied when rendering in line mode
+    if (getOverlayBufferNeedsUpdate(m_edgeBuffer))
+    {
+        std::vector<float>& vertices = m_edgeBuffer.m_vertexData;
+        vertices.clear();
+        vertices.reserve(9 * m_edges.size());
+
+        vector<cEdge>::iterator i;
+        for(i = m_edges.begin(); i != m_edges.end(); i++)
+        {
+            cVector3d v0 = (*i).m_parent->m_vertices->getLocalPos((*i).m_vertex0);
+            cVector3d v1 = (*i).m_parent->m_vertices->getLocalPos((*i).m_vertex1);
+
+            vertices.push_back((float)v0(0));
+            vertices.push_back((float)v0(1));
+            vertices.push_back((float)v0(2));
+            for (unsigned int k=0; k<2; k++)
+            {
+                vertices.push_back((float)v1(0));
+                vertices.push_back((float)v1(1));
+                vertices.push_back((float)v1(2));
+            }
+        }
+
+        updateOverlayBuffer(m_edgeBuffer);
+    }
+
+
     /////////////////////////////////////////////////////////////////////////
     // SET PROPERTIES
     /////////////////////////////////////////////////////////////////////////
 
-    // turn-off lighting
-    glDisable(GL_LIGHTING);
-    
-    // setup color for rendering line edges
-    m_edgeLineColor.render();
+    // turn-off lighting
+    glDisable(GL_LIGHTING);
+    
+    // setup color for rendering line edges
+    m_edgeLineColor.render();
+
+    // width of line edges
+    glLineWidth((GLfloat)m_edgeLineWidth);
+
+    // render all edges as triangles so that we can perform polygon offset
+    glEnable(GL_POLYGON_OFFSET_LINE);
+    glPolygonOffset (-10.0f, -100.0f);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+    // disable culling
+    glDisable(GL_CULL_FACE);
+
+
+    /////////////////////////////////////////////////////////////////////////
+    // RENDER LINES
+    /////////////////////////////////////////////////////////////////////////
+
+    // render all lines
+    renderOverlayBuffer(m_edgeBuffer, GL_TRIANGLES, 0, m_edgeBuffer.m_numVertices);
+
+
+    /////////////////////////////////////////////////////////////////////////
+    // FINALIZE
+    /////////////////////////////////////////////////////////////////////////
+
+    if (m_cullingEnabled)
+    {
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_BACK);
+    }
+    else
+    {
+        glDisable(GL_CULL_FACE);
+    }
+
+    // restore OpenGL properties
+    glPolygonOffset(0.0, 0.0);
+    glDisable(GL_POLYGON_OFFSET_LINE);
+    glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
+    glEnable(GL_LIGHTING);
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if an overlay buffer needs to be rebuilt, 
+    either because it was invalidated or because the vertex data of the mesh
+    has been modified since the buffer was last filled.
+
+    \param  a_overlay  Overlay buffer.
+
+    \return __true__ if the buffer must be rebuilt, __false__ otherwise.
+*/
+//==============================================================================
+bool cMesh::getOverlayBufferNeedsUpdate(const cMeshOverlayBuffer& a_overlay) const
+{
+    return (a_overlay.m_flagUpdate || 
+            (a_overlay.m_vertexCounter != m_vertices->getModificationCounter()));
+}
+
+
+//==============================================================================
+/*!
+    This method uploads the vertices of an overlay buffer to the GPU. The 
+    OpenGL buffer is created the first time this method is called, and its 
+    storage is reused as long as the number of vertices does not change.
+
+    \param  a_overlay   Overlay buffer, whose vertex data has been filled.
+*/
+//==============================================================================
+void cMesh::updateOverlayBuffer(cMeshOverlayBuffer& a_overlay)
+{
+    const std::vector<float>& vertices = a_overlay.m_vertexData;
+
+#ifdef C_USE_OPENGL
+
+    if (a_overlay.m_buffer == (GLuint)(-1))
+    {
+        glGenBuffers(1, &a_overlay.m_buffer);
+        a_overlay.m_bufferSize = 0;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, a_overlay.m_buffer);
+    if (vertices.size() > 0)
+    {
+        if (vertices.size() == a_overlay.m_bufferSize)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), &(vertices[0]));
+        }
+        else
+        {
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &(vertices[0]), GL_DYNAMIC_DRAW);
+            a_overlay.m_bufferSize = (unsigned int)(vertices.size());
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+#endif
+
+    a_overlay.m_numVertices = (unsigned int)(vertices.size() / 3);
+    a_overlay.m_vertexCounter = m_vertices->getModificationCounter();
+    a_overlay.m_flagUpdate = false;
+}
+
+
+//==============================================================================
+/*!
+    This method draws a range of vertices from an overlay buffer.
+
+    \param  a_overlay  Overlay buffer.
+    \param  a_mode     OpenGL primitive type (__GL_LINES__ or __GL_TRIANGLES__).
+    \param  a_first    Index of the first vertex.
+    \param  a_count    Number of vertices.
+*/
+//==============================================================================
+void cMesh::renderOverlayBuffer(const cMeshOverlayBuffer& a_overlay, 
+                                const GLenum a_mode,
+                                const unsigned int a_first,
+                                const unsigned int a_count)
+{
+#ifdef C_USE_OPENGL
+
+    if ((a_overlay.m_buffer == (GLuint)(-1)) || (a_count == 0))
+    {
+        return;
+    }
 
-    // width of line edges
-    glLineWidth((GLfloat)m_edgeLineWidth);
+    glBindBuffer(GL_ARRAY_BUFFER, a_overlay.m_buffer);
 
-    // render all edges as triangles so that we can perform polygon offset
-    glEnable(GL_POLYGON_OFFSET_LINE);
-    glPolygonOffset (-10.0f, -100.0f);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    glEnableVertexAttribArray(C_VB_POSITION);
+    glVertexAttribPointer(C_VB_POSITION, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
 
-    // disable culling
-    glDisable(GL_CULL_FACE);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, (void*)0);
 
+    glDrawArrays(a_mode, a_first, a_count);
 
-    /////////////////////////////////////////////////////////////////////////
-    // RENDER LINES
-    /////////////////////////////////////////////////////////////////////////
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableVertexAttribArray(C_VB_POSITION);
 
-    // render all lines
-    if (!m_displayListEdges.render(m_useDisplayList))
-    {
-        m_displayListEdges.begin(m_useDisplayList);
-   
-        glBegin(GL_TRIANGLES);
-            vector<cEdge>::iterator i;
-            for(i = m_edges.begin(); i != m_edges.end(); i++)
-            {
-                cVector3d v0 = (*i).m_parent->m_vertices->getLocalPos((*i).m_vertex0);
-                cVector3d v1 = (*i).m_parent->m_vertices->getLocalPos((*i).m_vertex1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-                glVertex3dv(&v0(0));
-                glVertex3dv(&v1(0));
-                glVertex3dv(&v1(0));
-            }
-        glEnd();
+#endif
+}
 
-        m_displayListEdges.end(true);
-    }
+
+//==============================================================================
+/*!
+    This method requests the edge, normal and tangent buffers to be rebuilt 
+    the next time they are rendered.
+*/
+//==============================================================================
+void cMesh::invalidateOverlayBuffers()
+{
+    m_edgeBuffer.m_flagUpdate = true;
+    m_normalBuffer.m_flagUpdate = true;
+    m_tangentBuffer.m_flagUpdate = true;
+}
 
 
-    /////////////////////////////////////////////////////////////////////////
-    // FINALIZE
-    /////////////////////////////////////////////////////////////////////////
+//==============================================================================
+/*!
+    This method releases the edge, normal and tangent buffers from GPU memory.
+*/
+//==============================================================================
+void cMesh::deleteOverlayBuffers()
+{
+#ifdef C_USE_OPENGL
 
-    if (m_cullingEnabled)
-    {
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-    }
-    else
+    cMeshOverlayBuffer* overlays[3] = { &m_edgeBuffer, &m_normalBuffer, &m_tangentBuffer };
+    for (unsigned int i=0; i<3; i++)
     {
-        glDisable(GL_CULL_FACE);
+        if (overlays[i]->m_buffer != (GLuint)(-1))
+        {
+            glDeleteBuffers(1, &(overlays[i]->m_buffer));
+            overlays[i]->m_buffer = (GLuint)(-1);
+            overlays[i]->m_bufferSize = 0;
+        }
     }
 
-    // restore OpenGL properties
-    glPolygonOffset(0.0, 0.0);
-    glDisable(GL_POLYGON_OFFSET_LINE);
-    glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
-    glEnable(GL_LIGHTING);
-
 #endif
+
+    invalidateOverlayBuffers();
 }
 
 
@@ -1407,91 +2708,8 @@ void cMesh::renderMesh(cRenderOptions& a_options)
     glDisable(GL_COLOR_MATERIAL);
 
 
-    //--------------------------------------------------------------------------
-    // RENDER MATERIAL
-    //--------------------------------------------------------------------------
-
-    // render material properties if enabled
-    if (m_useMaterialProperty && a_options.m_render_materials)
-    {
-        m_material->render(a_options);
-    }
-
-    //--------------------------------------------------------------------------
-    // RENDER TEXTURE
-    //--------------------------------------------------------------------------
-
-    // check if texture is available
-    if (m_texture == nullptr)
-    {
-        m_useTextureMapping = false;
-    }
-
-    // render texture if enabled
-    if ((m_texture != nullptr) && (m_useTextureMapping) && (a_options.m_render_materials))
-    {
-        m_texture->renderInitialize(a_options);
-    }
-
-
-    //--------------------------------------------------------------------------
-    // RENDER VERTEX COLORS
-    //--------------------------------------------------------------------------
-    /*
-    if vertex colors (m_useVertexColors) is enabled, we render the colors 
-    defined for each individual vertex.
-    
-    if material properties (m_useMaterialProperty) has also been enabled, 
-    then we combine vertex colors and materials together with OpenGL lighting 
-    enabled.
-    
-    if material properties are disabled then lighting is disabled and
-    we use the pure color defined at each vertex to render the object
-    */
-
-    if (m_useVertexColors && a_options.m_render_materials)
-    {
-        // Clear the effects of material properties...
-        if (m_useMaterialProperty || a_options.m_rendering_shadow)
-        {
-            // enable vertex colors
-            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
-            glEnable(GL_COLOR_MATERIAL);
-            glEnable(GL_LIGHTING);
-        }
-        else
-        {
-            glDisable(GL_LIGHTING);
-        }
-    }
-    else
-    {
-        glDisable(GL_COLOR_MATERIAL);
-    }
-
-
-    //--------------------------------------------------------------------------
-    // FOR OBJECTS WITH NO DEFINED COLOR/MATERIAL SETTINGS
-    //--------------------------------------------------------------------------
-    /*
-    A default color for objects that don't have vertex colors or
-    material properties (otherwise they're invisible)...
-    If texture mapping is enabled, then just turn off lighting
-    */
-
-    if (((!m_useVertexColors) && (!m_useMaterialProperty)) && a_options.m_render_materials)
-    {
-        if (m_useTextureMapping && !a_options.m_rendering_shadow)
-        {
-            glDisable(GL_LIGHTING);
-        }
-        else
-        {
-            glEnable(GL_COLOR_MATERIAL);
-            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
-            glColor4f(1.0,1.0,1.0,1.0);
-        }
-    }
+    // set material, texture and color states
+    renderMaterialInitialize(a_options);
 
 
     //--------------------------------------------------------------------------
@@ -1744,6 +2962,127 @@ void cMesh::renderMesh(cRenderOptions& a_options)
     // RESTORE OPENGL
     //--------------------------------------------------------------------------
 
+    renderMaterialFinalize(a_options);
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method sets the OpenGL states used to render the triangles of the 
+    mesh: material properties, texture, vertex colors, and a default color for 
+    meshes with neither material nor vertex colors.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cMesh::renderMaterialInitialize(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    //--------------------------------------------------------------------------
+    // RENDER MATERIAL
+    //--------------------------------------------------------------------------
+
+    // render material properties if enabled
+    if (m_useMaterialProperty && a_options.m_render_materials)
+    {
+        m_material->render(a_options);
+    }
+
+    //--------------------------------------------------------------------------
+    // RENDER TEXTURE
+    //--------------------------------------------------------------------------
+
+    // check if texture is available
+    if (m_texture == nullptr)
+    {
+        m_useTextureMapping = false;
+    }
+
+    // render texture if enabled
+    if ((m_texture != nullptr) && (m_useTextureMapping) && (a_options.m_render_materials))
+    {
+        m_texture->renderInitialize(a_options);
+    }
+
+
+    //--------------------------------------------------------------------------
+    // RENDER VERTEX COLORS
+    //--------------------------------------------------------------------------
+    /*
+    if vertex colors (m_useVertexColors) is enabled, we render the colors 
+    defined for each individual vertex.
+    
+    if material properties (m_useMaterialProperty) has also been enabled, 
+    then we combine vertex colors and materials together with OpenGL lighting 
+    enabled.
+    
+    if material properties are disabled then lighting is disabled and
+    we use the pure color defined at each vertex to render the object
+    */
+
+    if (m_useVertexColors && a_options.m_render_materials)
+    {
+        // Clear the effects of material properties...
+        if (m_useMaterialProperty || a_options.m_rendering_shadow)
+        {
+            // enable vertex colors
+            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+            glEnable(GL_COLOR_MATERIAL);
+            glEnable(GL_LIGHTING);
+        }
+        else
+        {
+            glDisable(GL_LIGHTING);
+        }
+    }
+    else
+    {
+        glDisable(GL_COLOR_MATERIAL);
+    }
+
+
+    //--------------------------------------------------------------------------
+    // FOR OBJECTS WITH NO DEFINED COLOR/MATERIAL SETTINGS
+    //--------------------------------------------------------------------------
+    /*
+    A default color for objects that don't have vertex colors or
+    material properties (otherwise they're invisible)...
+    If texture mapping is enabled, then just turn off lighting
+    */
+
+    if (((!m_useVertexColors) && (!m_useMaterialProperty)) && a_options.m_render_materials)
+    {
+        if (m_useTextureMapping && !a_options.m_rendering_shadow)
+        {
+            glDisable(GL_LIGHTING);
+        }
+        else
+        {
+            glEnable(GL_COLOR_MATERIAL);
+            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+            glColor4f(1.0,1.0,1.0,1.0);
+        }
+    }
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method restores the OpenGL states modified by 
+    \ref renderMaterialInitialize().
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cMesh::renderMaterialFinalize(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
     // turn off texture rendering
     if ((m_texture != nullptr) && (m_useTextureMapping))
     {
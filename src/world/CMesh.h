@@ -91,6 +91,82 @@ struct cEdge;
 
 //------------------------------------------------------------------------------
 
+//==============================================================================
+/*!
+    \struct     cMeshOptimizationReport
+    \ingroup    world
+
+    \brief
+    This structure reports the result of a mesh optimization.
+*/
+//==============================================================================
+struct cMeshOptimizationReport
+{
+    //! Constructor of cMeshOptimizationReport.
+    cMeshOptimizationReport() { m_numVerticesBefore = 0; m_numVerticesAfter = 0; m_numTrianglesBefore = 0; m_numTrianglesAfter = 0; }
+
+    //! Number of vertices before optimization.
+    unsigned int m_numVerticesBefore;
+
+    //! Number of vertices after optimization.
+    unsigned int m_numVerticesAfter;
+
+    //! Number of triangles before optimization.
+    unsigned int m_numTrianglesBefore;
+
+    //! Number of triangles after optimization.
+    unsigned int m_numTrianglesAfter;
+};
+
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \struct     cMeshOverlayBuffer
+    \ingroup    world
+
+    \brief
+    This structure stores the vertices of a debug overlay in GPU memory.
+
+    \details
+    Edges, normals and tangents are drawn from single-precision line vertices 
+    held in an OpenGL vertex buffer. The buffer is rebuilt only when the mesh 
+    geometry or the overlay properties change. Meshes that deform every frame 
+    therefore rebuild their overlays every frame; the vertex data and the 
+    OpenGL buffer are reused, so that these updates do not allocate memory. \n
+
+    Overlays are drawn with the fixed-function pipeline, like the triangles 
+    of meshes without a shader program: positions are bound both as a generic 
+    attribute and as a client-state vertex array, and colors and line widths 
+    are set with __glColor__ and __glLineWidth__.
+*/
+//==============================================================================
+struct cMeshOverlayBuffer
+{
+    //! Constructor of cMeshOverlayBuffer.
+    cMeshOverlayBuffer() { m_buffer = (GLuint)(-1); m_bufferSize = 0; m_numVertices = 0; m_vertexCounter = 0; m_flagUpdate = true; }
+
+    //! Vertex positions (three floats per vertex), kept to avoid reallocations when the buffer is rebuilt.
+    std::vector<float> m_vertexData;
+
+    //! OpenGL vertex buffer.
+    GLuint m_buffer;
+
+    //! Size of the OpenGL vertex buffer in floats.
+    unsigned int m_bufferSize;
+
+    //! Number of vertices stored in the buffer.
+    unsigned int m_numVertices;
+
+    //! Modification counter of the vertex array when the buffer was filled.
+    unsigned int m_vertexCounter;
+
+    //! If __true__, the buffer must be rebuilt before rendering.
+    bool m_flagUpdate;
+};
+
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     \class      cMesh
@@ -107,6 +183,8 @@ struct cEdge;
 //==============================================================================
 class cMesh : public cGenericObject
 {
+    friend class cMultiMesh;
+
     //--------------------------------------------------------------------------
     // CONSTRUCTOR & DESTRUCTOR:
     //--------------------------------------------------------------------------
@@ -185,6 +263,12 @@ public:
     //! This method sets the color of each vertex.
     void setVertexColor(const cColorf& a_color);
 
+    //! This method enables or disables the storage of global vertex positions.
+    void setUseGlobalPosData(const bool a_useGlobalPosData) { m_vertices->setUseGlobalPosData(a_useGlobalPosData); }
+
+    //! This method returns __true__ if global vertex positions are stored.
+    bool getUseGlobalPosData() const { return (m_vertices->getUseGlobalPosData()); }
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - TRIANGLES
@@ -239,6 +323,12 @@ public:
     //! This method clears all edges
     void clearAllEdges();
 
+    //! This method builds the list of neighbouring triangles across each triangle edge.
+    void computeTriangleAdjacency();
+
+    //! This method returns the triangle sharing a selected edge of a triangle, or -1 if there is none.
+    int getTriangleNeighbor(const unsigned int a_triangleIndex, const unsigned int a_edgeIndex) const;
+
     //! This method enables or disables the rendering of edges.
     void setShowEdges(const bool a_showEdges) { m_showEdges = a_showEdges; }
 
@@ -274,12 +364,18 @@ public:
     //! This method computes all triangle normals.
     void computeAllNormals();
 
+    //! This method recomputes the vertex normals around a set of modified vertices.
+    void computeNormals(const std::vector<unsigned int>& a_modifiedVertices);
+
     //! This method reverses all surface normals.
     virtual void reverseAllNormals();
 
     //! This method computes the normal matrix vectors for all triangles.
     void computeBTN();
 
+    //! This method builds the list of triangles adjacent to each vertex.
+    void computeVertexTriangleAdjacency();
+
     //! This method enables or disables the rendering of tangents and bi-tangents.
     void setShowTangents(const bool a_showTangents) { m_showTangents = a_showTangents; }
 
@@ -317,6 +413,56 @@ public:
     virtual cVector3d getCenterOfMass();
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - OPTIMIZATION:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method merges vertices that share the same position and attributes.
+    unsigned int weldVertices(const double a_tolerance = 0.0);
+
+    //! This method removes triangles that have no area.
+    unsigned int removeDegenerateTriangles(const double a_minArea = 0.0);
+
+    //! This method reorders triangles to improve the reuse of the GPU post-transform vertex cache.
+    void optimizeVertexCache(const unsigned int a_cacheSize = 32);
+
+    //! This method reorders vertices in the order in which they are first used by triangles.
+    void optimizeVertexFetch();
+
+    //! This method welds vertices, removes degenerate triangles and reorders the mesh for rendering.
+    cMeshOptimizationReport optimize(const double a_weldTolerance = 0.0);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - LEVEL OF DETAIL:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method reduces the number of triangles by quadric error edge collapses and returns the resulting geometric error.
+    double simplify(const unsigned int a_numTriangles);
+
+    //! This method builds simplified versions of this mesh that are used for graphic rendering only.
+    void buildLevelsOfDetail(const unsigned int a_numLevels = 3, const double a_reductionFactor = 0.5);
+
+    //! This method deletes all levels of detail.
+    void clearLevelsOfDetail();
+
+    //! This method returns the number of levels of detail, excluding the full-resolution mesh.
+    unsigned int getNumLevelsOfDetail() const { return ((unsigned int)(m_lodMeshes.size())); }
+
+    //! This method returns a level of detail. Level 0 is the first simplified mesh.
+    cMesh* getLevelOfDetail(const unsigned int a_level) const { return ((a_level < m_lodMeshes.size()) ? m_lodMeshes[a_level] : NULL); }
+
+    //! This method returns the geometric error of a level of detail, expressed in local units.
+    double getLevelOfDetailError(const unsigned int a_level) const { return ((a_level < m_lodErrors.size()) ? m_lodErrors[a_level] : 0.0); }
+
+    //! This method returns the level of detail used during the last rendering pass (0 for the full-resolution mesh).
+    unsigned int getRenderedLevelOfDetail() const { return (m_lodRendered); }
+
+
     //--------------------------------------------------------------------------
     // PROTECTED METHODS - INTERNAL
     //--------------------------------------------------------------------------
@@ -335,9 +481,33 @@ protected:
     //! This method draws all edges of the mesh.
     virtual void renderEdges(cRenderOptions& a_options);
 
+    //! This method returns __true__ if an overlay buffer must be rebuilt.
+    bool getOverlayBufferNeedsUpdate(const cMeshOverlayBuffer& a_overlay) const;
+
+    //! This method uploads the vertices of an overlay buffer to the GPU.
+    void updateOverlayBuffer(cMeshOverlayBuffer& a_overlay);
+
+    //! This method draws a range of vertices from an overlay buffer.
+    void renderOverlayBuffer(const cMeshOverlayBuffer& a_overlay, const GLenum a_mode, const unsigned int a_first, const unsigned int a_count);
+
+    //! This method requests all overlay buffers to be rebuilt.
+    void invalidateOverlayBuffers();
+
+    //! This method releases the overlay buffers from GPU memory.
+    void deleteOverlayBuffers();
+
     //! This method renders all triangles, material and texture properties.
     virtual void renderMesh(cRenderOptions& a_options);
 
+    //! This method selects the mesh used to render triangles according to the screen-space error of each level of detail.
+    cMesh* selectLevelOfDetail(cRenderOptions& a_options);
+
+    //! This method sets the OpenGL material, texture and color states used to render the triangles of the mesh.
+    void renderMaterialInitialize(cRenderOptions& a_options);
+
+    //! This method restores the OpenGL states modified by \ref renderMaterialInitialize().
+    void renderMaterialFinalize(cRenderOptions& a_options);
+
     //! This method updates the global position of each vertex.
     virtual void updateGlobalPositions(const bool a_frameOnly);
 
@@ -359,6 +529,15 @@ protected:
         const cVector3d& a_toolVel,
         const unsigned int a_IDN);
 
+    //! This method rebuilds the vertex to triangle adjacency if the triangles have changed.
+    bool updateVertexTriangleAdjacency();
+
+    //! This method computes the unit surface normal of a triangle.
+    void computeTriangleNormal(const unsigned int a_triangleIndex);
+
+    //! This method computes the normal of a vertex from the normals of its adjacent triangles.
+    void computeVertexNormal(const unsigned int a_vertexIndex);
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS - DISPLAY PROPERTIES:
@@ -384,8 +563,55 @@ protected:
     //! Width of edge lines.
     double m_edgeLineWidth;
 
-    //! Display list for edges.
-    cDisplayList m_displayListEdges;
+    //! Vertex buffer for edges.
+    cMeshOverlayBuffer m_edgeBuffer;
+
+    //! Vertex buffer for normals.
+    cMeshOverlayBuffer m_normalBuffer;
+
+    //! Vertex buffer for tangents and bitangents.
+    cMeshOverlayBuffer m_tangentBuffer;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - ADJACENCY:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Offset of the first adjacent triangle of each vertex in \ref m_vertexTriangles. The last entry holds the total count.
+    std::vector<unsigned int> m_vertexTriangleOffsets;
+
+    //! Triangles adjacent to each vertex, stored consecutively for each vertex in increasing order.
+    std::vector<unsigned int> m_vertexTriangles;
+
+    //! Modification counter of the triangle array when the adjacency was computed.
+    unsigned int m_vertexTriangleCounter;
+
+    //! Unit surface normal of each triangle from the last normal computation.
+    std::vector<cVector3d> m_triangleNormals;
+
+    //! Triangle sharing each edge (v0-v1, v1-v2, v2-v0) of each triangle, or -1 if there is none.
+    std::vector<int> m_triangleNeighbors;
+
+    //! Modification counter of the triangle array when the triangle neighbours were computed.
+    unsigned int m_triangleNeighborCounter;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - LEVEL OF DETAIL:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Simplified meshes, ordered from finest to coarsest.
+    std::vector<cMesh*> m_lodMeshes;
+
+    //! Geometric error of each simplified mesh, expressed in local units.
+    std::vector<double> m_lodErrors;
+
+    //! Level of detail used during the last rendering pass (0 for the full-resolution mesh).
+    unsigned int m_lodRendered;
 
 
     //--------------------------------------------------------------------------
@@ -50,11 +50,14 @@
 #include "files/CFileModel3DS.h"
 #include "files/CFileModelOBJ.h"
 #include "files/CFileModelSTL.h"
+#include "files/CFileModelCMM.h"
 #include "math/CMaths.h"
 //------------------------------------------------------------------------------
 #include <float.h>
 #include <algorithm>
 #include <set>
+#include <map>
+#include <tuple>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -63,6 +66,10 @@ using namespace std;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+bool g_meshLoaderShouldOptimize = false;
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     Constructor of cMultiMesh.
@@ -72,6 +79,10 @@ cMultiMesh::cMultiMesh()
 {
     // create array of mesh primitives
     m_meshes = new vector<cMesh*>;
+
+    // batching is disabled by default
+    m_useBatching = false;
+    m_flagBatchUpdate = true;
 }
 
 
@@ -82,6 +93,9 @@ cMultiMesh::cMultiMesh()
 //==============================================================================
 cMultiMesh::~cMultiMesh()
 {
+    // delete batches
+    clearBatches();
+
     // delete all meshes
     deleteAllMeshes();
 
@@ -303,6 +317,9 @@ void cMultiMesh::setShowEnabled(const bool a_show,
 void cMultiMesh::setUseTransparency(const bool a_useTransparency,
                                     const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setUseTransparency(a_useTransparency, a_affectChildren);
 
@@ -361,6 +378,9 @@ void cMultiMesh::setTransparencyLevel(const float a_level,
 void cMultiMesh::setWireMode(const bool a_showWireMode, 
                              const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setWireMode(a_showWireMode, a_affectChildren);
 
@@ -385,6 +405,9 @@ void cMultiMesh::setWireMode(const bool a_showWireMode,
 void cMultiMesh::setUseCulling(const bool a_useCulling, 
                                const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setUseCulling(a_useCulling, a_affectChildren);
 
@@ -410,6 +433,9 @@ void cMultiMesh::setUseCulling(const bool a_useCulling,
 void cMultiMesh::setUseVertexColors(const bool a_useColors, 
                                     const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setUseVertexColors(a_useColors, a_affectChildren);
 
@@ -507,6 +533,9 @@ void cMultiMesh::markForUpdate(const bool a_affectChildren)
      // update current object and possibly children
     cGenericObject::markForUpdate(a_affectChildren);
 
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // updated meshes
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
@@ -527,6 +556,9 @@ void cMultiMesh::markForUpdate(const bool a_affectChildren)
 void cMultiMesh::setUseMaterial(const bool a_useMaterial, 
                                 const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setUseMaterial(a_useMaterial, a_affectChildren);
 
@@ -556,6 +588,9 @@ void cMultiMesh::setUseMaterial(const bool a_useMaterial,
 void cMultiMesh::setMaterial(cMaterialPtr a_material,
                              const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setMaterial(a_material, a_affectChildren);
 
@@ -585,6 +620,9 @@ void cMultiMesh::setMaterial(cMaterialPtr a_material,
 void cMultiMesh::setMaterial(cMaterial& a_material,
                              const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setMaterial(a_material, a_affectChildren);
 
@@ -609,6 +647,9 @@ void cMultiMesh::setMaterial(cMaterial& a_material,
 void cMultiMesh::setUseTexture(const bool a_useTexture, 
                                const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setUseTexture(a_useTexture, a_affectChildren);
 
@@ -637,6 +678,9 @@ void cMultiMesh::setUseTexture(const bool a_useTexture,
 void cMultiMesh::setTexture(cTexture1dPtr a_texture,
                             const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setTexture(a_texture, a_affectChildren);
 
@@ -663,6 +707,9 @@ void cMultiMesh::setTexture(cTexture1dPtr a_texture,
 void cMultiMesh::setShaderProgram(cShaderProgramPtr a_shaderProgram,
                                   const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     m_shaderProgram = a_shaderProgram;
 
     // updated meshes
@@ -699,6 +746,9 @@ void cMultiMesh::setShaderProgram(cShaderProgramPtr a_shaderProgram,
 void cMultiMesh::setShowBoundaryBox(const bool a_showBoundaryBox, 
                                     const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setShowBoundaryBox(a_showBoundaryBox, a_affectChildren);
 
@@ -980,6 +1030,9 @@ bool cMultiMesh::computeCollisionDetection(const cVector3d& a_segmentPointA,
 void cMultiMesh::setShowCollisionDetector(const bool a_showCollisionDetector, 
                                           const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::setShowCollisionDetector(a_showCollisionDetector, a_affectChildren);
 
@@ -1038,6 +1091,9 @@ void cMultiMesh::setCollisionDetectorProperties(unsigned int a_displayDepth,
 void cMultiMesh::scale(const double& a_scaleFactor, 
                        const bool a_affectChildren)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // update current object and possibly children
     cGenericObject::scale(a_scaleFactor, a_affectChildren);
 
@@ -1063,6 +1119,9 @@ void cMultiMesh::scale(const double& a_scaleFactor,
 //==============================================================================
 void cMultiMesh::scaleXYZ(const double a_scaleX, const double a_scaleY, const double a_scaleZ)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1113,6 +1172,9 @@ void cMultiMesh::scaleXYZ(const double a_scaleX, const double a_scaleY, const do
 //==============================================================================
 cMesh* cMultiMesh::newMesh()
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // create new mesh entity
     cMesh* obj = new cMesh();
 
@@ -1137,6 +1199,9 @@ cMesh* cMultiMesh::newMesh()
 //==============================================================================
 bool cMultiMesh::addMesh(cMesh* a_mesh)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // sanity check
     if (a_mesh == NULL) { return (false); }
     if (a_mesh->getParent() != NULL) { return (false); }
@@ -1164,6 +1229,9 @@ bool cMultiMesh::addMesh(cMesh* a_mesh)
 //==============================================================================
 bool cMultiMesh::removeMesh(cMesh* a_mesh)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1193,6 +1261,9 @@ bool cMultiMesh::removeMesh(cMesh* a_mesh)
 //==============================================================================
 bool cMultiMesh::removeAllMesh()
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1220,6 +1291,9 @@ bool cMultiMesh::removeAllMesh()
 //==============================================================================
 bool cMultiMesh::deleteMesh(cMesh* a_mesh)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1250,6 +1324,9 @@ bool cMultiMesh::deleteMesh(cMesh* a_mesh)
 //==============================================================================
 bool cMultiMesh::deleteAllMeshes()
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     // delete all meshes
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
@@ -1467,6 +1544,80 @@ unsigned int cMultiMesh::getNumVertices() const
 }
 
 
+//==============================================================================
+/*!
+    This method enables or disables the storage of global vertex positions for
+    all meshes. When disabled, the global position arrays are released and 
+    global positions are computed on request, which removes the per-vertex 
+    work from \ref updateGlobalPositions().
+
+    \param  a_useGlobalPosData  If __true__ then global positions are stored.
+*/
+//==============================================================================
+void cMultiMesh::setUseGlobalPosData(const bool a_useGlobalPosData)
+{
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        (*it)->setUseGlobalPosData(a_useGlobalPosData);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the amount of memory allocated for global vertex 
+    positions of all meshes. Comparing this value before and after calling
+    \ref setUseGlobalPosData() reports the memory saved.
+
+    \return Size in bytes.
+*/
+//==============================================================================
+unsigned int cMultiMesh::getGlobalPosDataSize() const
+{
+    unsigned int size = 0;
+
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        size = size + (*it)->m_vertices->getGlobalPosDataSize();
+    }
+
+    return (size);
+}
+
+
+//==============================================================================
+/*!
+    This method optimizes all meshes for memory usage and rendering speed. 
+    See \ref cMesh::optimize() for details. The result is also available 
+    from \ref getLastOptimizationReport().
+
+    \param  a_weldTolerance  Largest distance between two merged vertices.
+
+    \return Total number of vertices and triangles before and after optimization.
+*/
+//==============================================================================
+cMeshOptimizationReport cMultiMesh::optimize(const double a_weldTolerance)
+{
+    cMeshOptimizationReport report;
+
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        cMeshOptimizationReport meshReport = (*it)->optimize(a_weldTolerance);
+        report.m_numVerticesBefore  += meshReport.m_numVerticesBefore;
+        report.m_numVerticesAfter   += meshReport.m_numVerticesAfter;
+        report.m_numTrianglesBefore += meshReport.m_numTrianglesBefore;
+        report.m_numTrianglesAfter  += meshReport.m_numTrianglesAfter;
+    }
+
+    m_lastOptimizationReport = report;
+
+    return (report);
+}
+
+
 //==============================================================================
 /*!
     This method clears all triangles and vertices of multi-mesh.
@@ -1540,7 +1691,12 @@ void cMultiMesh::convertToSingleMesh(cMesh* a_mesh)
 //==============================================================================
 /*!
     This method loads a 3D mesh file. \n
-    CHAI3D currently supports .obj, .3ds, and .stl files.
+    CHAI3D currently supports .obj, .3ds, .stl, and .cmm files. \n
+
+    If global variable \ref g_meshLoaderShouldOptimize is enabled, the loaded 
+    meshes are optimized and the reduction of vertices and triangles can be 
+    retrieved with \ref getLastOptimizationReport(). CMM files store meshes 
+    that are already optimized; after loading them the report is empty.
 
     \param  a_filename  Filename of 3D model.
 
@@ -1561,6 +1717,9 @@ bool cMultiMesh::loadFromFile(string a_filename)
     // convert string to lower extension
     string fileType = cStrToLower(extension);
 
+    // no optimization performed by this load yet
+    m_lastOptimizationReport = cMeshOptimizationReport();
+
     // result for loading file
     bool result = false;
 
@@ -1585,7 +1744,21 @@ bool cMultiMesh::loadFromFile(string a_filename)
     //--------------------------------------------------------------------
     else if (fileType == "stl")
     {
-        result = cLoadFileSTL(this, a_filename);
+        result = cLoadFileSTL(this, a_filename, &m_lastOptimizationReport);
+    }
+
+    //--------------------------------------------------------------------
+    // .CMM FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "cmm")
+    {
+        result = cLoadFileCMM(this, a_filename);
+    }
+
+    // optimize meshes (STL meshes are optimized by the loader before normals are computed, CMM files store optimized meshes)
+    if (result && g_meshLoaderShouldOptimize && (fileType != "stl") && (fileType != "cmm"))
+    {
+        optimize();
     }
 
     return (result);
@@ -1595,7 +1768,7 @@ bool cMultiMesh::loadFromFile(string a_filename)
 //==============================================================================
 /*!
     This method saves a mesh object to file. \n
-    CHAI3D currently supports .obj, .3ds, and .stl files.
+    CHAI3D currently supports .obj, .3ds, .stl, and .cmm files.
 
     \param  a_filename  Filename of 3D model.
 
@@ -1643,6 +1816,14 @@ bool cMultiMesh::saveToFile(std::string a_filename)
         result = cSaveFileSTL(this, a_filename);
     }
 
+    //--------------------------------------------------------------------
+    // .CMM FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "cmm")
+    {
+        result = cSaveFileCMM(this, a_filename);
+    }
+
     return (result);
 }
 
@@ -1687,6 +1868,9 @@ void cMultiMesh::computeBTN()
 //==============================================================================
 void cMultiMesh::setShowTangents(const bool a_showTangents)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1704,6 +1888,9 @@ void cMultiMesh::setShowTangents(const bool a_showTangents)
 //==============================================================================
 void cMultiMesh::setShowTriangles(const bool a_showTriangles)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1721,6 +1908,9 @@ void cMultiMesh::setShowTriangles(const bool a_showTriangles)
 //==============================================================================
 void cMultiMesh::setShowEdges(const bool a_showEdges)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1900,6 +2090,9 @@ void cMultiMesh::setNormalsLength(const double a_length)
 //==============================================================================
 void cMultiMesh::setShowNormals(const bool& a_showNormals)
 {
+    // rebuild batches
+    m_flagBatchUpdate = true;
+
     vector<cMesh*>::iterator it;
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
@@ -1949,11 +2142,453 @@ void cMultiMesh::createAABBCollisionDetector(const double a_radius)
 //==============================================================================
 void cMultiMesh::render(cRenderOptions& a_options)
 {
+    // render each mesh individually
+    if (!m_useBatching)
+    {
+        vector<cMesh*>::iterator it;
+        for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+        {
+            (*it)->renderSceneGraph(a_options);
+        }
+        return;
+    }
+
+    // rebuild batches if required
+    if (m_flagBatchUpdate || getBatchesNeedUpdate())
+    {
+        updateBatches();
+    }
+
+    // render meshes that cannot be batched
     vector<cMesh*>::iterator it;
-    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    for (it = m_unbatchedMeshes.begin(); it < m_unbatchedMeshes.end(); it++)
     {
         (*it)->renderSceneGraph(a_options);
     }
+
+    // render batches
+    renderBatches(a_options);
+}
+
+
+//==============================================================================
+/*!
+    This method enables or disables batch rendering. When enabled, meshes that 
+    share the same material, texture and rendering flags are merged into 
+    common vertex and index buffers, and each group is drawn with a single 
+    call to __glMultiDrawElements__. This significantly reduces the number of 
+    draw calls and state changes for models composed of many small meshes. \n
+
+    Meshes that use transparency, shaders, levels of detail, or display edges, 
+    normals, tangents, boundary boxes or collision trees are rendered 
+    individually. Batched meshes are culled individually against the view 
+    frustum. \n
+
+    The position, orientation and vertex data of batched meshes are copied 
+    when the batches are built. Batches are rebuilt automatically when a mesh 
+    is moved, when its vertex positions, normals or triangles are modified, or 
+    when its material, texture or rendering flags change. Batching is 
+    therefore intended for meshes that remain static. Call \ref markForUpdate() 
+    after writing texture coordinates or colors directly into vertex arrays.
+
+    \param  a_useBatching  If __true__ then batch rendering is enabled.
+*/
+//==============================================================================
+void cMultiMesh::setUseBatching(const bool a_useBatching)
+{
+    m_useBatching = a_useBatching;
+    m_flagBatchUpdate = true;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the material, texture and rendering flags that
+    determine the batch of a mesh. Meshes with their own rendering passes,
+    overlays, levels of detail or OpenGL states cannot be batched.
+
+    \param  a_mesh      Mesh.
+    \param  a_material  Returns the material of the mesh, or NULL.
+    \param  a_texture   Returns the texture of the mesh, or NULL.
+    \param  a_flags     Returns the rendering flags of the mesh.
+
+    \return __true__ if the mesh can be batched, __false__ otherwise.
+*/
+//==============================================================================
+bool cMultiMesh::getMeshBatchKey(cMesh* a_mesh,
+                                 const void*& a_material,
+                                 const void*& a_texture,
+                                 int& a_flags) const
+{
+    // meshes with their own passes, overlays or states are rendered individually
+    if ((a_mesh->getNumChildren() > 0) ||
+        (a_mesh->getNumLevelsOfDetail() > 0) ||
+        (a_mesh->m_shaderProgram != nullptr) ||
+        (a_mesh->m_useTransparency) ||
+        (!a_mesh->m_showTriangles) ||
+        (a_mesh->m_showEdges) ||
+        (a_mesh->m_showNormals) ||
+        (a_mesh->m_showTangents) ||
+        (a_mesh->m_showBoundaryBox) ||
+        (a_mesh->m_showFrame) ||
+        (a_mesh->m_showCollisionDetector) ||
+        (a_mesh->m_triangleMode != m_triangleMode) ||
+        (a_mesh->m_cullingEnabled != m_cullingEnabled))
+    {
+        return (false);
+    }
+
+    bool useTextureMapping = a_mesh->m_useTextureMapping && (a_mesh->m_texture != nullptr);
+
+    a_material = a_mesh->m_useMaterialProperty ? a_mesh->m_material.get() : NULL;
+    a_texture = useTextureMapping ? a_mesh->m_texture.get() : NULL;
+    a_flags = (a_mesh->m_useMaterialProperty ? 1 : 0) | 
+              (useTextureMapping ? 2 : 0) | 
+              (a_mesh->m_useVertexColors ? 4 : 0);
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method compares the meshes with the state they had when the batches
+    were built. Batches must be rebuilt if a batched mesh has been moved, if
+    its vertices or triangles have been modified, or if its material, texture
+    or rendering flags have changed.
+
+    \return __true__ if the batches must be rebuilt, __false__ otherwise.
+*/
+//==============================================================================
+bool cMultiMesh::getBatchesNeedUpdate()
+{
+    const void* material;
+    const void* texture;
+    int flags;
+
+    vector<cMultiMeshBatch>::iterator it;
+    for (it = m_batches.begin(); it < m_batches.end(); it++)
+    {
+        cMultiMeshBatch& batch = (*it);
+        for (unsigned int i=0; i<batch.m_meshes.size(); i++)
+        {
+            cMesh* mesh = batch.m_meshes[i];
+            if ((!mesh->m_localPos.equals(batch.m_meshPos[i])) ||
+                (!batch.m_meshRot[i].equals(mesh->m_localRot)) ||
+                (mesh->m_vertices->getModificationCounter() != batch.m_vertexCounters[i]) ||
+                (mesh->m_triangles->getModificationCounter() != batch.m_triangleCounters[i]))
+            {
+                return (true);
+            }
+
+            if ((!getMeshBatchKey(mesh, material, texture, flags)) ||
+                (material != batch.m_material) ||
+                (texture != batch.m_texture) ||
+                (flags != batch.m_flags))
+            {
+                return (true);
+            }
+        }
+    }
+
+    vector<cMesh*>::iterator itMesh;
+    for (itMesh = m_unbatchedMeshes.begin(); itMesh < m_unbatchedMeshes.end(); itMesh++)
+    {
+        if (getMeshBatchKey(*itMesh, material, texture, flags))
+        {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+
+//==============================================================================
+/*!
+    This method groups meshes by material, texture and rendering flags, and 
+    builds the interleaved vertex data and the index data of each batch. 
+    Vertex positions and normals are expressed in the reference frame of the 
+    multi-mesh. The OpenGL buffers are created during the next rendering pass.
+*/
+//==============================================================================
+void cMultiMesh::updateBatches()
+{
+    clearBatches();
+    m_flagBatchUpdate = false;
+
+    map<tuple<const void*, const void*, int>, unsigned int> batchIndices;
+
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        cMesh* mesh = (*it);
+
+        // check if texture is available
+        if (mesh->m_texture == nullptr)
+        {
+            mesh->m_useTextureMapping = false;
+        }
+
+        // meshes with their own passes, overlays or states are rendered individually
+        const void* material;
+        const void* texture;
+        int flags;
+        if (!getMeshBatchKey(mesh, material, texture, flags))
+        {
+            m_unbatchedMeshes.push_back(mesh);
+            continue;
+        }
+
+        // find batch with same material, texture and flags
+        tuple<const void*, const void*, int> key(material, texture, flags);
+        map<tuple<const void*, const void*, int>, unsigned int>::iterator found = batchIndices.find(key);
+        if (found == batchIndices.end())
+        {
+            cMultiMeshBatch batch;
+            batch.m_mesh = mesh;
+            batch.m_material = material;
+            batch.m_texture = texture;
+            batch.m_flags = flags;
+            batch.m_useTexCoords = mesh->m_useTextureMapping;
+            batch.m_useColors = mesh->m_useVertexColors;
+            batch.m_stride = 6 + (batch.m_useTexCoords ? 3 : 0) + (batch.m_useColors ? 4 : 0);
+            batch.m_vertexBuffer = (GLuint)(-1);
+            batch.m_indexBuffer = (GLuint)(-1);
+
+            found = batchIndices.insert(make_pair(key, (unsigned int)(m_batches.size()))).first;
+            m_batches.push_back(batch);
+        }
+        cMultiMeshBatch& batch = m_batches[found->second];
+
+        // append vertices, expressed in the reference frame of the multi-mesh
+        cVertexArrayPtr vertices = mesh->m_vertices;
+        unsigned int numVertices = vertices->getNumElements();
+        unsigned int firstVertex = (unsigned int)(batch.m_vertexData.size() / batch.m_stride);
+        cVector3d meshPos = mesh->getLocalPos();
+        cMatrix3d meshRot = mesh->getLocalRot();
+
+        batch.m_vertexData.reserve(batch.m_vertexData.size() + numVertices * batch.m_stride);
+        for (unsigned int i=0; i<numVertices; i++)
+        {
+            cVector3d pos = meshPos + meshRot * vertices->m_localPos[i];
+            cVector3d normal = meshRot * vertices->m_normal[i];
+
+            batch.m_vertexData.push_back((float)pos(0));
+            batch.m_vertexData.push_back((float)pos(1));
+            batch.m_vertexData.push_back((float)pos(2));
+            batch.m_vertexData.push_back((float)normal(0));
+            batch.m_vertexData.push_back((float)normal(1));
+            batch.m_vertexData.push_back((float)normal(2));
+
+            if (batch.m_useTexCoords)
+            {
+                const cVector3d& texCoord = vertices->m_texCoord[i];
+                batch.m_vertexData.push_back((float)texCoord(0));
+                batch.m_vertexData.push_back((float)texCoord(1));
+                batch.m_vertexData.push_back((float)texCoord(2));
+            }
+
+            if (batch.m_useColors)
+            {
+                const GLfloat* color = vertices->m_color[i].getData();
+                batch.m_vertexData.insert(batch.m_vertexData.end(), color, color + 4);
+            }
+        }
+
+        // append triangles
+        cTriangleArrayPtr triangles = mesh->m_triangles;
+        unsigned int numTriangles = triangles->getNumElements();
+        unsigned int firstIndex = (unsigned int)(batch.m_indexData.size());
+
+        for (unsigned int i=0; i<numTriangles; i++)
+        {
+            if (triangles->getAllocated(i))
+            {
+                batch.m_indexData.push_back(firstVertex + triangles->getVertexIndex0(i));
+                batch.m_indexData.push_back(firstVertex + triangles->getVertexIndex1(i));
+                batch.m_indexData.push_back(firstVertex + triangles->getVertexIndex2(i));
+            }
+        }
+
+        batch.m_meshes.push_back(mesh);
+        batch.m_firstIndex.push_back(firstIndex);
+        batch.m_numIndices.push_back((unsigned int)(batch.m_indexData.size()) - firstIndex);
+        batch.m_meshPos.push_back(meshPos);
+        batch.m_meshRot.push_back(meshRot);
+        batch.m_vertexCounters.push_back(vertices->getModificationCounter());
+        batch.m_triangleCounters.push_back(triangles->getModificationCounter());
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method renders all batches. The OpenGL buffers of each batch are 
+    created and uploaded the first time the batch is rendered. Meshes that 
+    lie outside of the view frustum are skipped. Index ranges of adjacent 
+    visible meshes are merged so that a batch whose meshes are all 
+    visible is drawn with a single range.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cMultiMesh::renderBatches(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    // batched meshes are opaque
+    if (!SECTION_RENDER_PARTS_WITH_MATERIALS(a_options, false))
+    {
+        return;
+    }
+
+    vector<cMultiMeshBatch>::iterator it;
+    for (it = m_batches.begin(); it < m_batches.end(); it++)
+    {
+        cMultiMeshBatch& batch = (*it);
+
+        // collect index ranges of visible meshes
+        m_batchCounts.clear();
+        m_batchOffsets.clear();
+        unsigned int first = 0;
+        unsigned int count = 0;
+        for (unsigned int i=0; i<batch.m_meshes.size(); i++)
+        {
+            cMesh* mesh = batch.m_meshes[i];
+            if (!mesh->m_enabled || !mesh->m_showEnabled || (batch.m_numIndices[i] == 0) ||
+                mesh->isOutsideFrustum(a_options))
+            {
+                continue;
+            }
+
+            if ((count > 0) && (first + count == batch.m_firstIndex[i]))
+            {
+                count += batch.m_numIndices[i];
+            }
+            else
+            {
+                if (count > 0)
+                {
+                    m_batchCounts.push_back((GLsizei)count);
+                    m_batchOffsets.push_back((const GLvoid*)(first * sizeof(unsigned int)));
+                }
+                first = batch.m_firstIndex[i];
+                count = batch.m_numIndices[i];
+            }
+        }
+        if (count > 0)
+        {
+            m_batchCounts.push_back((GLsizei)count);
+            m_batchOffsets.push_back((const GLvoid*)(first * sizeof(unsigned int)));
+        }
+
+        if (m_batchCounts.size() == 0)
+        {
+            continue;
+        }
+
+        // create and upload buffers first time
+        if (batch.m_vertexBuffer == (GLuint)(-1))
+        {
+            glGenBuffers(1, &batch.m_vertexBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, batch.m_vertexBuffer);
+            glBufferData(GL_ARRAY_BUFFER, batch.m_vertexData.size() * sizeof(float), &(batch.m_vertexData[0]), GL_STATIC_DRAW);
+
+            glGenBuffers(1, &batch.m_indexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.m_indexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, batch.m_indexData.size() * sizeof(unsigned int), &(batch.m_indexData[0]), GL_STATIC_DRAW);
+
+            // data is now held by the GPU
+            vector<float>().swap(batch.m_vertexData);
+            vector<unsigned int>().swap(batch.m_indexData);
+        }
+
+        // set material, texture and color states
+        cMesh* mesh = batch.m_mesh;
+        mesh->renderMaterialInitialize(a_options);
+
+        // bind buffers
+        GLsizei stride = batch.m_stride * sizeof(float);
+        unsigned int offset = 6;
+
+        glBindBuffer(GL_ARRAY_BUFFER, batch.m_vertexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.m_indexBuffer);
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(3, GL_FLOAT, stride, (void*)0);
+
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, stride, (void*)(3 * sizeof(float)));
+
+        if (batch.m_useTexCoords)
+        {
+            glClientActiveTexture(mesh->m_texture->getTextureUnit());
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+            glTexCoordPointer(3, GL_FLOAT, stride, (void*)(offset * sizeof(float)));
+            offset += 3;
+        }
+
+        if (batch.m_useColors)
+        {
+            glEnableClientState(GL_COLOR_ARRAY);
+            glColorPointer(4, GL_FLOAT, stride, (void*)(offset * sizeof(float)));
+        }
+
+        // render visible meshes
+        if (m_batchCounts.size() == 1)
+        {
+            glDrawElements(GL_TRIANGLES, m_batchCounts[0], GL_UNSIGNED_INT, m_batchOffsets[0]);
+        }
+        else
+        {
+            glMultiDrawElements(GL_TRIANGLES, &(m_batchCounts[0]), GL_UNSIGNED_INT, &(m_batchOffsets[0]), (GLsizei)(m_batchCounts.size()));
+        }
+
+        // restore OpenGL states
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glDisableClientState(GL_NORMAL_ARRAY);
+        if (batch.m_useTexCoords)
+        {
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+            glClientActiveTexture(GL_TEXTURE0);
+        }
+        if (batch.m_useColors)
+        {
+            glDisableClientState(GL_COLOR_ARRAY);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        mesh->renderMaterialFinalize(a_options);
+    }
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method deletes all batches and their OpenGL buffers.
+*/
+//==============================================================================
+void cMultiMesh::clearBatches()
+{
+#ifdef C_USE_OPENGL
+    vector<cMultiMeshBatch>::iterator it;
+    for (it = m_batches.begin(); it < m_batches.end(); it++)
+    {
+        if (it->m_vertexBuffer != (GLuint)(-1))
+        {
+            glDeleteBuffers(1, &(it->m_vertexBuffer));
+            glDeleteBuffers(1, &(it->m_indexBuffer));
+        }
+    }
+#endif
+
+    m_batches.clear();
+    m_unbatchedMeshes.clear();
 }
 
 
@@ -61,6 +61,79 @@ namespace chai3d {
 */
 //==============================================================================
 
+//==============================================================================
+/*!
+    \struct     cMultiMeshBatch
+    \ingroup    world
+
+    \brief
+    This structure stores a group of meshes that are rendered together.
+
+    \details
+    Meshes that share the same material, texture and rendering flags are 
+    merged into a common vertex buffer and index buffer. The triangles of each 
+    mesh occupy a contiguous range of the index buffer, so that visible meshes 
+    can be drawn with a single call to __glMultiDrawElements__.
+*/
+//==============================================================================
+struct cMultiMeshBatch
+{
+    //! Mesh providing the material, texture and rendering flags of the batch.
+    cMesh* m_mesh;
+
+    //! Meshes contained in the batch.
+    std::vector<cMesh*> m_meshes;
+
+    //! First index of each mesh in the index buffer.
+    std::vector<unsigned int> m_firstIndex;
+
+    //! Number of indices of each mesh.
+    std::vector<unsigned int> m_numIndices;
+
+    //! Local position of each mesh when the batch was built.
+    std::vector<cVector3d> m_meshPos;
+
+    //! Local rotation of each mesh when the batch was built.
+    std::vector<cMatrix3d> m_meshRot;
+
+    //! Vertex modification counter of each mesh when the batch was built.
+    std::vector<unsigned int> m_vertexCounters;
+
+    //! Triangle modification counter of each mesh when the batch was built.
+    std::vector<unsigned int> m_triangleCounters;
+
+    //! Material shared by the meshes of the batch (NULL if material properties are disabled).
+    const void* m_material;
+
+    //! Texture shared by the meshes of the batch (NULL if texture mapping is disabled).
+    const void* m_texture;
+
+    //! Rendering flags shared by the meshes of the batch.
+    int m_flags;
+
+    //! Interleaved vertex data (position, normal, texture coordinate, color).
+    std::vector<float> m_vertexData;
+
+    //! Triangle indices.
+    std::vector<unsigned int> m_indexData;
+
+    //! Number of floats per vertex.
+    unsigned int m_stride;
+
+    //! If __true__, the vertex data includes texture coordinates.
+    bool m_useTexCoords;
+
+    //! If __true__, the vertex data includes colors.
+    bool m_useColors;
+
+    //! OpenGL vertex buffer.
+    GLuint m_vertexBuffer;
+
+    //! OpenGL index buffer.
+    GLuint m_indexBuffer;
+};
+
+
 //==============================================================================
 /*!    
     \class      cMultiMesh
@@ -169,6 +242,22 @@ public:
     virtual void markForUpdate(const bool a_affectChildren = false);
 
 
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - BATCHING:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables the rendering of meshes sharing the same material in batches.
+    void setUseBatching(const bool a_useBatching);
+
+    //! This method returns __true__ if meshes are rendered in batches, __false__ otherwise.
+    bool getUseBatching() const { return (m_useBatching); }
+
+    //! This method returns the number of batches built during the last update.
+    unsigned int getNumBatches() const { return ((unsigned int)(m_batches.size())); }
+
+
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - MATERIAL PROPERTIES:
     //-----------------------------------------------------------------------
@@ -323,6 +412,18 @@ public:
     //! This method sets the color of each vertex.
     void setVertexColor(const cColorf& a_color);
 
+    //! This method enables or disables the storage of global vertex positions for all meshes.
+    void setUseGlobalPosData(const bool a_useGlobalPosData);
+
+    //! This method returns the amount of memory allocated for global vertex positions of all meshes.
+    unsigned int getGlobalPosDataSize() const;
+
+    //! This method welds and reorders the vertices and triangles of all meshes for faster rendering.
+    cMeshOptimizationReport optimize(const double a_weldTolerance = 0.0);
+
+    //! This method returns the result of the last optimization, including the optimization performed automatically by \ref loadFromFile().
+    const cMeshOptimizationReport& getLastOptimizationReport() const { return (m_lastOptimizationReport); }
+
 
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - TRIANGLES
@@ -435,6 +536,21 @@ protected:
     //! This method updates the boundary box of this object.
     virtual void updateBoundaryBox();
 
+    //! This method returns the material, texture and rendering flags of a mesh, or __false__ if the mesh cannot be batched.
+    bool getMeshBatchKey(cMesh* a_mesh, const void*& a_material, const void*& a_texture, int& a_flags) const;
+
+    //! This method returns __true__ if meshes have been moved or modified since the batches were built.
+    bool getBatchesNeedUpdate();
+
+    //! This method groups meshes by material and builds the vertex and index data of each batch.
+    void updateBatches();
+
+    //! This method renders all batches.
+    void renderBatches(cRenderOptions& a_options);
+
+    //! This method deletes all batches and their OpenGL buffers.
+    void clearBatches();
+
     //! This method copies all properties of this multi-mesh object to another.
     void copyMultiMeshProperties(cMultiMesh* a_obj,
         const bool a_duplicateMaterialData,
@@ -452,8 +568,45 @@ public:
     //! Array of meshes.
     std::vector<cMesh*> *m_meshes;
 
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Result of the last optimization of this multi-mesh.
+    cMeshOptimizationReport m_lastOptimizationReport;
+
+    //! If __true__, meshes sharing the same material are rendered in batches.
+    bool m_useBatching;
+
+    //! If __true__, batches need to be rebuilt before the next rendering pass.
+    bool m_flagBatchUpdate;
+
+    //! Batches of meshes sharing the same material.
+    std::vector<cMultiMeshBatch> m_batches;
+
+    //! Meshes that cannot be batched and are rendered individually.
+    std::vector<cMesh*> m_unbatchedMeshes;
+
+    //! Index ranges of the current rendering pass.
+    std::vector<GLsizei> m_batchCounts;
+
+    //! Index offsets of the current rendering pass.
+    std::vector<const GLvoid*> m_batchOffsets;
+
 };
 
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to tell the mesh file loaders to optimize loaded 
+    meshes by calling \ref cMesh::optimize(). \n
+    If __false__ (default), meshes are kept as they are stored in the file.
+*/
+//------------------------------------------------------------------------------
+extern bool g_meshLoaderShouldOptimize;
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -411,12 +411,7 @@ void cMultiPoint::updateGlobalPositions(const bool a_frameOnly)
 {
     if (a_frameOnly) return;
 
-    int numVertices = m_vertices->getNumElements();
-
-    for (int i=0; i<numVertices; i++)
-    {
-        m_vertices->computeGlobalPosition(i, m_globalPos, m_globalRot);
-    }
+    m_vertices->computeGlobalPositions(m_globalPos, m_globalRot);
 }
 
 
@@ -425,12 +425,7 @@ void cMultiSegment::updateGlobalPositions(const bool a_frameOnly)
 {
     if (a_frameOnly) return;
 
-    int numVertices = m_vertices->getNumElements();
-
-    for (int i=0; i<numVertices; i++)
-    {
-        m_vertices->computeGlobalPosition(i, m_globalPos, m_globalRot);
-    }
+    m_vertices->computeGlobalPositions(m_globalPos, m_globalRot);
 }
 
 
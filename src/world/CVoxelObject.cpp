@@ -46,9 +46,11 @@
 #include "world/CVoxelObject.h"
 //------------------------------------------------------------------------------
 #include "display/CCamera.h"
+#include "graphics/CMultiImageView.h"
 #include "materials/CTexture3d.h"
 #include "math/CMarchingCubes.h"
 #include "shaders/CShaderProgram.h"
+#include "system/CThreadPool.h"
 #include "collisions/CCollisionAABB.h"
 #include "resources/CShaderBasicVoxel-RGBA8.h"
 #include "resources/CShaderBasicVoxel-LUT8.h"
@@ -76,6 +78,25 @@ const int C_RENDERING_MODE_CUSTOM                       = 9;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// holds the lock of a 3D image until the end of the enclosing scope
+class cMultiImageLock
+{
+public:
+    cMultiImageLock(cMultiImage* a_image) : m_image(a_image) { m_image->acquireLock(); }
+    ~cMultiImageLock() { m_image->releaseLock(); }
+
+private:
+    cMultiImage* m_image;
+};
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     Constructor of cVoxelObject.
@@ -141,6 +162,29 @@ cVoxelObject::cVoxelObject()
     
     // render only front faces
     setUseCulling(true);
+
+    // no incremental polygonization performed yet
+    m_polygonizeMesh = NULL;
+    m_polygonizeData = NULL;
+    m_polygonizeSize[0] = 0;
+    m_polygonizeSize[1] = 0;
+    m_polygonizeSize[2] = 0;
+    m_polygonizeSize[3] = 0;
+    m_polygonizeCounter = 0;
+
+    // material removal settings
+    m_removalToolShape = C_VOXEL_TOOL_SPHERE;
+    m_removalToolRadius = 0.01;
+    m_removalRate = 1.0;
+    m_removalStiffness = 0.0;
+    m_materialHardness.assign(256, 1.0);
+    m_removalRandomState = 2463534242u;
+    m_removalThread = NULL;
+    m_removalRequestQueued = false;
+    m_removalRequestPos.zero();
+    m_removalRequestTimeStep = 0.0;
+    m_removalForce.zero();
+    m_removedVolume = 0.0;
 }
 
 
@@ -151,6 +195,11 @@ cVoxelObject::cVoxelObject()
 //==============================================================================
 cVoxelObject::~cVoxelObject()
 {
+    // complete pending removal requests and terminate worker thread
+    if (m_removalThread != NULL)
+    {
+        delete m_removalThread;
+    }
 }
 
 
@@ -972,7 +1021,10 @@ void cVoxelObject::loadRenderingShaders()
     All detected collisions are reported in the collision recorder passed 
     by argument \p a_recorder. \n
     Specifications about the type of collisions reported are specified by 
-    argument \p a_settings.
+    argument \p a_settings. \n
+    Voxels are read while holding the lock of the image 
+    (\ref cMultiImage::acquireLock()), so that collisions can be computed 
+    while material is removed by \ref requestRemoval() on another thread.
 
     \param  a_segmentPointA  Start point of segment.
     \param  a_segmentPointB  End point of segment.
@@ -1105,6 +1157,25 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
     // distance counter
     double distance = 0.0;
 
+    // compute lowest alpha value of a voxel located inside the isosurface
+    const float CONVERSION_FACTOR = (1.0f / 255.0f);
+    unsigned int threshold = 0;
+    while ((threshold < 256) && (CONVERSION_FACTOR * (float)(threshold) < m_isosurfaceValue))
+    {
+        threshold++;
+    }
+
+    // list of solid voxels located near the segment
+    cImage* image = m_texture->m_image.get();
+    std::vector<cVoxelCoord> voxels;
+
+    // voxels may be modified by the removal thread while they are read
+    cMultiImage* lockedImage = dynamic_cast<cMultiImage*>(image);
+    if (lockedImage != NULL)
+    {
+        lockedImage->acquireLock();
+    }
+
     // search for collision
     while ((!hit) && (distance < distanceAB))
     {
@@ -1135,115 +1206,96 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
         tmax[1] = texel[1] + texRadius[1] + 1;
         tmax[2] = texel[2] + texRadius[2] + 1;
 
-        // check all voxels 
-        for (int t2=tmin[2]; t2<=tmax[2]; t2++)
+        // collect solid voxels within the area covered by the radius
+        findSolidVoxels(image, tmin, tmax, threshold, voxels);
+
+        // check all solid voxels
+        for (unsigned int v=0; v<voxels.size(); v++)
         {
-            for (int t1=tmin[1]; t1<=tmax[1]; t1++)
+            int t0 = voxels[v].m_x;
+            int t1 = voxels[v].m_y;
+            int t2 = voxels[v].m_z;
+
+            // compute position of texel in local space
+            double tpos[3];
+            tpos[0] = m_minCorner(0) + ((((double)t0 / texSize[0]) - m_minTextureCoord(0)) / (texRange(0))) * (objectRange(0));
+            tpos[1] = m_minCorner(1) + ((((double)t1 / texSize[1]) - m_minTextureCoord(1)) / (texRange(1))) * (objectRange(1));
+            tpos[2] = m_minCorner(2) + ((((double)t2 / texSize[2]) - m_minTextureCoord(2)) / (texRange(2))) * (objectRange(2));
+
+            // check if point is located outside of object
+            double distanceSq = cDistanceSq(cVector3d(tpos[0] + 0.5 * voxelSize[0], tpos[1] + 0.5 * voxelSize[1], tpos[2] + 0.5 * +voxelSize[2]), pointB);
+            if (distanceSq < r2)
             {
-                for (int t0=tmin[0]; t0<=tmax[0]; t0++)
+                // check intersection with segment and voxel (approximated by sphere)
+                cVector3d t_p, t_n;
+                cVector3d t_collisionPoint, t_collisionNormal;
+                double t_collisionDistanceSq;
+
+                if (a_settings.m_collisionRadius == 0)
                 {
+                    if (cIntersectionSegmentBox(a_segmentPointA,
+                        a_segmentPointB,
+                        cVector3d(tpos[0] - (0.0 * voxelSize[0] + collisionRadius), tpos[1] - (0.0 * voxelSize[1] + collisionRadius), tpos[2] - (0.0 * voxelSize[2] + collisionRadius)),
+                        cVector3d(tpos[0] + (1.0 * voxelSize[0] + collisionRadius), tpos[1] + (1.0 * voxelSize[1] + collisionRadius), tpos[2] + (1.0 * voxelSize[2] + collisionRadius)),
+                        t_collisionPoint,
+                        t_collisionNormal) > 0)
                     {
-                        // get voxel color
-                        cColorb color;
-                        bool result = false;
-                        
-                        if ((t0 >= 0) && (t1 >= 0) && (t2 >= 0))
-                        {                            
-                            result = m_texture->m_image->getVoxelColor(t0, t1, t2, color);
-                        }
+                        // intersection occurred
+                        hit = true;
+
+                        counter++;
+
+                        // compute distance from collision point
+                        t_collisionDistanceSq = cDistanceSq(a_segmentPointA, t_collisionPoint);
 
-                        if (result)
+                        // if nearest, then select and store data.
+                        if (t_collisionDistanceSq <= collisionDistanceSq)
                         {
-                            const float CONVERSION_FACTOR = (1.0f / 255.0f);
-                            float level = CONVERSION_FACTOR * (float)(color.getA());
+                            collisionPoint = t_collisionPoint;
+                            collisionNormal = t_collisionNormal;
+                            collisionDistanceSq = t_collisionDistanceSq;
+                            collisionPointV01 = 0.0;
+                            collisionPointV02 = 0.0;
+                            voxelIndexX = t0;
+                            voxelIndexY = t1;
+                            voxelIndexZ = t2;
+                        }
+                    }
+                }
+                else
+                {
+                    cVector3d p, n;
+
+                    if (cIntersectionSegmentEllipsoid(a_segmentPointA,
+                        a_segmentPointB,
+                        cVector3d(tpos[0] + 0.5 * voxelSize[0], tpos[1] + 0.5 * voxelSize[1], tpos[2] + 0.5 * voxelSize[2]),
+                        0.7*voxelSize[0] + collisionRadius,
+                        0.7*voxelSize[1] + collisionRadius,
+                        0.7*voxelSize[2] + collisionRadius,
+                        t_collisionPoint,
+                        t_collisionNormal,
+                        p,
+                        n) > 0)
+                    {
+                        // intersection occurred
+                        hit = true;
 
-                            if (level >= m_isosurfaceValue)
-                            {
-                                // compute position of texel in local space
-                                double tpos[3];
-                                tpos[0] = m_minCorner(0) + ((((double)t0 / texSize[0]) - m_minTextureCoord(0)) / (texRange(0))) * (objectRange(0));
-                                tpos[1] = m_minCorner(1) + ((((double)t1 / texSize[1]) - m_minTextureCoord(1)) / (texRange(1))) * (objectRange(1));
-                                tpos[2] = m_minCorner(2) + ((((double)t2 / texSize[2]) - m_minTextureCoord(2)) / (texRange(2))) * (objectRange(2));
-
-                                // check if point is located outside of object
-                                double distanceSq = cDistanceSq(cVector3d(tpos[0] + 0.5 * voxelSize[0], tpos[1] + 0.5 * voxelSize[1], tpos[2] + 0.5 * +voxelSize[2]), pointB);
-                                if (distanceSq < r2)
-                                {
-                                    // check intersection with segment and voxel (approximated by sphere)
-                                    cVector3d t_p, t_n;
-                                    cVector3d t_collisionPoint, t_collisionNormal;
-                                    double t_collisionDistanceSq;
-
-                                    if (a_settings.m_collisionRadius == 0)
-                                    {
-                                        if (cIntersectionSegmentBox(a_segmentPointA,
-                                            a_segmentPointB,
-                                            cVector3d(tpos[0] - (0.0 * voxelSize[0] + collisionRadius), tpos[1] - (0.0 * voxelSize[1] + collisionRadius), tpos[2] - (0.0 * voxelSize[2] + collisionRadius)),
-                                            cVector3d(tpos[0] + (1.0 * voxelSize[0] + collisionRadius), tpos[1] + (1.0 * voxelSize[1] + collisionRadius), tpos[2] + (1.0 * voxelSize[2] + collisionRadius)),
-                                            t_collisionPoint,
-                                            t_collisionNormal) > 0)
-                                        {
-                                            // intersection occurred
-                                            hit = true;
-
-                                            counter++;
-
-                                            // compute distance from collision point
-                                            t_collisionDistanceSq = cDistanceSq(a_segmentPointA, t_collisionPoint);
-
-                                            // if nearest, then select and store data.
-                                            if (t_collisionDistanceSq <= collisionDistanceSq)
-                                            {
-                                                collisionPoint = t_collisionPoint;
-                                                collisionNormal = t_collisionNormal;
-                                                collisionDistanceSq = t_collisionDistanceSq;
-                                                collisionPointV01 = 0.0;
-                                                collisionPointV02 = 0.0;
-                                                voxelIndexX = t0;
-                                                voxelIndexY = t1;
-                                                voxelIndexZ = t2;
-                                            }
-                                        }
-                                    }
-                                    else
-                                    {
-                                        cVector3d p, n;
-
-                                        if (cIntersectionSegmentEllipsoid(a_segmentPointA,
-                                            a_segmentPointB,
-                                            cVector3d(tpos[0] + 0.5 * voxelSize[0], tpos[1] + 0.5 * voxelSize[1], tpos[2] + 0.5 * voxelSize[2]),
-                                            0.7*voxelSize[0] + collisionRadius,
-                                            0.7*voxelSize[1] + collisionRadius,
-                                            0.7*voxelSize[2] + collisionRadius,
-                                            t_collisionPoint,
-                                            t_collisionNormal,
-                                            p,
-                                            n) > 0)
-                                        {
-                                            // intersection occurred
-                                            hit = true;
-
-                                            counter++;
-
-                                            // compute distance from collision point
-                                            t_collisionDistanceSq = cDistanceSq(a_segmentPointA, t_collisionPoint);
-
-                                            // if nearest, then select and store data.
-                                            if (t_collisionDistanceSq <= collisionDistanceSq)
-                                            {
-                                                collisionPoint = t_collisionPoint;
-                                                collisionNormal = t_collisionNormal;
-                                                collisionDistanceSq = t_collisionDistanceSq;
-                                                collisionPointV01 = 0.0;
-                                                collisionPointV02 = 0.0;
-                                                voxelIndexX = t0;
-                                                voxelIndexY = t1;
-                                                voxelIndexZ = t2;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
+                        counter++;
+
+                        // compute distance from collision point
+                        t_collisionDistanceSq = cDistanceSq(a_segmentPointA, t_collisionPoint);
+
+                        // if nearest, then select and store data.
+                        if (t_collisionDistanceSq <= collisionDistanceSq)
+                        {
+                            collisionPoint = t_collisionPoint;
+                            collisionNormal = t_collisionNormal;
+                            collisionDistanceSq = t_collisionDistanceSq;
+                            collisionPointV01 = 0.0;
+                            collisionPointV02 = 0.0;
+                            voxelIndexX = t0;
+                            voxelIndexY = t1;
+                            voxelIndexZ = t2;
                         }
                     }
                 }
@@ -1251,6 +1303,11 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
         }
     }
 
+    if (lockedImage != NULL)
+    {
+        lockedImage->releaseLock();
+    }
+
     // here we finally report the new collision to the collision event handler.
     if (hit)
     {
@@ -1330,6 +1387,126 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method polygonizes the volume on a regular grid, using an accessor
+    specialized at compile time for the voxel format of the image.
+
+    \param  a_image     3D image. Its format must match __T__.
+    \param  a_mesh      Mesh object.
+    \param  a_gridSize  Sampling grid size along each axis.
+    \param  a_padding   Padding added around the object along each axis.
+
+    \return __true__ if the format of the image matches __T__, __false__ otherwise.
+*/
+//==============================================================================
+template <class T> bool cVoxelObject::polygonizeTyped(cMultiImage* a_image, cMesh* a_mesh, const double a_gridSize[3], const double a_padding[3])
+{
+    // typed access to voxels
+    cMultiImageView<T> view(a_image);
+    if (!view.isValid()) { return (false); }
+
+    // compute range of object
+    cVector3d objectRange = m_maxCorner - m_minCorner;
+
+    // compute range of texture
+    cVector3d texRange = m_maxTextureCoord - m_minTextureCoord;
+
+    // get size of 3d texture
+    double texSize[3];
+    texSize[0] = (double)(view.getWidth());
+    texSize[1] = (double)(view.getHeight());
+    texSize[2] = (double)(view.getDepth());
+
+    // declared variables
+    const double* gridSize = a_gridSize;
+    const double* padding = a_padding;
+    cMarchingCubeGridCell gridCell;
+    cMarchingCubeTriangle triangles[16];
+    cVector3d p;
+
+    // parse volume
+    p(2) = m_minCorner(2) - padding[2];
+    while (p(2) < (m_maxCorner(2) + padding[2]))
+    {
+        p(1) = m_minCorner(1) - padding[1];
+        while (p(1) < (m_maxCorner(1) + padding[1]))
+        {
+            p(0) = m_minCorner(0) - padding[0];
+            while (p(0) < (m_maxCorner(0) + padding[0]))
+            {
+                // compute cell positions
+                gridCell.p[0] = p + cVector3d(0.0, 0.0, 0.0);
+                gridCell.p[1] = p + cVector3d(0.0, gridSize[1], 0.0);
+                gridCell.p[2] = p + cVector3d(gridSize[0], gridSize[1], 0.0);
+                gridCell.p[3] = p + cVector3d(gridSize[0], 0.0, 0.0);
+                gridCell.p[4] = p + cVector3d(0.0, 0.0, gridSize[2]);
+                gridCell.p[5] = p + cVector3d(0.0, gridSize[1], gridSize[2]);
+                gridCell.p[6] = p + cVector3d(gridSize[0], gridSize[1], gridSize[2]);
+                gridCell.p[7] = p + cVector3d(gridSize[0], 0.0, gridSize[2]);
+
+                // get cell value
+                for (int i = 0; i < 8; i++)
+                {
+                    // get voxel position
+                    cVector3d p = gridCell.p[i];
+
+                    // compute point in texels
+                    cVector3d texCoord;
+                    texCoord(0) = m_minTextureCoord(0) + ((p(0) - m_minCorner(0)) / (objectRange(0)) * (texRange(0)));
+                    texCoord(1) = m_minTextureCoord(1) + ((p(1) - m_minCorner(1)) / (objectRange(1)) * (texRange(1)));
+                    texCoord(2) = m_minTextureCoord(2) + ((p(2) - m_minCorner(2)) / (objectRange(2)) * (texRange(2)));
+
+                    // get voxel position (voxels outside of the volume have an isovalue of zero)
+                    int x = (int)(floor(texSize[0] * texCoord(0)));
+                    int y = (int)(floor(texSize[1] * texCoord(1)));
+                    int z = (int)(floor(texSize[2] * texCoord(2)));
+
+                    // convert alpha component to isovalue
+                    const float CONVERSION_FACTOR = (1.0f / 255.0f);
+                    gridCell.val[i] = CONVERSION_FACTOR * (float)(view.getAlphaChecked(x, y, z, 0));
+                }
+
+                // polygonize model
+                int numTriangles = cPolygonize(gridCell, m_isosurfaceValue, triangles);
+
+                // add triangles to mesh
+                for (int j = 0; j < numTriangles; j++)
+                {
+                    // compute surface normal (an interpolated normal would be better!)
+                    cVector3d normal = cComputeSurfaceNormal(triangles[j].p[0], triangles[j].p[1], triangles[j].p[2]);
+
+                    // create new triangle
+                    a_mesh->newTriangle(triangles[j].p[0],
+                                        triangles[j].p[1],
+                                        triangles[j].p[2],
+                                        normal, normal, normal);
+                }
+
+                // increment x
+                p(0) = p(0) + gridSize[0];
+            }
+
+            // increment y
+            p(1) = p(1) + gridSize[1];
+        }
+
+        // increment z
+        p(2) = p(2) + gridSize[2];
+
+        // verbose progress
+        if (true)
+        {
+            double range = (m_maxCorner(2) + padding[2]) - (m_minCorner(2) - padding[2]);
+            int progress = 100 * ((p(2) - (m_minCorner(2) - padding[2])) / range);
+            cout << "polygonization: "+cStr(progress) + "%                                                       \r";
+        }
+    }
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This method converts this voxel object into a triangle multi-mesh.\n
@@ -1363,7 +1540,9 @@ bool cVoxelObject::polygonize(cMultiMesh* a_multiMesh, double a_gridSizeX, doubl
 
 //==============================================================================
 /*!
-    This method converts this voxel object into a triangle mesh.\n
+    This method converts this voxel object into a triangle mesh.
+    The volume must be stored as 8-bit GL_LUMINANCE, GL_RGB or GL_RGBA voxels;
+    other formats are rejected.\n
 
     \param  a_mesh  Mesh object.
     \param  a_gridSizeX  Sampling grid size along __x__-axis
@@ -1381,12 +1560,12 @@ bool cVoxelObject::polygonize(cMesh* a_mesh, double a_gridSizeX, double a_gridSi
         return (C_ERROR);
     }
 
-    // backup border color
-    cColorb borderColor = m_texture->m_image->m_borderColor;
-
-    // assign new value to border color so that isovalue is zero when fetching
-    // voxel outside the boundaries of the 3D image
-    m_texture->m_image->m_borderColor.set(0.0, 0.0, 0.0, 0.0);
+    // polygonization requires a 3D image
+    cMultiImage* image = dynamic_cast<cMultiImage*>(m_texture->m_image.get());
+    if (image == NULL)
+    {
+        return (C_ERROR);
+    }
 
     // get size of 3d texture
     double texSize[3];
@@ -1415,12 +1594,6 @@ bool cVoxelObject::polygonize(cMesh* a_mesh, double a_gridSizeX, double a_gridSi
         }
     }
 
-    // compute range of object
-    cVector3d objectRange = m_maxCorner - m_minCorner;
-
-    // compute range of texture
-    cVector3d texRange = m_maxTextureCoord - m_minTextureCoord;
-
     // set grid size
     double gridSize[3];
     gridSize[0] = a_gridSizeX;
@@ -1435,11 +1608,6 @@ bool cVoxelObject::polygonize(cMesh* a_mesh, double a_gridSizeX, double a_gridSi
         }
     }
 
-    // declared variables
-    cMarchingCubeGridCell gridCell;
-    cMarchingCubeTriangle triangles[16];
-    cVector3d p;
-
     // compute padding
     double padding[3];
     for (int i = 0; i < 3; i++)
@@ -1447,108 +1615,899 @@ bool cVoxelObject::polygonize(cMesh* a_mesh, double a_gridSizeX, double a_gridSi
         padding[i] = cMax(st[i], gridSize[i]);
     }
 
-    // parse volume
-    p(2) = m_minCorner(2) - padding[2];
-    while (p(2) < (m_maxCorner(2) + padding[2]))
+    // polygonize volume using an accessor specialized for the voxel format
+    bool result = C_ERROR;
+    image->acquireLock();
+    switch (image->getFormat())
     {
-        p(1) = m_minCorner(1) - padding[1];
-        while (p(1) < (m_maxCorner(1) + padding[1]))
+    case GL_LUMINANCE:
+        result = polygonizeTyped<cVoxelFormatLuminance>(image, a_mesh, gridSize, padding);
+        break;
+
+    case GL_RGB:
+        result = polygonizeTyped<cVoxelFormatRGB>(image, a_mesh, gridSize, padding);
+        break;
+
+    case GL_RGBA:
+        result = polygonizeTyped<cVoxelFormatRGBA>(image, a_mesh, gridSize, padding);
+        break;
+
+    default:
+        // voxel format not supported
+        result = C_ERROR;
+        break;
+    }
+    image->releaseLock();
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method updates a triangle mesh by re-polygonizing only the regions of
+    the volume that have been modified since the last call.\n
+
+    The volume is sampled at the center of each voxel. It is divided into the
+    bricks defined by the associated image (see \ref cMultiImage::setBrickSize()),
+    and the triangles generated by each brick are recorded. On subsequent calls,
+    only the bricks modified through \ref cMultiImage::setVoxelColor() or 
+    \ref cMultiImage::markVoxelModified() (and their immediate neighbours) are
+    polygonized again. Triangles of the affected bricks are removed from the 
+    mesh and their slots and vertices are reused by the new triangles. If the 
+    mesh uses an AABB collision detector, the tree is refitted for the modified
+    triangles only.\n
+
+    A full polygonization is performed on the first call, when a different mesh
+    is passed as argument, or when the volume has been reallocated. The mesh 
+    should not be modified by other means between calls. As with 
+    \ref polygonize(), only 8-bit GL_LUMINANCE, GL_RGB and GL_RGBA volumes are
+    supported.
+
+    \param  a_mesh  Mesh object.
+
+    \return __true__ of the operation succeeds, __false__otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::polygonizeIncremental(cMesh* a_mesh)
+{
+    // sanity check
+    if ((a_mesh == NULL) || (m_texture == nullptr))
+    {
+        return (C_ERROR);
+    }
+
+    // incremental updates require a 3D image
+    cMultiImagePtr image = std::dynamic_pointer_cast<cMultiImage>(m_texture->m_image);
+    if (image == nullptr)
+    {
+        return (C_ERROR);
+    }
+
+    // only 8-bit luminance, RGB and RGBA voxels are supported
+    if ((image->getType() != GL_UNSIGNED_BYTE) ||
+        ((image->getFormat() != GL_LUMINANCE) && (image->getFormat() != GL_RGB) && (image->getFormat() != GL_RGBA)))
+    {
+        return (C_ERROR);
+    }
+
+    // get size of 3d texture
+    unsigned int texSize[3];
+    texSize[0] = image->getWidth();
+    texSize[1] = image->getHeight();
+    texSize[2] = image->getImageCount();
+
+    // sanity check
+    if ((texSize[0] == 0) || (texSize[1] == 0) || (texSize[2] == 0))
+    {
+        return (C_ERROR);
+    }
+
+    // compute mapping from voxel centers to local coordinates
+    cVector3d objectRange = m_maxCorner - m_minCorner;
+    cVector3d texRange = m_maxTextureCoord - m_minTextureCoord;
+    double scale[3];
+    double offset[3];
+    for (int i=0; i<3; i++)
+    {
+        if (texRange(i) == 0.0)
         {
-            p(0) = m_minCorner(0) - padding[0];
-            while (p(0) < (m_maxCorner(0) + padding[0]))
+            return (C_ERROR);
+        }
+        scale[i] = objectRange(i) / (texRange(i) * (double)(texSize[i]));
+        offset[i] = m_minCorner(i) + (((0.5 / (double)(texSize[i])) - m_minTextureCoord(i)) / texRange(i)) * objectRange(i);
+    }
+
+    // voxels may be modified by the removal thread while they are polygonized
+    cMultiImageLock lock(image.get());
+
+    // get brick layout
+    unsigned int brickSize = image->getBrickSize();
+    unsigned int brickCount[3];
+    image->getBrickCount(brickCount[0], brickCount[1], brickCount[2]);
+    unsigned int numBricks = brickCount[0] * brickCount[1] * brickCount[2];
+
+    // read modification counter before querying bricks
+    unsigned long long counter = image->getModificationCounter();
+
+    // check if a full polygonization is required
+    bool rebuild = ((a_mesh != m_polygonizeMesh) ||
+                    (image->getArray() != m_polygonizeData) ||
+                    (texSize[0] != m_polygonizeSize[0]) ||
+                    (texSize[1] != m_polygonizeSize[1]) ||
+                    (texSize[2] != m_polygonizeSize[2]) ||
+                    (brickSize != m_polygonizeSize[3]) ||
+                    (m_polygonizeBrickTriangles.size() != numBricks));
+
+    // build list of bricks to process
+    std::vector<unsigned int> bricks;
+    if (rebuild)
+    {
+        a_mesh->clear();
+        m_polygonizeBrickTriangles.clear();
+        m_polygonizeBrickTriangles.resize(numBricks);
+        m_polygonizeFreeVertices.clear();
+
+        bricks.resize(numBricks);
+        for (unsigned int i=0; i<numBricks; i++)
+        {
+            bricks[i] = i;
+        }
+
+        m_polygonizeMesh = a_mesh;
+        m_polygonizeData = image->getArray();
+        m_polygonizeSize[0] = texSize[0];
+        m_polygonizeSize[1] = texSize[1];
+        m_polygonizeSize[2] = texSize[2];
+        m_polygonizeSize[3] = brickSize;
+    }
+    else
+    {
+        std::vector<unsigned int> modified;
+        image->getModifiedBricks(m_polygonizeCounter, modified);
+        if (modified.size() == 0)
+        {
+            m_polygonizeCounter = counter;
+            return (C_SUCCESS);
+        }
+
+        // a modified voxel also affects the cells whose origin lies in the 
+        // previous voxel along each axis, which may belong to neighbouring bricks
+        std::vector<bool> selected(numBricks, false);
+        for (unsigned int i=0; i<modified.size(); i++)
+        {
+            int bx = (int)(modified[i] % brickCount[0]);
+            int by = (int)((modified[i] / brickCount[0]) % brickCount[1]);
+            int bz = (int)(modified[i] / (brickCount[0] * brickCount[1]));
+
+            for (int z=cMax(bz-1, 0); z<=bz; z++)
             {
-                // compute cell positions
-                gridCell.p[0] = p + cVector3d(0.0, 0.0, 0.0);
-                gridCell.p[1] = p + cVector3d(0.0, gridSize[1], 0.0);
-                gridCell.p[2] = p + cVector3d(gridSize[0], gridSize[1], 0.0);
-                gridCell.p[3] = p + cVector3d(gridSize[0], 0.0, 0.0);
-                gridCell.p[4] = p + cVector3d(0.0, 0.0, gridSize[2]);
-                gridCell.p[5] = p + cVector3d(0.0, gridSize[1], gridSize[2]);
-                gridCell.p[6] = p + cVector3d(gridSize[0], gridSize[1], gridSize[2]);
-                gridCell.p[7] = p + cVector3d(gridSize[0], 0.0, gridSize[2]);
+                for (int y=cMax(by-1, 0); y<=by; y++)
+                {
+                    for (int x=cMax(bx-1, 0); x<=bx; x++)
+                    {
+                        unsigned int index = x + brickCount[0] * (y + brickCount[1] * z);
+                        if (!selected[index])
+                        {
+                            selected[index] = true;
+                            bricks.push_back(index);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    m_polygonizeCounter = counter;
 
-                // get cell value
-                for (int i = 0; i < 8; i++)
+    // declared variables
+    cMarchingCubeGridCell gridCell;
+    cMarchingCubeTriangle triangles[16];
+    std::vector<unsigned int> modifiedTriangles;
+    std::vector<float> values;
+    const int cornerOffset[8][3] = { {0,0,0}, {0,1,0}, {1,1,0}, {1,0,0},
+                                     {0,0,1}, {0,1,1}, {1,1,1}, {1,0,1} };
+
+    for (unsigned int b=0; b<bricks.size(); b++)
+    {
+        unsigned int brick = bricks[b];
+        std::vector<unsigned int>& brickTriangles = m_polygonizeBrickTriangles[brick];
+
+        // remove previous triangles of brick and release their vertices
+        for (unsigned int i=0; i<brickTriangles.size(); i++)
+        {
+            unsigned int index = brickTriangles[i];
+            for (int j=0; j<3; j++)
+            {
+                m_polygonizeFreeVertices.push_back(a_mesh->m_triangles->getVertexIndex(index, j));
+            }
+            a_mesh->removeTriangle(index);
+            modifiedTriangles.push_back(index);
+        }
+        brickTriangles.clear();
+
+        // compute range of cells owned by brick. A cell is owned by the brick
+        // that contains its origin. Cells starting outside of the volume are
+        // owned by the bricks located on the boundary.
+        unsigned int minVoxel[3], maxVoxel[3];
+        image->getBrickRange(brick, minVoxel[0], minVoxel[1], minVoxel[2], maxVoxel[0], maxVoxel[1], maxVoxel[2]);
+
+        int cellMin[3], cellMax[3], sampleMax[3];
+        for (int i=0; i<3; i++)
+        {
+            cellMin[i] = (minVoxel[i] == 0) ? -1 : (int)(minVoxel[i]);
+            cellMax[i] = (int)(maxVoxel[i]);
+            sampleMax[i] = cellMax[i] + 1;
+        }
+
+        // sample isovalues of all cell corners
+        sampleVoxels(image.get(), cellMin, sampleMax, values);
+        int sx = sampleMax[0] - cellMin[0] + 1;
+        int sxy = sx * (sampleMax[1] - cellMin[1] + 1);
+
+        // polygonize cells
+        for (int z=cellMin[2]; z<=cellMax[2]; z++)
+        {
+            for (int y=cellMin[1]; y<=cellMax[1]; y++)
+            {
+                for (int x=cellMin[0]; x<=cellMax[0]; x++)
                 {
-                    // get voxel position
-                    cVector3d p = gridCell.p[i];
+                    // get cell values
+                    bool inside = false;
+                    bool outside = false;
+                    int base = (x - cellMin[0]) + sx * (y - cellMin[1]) + sxy * (z - cellMin[2]);
+                    for (int i=0; i<8; i++)
+                    {
+                        gridCell.val[i] = values[base + cornerOffset[i][0] + sx * cornerOffset[i][1] + sxy * cornerOffset[i][2]];
 
-                    // compute point in texels
-                    cVector3d texCoord;
-                    texCoord(0) = m_minTextureCoord(0) + ((p(0) - m_minCorner(0)) / (objectRange(0)) * (texRange(0)));
-                    texCoord(1) = m_minTextureCoord(1) + ((p(1) - m_minCorner(1)) / (objectRange(1)) * (texRange(1)));
-                    texCoord(2) = m_minTextureCoord(2) + ((p(2) - m_minCorner(2)) / (objectRange(2)) * (texRange(2)));
+                        if (gridCell.val[i] < m_isosurfaceValue) { inside = true; } else { outside = true; }
+                    }
 
-                    // color variable
-                    cColorf color;
+                    // skip cells that are not crossed by the isosurface
+                    if (!(inside && outside)) { continue; }
 
-                    // get voxel color given a texture coordinate
-#if 0
-                    // get voxel position
-                    double x, y, z;
-                    m_texture->m_image->getVoxelLocationInterpolated(texCoord, x, y, z, false);
-                  
-                    // get voxel color
-                    m_texture->m_image->getVoxelColorInterpolated(x, y, z, color);
-#else
-                    // get voxel position
-                    int x, y, z;
-                    m_texture->m_image->getVoxelLocation(texCoord, x, y, z, false);
-                  
-                    // get voxel color
-                    cColorb colorb;
-                    m_texture->m_image->getVoxelColor(x, y, z, colorb);
-                  
-                    // convert color to floating point format
-                    color = colorb.getColorf();
-#endif
-                  
-                    // convert color to isovalue by taking the luminance
-                    double isoValue = color.getA();
-                    gridCell.val[i] = isoValue;
+                    // compute cell positions
+                    for (int i=0; i<8; i++)
+                    {
+                        gridCell.p[i].set(offset[0] + scale[0] * (double)(x + cornerOffset[i][0]),
+                                          offset[1] + scale[1] * (double)(y + cornerOffset[i][1]),
+                                          offset[2] + scale[2] * (double)(z + cornerOffset[i][2]));
+                    }
+
+                    // polygonize cell
+                    int numTriangles = cPolygonize(gridCell, m_isosurfaceValue, triangles);
+
+                    // add triangles to mesh
+                    for (int j=0; j<numTriangles; j++)
+                    {
+                        // compute surface normal
+                        cVector3d normal = cComputeSurfaceNormal(triangles[j].p[0], triangles[j].p[1], triangles[j].p[2]);
+
+                        // allocate vertices, reusing released ones first
+                        unsigned int vertices[3];
+                        for (int k=0; k<3; k++)
+                        {
+                            if (m_polygonizeFreeVertices.size() > 0)
+                            {
+                                vertices[k] = m_polygonizeFreeVertices.back();
+                                m_polygonizeFreeVertices.pop_back();
+                                a_mesh->m_vertices->setLocalPos(vertices[k], triangles[j].p[k]);
+                                a_mesh->m_vertices->setNormal(vertices[k], normal);
+                            }
+                            else
+                            {
+                                vertices[k] = a_mesh->newVertex(triangles[j].p[k], normal);
+                            }
+                        }
+
+                        // create new triangle
+                        unsigned int index = a_mesh->newTriangle(vertices[0], vertices[1], vertices[2]);
+                        brickTriangles.push_back(index);
+                        modifiedTriangles.push_back(index);
+                    }
                 }
+            }
+        }
+    }
 
-                // polygonize model
-                int numTriangles = cPolygonize(gridCell, m_isosurfaceValue, triangles);
+    // refit collision tree on modified triangles
+    cCollisionAABB* collisionAABB = dynamic_cast<cCollisionAABB*>(a_mesh->getCollisionDetector());
+    if (collisionAABB != NULL)
+    {
+        collisionAABB->updateElements(modifiedTriangles);
+    }
 
-                // add triangles to mesh
-                for (int j = 0; j < numTriangles; j++)
+    // mark mesh for graphic update
+    a_mesh->markForUpdate(false);
+
+    // return success
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method collects the voxels located inside a box whose alpha value 
+    is greater or equal to a threshold. Voxels are listed in memory order. 
+    Portions of the box located outside of the volume are ignored.
+
+    \param  a_image      Image containing the voxels.
+    \param  a_min        Lowest voxel coordinate of the box.
+    \param  a_max        Highest voxel coordinate of the box.
+    \param  a_threshold  Alpha threshold.
+    \param  a_voxels     Returned list of voxels.
+*/
+//==============================================================================
+void cVoxelObject::findSolidVoxels(cImage* a_image, 
+                                   const int a_min[3], 
+                                   const int a_max[3], 
+                                   const unsigned int a_threshold, 
+                                   std::vector<cVoxelCoord>& a_voxels)
+{
+    a_voxels.clear();
+
+    // use an accessor specialized for the voxel format when possible
+    cMultiImage* image = dynamic_cast<cMultiImage*>(a_image);
+    if ((image != NULL) && (image->getType() == GL_UNSIGNED_BYTE))
+    {
+        switch (image->getFormat())
+        {
+        case GL_LUMINANCE:
+            findSolidVoxelsTyped<cVoxelFormatLuminance>(image, a_min, a_max, a_threshold, a_voxels);
+            return;
+
+        case GL_RGB:
+            findSolidVoxelsTyped<cVoxelFormatRGB>(image, a_min, a_max, a_threshold, a_voxels);
+            return;
+
+        case GL_RGBA:
+            findSolidVoxelsTyped<cVoxelFormatRGBA>(image, a_min, a_max, a_threshold, a_voxels);
+            return;
+        }
+    }
+
+    // generic access
+    for (int z=cMax(a_min[2], 0); z<=a_max[2]; z++)
+    {
+        for (int y=cMax(a_min[1], 0); y<=a_max[1]; y++)
+        {
+            for (int x=cMax(a_min[0], 0); x<=a_max[0]; x++)
+            {
+                cColorb color;
+                if (a_image->getVoxelColor(x, y, z, color) && (color.getA() >= a_threshold))
                 {
-                    // compute surface normal (an interpolated normal would be better!)
-                    cVector3d normal = cComputeSurfaceNormal(triangles[j].p[0], triangles[j].p[1], triangles[j].p[2]);
+                    cVoxelCoord coord;
+                    coord.m_x = x;
+                    coord.m_y = y;
+                    coord.m_z = z;
+                    a_voxels.push_back(coord);
+                }
+            }
+        }
+    }
+}
 
-                    // create new triangle
-                    a_mesh->newTriangle(triangles[j].p[0],
-                                        triangles[j].p[1],
-                                        triangles[j].p[2],
-                                        normal, normal, normal);
+
+//==============================================================================
+/*!
+    This method collects the voxels located inside a box whose alpha value
+    is greater or equal to a threshold, using an accessor specialized for 
+    the voxel format.
+
+    \param  a_image      Image containing the voxels. Its format must match __T__.
+    \param  a_min        Lowest voxel coordinate of the box.
+    \param  a_max        Highest voxel coordinate of the box.
+    \param  a_threshold  Alpha threshold.
+    \param  a_voxels     Returned list of voxels.
+*/
+//==============================================================================
+template <class T> void cVoxelObject::findSolidVoxelsTyped(cMultiImage* a_image, 
+                                                           const int a_min[3], 
+                                                           const int a_max[3], 
+                                                           const unsigned int a_threshold, 
+                                                           std::vector<cVoxelCoord>& a_voxels)
+{
+    cMultiImageView<T> view(a_image);
+    if (!view.isValid()) { return; }
+
+    // clamp box to volume
+    int minX = cMax(a_min[0], 0);
+    int minY = cMax(a_min[1], 0);
+    int minZ = cMax(a_min[2], 0);
+    int maxX = cMin(a_max[0], (int)(view.getWidth()) - 1);
+    int maxY = cMin(a_max[1], (int)(view.getHeight()) - 1);
+    int maxZ = cMin(a_max[2], (int)(view.getDepth()) - 1);
+
+    for (int z=minZ; z<=maxZ; z++)
+    {
+        for (int y=minY; y<=maxY; y++)
+        {
+            const unsigned char* row = view.getRow(y, z);
+            for (int x=minX; x<=maxX; x++)
+            {
+                if (cMultiImageView<T>::getAlphaInRow(row, x) >= a_threshold)
+                {
+                    cVoxelCoord coord;
+                    coord.m_x = x;
+                    coord.m_y = y;
+                    coord.m_z = z;
+                    a_voxels.push_back(coord);
                 }
+            }
+        }
+    }
+}
 
-                // increment x
-                p(0) = p(0) + gridSize[0];
+
+//==============================================================================
+/*!
+    This method samples the isovalues (alpha component ranging from 0.0 to 1.0)
+    of all voxels located inside a box. Voxels located outside of the volume
+    are assigned an isovalue of zero. Values are returned in memory order, 
+    __x__ varying fastest.
+
+    \param  a_image   Image containing the voxels.
+    \param  a_min     Lowest voxel coordinate of the box.
+    \param  a_max     Highest voxel coordinate of the box.
+    \param  a_values  Returned isovalues.
+*/
+//==============================================================================
+void cVoxelObject::sampleVoxels(cImage* a_image, 
+                                const int a_min[3], 
+                                const int a_max[3], 
+                                std::vector<float>& a_values)
+{
+    int sizeX = a_max[0] - a_min[0] + 1;
+    int sizeY = a_max[1] - a_min[1] + 1;
+    int sizeZ = a_max[2] - a_min[2] + 1;
+    a_values.assign(sizeX * sizeY * sizeZ, 0.0f);
+
+    // use an accessor specialized for the voxel format when possible
+    cMultiImage* image = dynamic_cast<cMultiImage*>(a_image);
+    if ((image != NULL) && (image->getType() == GL_UNSIGNED_BYTE))
+    {
+        switch (image->getFormat())
+        {
+        case GL_LUMINANCE:
+            sampleVoxelsTyped<cVoxelFormatLuminance>(image, a_min, a_max, a_values);
+            return;
+
+        case GL_RGB:
+            sampleVoxelsTyped<cVoxelFormatRGB>(image, a_min, a_max, a_values);
+            return;
+
+        case GL_RGBA:
+            sampleVoxelsTyped<cVoxelFormatRGBA>(image, a_min, a_max, a_values);
+            return;
+        }
+    }
+
+    // generic access
+    const float CONVERSION_FACTOR = (1.0f / 255.0f);
+    int index = 0;
+    for (int z=a_min[2]; z<=a_max[2]; z++)
+    {
+        for (int y=a_min[1]; y<=a_max[1]; y++)
+        {
+            for (int x=a_min[0]; x<=a_max[0]; x++)
+            {
+                cColorb color;
+                if ((x >= 0) && (y >= 0) && (z >= 0) && a_image->getVoxelColor(x, y, z, color))
+                {
+                    a_values[index] = CONVERSION_FACTOR * (float)(color.getA());
+                }
+                index++;
             }
+        }
+    }
+}
 
-            // increment y
-            p(1) = p(1) + gridSize[1];
+
+//==============================================================================
+/*!
+    This method samples the isovalues of all voxels located inside a box, 
+    using an accessor specialized for the voxel format. The value array must
+    be sized and cleared to zero by the caller.
+
+    \param  a_image   Image containing the voxels. Its format must match __T__.
+    \param  a_min     Lowest voxel coordinate of the box.
+    \param  a_max     Highest voxel coordinate of the box.
+    \param  a_values  Returned isovalues.
+*/
+//==============================================================================
+template <class T> void cVoxelObject::sampleVoxelsTyped(cMultiImage* a_image, 
+                                                        const int a_min[3], 
+                                                        const int a_max[3], 
+                                                        std::vector<float>& a_values)
+{
+    cMultiImageView<T> view(a_image);
+    if (!view.isValid()) { return; }
+
+    const float CONVERSION_FACTOR = (1.0f / 255.0f);
+    int sizeX = a_max[0] - a_min[0] + 1;
+    int sizeXY = sizeX * (a_max[1] - a_min[1] + 1);
+
+    // clamp box to volume
+    int minX = cMax(a_min[0], 0);
+    int minY = cMax(a_min[1], 0);
+    int minZ = cMax(a_min[2], 0);
+    int maxX = cMin(a_max[0], (int)(view.getWidth()) - 1);
+    int maxY = cMin(a_max[1], (int)(view.getHeight()) - 1);
+    int maxZ = cMin(a_max[2], (int)(view.getDepth()) - 1);
+
+    for (int z=minZ; z<=maxZ; z++)
+    {
+        for (int y=minY; y<=maxY; y++)
+        {
+            const unsigned char* row = view.getRow(y, z);
+            float* values = &a_values[(minX - a_min[0]) + sizeX * (y - a_min[1]) + sizeXY * (z - a_min[2])];
+            for (int x=minX; x<=maxX; x++)
+            {
+                *values++ = CONVERSION_FACTOR * (float)(cMultiImageView<T>::getAlphaInRow(row, x));
+            }
         }
+    }
+}
 
-        // increment z
-        p(2) = p(2) + gridSize[2];
 
-        // verbose progress
-        if (true)
+//==============================================================================
+/*!
+    This method sets the hardness of the material identified by a label. The
+    label of a voxel is given by its first color component (red for RGB and 
+    RGBA images, luminance for luminance images). Material is removed at a 
+    speed equal to the removal rate divided by the hardness. Use a very large
+    hardness (e.g. __C_LARGE__) for materials that cannot be removed.
+
+    \param  a_label     Material label.
+    \param  a_hardness  Hardness of the material. Default value is 1.0.
+*/
+//==============================================================================
+void cVoxelObject::setMaterialHardness(const unsigned char a_label, const double a_hardness)
+{
+    m_materialHardness[a_label] = cMax(a_hardness, C_SMALL);
+}
+
+
+//==============================================================================
+/*!
+    This method removes material from all voxels located inside the tool, and
+    computes the reaction force of the material on the tool. \n
+
+    The opacity (alpha component) of each voxel inside the tool is reduced 
+    by the removal rate times the time step, divided by the hardness of its 
+    material. Fractional amounts are distributed randomly so that small time
+    steps remove the correct volume on average. The modified region is 
+    recorded in the image so that textures and incrementally polygonized 
+    meshes are updated on their next update. \n
+
+    The reaction force is a simple penalty model: each solid voxel inside 
+    the tool pushes the tool away from its center proportionally to its 
+    opacity and penetration depth. The sum is averaged over the tool volume 
+    and scaled by the removal stiffness. \n
+
+    Only luminance and RGBA images can be modified. RGB images have no 
+    opacity component: every voxel is fully opaque, no voxel is modified,
+    and the method returns zero with a zero force. For luminance images the
+    luminance value is both the opacity of the voxel and its material label, 
+    so the hardness applied to a voxel depends on its current opacity and 
+    changes as material is removed. \n
+
+    The tool position is expressed in the local coordinates of the object. 
+    Voxel data is modified while holding the lock of the image 
+    (\ref cMultiImage::acquireLock()), which is also taken by cTexture3d when
+    transferring the volume to the GPU, by \ref polygonize() and 
+    \ref polygonizeIncremental(), and by collision detection. Collision 
+    queries can therefore run on the haptic thread while removal requested 
+    with \ref requestRemoval() is in progress.
+
+    \param  a_toolPos   Position of the tool in local coordinates.
+    \param  a_timeStep  Time step in seconds.
+    \param  a_force     Returned reaction force in local coordinates.
+
+    \return Volume of material removed, in local units.
+*/
+//==============================================================================
+double cVoxelObject::removeVoxels(const cVector3d& a_toolPos, const double a_timeStep, cVector3d& a_force)
+{
+    a_force.zero();
+
+    // sanity check
+    if (m_texture == nullptr)
+    {
+        return (0.0);
+    }
+
+    // material removal requires a 3D image
+    cMultiImage* image = dynamic_cast<cMultiImage*>(m_texture->m_image.get());
+    if ((image == NULL) || (image->getType() != GL_UNSIGNED_BYTE))
+    {
+        return (0.0);
+    }
+
+    // remove material using an accessor specialized for the voxel format.
+    // RGB voxels have no opacity to reduce and are left unchanged.
+    double volume = 0.0;
+    image->acquireLock();
+    switch (image->getFormat())
+    {
+    case GL_LUMINANCE:
+        volume = removeVoxelsTyped<cVoxelFormatLuminance>(image, a_toolPos, a_timeStep, a_force);
+        break;
+
+    case GL_RGBA:
+        volume = removeVoxelsTyped<cVoxelFormatRGBA>(image, a_toolPos, a_timeStep, a_force);
+        break;
+    }
+    image->releaseLock();
+
+    // update total volume
+    m_removalMutex.acquire();
+    m_removedVolume += volume;
+    m_removalMutex.release();
+
+    return (volume);
+}
+
+
+//==============================================================================
+/*!
+    This method removes material from all voxels located inside the tool, 
+    using an accessor specialized for the voxel format.
+
+    \param  a_image     3D image. Its format must match __T__.
+    \param  a_toolPos   Position of the tool in local coordinates.
+    \param  a_timeStep  Time step in seconds.
+    \param  a_force     Returned reaction force in local coordinates.
+
+    \return Volume of material removed, in local units.
+*/
+//==============================================================================
+template <class T> double cVoxelObject::removeVoxelsTyped(cMultiImage* a_image, 
+                                                          const cVector3d& a_toolPos, 
+                                                          const double a_timeStep, 
+                                                          cVector3d& a_force)
+{
+    cMultiImageView<T> view(a_image);
+    if (!view.isValid()) { return (0.0); }
+
+    // get size of volume
+    int size[3];
+    size[0] = (int)(view.getWidth());
+    size[1] = (int)(view.getHeight());
+    size[2] = (int)(view.getDepth());
+
+    // compute mapping from voxel centers to local coordinates
+    cVector3d objectRange = m_maxCorner - m_minCorner;
+    cVector3d texRange = m_maxTextureCoord - m_minTextureCoord;
+    double scale[3];
+    double offset[3];
+    for (int i=0; i<3; i++)
+    {
+        if ((texRange(i) == 0.0) || (objectRange(i) == 0.0))
         {
-            double range = (m_maxCorner(2) + padding[2]) - (m_minCorner(2) - padding[2]);
-            int progress = 100 * ((p(2) - (m_minCorner(2) - padding[2])) / range);
-            cout << "polygonization: "+cStr(progress) + "%                                                       \r";
+            return (0.0);
         }
+        scale[i] = objectRange(i) / (texRange(i) * (double)(size[i]));
+        offset[i] = m_minCorner(i) + (((0.5 / (double)(size[i])) - m_minTextureCoord(i)) / texRange(i)) * objectRange(i);
     }
+    double voxelVolume = fabs(scale[0] * scale[1] * scale[2]);
 
-    // restore border color
-    m_texture->m_image->m_borderColor = borderColor;
+    // compute range of voxels covered by tool
+    double r = m_removalToolRadius;
+    int vmin[3], vmax[3];
+    for (int i=0; i<3; i++)
+    {
+        double a = (a_toolPos(i) - r - offset[i]) / scale[i];
+        double b = (a_toolPos(i) + r - offset[i]) / scale[i];
+        vmin[i] = cMax((int)(ceil(cMin(a, b))), 0);
+        vmax[i] = cMin((int)(floor(cMax(a, b))), size[i] - 1);
+        if (vmin[i] > vmax[i])
+        {
+            return (0.0);
+        }
+    }
 
-    // return success
-    return (C_SUCCESS);
+    // amount of opacity removed from a voxel of unit hardness
+    double decrement = 255.0 * m_removalRate * cMax(a_timeStep, 0.0);
+
+    // parse voxels
+    const double CONVERSION_FACTOR = (1.0 / 255.0);
+    unsigned int removed = 0;
+    unsigned int numToolVoxels = 0;
+    cVector3d force(0.0, 0.0, 0.0);
+
+    for (int z=vmin[2]; z<=vmax[2]; z++)
+    {
+        double dz = offset[2] + scale[2] * (double)z - a_toolPos(2);
+        for (int y=vmin[1]; y<=vmax[1]; y++)
+        {
+            double dy = offset[1] + scale[1] * (double)y - a_toolPos(1);
+            unsigned char* row = view.getRow(y, z);
+            for (int x=vmin[0]; x<=vmax[0]; x++)
+            {
+                double dx = offset[0] + scale[0] * (double)x - a_toolPos(0);
+
+                // check if voxel is located inside the tool
+                double distance;
+                if (m_removalToolShape == C_VOXEL_TOOL_CUBE)
+                {
+                    distance = cMax(fabs(dx), cMax(fabs(dy), fabs(dz)));
+                }
+                else
+                {
+                    distance = sqrt(dx*dx + dy*dy + dz*dz);
+                }
+                if (distance > r) { continue; }
+                numToolVoxels++;
+
+                // skip empty voxels
+                unsigned char* voxel = row + x * T::BYTES_PER_VOXEL;
+                unsigned char alpha = T::getAlpha(voxel);
+                if (alpha == 0) { continue; }
+
+                // reaction force pushes the tool away from the voxel
+                if (distance > C_SMALL)
+                {
+                    double k = CONVERSION_FACTOR * (double)(alpha) * (r - distance) / distance;
+                    force.add(-k * dx, -k * dy, -k * dz);
+                }
+
+                // compute amount removed, distributing fractional amounts randomly
+                double amount = cMin(decrement / m_materialHardness[voxel[0]], 255.0);
+                unsigned int step = (unsigned int)(amount);
+                m_removalRandomState ^= (m_removalRandomState << 13);
+                m_removalRandomState ^= (m_removalRandomState >> 17);
+                m_removalRandomState ^= (m_removalRandomState << 5);
+                if ((double)(m_removalRandomState) * (1.0 / 4294967296.0) < (amount - (double)(step)))
+                {
+                    step++;
+                }
+
+                // update voxel
+                unsigned char newAlpha = (alpha > step) ? (unsigned char)(alpha - step) : 0;
+                T::setAlpha(voxel, newAlpha);
+                removed += alpha - newAlpha;
+            }
+        }
+    }
+
+    // compute reaction force
+    if (numToolVoxels > 0)
+    {
+        a_force = (m_removalStiffness / (double)(numToolVoxels)) * force;
+    }
+
+    // record modified region
+    if (removed > 0)
+    {
+        a_image->markRegionModified(vmin[0], vmin[1], vmin[2], vmax[0], vmax[1], vmax[2]);
+    }
+
+    // return volume removed
+    return (CONVERSION_FACTOR * (double)(removed) * voxelVolume);
+}
+
+
+//==============================================================================
+/*!
+    This method requests material removal around the tool, and returns 
+    immediately. This method is designed to be called from the haptics loop:
+    requests are processed by a worker thread, and requests received while
+    the worker is busy are merged into a single request at the latest tool
+    position with their time steps accumulated. The reaction force of the 
+    last completed request is retrieved by calling \ref getRemovalForce().
+
+    \param  a_toolPos   Position of the tool in local coordinates.
+    \param  a_timeStep  Time step in seconds.
+*/
+//==============================================================================
+void cVoxelObject::requestRemoval(const cVector3d& a_toolPos, const double a_timeStep)
+{
+    m_removalMutex.acquire();
+
+    // update pending request
+    m_removalRequestPos = a_toolPos;
+    m_removalRequestTimeStep += a_timeStep;
+
+    // submit request to worker thread if none is pending
+    if (!m_removalRequestQueued)
+    {
+        if (m_removalThread == NULL)
+        {
+            m_removalThread = new cThreadPool(1);
+        }
+        m_removalRequestQueued = true;
+        m_removalThread->addTask(std::bind(&cVoxelObject::processRemovalRequest, this));
+    }
+
+    m_removalMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method processes the pending removal request. It is executed by the
+    worker thread.
+*/
+//==============================================================================
+void cVoxelObject::processRemovalRequest()
+{
+    // retrieve pending request
+    m_removalMutex.acquire();
+    cVector3d pos = m_removalRequestPos;
+    double timeStep = m_removalRequestTimeStep;
+    m_removalRequestTimeStep = 0.0;
+    m_removalRequestQueued = false;
+    m_removalMutex.release();
+
+    // remove material
+    cVector3d force;
+    removeVoxels(pos, timeStep, force);
+
+    // store result
+    m_removalMutex.acquire();
+    m_removalForce = force;
+    m_removalMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method waits until all pending removal requests have completed.
+*/
+//==============================================================================
+void cVoxelObject::waitForRemoval()
+{
+    if (m_removalThread != NULL)
+    {
+        m_removalThread->waitForCompletion();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the reaction force computed by the last completed 
+    removal request, in local coordinates.
+
+    \return Reaction force.
+*/
+//==============================================================================
+cVector3d cVoxelObject::getRemovalForce()
+{
+    m_removalMutex.acquire();
+    cVector3d force = m_removalForce;
+    m_removalMutex.release();
+    return (force);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the total volume of material removed since the last
+    call to \ref resetRemovedVolume().
+
+    \return Volume removed, in local units.
+*/
+//==============================================================================
+double cVoxelObject::getRemovedVolume()
+{
+    m_removalMutex.acquire();
+    double volume = m_removedVolume;
+    m_removalMutex.release();
+    return (volume);
+}
+
+
+//==============================================================================
+/*!
+    This method resets the total volume of material removed.
+*/
+//==============================================================================
+void cVoxelObject::resetRemovedVolume()
+{
+    m_removalMutex.acquire();
+    m_removedVolume = 0.0;
+    m_removalMutex.release();
 }
 
 
@@ -48,11 +48,14 @@
 //------------------------------------------------------------------------------
 #include "world/CMesh.h"
 #include "world/CMultiMesh.h"
+#include "system/CMutex.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
+class cMultiImage;
+class cThreadPool;
 const int C_NUM_VOXEL_RENDERING_MODES = 9;
 //------------------------------------------------------------------------------
 
@@ -91,6 +94,17 @@ struct cVoxelCoordList
 #endif  // DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+/*!
+    Defines the shapes of tools used to remove material from a voxel object.
+*/
+//------------------------------------------------------------------------------
+enum cVoxelToolShape
+{
+    C_VOXEL_TOOL_SPHERE,
+    C_VOXEL_TOOL_CUBE
+};
+
 
 //==============================================================================
 /*!
@@ -211,6 +225,64 @@ public:
     //! This method converts this voxel object into a triangle multi-mesh.
     bool polygonize(cMultiMesh* a_multiMesh, double a_gridSizeX = -1.0, double a_gridSizeY = -1.0, double a_gridSizeZ = -1.0);
 
+    //! This method updates a triangle mesh by re-polygonizing only the regions of the volume that have been modified since the last call.
+    bool polygonizeIncremental(cMesh* a_mesh);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - MATERIAL REMOVAL:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the shape of the material removal tool.
+    void setRemovalToolShape(const cVoxelToolShape a_shape) { m_removalToolShape = a_shape; }
+
+    //! This method returns the shape of the material removal tool.
+    cVoxelToolShape getRemovalToolShape() const { return (m_removalToolShape); }
+
+    //! This method sets the radius (or half size for a cube) of the material removal tool, in local coordinates.
+    void setRemovalToolRadius(const double a_radius) { m_removalToolRadius = fabs(a_radius); }
+
+    //! This method returns the radius of the material removal tool.
+    double getRemovalToolRadius() const { return (m_removalToolRadius); }
+
+    //! This method sets the removal rate, expressed as the fraction of a voxel of unit hardness removed per second.
+    void setRemovalRate(const double a_removalRate) { m_removalRate = fabs(a_removalRate); }
+
+    //! This method returns the removal rate.
+    double getRemovalRate() const { return (m_removalRate); }
+
+    //! This method sets the stiffness used to compute the reaction force of the material on the tool.
+    void setRemovalStiffness(const double a_stiffness) { m_removalStiffness = fabs(a_stiffness); }
+
+    //! This method returns the stiffness used to compute the reaction force.
+    double getRemovalStiffness() const { return (m_removalStiffness); }
+
+    //! This method sets the hardness of the material identified by a label.
+    void setMaterialHardness(const unsigned char a_label, const double a_hardness);
+
+    //! This method returns the hardness of the material identified by a label.
+    double getMaterialHardness(const unsigned char a_label) const { return (m_materialHardness[a_label]); }
+
+    //! This method removes material around the tool and computes the reaction force.
+    double removeVoxels(const cVector3d& a_toolPos, const double a_timeStep, cVector3d& a_force);
+
+    //! This method requests material removal on the worker thread and returns immediately.
+    void requestRemoval(const cVector3d& a_toolPos, const double a_timeStep);
+
+    //! This method waits until all pending removal requests have completed.
+    void waitForRemoval();
+
+    //! This method returns the reaction force computed by the last completed removal request.
+    cVector3d getRemovalForce();
+
+    //! This method returns the total volume removed since the last reset.
+    double getRemovedVolume();
+
+    //! This method resets the total volume removed.
+    void resetRemovedVolume();
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -255,6 +327,27 @@ protected:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings);
 
+    //! This method collects the voxels of a box whose alpha value reaches a threshold.
+    void findSolidVoxels(cImage* a_image, const int a_min[3], const int a_max[3], const unsigned int a_threshold, std::vector<cVoxelCoord>& a_voxels);
+
+    //! This method collects the voxels of a box whose alpha value reaches a threshold, for a given voxel format.
+    template <class T> void findSolidVoxelsTyped(cMultiImage* a_image, const int a_min[3], const int a_max[3], const unsigned int a_threshold, std::vector<cVoxelCoord>& a_voxels);
+
+    //! This method samples the isovalues of a box of voxels. Voxels located outside of the volume are set to zero.
+    void sampleVoxels(cImage* a_image, const int a_min[3], const int a_max[3], std::vector<float>& a_values);
+
+    //! This method samples the isovalues of a box of voxels, for a given voxel format.
+    template <class T> void sampleVoxelsTyped(cMultiImage* a_image, const int a_min[3], const int a_max[3], std::vector<float>& a_values);
+
+    //! This method polygonizes the volume on a regular grid, for a given voxel format.
+    template <class T> bool polygonizeTyped(cMultiImage* a_image, cMesh* a_mesh, const double a_gridSize[3], const double a_padding[3]);
+
+    //! This method removes material around the tool, for a given voxel format.
+    template <class T> double removeVoxelsTyped(cMultiImage* a_image, const cVector3d& a_toolPos, const double a_timeStep, cVector3d& a_force);
+
+    //! This method processes the pending removal request on the worker thread.
+    void processRemovalRequest();
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -293,6 +386,77 @@ protected:
     std::vector<cVoxelCoordList> m_voxelCoordList;
 
 
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - INCREMENTAL POLYGONIZATION:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Mesh updated by the last call to \ref polygonizeIncremental().
+    cMesh* m_polygonizeMesh;
+
+    //! Pointer to voxel data used during the last incremental polygonization.
+    const unsigned char* m_polygonizeData;
+
+    //! Size of volume (x, y, z) and brick size used during the last incremental polygonization.
+    unsigned int m_polygonizeSize[4];
+
+    //! Value of the image modification counter at the last incremental polygonization.
+    unsigned long long m_polygonizeCounter;
+
+    //! List of triangles generated by each brick of the volume.
+    std::vector< std::vector<unsigned int> > m_polygonizeBrickTriangles;
+
+    //! List of vertices released by removed triangles, available for reuse.
+    std::vector<unsigned int> m_polygonizeFreeVertices;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - MATERIAL REMOVAL:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Shape of the material removal tool.
+    cVoxelToolShape m_removalToolShape;
+
+    //! Radius of the material removal tool.
+    double m_removalToolRadius;
+
+    //! Fraction of a voxel of unit hardness removed per second.
+    double m_removalRate;
+
+    //! Stiffness used to compute the reaction force.
+    double m_removalStiffness;
+
+    //! Hardness of each material label.
+    std::vector<double> m_materialHardness;
+
+    //! State of the random generator used to distribute fractional removal.
+    unsigned int m_removalRandomState;
+
+    //! Worker thread processing removal requests.
+    cThreadPool* m_removalThread;
+
+    //! Mutex protecting removal requests and results.
+    cMutex m_removalMutex;
+
+    //! If __true__, a request has been submitted to the worker thread and not yet started.
+    bool m_removalRequestQueued;
+
+    //! Position of the tool of the pending request.
+    cVector3d m_removalRequestPos;
+
+    //! Accumulated time step of the pending request.
+    double m_removalRequestTimeStep;
+
+    //! Reaction force computed by the last completed request.
+    cVector3d m_removalForce;
+
+    //! Total volume removed since the last reset.
+    double m_removedVolume;
+
+
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS - SHADERS:
     //--------------------------------------------------------------------------
@@ -0,0 +1,164 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "check.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// reads a file into memory
+vector<unsigned char> readFile(const string& a_filename)
+{
+    ifstream in(a_filename.c_str(), ios::binary);
+    return (vector<unsigned char>((istreambuf_iterator<char>(in)), istreambuf_iterator<char>()));
+}
+
+// writes memory to a file
+void writeFile(const string& a_filename, const vector<unsigned char>& a_data)
+{
+    ofstream out(a_filename.c_str(), ios::binary);
+    out.write((const char*)&a_data[0], a_data.size());
+}
+
+// checks that a corrupted file is rejected and leaves the object empty
+void testCorrupted(const vector<unsigned char>& a_data)
+{
+    writeFile("test-corrupted.cmm", a_data);
+
+    cMultiMesh object;
+    CHECK(!cLoadFileCMM(&object, "test-corrupted.cmm"));
+    CHECK(object.getNumMeshes() == 0);
+}
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // create a model with two meshes and their collision trees
+    cMultiMesh model;
+    cCreateSphere(model.newMesh(), 0.1);
+    cCreateBox(model.newMesh(), 0.2, 0.1, 0.3);
+    model.getMesh(1)->setLocalPos(0.5, 0.0, 0.0);
+    model.createAABBCollisionDetector(0.01);
+    CHECK(cSaveFileCMM(&model, "test-model.cmm"));
+
+    // round trip
+    cMultiMesh loaded;
+    CHECK(cLoadFileCMM(&loaded, "test-model.cmm"));
+    CHECK(loaded.getNumMeshes() == 2);
+    for (int i=0; (i<2) && (i<loaded.getNumMeshes()); i++)
+    {
+        cMesh* a = model.getMesh(i);
+        cMesh* b = loaded.getMesh(i);
+        CHECK(a->getNumVertices() == b->getNumVertices());
+        CHECK(a->getNumTriangles() == b->getNumTriangles());
+        CHECK(cEqualPoints(a->getLocalPos(), b->getLocalPos()));
+        for (unsigned int j=0; (j<a->getNumVertices()) && (j<b->getNumVertices()); j++)
+        {
+            CHECK(cEqualPoints(a->m_vertices->getLocalPos(j), b->m_vertices->getLocalPos(j)));
+        }
+
+        cCollisionAABB* treeA = dynamic_cast<cCollisionAABB*>(a->getCollisionDetector());
+        cCollisionAABB* treeB = dynamic_cast<cCollisionAABB*>(b->getCollisionDetector());
+        CHECK((treeA != NULL) && (treeB != NULL));
+        if ((treeA != NULL) && (treeB != NULL))
+        {
+            CHECK(treeA->getNodes().size() == treeB->getNodes().size());
+            CHECK(treeA->getRootIndex() == treeB->getRootIndex());
+        }
+    }
+
+    // truncated files and files of another version or byte order are rejected
+    vector<unsigned char> data = readFile("test-model.cmm");
+    CHECK(data.size() > 1000);
+    if (data.size() > 1000)
+    {
+        vector<unsigned char> truncated(data.begin(), data.end() - 100);
+        testCorrupted(truncated);
+
+        vector<unsigned char> version = data;
+        version[8] ^= 0xff;
+        testCorrupted(version);
+
+        vector<unsigned char> byteOrder = data;
+        std::swap(byteOrder[20], byteOrder[23]);
+        std::swap(byteOrder[21], byteOrder[22]);
+        testCorrupted(byteOrder);
+    }
+
+    // collision trees containing cycles or shared subtrees are rejected
+    cMesh* mesh = model.getMesh(1);
+    cCollisionAABB* tree = dynamic_cast<cCollisionAABB*>(mesh->getCollisionDetector());
+    CHECK(tree != NULL);
+    if (tree != NULL)
+    {
+        vector<cCollisionAABBNode> nodes = tree->getNodes();
+        int root = tree->getRootIndex();
+
+        cCollisionAABB restored;
+        CHECK(restored.restore(mesh->m_triangles, nodes, root, 0.01));
+
+        vector<cCollisionAABBNode> cycle = nodes;
+        cycle[root].m_leftSubTree = root;
+        CHECK(!restored.restore(mesh->m_triangles, cycle, root, 0.01));
+
+        vector<cCollisionAABBNode> shared = nodes;
+        shared[root].m_leftSubTree = shared[root].m_rightSubTree;
+        CHECK(!restored.restore(mesh->m_triangles, shared, root, 0.01));
+    }
+
+    return (CHECK_RESULT());
+}
@@ -0,0 +1,185 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "check.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// reads a file into memory
+vector<unsigned char> readFile(const string& a_filename)
+{
+    ifstream in(a_filename.c_str(), ios::binary);
+    return (vector<unsigned char>((istreambuf_iterator<char>(in)), istreambuf_iterator<char>()));
+}
+
+// writes memory to a file
+void writeFile(const string& a_filename, const vector<unsigned char>& a_data)
+{
+    ofstream out(a_filename.c_str(), ios::binary);
+    out.write((const char*)&a_data[0], a_data.size());
+}
+
+// writes a little-endian 32-bit value
+void writeUInt32(vector<unsigned char>& a_data, size_t a_offset, unsigned int a_value)
+{
+    for (int i=0; i<4; i++)
+    {
+        a_data[a_offset + i] = (unsigned char)(a_value >> (8 * i));
+    }
+}
+
+// checks that a file round trip preserves all mipmap levels
+void testRoundTrip(cCompressedImagePtr a_image, const string& a_filename)
+{
+    CHECK(a_image->saveToFile(a_filename));
+
+    cCompressedImagePtr loaded = cCompressedImage::create();
+    CHECK(loaded->loadFromFile(a_filename));
+    CHECK(loaded->getWidth() == a_image->getWidth());
+    CHECK(loaded->getHeight() == a_image->getHeight());
+    CHECK(loaded->getFormat() == a_image->getFormat());
+    CHECK(loaded->getNumLevels() == a_image->getNumLevels());
+    CHECK(loaded->getSizeInBytes() == a_image->getSizeInBytes());
+    if (loaded->getSizeInBytes() == a_image->getSizeInBytes())
+    {
+        CHECK(memcmp(loaded->getLevelData(0), a_image->getLevelData(0), a_image->getSizeInBytes()) == 0);
+    }
+}
+
+// checks that a file with the given header dimensions is rejected
+void testMalformed(const vector<unsigned char>& a_file, size_t a_widthOffset, size_t a_heightOffset,
+                   unsigned int a_width, unsigned int a_height, const string& a_filename)
+{
+    vector<unsigned char> data = a_file;
+    writeUInt32(data, a_widthOffset, a_width);
+    writeUInt32(data, a_heightOffset, a_height);
+    writeFile(a_filename, data);
+
+    cCompressedImagePtr image = cCompressedImage::create();
+    CHECK(!image->loadFromFile(a_filename));
+    CHECK(!image->isInitialized());
+}
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // size computations
+    CHECK(cCompressedImage::querySize(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 4, 4, 1) == 8);
+    CHECK(cCompressedImage::querySize(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 5, 3, 1) == 32);
+    CHECK(cCompressedImage::querySize(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 8, 8, 4) == 32 + 8 + 8 + 8);
+    CHECK(cCompressedImage::querySize(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 4194304, 16384, 1) == 0);
+    CHECK(cCompressedImage::querySize(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 0xffffffff, 0xffffffff, 1) == 0);
+    CHECK(cCompressedImage::querySize(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 8, 8, 5) == 0);
+    CHECK(cCompressedImage::querySize(0, 8, 8, 1) == 0);
+    CHECK(!cCompressedImage::create()->allocate(4194304, 16384, GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
+
+    // compress a noisy image with all mipmap levels
+    cImagePtr image = cImage::create();
+    image->allocate(64, 32, GL_RGBA);
+    srand(1);
+    for (unsigned int i=0; i<image->getSizeInBytes(); i++)
+    {
+        image->getData()[i] = (unsigned char)(rand());
+    }
+
+    GLenum formats[] = { GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT };
+    for (int i=0; i<3; i++)
+    {
+        cCompressedImagePtr compressed = cCompressedImage::create();
+        CHECK(compressed->compress(image, formats[i], true));
+        CHECK(compressed->getNumLevels() == 7);
+
+        cImagePtr decompressed = cImage::create();
+        CHECK(compressed->decompress(decompressed, 0));
+        CHECK((decompressed->getWidth() == 64) && (decompressed->getHeight() == 32));
+
+        testRoundTrip(compressed, "test-compressed-image.dds");
+        testRoundTrip(compressed, "test-compressed-image.ktx");
+    }
+
+    // headers announcing images larger than the file are rejected before allocation
+    cCompressedImagePtr small = cCompressedImage::create();
+    CHECK(small->compress(image, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, false));
+    CHECK(small->saveToFile("test-compressed-image.dds"));
+    CHECK(small->saveToFile("test-compressed-image.ktx"));
+
+    vector<unsigned char> dds = readFile("test-compressed-image.dds");
+    CHECK(dds.size() > 192);
+    if (dds.size() > 192)
+    {
+        dds.resize(192);
+        testMalformed(dds, 16, 12, 4194304, 16384, "test-malformed.dds");
+        testMalformed(dds, 16, 12, 16384, 16384, "test-malformed.dds");
+        testMalformed(dds, 16, 12, 0xffffffff, 0xffffffff, "test-malformed.dds");
+        testMalformed(dds, 16, 12, 0, 64, "test-malformed.dds");
+    }
+
+    vector<unsigned char> ktx = readFile("test-compressed-image.ktx");
+    CHECK(ktx.size() > 64);
+    if (ktx.size() > 64)
+    {
+        testMalformed(ktx, 36, 40, 4194304, 16384, "test-malformed.ktx");
+        testMalformed(ktx, 36, 40, 16384, 16384, "test-malformed.ktx");
+        testMalformed(ktx, 36, 40, 0xffffffff, 0xffffffff, "test-malformed.ktx");
+        testMalformed(ktx, 36, 40, 0, 64, "test-malformed.ktx");
+    }
+
+    return (CHECK_RESULT());
+}
@@ -0,0 +1,150 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED CONSTANTS
+//---------------------------------------------------------------------------
+
+// number of runs of each operation, the fastest one is reported
+const int NUM_RUNS = 5;
+
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// returns the name of a pixel format
+string formatName(GLenum a_format)
+{
+    switch (a_format)
+    {
+        case GL_LUMINANCE:          return ("L");
+        case GL_LUMINANCE_ALPHA:    return ("LA");
+        case GL_RGB:                return ("RGB");
+        default:                    return ("RGBA");
+    }
+}
+
+// creates an image filled with random pixels
+cImagePtr createRandomImage(unsigned int a_width, unsigned int a_height, GLenum a_format)
+{
+    cImagePtr image = cImage::create();
+    image->allocate(a_width, a_height, a_format);
+    for (unsigned int i=0; i<image->getSizeInBytes(); i++)
+    {
+        image->getData()[i] = (unsigned char)(rand());
+    }
+    return (image);
+}
+
+// runs an operation several times and prints the fastest time in milliseconds
+void measure(const string& a_name, const function<void()>& a_operation)
+{
+    double best = C_LARGE;
+    for (int i=0; i<NUM_RUNS; i++)
+    {
+        cPrecisionClock clock;
+        clock.start(true);
+        a_operation();
+        best = cMin(best, clock.getCurrentTimeSeconds());
+    }
+    cout << setw(24) << left << a_name << fixed << setprecision(2) << 1000.0 * best << " ms" << endl;
+}
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // image size, 8K by default
+    unsigned int width = 7680;
+    unsigned int height = 4320;
+    if (argc == 3)
+    {
+        width = (unsigned int)(atoi(argv[1]));
+        height = (unsigned int)(atoi(argv[2]));
+    }
+
+    cout << "cImage benchmark, " << width << "x" << height << " pixels, "
+         << cThreadPool::getSharedThreadPool()->getNumThreads() << " worker threads" << endl << endl;
+
+    // format conversions
+    const GLenum formats[] = { GL_LUMINANCE, GL_LUMINANCE_ALPHA, GL_RGB, GL_RGBA };
+    for (int i=0; i<4; i++)
+    {
+        cImagePtr src = createRandomImage(width, height, formats[i]);
+        for (int j=0; j<4; j++)
+        {
+            if (i == j) { continue; }
+            cImagePtr dst = cImage::create();
+            dst->allocate(width, height, formats[j]);
+            measure("copyTo " + formatName(formats[i]) + "->" + formatName(formats[j]), [&]()
+            {
+                src->copyTo(0, 0, width, height, dst, 0, 0);
+            });
+        }
+    }
+    cout << endl;
+
+    // pixel operations
+    cImagePtr image = createRandomImage(width, height, GL_RGBA);
+    measure("setTransparentColor", [&]() { image->setTransparentColor(0x10, 0x20, 0x30, 0x40); });
+    measure("setTransparency", [&]() { image->setTransparency(0x80); });
+    measure("flipHorizontal", [&]() { image->flipHorizontal(); });
+
+    return (0);
+}
@@ -0,0 +1,284 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "check.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED CONSTANTS
+//---------------------------------------------------------------------------
+
+// pixel formats covered by the conversion kernels
+const GLenum FORMATS[] = { GL_LUMINANCE, GL_LUMINANCE_ALPHA, GL_RGB, GL_RGBA };
+const unsigned int NUM_FORMATS = 4;
+
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// returns the number of components of a pixel format
+unsigned int numComponents(GLenum a_format)
+{
+    switch (a_format)
+    {
+        case GL_LUMINANCE:          return (1);
+        case GL_LUMINANCE_ALPHA:    return (2);
+        case GL_RGB:                return (3);
+        default:                    return (4);
+    }
+}
+
+// converts one pixel the way the conversion kernels are specified
+void convertPixel(const unsigned char* a_src, GLenum a_srcFormat, unsigned char* a_dst, GLenum a_dstFormat)
+{
+    unsigned char r, g, b, l, a;
+    switch (a_srcFormat)
+    {
+        case GL_LUMINANCE:          r = g = b = l = a_src[0]; a = 0xff; break;
+        case GL_LUMINANCE_ALPHA:    r = g = b = l = a_src[0]; a = a_src[1]; break;
+        case GL_RGB:                r = a_src[0]; g = a_src[1]; b = a_src[2]; a = 0xff; break;
+        default:                    r = a_src[0]; g = a_src[1]; b = a_src[2]; a = a_src[3]; break;
+    }
+    if ((a_srcFormat == GL_RGB) || (a_srcFormat == GL_RGBA))
+    {
+        l = (unsigned char)(((unsigned int)(r) + (unsigned int)(g) + (unsigned int)(b)) / 3);
+    }
+
+    switch (a_dstFormat)
+    {
+        case GL_LUMINANCE:          a_dst[0] = l; break;
+        case GL_LUMINANCE_ALPHA:    a_dst[0] = l; a_dst[1] = a; break;
+        case GL_RGB:                a_dst[0] = r; a_dst[1] = g; a_dst[2] = b; break;
+        default:                    a_dst[0] = r; a_dst[1] = g; a_dst[2] = b; a_dst[3] = a; break;
+    }
+}
+
+// creates an image filled with random pixels
+cImagePtr createRandomImage(unsigned int a_width, unsigned int a_height, GLenum a_format)
+{
+    cImagePtr image = cImage::create();
+    image->allocate(a_width, a_height, a_format);
+    for (unsigned int i=0; i<image->getSizeInBytes(); i++)
+    {
+        image->getData()[i] = (unsigned char)(rand());
+    }
+    return (image);
+}
+
+// checks a copy of an area against the reference conversion, and that pixels outside the area are untouched
+void checkCopy(cImagePtr a_src, unsigned int a_srcX, unsigned int a_srcY, unsigned int a_sizeX, unsigned int a_sizeY,
+               cImagePtr a_dst, unsigned int a_dstX, unsigned int a_dstY)
+{
+    vector<unsigned char> before(a_dst->getData(), a_dst->getData() + a_dst->getSizeInBytes());
+    a_src->copyTo(a_srcX, a_srcY, a_sizeX, a_sizeY, a_dst, a_dstX, a_dstY);
+
+    unsigned int srcBpp = numComponents(a_src->getFormat());
+    unsigned int dstBpp = numComponents(a_dst->getFormat());
+    int errors = 0;
+    for (unsigned int y=0; y<a_dst->getHeight(); y++)
+    {
+        for (unsigned int x=0; x<a_dst->getWidth(); x++)
+        {
+            unsigned int offset = dstBpp * (x + y * a_dst->getWidth());
+            unsigned char expected[4];
+            memcpy(expected, &before[offset], dstBpp);
+            if ((x >= a_dstX) && (x < a_dstX + a_sizeX) && (y >= a_dstY) && (y < a_dstY + a_sizeY))
+            {
+                unsigned int sx = a_srcX + x - a_dstX;
+                unsigned int sy = a_srcY + y - a_dstY;
+                convertPixel(a_src->getData() + srcBpp * (sx + sy * a_src->getWidth()), a_src->getFormat(),
+                             expected, a_dst->getFormat());
+            }
+            if (memcmp(expected, a_dst->getData() + offset, dstBpp) != 0)
+            {
+                errors++;
+            }
+        }
+    }
+    CHECK(errors == 0);
+}
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    srand(1);
+
+    // widths cover the vector loops and their scalar tails, the largest
+    // image is split across threads
+    const unsigned int sizes[][2] = { { 1, 1 }, { 7, 3 }, { 37, 19 }, { 613, 211 } };
+
+    // every pair of formats, whole images and sub-areas
+    for (unsigned int s=0; s<4; s++)
+    {
+        unsigned int w = sizes[s][0];
+        unsigned int h = sizes[s][1];
+        for (unsigned int i=0; i<NUM_FORMATS; i++)
+        {
+            for (unsigned int j=0; j<NUM_FORMATS; j++)
+            {
+                cImagePtr src = createRandomImage(w, h, FORMATS[i]);
+                checkCopy(src, 0, 0, w, h, createRandomImage(w, h, FORMATS[j]), 0, 0);
+                checkCopy(src, w/3, h/4, w/2 + 1, h/2 + 1, createRandomImage(w + 5, h + 2, FORMATS[j]), 3, 1);
+
+                // convert replaces the image with a converted copy
+                cImagePtr converted = src->copy();
+                CHECK(converted->convert(FORMATS[j]));
+                CHECK(converted->getFormat() == FORMATS[j]);
+                cImagePtr reference = createRandomImage(w, h, FORMATS[j]);
+                checkCopy(src, 0, 0, w, h, reference, 0, 0);
+                CHECK(memcmp(converted->getData(), reference->getData(), reference->getSizeInBytes()) == 0);
+            }
+        }
+    }
+
+    // copy within the same image with overlapping areas
+    for (unsigned int i=0; i<NUM_FORMATS; i++)
+    {
+        cImagePtr image = createRandomImage(613, 211, FORMATS[i]);
+        cImagePtr source = image->copy();
+        image->copyTo(0, 0, 600, 200, image, 5, 7);
+
+        cImagePtr expected = source->copy();
+        source->copyTo(0, 0, 600, 200, expected, 5, 7);
+        CHECK(memcmp(image->getData(), expected->getData(), expected->getSizeInBytes()) == 0);
+
+        // an image whose data overlaps another image
+        image = source->copy();
+        unsigned int lineSize = numComponents(FORMATS[i]) * 613;
+        cImagePtr view = cImage::create();
+        view->setData(image->getData() + 3 * lineSize, 200 * lineSize, false);
+        view->setProperties(613, 200, FORMATS[i], GL_UNSIGNED_BYTE);
+        image->copyTo(0, 0, 613, 200, view, 0, 0);
+        CHECK(memcmp(image->getData() + 3 * lineSize, source->getData(), 200 * lineSize) == 0);
+    }
+
+    // transparency
+    cImagePtr image = createRandomImage(613, 211, GL_RGBA);
+    cImagePtr original = image->copy();
+    for (unsigned int i=0; i<image->getWidth() * image->getHeight(); i+=3)
+    {
+        memcpy(image->getData() + 4 * i, "\x10\x20\x30", 3);
+    }
+    cImagePtr marked = image->copy();
+    image->setTransparentColor(0x10, 0x20, 0x30, 0x40);
+    int errors = 0;
+    for (unsigned int i=0; i<image->getWidth() * image->getHeight(); i++)
+    {
+        const unsigned char* p = image->getData() + 4 * i;
+        const unsigned char* q = marked->getData() + 4 * i;
+        bool match = (q[0] == 0x10) && (q[1] == 0x20) && (q[2] == 0x30);
+        if ((memcmp(p, q, 3) != 0) || (p[3] != (match ? 0x40 : q[3]))) { errors++; }
+    }
+    CHECK(errors == 0);
+
+    image->setTransparency(0x80);
+    errors = 0;
+    for (unsigned int i=0; i<image->getWidth() * image->getHeight(); i++)
+    {
+        if ((memcmp(image->getData() + 4 * i, marked->getData() + 4 * i, 3) != 0) ||
+            (image->getData()[4 * i + 3] != 0x80)) { errors++; }
+    }
+    CHECK(errors == 0);
+
+    // flipping twice restores the image, flipping once reverses the rows
+    image = original->copy();
+    image->flipHorizontal();
+    unsigned int lineSize = 4 * image->getWidth();
+    errors = 0;
+    for (unsigned int y=0; y<image->getHeight(); y++)
+    {
+        if (memcmp(image->getData() + y * lineSize,
+                   original->getData() + (image->getHeight() - 1 - y) * lineSize, lineSize) != 0) { errors++; }
+    }
+    CHECK(errors == 0);
+    image->flipHorizontal();
+    CHECK(memcmp(image->getData(), original->getData(), original->getSizeInBytes()) == 0);
+
+    // image sets are decoded in place, files that do not match the first one are rejected
+    vector<cImagePtr> slices;
+    vector<string> filenames;
+    for (unsigned int i=0; i<4; i++)
+    {
+        slices.push_back(createRandomImage(37, 19, GL_RGB));
+    }
+    slices[2] = createRandomImage(37, 19, GL_RGBA);
+    slices.push_back(createRandomImage(19, 37, GL_RGB));
+    for (unsigned int i=0; i<slices.size(); i++)
+    {
+        filenames.push_back("multi-image-" + cStr(i) + ".png");
+        CHECK(slices[i]->saveToFile(filenames[i]));
+    }
+    cMultiImagePtr multiImage = cMultiImage::create();
+    CHECK(multiImage->loadFromFiles(filenames) == 3);
+    CHECK(multiImage->getImageCount() == 5);
+    unsigned int sliceSize = slices[0]->getSizeInBytes();
+    for (unsigned int i=0; i<slices.size(); i++)
+    {
+        const unsigned char* slice = multiImage->getData() + i * sliceSize;
+        if ((i == 2) || (i == 4))
+        {
+            vector<unsigned char> zero(sliceSize, 0);
+            CHECK(memcmp(slice, &zero[0], sliceSize) == 0);
+        }
+        else
+        {
+            CHECK(memcmp(slice, slices[i]->getData(), sliceSize) == 0);
+        }
+    }
+
+    return (CHECK_RESULT());
+}
@@ -0,0 +1,179 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <cmath>
+#include <fstream>
+#include <string>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "check.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// writes a text file
+void writeFile(const string& a_filename, const string& a_text)
+{
+    ofstream out(a_filename.c_str(), ios::binary);
+    out << a_text;
+}
+
+// returns the total area of the triangles of a mesh
+double computeArea(cMesh* a_mesh)
+{
+    double area = 0.0;
+    for (unsigned int i=0; i<a_mesh->getNumTriangles(); i++)
+    {
+        cVector3d p0 = a_mesh->m_vertices->getLocalPos(a_mesh->m_triangles->getVertexIndex0(i));
+        cVector3d p1 = a_mesh->m_vertices->getLocalPos(a_mesh->m_triangles->getVertexIndex1(i));
+        cVector3d p2 = a_mesh->m_vertices->getLocalPos(a_mesh->m_triangles->getVertexIndex2(i));
+        area += 0.5 * cCross(p1 - p0, p2 - p0).length();
+    }
+    return (area);
+}
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // small file: two materials, texture coordinates and normals, a quad,
+    // relative indices, CRLF line endings and a face referencing a missing vertex
+    writeFile("test-small.mtl",
+              "newmtl red\n"
+              "Kd 1.0 0.0 0.0\n"
+              "newmtl blue\n"
+              "Kd 0.0 0.0 1.0\n");
+    writeFile("test-small.obj",
+              "# test model\r\n"
+              "mtllib test-small.mtl\r\n"
+              "v 0 0 0\r\n"
+              "v 1 0 0\r\n"
+              "v 1 1 0\r\n"
+              "v 0 1 0\r\n"
+              "vt 0 0\r\n"
+              "vt 1 0\r\n"
+              "vt 1 1\r\n"
+              "vt 0 1\r\n"
+              "vn 0 0 1\r\n"
+              "g square\r\n"
+              "usemtl red\r\n"
+              "f 1/1/1 2/2/1 3/3/1 4/4/1\r\n"
+              "v 0 0 2.5e0\r\n"
+              "usemtl blue\r\n"
+              "f -5 -4 -1\r\n"
+              "f 1 2 9\r\n");
+
+    cMultiMesh small;
+    CHECK(cLoadFileOBJ(&small, "test-small.obj"));
+    CHECK(small.getNumMeshes() == 2);
+    if (small.getNumMeshes() == 2)
+    {
+        cMesh* red = small.getMesh(0);
+        cMesh* blue = small.getMesh(1);
+        CHECK(red->m_name == "square");
+        CHECK(red->m_material->m_diffuse.getR() == 1.0f);
+        CHECK(blue->m_material->m_diffuse.getB() == 1.0f);
+        CHECK(red->getNumTriangles() == 2);
+        CHECK(red->getNumVertices() == 4);
+        CHECK(fabs(computeArea(red) - 1.0) < 1e-9);
+        CHECK(cEqualPoints(red->m_vertices->getTexCoord(2), cVector3d(1, 1, 0)));
+        CHECK(cEqualPoints(red->m_vertices->getNormal(0), cVector3d(0, 0, 1)));
+        CHECK(blue->getNumTriangles() == 1);
+        CHECK(fabs(computeArea(blue) - 1.25) < 1e-9);
+    }
+
+    // large file, parsed in several chunks: a grid written row by row, with
+    // faces using relative indices and materials alternating between rows
+    const int n = 300;
+    const double step = 1.0 / (double)(n - 1);
+    string text = "mtllib test-small.mtl\n";
+    text.reserve(16 * 1024 * 1024);
+    char line[256];
+    for (int y=0; y<n; y++)
+    {
+        for (int x=0; x<n; x++)
+        {
+            sprintf(line, "v %.9f %.9f %d\nvt %.9f %.9f\nvn 0 0 1\n", x * step, y * step, 0, x * step, y * step);
+            text += line;
+        }
+        if (y > 0)
+        {
+            text += (y % 2) ? "usemtl red\n" : "usemtl blue\n";
+            for (int x=0; x<n-1; x++)
+            {
+                int a = -2 * n + x;
+                int b = -n + x;
+                sprintf(line, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, a + 1, a + 1, a + 1, b + 1, b + 1, b + 1, b, b, b);
+                text += line;
+            }
+        }
+    }
+    writeFile("test-large.obj", text);
+    CHECK(text.size() > 4 * C_OBJ_MIN_CHUNK_SIZE);
+
+    cMultiMesh large;
+    CHECK(cLoadFileOBJ(&large, "test-large.obj"));
+    CHECK(large.getNumMeshes() == 2);
+    if (large.getNumMeshes() == 2)
+    {
+        int numRed = n / 2;
+        int numBlue = (n - 1) - numRed;
+        CHECK(large.getMesh(0)->getNumTriangles() == (unsigned int)(2 * (n - 1) * numRed));
+        CHECK(large.getMesh(1)->getNumTriangles() == (unsigned int)(2 * (n - 1) * numBlue));
+        CHECK(fabs(computeArea(large.getMesh(0)) - numRed * step) < 1e-6);
+        CHECK(fabs(computeArea(large.getMesh(1)) - numBlue * step) < 1e-6);
+
+        // vertices shared by faces of the same material are merged
+        CHECK(large.getMesh(0)->getNumVertices() == (unsigned int)(2 * n * numRed));
+    }
+
+    return (CHECK_RESULT());
+}
@@ -0,0 +1,197 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "check.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// writes a text file
+void writeFile(const string& a_filename, const string& a_text)
+{
+    ofstream out(a_filename.c_str(), ios::binary);
+    out << a_text;
+}
+
+// returns the total area of the triangles of a multimesh
+double computeArea(cMultiMesh* a_object)
+{
+    double area = 0.0;
+    for (int m=0; m<a_object->getNumMeshes(); m++)
+    {
+        cMesh* mesh = a_object->getMesh(m);
+        for (unsigned int i=0; i<mesh->getNumTriangles(); i++)
+        {
+            cVector3d p0 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex0(i));
+            cVector3d p1 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex1(i));
+            cVector3d p2 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex2(i));
+            area += 0.5 * cCross(p1 - p0, p2 - p0).length();
+        }
+    }
+    return (area);
+}
+
+// loads a file, with or without vertex welding
+bool load(cMultiMesh* a_object, const string& a_filename, bool a_optimize)
+{
+    bool optimize = g_meshLoaderShouldOptimize;
+    g_meshLoaderShouldOptimize = a_optimize;
+    bool result = cLoadFileSTL(a_object, a_filename);
+    g_meshLoaderShouldOptimize = optimize;
+    return (result);
+}
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // binary round trip of a box (6 faces of 1x2, 1x3 and 2x3)
+    cMultiMesh box;
+    cCreateBox(box.newMesh(), 1.0, 2.0, 3.0);
+    unsigned int numTriangles = box.getMesh(0)->getNumTriangles();
+    CHECK(cSaveFileSTL(&box, "test-box.stl"));
+
+    cMultiMesh flat;
+    CHECK(load(&flat, "test-box.stl", false));
+    CHECK(flat.getNumMeshes() == 1);
+    if (flat.getNumMeshes() == 1)
+    {
+        CHECK(flat.getMesh(0)->getNumTriangles() == numTriangles);
+        CHECK(flat.getMesh(0)->getNumVertices() == 3 * numTriangles);
+        CHECK(fabs(computeArea(&flat) - 22.0) < 1e-5);
+    }
+
+    // welding merges the corners shared by facets
+    cMultiMesh welded;
+    CHECK(load(&welded, "test-box.stl", true));
+    CHECK(welded.getNumMeshes() == 1);
+    if (welded.getNumMeshes() == 1)
+    {
+        CHECK(welded.getMesh(0)->getNumTriangles() == numTriangles);
+        CHECK(welded.getMesh(0)->getNumVertices() == 8);
+        CHECK(fabs(computeArea(&welded) - 22.0) < 1e-5);
+    }
+
+    // the automatic optimization of the load path reports the reduction
+    cMultiMesh reported;
+    bool optimize = g_meshLoaderShouldOptimize;
+    g_meshLoaderShouldOptimize = true;
+    CHECK(reported.loadFromFile("test-box.stl"));
+    g_meshLoaderShouldOptimize = optimize;
+    const cMeshOptimizationReport& report = reported.getLastOptimizationReport();
+    CHECK(report.m_numVerticesBefore == 3 * numTriangles);
+    CHECK(report.m_numVerticesAfter == 8);
+    CHECK(report.m_numTrianglesBefore == numTriangles);
+    CHECK(report.m_numTrianglesAfter == numTriangles);
+
+    // binary file whose header starts with "solid"
+    {
+        ifstream in("test-box.stl", ios::binary);
+        vector<char> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        memcpy(&data[0], "solid box", 9);
+        writeFile("test-solid.stl", string(data.begin(), data.end()));
+    }
+    cMultiMesh solid;
+    CHECK(load(&solid, "test-solid.stl", false));
+    CHECK(solid.getNumMeshes() == 1);
+    if (solid.getNumMeshes() == 1)
+    {
+        CHECK(solid.getMesh(0)->getNumTriangles() == numTriangles);
+    }
+
+    // ASCII file with a triangle, a quad triangulated as a fan, exponents, 
+    // signs and CRLF line endings
+    writeFile("test-ascii.stl",
+              "solid test\r\n"
+              "  facet normal 0 0 1\r\n"
+              "    outer loop\r\n"
+              "      vertex 0 0 0\r\n"
+              "      vertex 1 0 0\r\n"
+              "      vertex 0 1 0\r\n"
+              "    endloop\r\n"
+              "  endfacet\r\n"
+              "  facet normal 0 0 1\r\n"
+              "    outer loop\r\n"
+              "      vertex 0 0 1e0\r\n"
+              "      vertex 2.0 0 1.0\r\n"
+              "      vertex 2.0 2.5E-1 +1\r\n"
+              "      vertex -0.0 0.25 1\r\n"
+              "    endloop\r\n"
+              "  endfacet\r\n"
+              "endsolid test\r\n");
+
+    cMultiMesh ascii;
+    CHECK(load(&ascii, "test-ascii.stl", false));
+    CHECK(ascii.getNumMeshes() == 1);
+    if (ascii.getNumMeshes() == 1)
+    {
+        CHECK(ascii.getMesh(0)->getNumTriangles() == 3);
+        CHECK(fabs(computeArea(&ascii) - 1.0) < 1e-6);
+    }
+
+    // truncated binary file is rejected
+    {
+        ifstream in("test-box.stl", ios::binary);
+        vector<char> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        writeFile("test-truncated.stl", string(data.begin(), data.end() - 20));
+    }
+    cMultiMesh truncated;
+    CHECK(!load(&truncated, "test-truncated.stl", false));
+    CHECK(truncated.getNumMeshes() == 0);
+
+    return (CHECK_RESULT());
+}
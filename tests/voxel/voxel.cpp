@@ -0,0 +1,125 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "check.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED CONSTANTS
+//---------------------------------------------------------------------------
+
+// resolution of the voxel model
+const unsigned int RESOLUTION = 32;
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // create a solid unit cube centered at the origin
+    cVoxelObject* object = new cVoxelObject();
+    object->m_minCorner.set(-0.5,-0.5,-0.5);
+    object->m_maxCorner.set( 0.5, 0.5, 0.5);
+    object->m_minTextureCoord.set(0.0, 0.0, 0.0);
+    object->m_maxTextureCoord.set(1.0, 1.0, 1.0);
+
+    cMultiImagePtr image = cMultiImage::create();
+    image->allocate(RESOLUTION, RESOLUTION, RESOLUTION, GL_RGBA);
+    for (unsigned int z=0; z<RESOLUTION; z++)
+    {
+        for (unsigned int y=0; y<RESOLUTION; y++)
+        {
+            for (unsigned int x=0; x<RESOLUTION; x++)
+            {
+                image->setVoxelColor(x, y, z, cColorb(0xff, 0xff, 0xff, 0xff));
+            }
+        }
+    }
+    cTexture3dPtr texture = cTexture3d::create();
+    object->setTexture(texture);
+    texture->setImage(image);
+
+    // carve the face crossed by the segment while collisions are computed.
+    // the removal worker modifies the voxels read by the collision queries,
+    // but never deeper than the tool radius.
+    object->setRemovalToolRadius(0.1);
+    object->setRemovalRate(50.0);
+
+    cCollisionSettings settings;
+    settings.m_checkHapticObjects = true;
+    settings.m_collisionRadius = 0.01;
+
+    int errors = 0;
+    for (int i=0; i<2000; i++)
+    {
+        object->requestRemoval(cVector3d(-0.5, 0.0, 0.0), 0.001);
+
+        cCollisionRecorder recorder;
+        if (!object->computeCollisionDetection(cVector3d(-1.0, 0.0, 0.0), cVector3d(1.0, 0.0, 0.0), recorder, settings))
+        {
+            errors++;
+        }
+        else
+        {
+            double x = recorder.m_nearestCollision.m_localPos(0);
+            if ((x < -0.6) || (x > -0.3)) { errors++; }
+        }
+    }
+    object->waitForRemoval();
+    CHECK(errors == 0);
+    CHECK(object->getRemovedVolume() > 0.0);
+
+    // the carved face is now hit further along the segment
+    cCollisionRecorder recorder;
+    CHECK(object->computeCollisionDetection(cVector3d(-1.0, 0.0, 0.0), cVector3d(1.0, 0.0, 0.0), recorder, settings));
+    CHECK(recorder.m_nearestCollision.m_localPos(0) > -0.45);
+
+    delete object;
+
+    return (CHECK_RESULT());
+}
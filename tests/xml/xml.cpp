@@ -0,0 +1,220 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "check.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// writes a text file
+void writeFile(const string& a_filename, const string& a_text)
+{
+    ofstream out(a_filename.c_str(), ios::binary);
+    out << a_text;
+}
+
+// returns true if two lists of numbers are identical
+bool equal(const vector<double>& a_values, const double* a_expected, size_t a_count)
+{
+    if (a_values.size() != a_count) return (false);
+    for (size_t i=0; i<a_count; i++)
+    {
+        if (a_values[i] != a_expected[i]) return (false);
+    }
+    return (true);
+}
+
+
+//---------------------------------------------------------------------------
+// MAIN
+//---------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    // scene with nested and indexed nodes
+    writeFile("test-scene.xml",
+        "<?xml version=\"1.0\"?>\n"
+        "<scene>\n"
+        "  <name>test scene</name>\n"
+        "  <enabled>1</enabled>\n"
+        "  <hidden>0</hidden>\n"
+        "  <count>-42</count>\n"
+        "  <scale>0.125</scale>\n"
+        "  <object><position>0 0 0</position></object>\n"
+        "  <object><position>1, 2, 3</position></object>\n"
+        "  <object><position> -1.5;2.5e1 ; 3E-2 </position><mass>2.5</mass></object>\n"
+        "  <values><v>1</v><v>2.5</v><v>-3</v></values>\n"
+        "  <bad>1 2 abc</bad>\n"
+        "</scene>\n");
+
+    cFileXML xml;
+    CHECK(xml.loadFromFile("test-scene.xml"));
+
+    // typed path values
+    bool enabled = false;
+    bool hidden = true;
+    long int count = 0;
+    int countInt = 0;
+    double scale = 0.0;
+    float scaleFloat = 0.0f;
+    string name;
+    CHECK(xml.getPathValue("/scene/enabled", enabled) && enabled);
+    CHECK(xml.getPathValue("/scene/hidden", hidden) && !hidden);
+    CHECK(xml.getPathValue("/scene/count", count) && (count == -42));
+    CHECK(xml.getPathValue("/scene/count", countInt) && (countInt == -42));
+    CHECK(xml.getPathValue("/scene/scale", scale) && (scale == 0.125));
+    CHECK(xml.getPathValue("/scene/scale", scaleFloat) && (scaleFloat == 0.125f));
+    CHECK(xml.getPathValue("/scene/name", name) && (name == "test scene"));
+
+    // missing nodes
+    CHECK(!xml.getPathValue("/scene/missing", scale));
+    CHECK(!xml.getPathValue("/scene/object[3]/position", scale));
+    CHECK(!xml.gotoPath("/scene/missing"));
+
+    // number lists separated by spaces, commas and semicolons
+    vector<double> values;
+    const double position0[] = { 0.0, 0.0, 0.0 };
+    const double position1[] = { 1.0, 2.0, 3.0 };
+    const double position2[] = { -1.5, 25.0, 0.03 };
+    CHECK(xml.getPathValues("/scene/object/position", values) && equal(values, position0, 3));
+    CHECK(xml.getPathValues("/scene/object[1]/position", values) && equal(values, position1, 3));
+    CHECK(xml.getPathValues("/scene/object[2]/position", values) && equal(values, position2, 3));
+    CHECK(!xml.getPathValues("/scene/bad", values));
+
+    // relative paths and current node
+    xml.gotoRoot();
+    CHECK(xml.gotoPath("scene/object[2]"));
+    string nodeName;
+    CHECK(xml.getName(nodeName) && (nodeName == "object"));
+    double mass = 0.0;
+    CHECK(xml.getPathValue("mass", mass) && (mass == 2.5));
+    CHECK(xml.getName(nodeName) && (nodeName == "object"));
+    CHECK(xml.gotoPath("position") && xml.getValues(values) && equal(values, position2, 3));
+    CHECK(xml.gotoPath("../../values"));
+    const double children[] = { 1.0, 2.5, -3.0 };
+    CHECK(xml.getChildValues("v", values) && equal(values, children, 3));
+    CHECK(!xml.getChildValues("w", values));
+
+    // failed navigation leaves the current node unchanged
+    CHECK(!xml.gotoPath("v[5]"));
+    CHECK(xml.getName(nodeName) && (nodeName == "values"));
+
+    // indexed access over a long list of siblings
+    const int numItems = 2000;
+    cFileXML list;
+    list.gotoRoot();
+    list.gotoChild("list", 0, true);
+    for (int i=0; i<numItems; i++)
+    {
+        list.setValue("item", 3 * i, i);
+    }
+    bool ok = true;
+    for (int i=numItems-1; i>=0; i--)
+    {
+        int value = -1;
+        ok = ok && list.getValue("item", value, i) && (value == 3 * i);
+    }
+    CHECK(ok);
+    CHECK(list.getChildValues("item", values) && (values.size() == (size_t)numItems));
+
+    // cached lookups follow removed and renamed nodes
+    CHECK(list.removeChild("item", 0));
+    int first = -1;
+    CHECK(list.getValue("item", first, 0) && (first == 3));
+    CHECK(list.gotoChild("item", 0) >= 0);
+    CHECK(list.setName("renamed"));
+    list.gotoParent();
+    CHECK(list.getValue("item", first, 0) && (first == 6));
+    CHECK(list.getValue("renamed", first, 0) && (first == 3));
+    CHECK(list.getPathValue("/list/item[1]", first) && (first == 9));
+    int last = -1;
+    CHECK(!list.getValue("item", last, numItems - 2));
+    CHECK(list.getValue("item", last, numItems - 3) && (last == 3 * (numItems - 1)));
+
+    // double parsing agrees with strtod
+    srand(1234);
+    int numMismatches = 0;
+    for (int i=0; i<20000; i++)
+    {
+        char text[64];
+        double mantissa = (double)rand() / RAND_MAX + (double)rand() / RAND_MAX / RAND_MAX;
+        int exponent = (rand() % 601) - 300;
+        switch (i % 4)
+        {
+            case 0: snprintf(text, sizeof(text), "%.17g", mantissa * pow(10.0, exponent)); break;
+            case 1: snprintf(text, sizeof(text), "%.6f", 1000.0 * (mantissa - 0.5)); break;
+            case 2: snprintf(text, sizeof(text), "%d.%de%d", rand() % 1000, rand(), (rand() % 41) - 20); break;
+            default: snprintf(text, sizeof(text), "-%.25f", mantissa); break;
+        }
+
+        cFileXML number;
+        number.gotoRoot();
+        number.setValue("x", string(text));
+        double value = 0.0;
+        if (!number.getValue("x", value) || (value != strtod(text, NULL)))
+        {
+            if (numMismatches++ < 10)
+            {
+                printf("mismatch parsing %s\n", text);
+            }
+        }
+    }
+    CHECK(numMismatches == 0);
+
+    return (CHECK_RESULT());
+}
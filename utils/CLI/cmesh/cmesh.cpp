@@ -0,0 +1,181 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 2182 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <cstdlib>
+#include <iostream>
+#include <string>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// simple usage printer
+int usage()
+{
+    cout << endl << "cmesh [-c] [-r radius] [-n] model.{3ds|obj|stl} [-o model.cmm]" << endl;
+    cout << "\t-c\tinclude AABB collision trees in the cache" << endl;
+    cout << "\t-r\tspecify collision tree radius (default 0.0)" << endl;
+    cout << "\t-n\tdo not optimize meshes" << endl;
+    cout << "\t-o\tspecify cache filename" << endl;
+    cout << "\t-h\tdisplay this message" << endl << endl;
+
+    return -1;
+}
+
+
+//===========================================================================
+/*
+    UTILITY:    cmesh.cpp
+
+    This utility takes a 3D model in any CHAI3D supported format and produces
+    a CHAI3D binary model cache (.cmm). Models are loaded, optimized and have
+    their normals computed once, offline; applications can then load the 
+    cache directly into vertex and triangle arrays, without parsing the 
+    original file or rebuilding the collision trees at start-up.
+ */
+//===========================================================================
+
+int main(int argc, char* argv[])
+{
+    string modelname;
+    string filename;
+    bool   collisionTree = false;
+    bool   optimize = true;
+    double radius = 0.0;
+
+    // process arguments
+    if (argc < 2) return usage();
+    for (int i=1; i<argc; i++)
+    {
+        if (argv[i][0] != '-') {
+            if (modelname.length() > 0) return usage();
+            modelname = string(argv[i]);
+        }
+        else switch (argv[i][1]) {
+            case 'h':
+                return usage ();
+            case 'o':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    filename = string(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 'r':
+                if (i+1 < argc) {
+                    i++;
+                    radius = atof(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 'c':
+                collisionTree = true;
+                break;
+            case 'n':
+                optimize = false;
+                break;
+            default:
+                return usage ();
+        }
+    }
+
+    // figure out output filename
+    if (modelname.length() == 0) return usage();
+    if (filename.length() == 0)
+    {
+        filename = cReplaceFileExtension(modelname, ".cmm");
+    }
+
+    // pretty message
+    cout << endl;
+    cout << "-----------------------------------" << endl;
+    cout << "CHAI3D" << endl;
+    cout << "Mesh Converter" << endl;
+    cout << "Copyright 2003-2016" << endl;
+    cout << "-----------------------------------" << endl;
+    cout << endl;
+
+    // report action
+    cout << "converting " << modelname << " to " << filename << "..." << endl;
+
+    // read model
+    cMultiMesh* model = new cMultiMesh();
+    g_meshLoaderShouldOptimize = optimize;
+    if (!model->loadFromFile(modelname))
+    {
+        cout << "error: cannot load model file " << modelname << endl;
+        delete model;
+        return -1;
+    }
+    cout << "model load succeeded (" << model->getNumMeshes() << " meshes, " 
+         << model->getNumVertices() << " vertices, " 
+         << model->getNumTriangles() << " triangles)" << endl;
+
+    // build collision trees
+    if (collisionTree)
+    {
+        model->createAABBCollisionDetector(radius);
+    }
+    cout << endl;
+
+    // export cache
+    if (!cSaveFileCMM(model, filename, collisionTree))
+    {
+        cout << "error: conversion failed" << endl;
+        delete model;
+        return -1;
+    }
+
+    cout << "conversion succeeded" << endl;
+    delete model;
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------